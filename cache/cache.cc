@@ -10,6 +10,7 @@
 #include "rocksdb/cache.h"
 
 #include "cache/lru_cache.h"
+#include "rocksdb/env.h"
 #include "rocksdb/secondary_cache.h"
 #include "rocksdb/utilities/customizable_util.h"
 #include "rocksdb/utilities/options_type.h"
@@ -63,6 +64,42 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    enable_custom_split_merge),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"compression_level",
+         {offsetof(struct CompressedSecondaryCacheOptions, compression_level),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"max_dict_bytes",
+         {offsetof(struct CompressedSecondaryCacheOptions, max_dict_bytes),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+};
+
+static std::unordered_map<std::string, OptionTypeInfo>
+    file_sec_cache_options_type_info = {
+        {"path",
+         {offsetof(struct FileSecondaryCacheOptions, path),
+          OptionType::kString, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"capacity",
+         {offsetof(struct FileSecondaryCacheOptions, capacity),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"file_size",
+         {offsetof(struct FileSecondaryCacheOptions, file_size),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"write_buffer_size",
+         {offsetof(struct FileSecondaryCacheOptions, write_buffer_size),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"admission_min_frequency",
+         {offsetof(struct FileSecondaryCacheOptions, admission_min_frequency),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"num_read_threads",
+         {offsetof(struct FileSecondaryCacheOptions, num_read_threads),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
 };
 #endif  // ROCKSDB_LITE
 
@@ -90,6 +127,31 @@ Status SecondaryCache::CreateFromString(
         "Cannot load compressed secondary cache in LITE mode ", args);
 #endif  //! ROCKSDB_LITE
 
+    if (status.ok()) {
+      result->swap(sec_cache);
+    }
+    return status;
+  } else if (value.find("file_secondary_cache://") == 0) {
+    std::string args = value;
+    args.erase(0, std::strlen("file_secondary_cache://"));
+    Status status;
+    std::shared_ptr<SecondaryCache> sec_cache;
+
+#ifndef ROCKSDB_LITE
+    FileSecondaryCacheOptions sec_cache_opts;
+    status = OptionTypeInfo::ParseStruct(config_options, "",
+                                         &file_sec_cache_options_type_info, "",
+                                         args, &sec_cache_opts);
+    if (status.ok()) {
+      sec_cache_opts.file_system = config_options.env->GetFileSystem();
+      status = NewFileSecondaryCache(sec_cache_opts, &sec_cache);
+    }
+#else
+    (void)config_options;
+    status = Status::NotSupported(
+        "Cannot load file secondary cache in LITE mode ", args);
+#endif  //! ROCKSDB_LITE
+
     if (status.ok()) {
       result->swap(sec_cache);
     }
@@ -14,6 +14,8 @@
 #include <sstream>
 
 #include "db/db_impl/db_impl.h"
+#include "memory/memory_allocator.h"
+#include "memory/slab_allocator.h"
 #include "monitoring/histogram.h"
 #include "port/port.h"
 #include "rocksdb/cache.h"
@@ -49,6 +51,10 @@ DEFINE_double(resident_ratio, 0.25,
               "Ratio of keys fitting in cache to keyspace.");
 DEFINE_uint64(ops_per_thread, 2000000U, "Number of operations per thread.");
 DEFINE_uint32(value_bytes, 8 * KiB, "Size of each value added.");
+DEFINE_bool(mixed_value_bytes, false,
+            "If true, the size of the value of each key is value_bytes "
+            "divided by 1, 2, 4, 8 or 16, for a mix of entry sizes like "
+            "data and metadata blocks with different block sizes.");
 
 DEFINE_uint32(skew, 5, "Degree of skew in key selection");
 DEFINE_bool(populate_cache, true, "Populate cache before operations");
@@ -81,9 +87,17 @@ DEFINE_bool(lean, false,
 DEFINE_string(secondary_cache_uri, "",
               "Full URI for creating a custom secondary cache object");
 static class std::shared_ptr<ROCKSDB_NAMESPACE::SecondaryCache> secondary_cache;
+DEFINE_string(memory_allocator_uri, "",
+              "Full URI for creating a custom memory allocator for the cache "
+              "entries, e.g. \"SlabAllocator; use_huge_pages=true\"");
 #endif  // ROCKSDB_LITE
+static class std::shared_ptr<ROCKSDB_NAMESPACE::MemoryAllocator>
+    memory_allocator;
 
-DEFINE_string(cache_type, "lru_cache", "Type of block cache.");
+DEFINE_string(cache_type, "lru_cache",
+              "Type of block cache: lru_cache, hyper_clock_cache (with "
+              "estimated_entry_charge = value_bytes) or auto_hyper_clock_cache "
+              "(without estimated_entry_charge).");
 
 // ## BEGIN stress_cache_key sub-tool options ##
 // See class StressCacheKey below.
@@ -226,17 +240,40 @@ struct KeyGen {
   }
 };
 
-Cache::ObjectPtr createValue(Random64& rnd) {
-  char* rv = new char[FLAGS_value_bytes];
+// The size of the value of a key
+uint32_t GetValueBytes(const Slice& key) {
+  if (!FLAGS_mixed_value_bytes) {
+    return FLAGS_value_bytes;
+  }
+  uint32_t shift = Lower32of64(NPHash64(key.data(), key.size())) % 5;
+  return std::max(uint32_t{8}, (FLAGS_value_bytes >> shift) & ~uint32_t{7});
+}
+
+// The average size of the values, for sizing the key space
+double GetAverageValueBytes() {
+  if (!FLAGS_mixed_value_bytes) {
+    return FLAGS_value_bytes;
+  }
+  return FLAGS_value_bytes * (1.0 + 1.0 / 2 + 1.0 / 4 + 1.0 / 8 + 1.0 / 16) /
+         5;
+}
+
+Cache::ObjectPtr createValue(Random64& rnd, uint32_t value_bytes,
+                             MemoryAllocator* allocator) {
+  char* rv = AllocateBlock(value_bytes, allocator).release();
   // Fill with some filler data, and take some CPU time
-  for (uint32_t i = 0; i < FLAGS_value_bytes; i += 8) {
+  for (uint32_t i = 0; i < value_bytes; i += 8) {
     EncodeFixed64(rv + i, rnd.Next());
   }
+  // Starting with the size, for the callbacks
+  EncodeFixed32(rv, value_bytes);
   return rv;
 }
 
 // Callbacks for secondary cache
-size_t SizeFn(Cache::ObjectPtr /*obj*/) { return FLAGS_value_bytes; }
+size_t SizeFn(Cache::ObjectPtr obj) {
+  return DecodeFixed32(static_cast<char*>(obj));
+}
 
 Status SaveToFn(Cache::ObjectPtr from_obj, size_t /*from_offset*/,
                 size_t length, char* out) {
@@ -245,16 +282,16 @@ Status SaveToFn(Cache::ObjectPtr from_obj, size_t /*from_offset*/,
 }
 
 Status CreateFn(const Slice& data, Cache::CreateContext* /*context*/,
-                MemoryAllocator* /*allocator*/, Cache::ObjectPtr* out_obj,
+                MemoryAllocator* allocator, Cache::ObjectPtr* out_obj,
                 size_t* out_charge) {
-  *out_obj = new char[data.size()];
+  *out_obj = AllocateBlock(data.size(), allocator).release();
   memcpy(*out_obj, data.data(), data.size());
   *out_charge = data.size();
   return Status::OK();
 };
 
-void DeleteFn(Cache::ObjectPtr value, MemoryAllocator* /*alloc*/) {
-  delete[] static_cast<char*>(value);
+void DeleteFn(Cache::ObjectPtr value, MemoryAllocator* alloc) {
+  CustomDeleter{alloc}(static_cast<char*>(value));
 }
 
 Cache::CacheItemHelper helper1(CacheEntryRole::kDataBlock, DeleteFn, SizeFn,
@@ -272,7 +309,7 @@ class CacheBench {
  public:
   CacheBench()
       : max_key_(static_cast<uint64_t>(FLAGS_cache_size / FLAGS_resident_ratio /
-                                       FLAGS_value_bytes)),
+                                       GetAverageValueBytes())),
         lookup_insert_threshold_(kHundredthUint64 *
                                  FLAGS_lookup_insert_percent),
         insert_threshold_(lookup_insert_threshold_ +
@@ -294,17 +331,39 @@ class CacheBench {
       if (max_key > (static_cast<uint64_t>(1) << max_log_)) max_log_++;
     }
 
+#ifndef ROCKSDB_LITE
+    if (!FLAGS_memory_allocator_uri.empty()) {
+      Status s = MemoryAllocator::CreateFromString(
+          ConfigOptions(), FLAGS_memory_allocator_uri, &memory_allocator);
+      if (memory_allocator == nullptr) {
+        fprintf(stderr,
+                "No memory allocator registered matching string: %s "
+                "status=%s\n",
+                FLAGS_memory_allocator_uri.c_str(), s.ToString().c_str());
+        exit(1);
+      }
+    }
+#endif  // ROCKSDB_LITE
+
     if (FLAGS_cache_type == "clock_cache") {
       fprintf(stderr, "Old clock cache implementation has been removed.\n");
       exit(1);
     } else if (FLAGS_cache_type == "hyper_clock_cache") {
-      cache_ = HyperClockCacheOptions(FLAGS_cache_size, FLAGS_value_bytes,
-                                      FLAGS_num_shard_bits)
-                   .MakeSharedCache();
+      HyperClockCacheOptions opts(FLAGS_cache_size, FLAGS_value_bytes,
+                                  FLAGS_num_shard_bits);
+      opts.memory_allocator = memory_allocator;
+      cache_ = opts.MakeSharedCache();
+    } else if (FLAGS_cache_type == "auto_hyper_clock_cache") {
+      HyperClockCacheOptions opts(FLAGS_cache_size,
+                                  /*estimated_entry_charge=*/0,
+                                  FLAGS_num_shard_bits);
+      opts.memory_allocator = memory_allocator;
+      cache_ = opts.MakeSharedCache();
     } else if (FLAGS_cache_type == "lru_cache") {
       LRUCacheOptions opts(FLAGS_cache_size, FLAGS_num_shard_bits,
                            false /* strict_capacity_limit */,
                            0.5 /* high_pri_pool_ratio */);
+      opts.memory_allocator = memory_allocator;
 #ifndef ROCKSDB_LITE
       if (!FLAGS_secondary_cache_uri.empty()) {
         Status s = SecondaryCache::CreateFromString(
@@ -332,10 +391,14 @@ class CacheBench {
   void PopulateCache() {
     Random64 rnd(1);
     KeyGen keygen;
-    for (uint64_t i = 0; i < 2 * FLAGS_cache_size; i += FLAGS_value_bytes) {
-      Status s = cache_->Insert(keygen.GetRand(rnd, max_key_, max_log_),
-                                createValue(rnd), &helper1, FLAGS_value_bytes);
+    for (uint64_t i = 0; i < 2 * FLAGS_cache_size;) {
+      Slice key = keygen.GetRand(rnd, max_key_, max_log_);
+      uint32_t value_bytes = GetValueBytes(key);
+      Status s = cache_->Insert(
+          key, createValue(rnd, value_bytes, memory_allocator.get()),
+          &helper1, value_bytes);
       assert(s.ok());
+      i += value_bytes;
     }
   }
 
@@ -409,6 +472,33 @@ class CacheBench {
 
     printf("\n%s", stats_report.c_str());
 
+    // Whether the cache could use its capacity, e.g. with the table of a
+    // HyperClockCache sized for the wrong entry charge
+    printf("\nCache usage: %s / %s\n",
+           BytesToHumanString(cache_->GetUsage()).c_str(),
+           BytesToHumanString(cache_->GetCapacity()).c_str());
+    printf("Table occupancy: %zu / %zu\n", cache_->GetOccupancyCount(),
+           cache_->GetTableAddressCount());
+
+    // Memory overhead of the allocator, which is traded for fewer TLB misses
+    // in the lookups above, which hash the whole value unless lean
+    auto slab_allocator =
+        memory_allocator ? memory_allocator->CheckedCast<SlabAllocator>()
+                         : nullptr;
+    if (slab_allocator) {
+      SlabAllocator::Stats alloc_stats = slab_allocator->GetStats();
+      printf("Allocator: %s mapped for %s allocated (%.1f%% overhead)\n",
+             BytesToHumanString(alloc_stats.mapped_bytes).c_str(),
+             BytesToHumanString(alloc_stats.allocated_bytes).c_str(),
+             alloc_stats.allocated_bytes == 0
+                 ? 0.0
+                 : 100.0 * (static_cast<double>(alloc_stats.mapped_bytes) /
+                                alloc_stats.allocated_bytes -
+                            1.0));
+      printf("Slabs: %zu, on huge pages: %zu\n", alloc_stats.num_slabs,
+             alloc_stats.num_huge_page_slabs);
+    }
+
     return true;
   }
 
@@ -530,6 +620,7 @@ class CacheBench {
     uint64_t result = 0;
     // To hold handles for a non-trivial amount of time
     Cache::Handle* handle = nullptr;
+    MemoryAllocator* const allocator = memory_allocator.get();
     KeyGen gen;
     const auto clock = SystemClock::Default().get();
     uint64_t start_time = clock->NowMicros();
@@ -537,6 +628,7 @@ class CacheBench {
 
     for (uint64_t i = 0; i < FLAGS_ops_per_thread; i++) {
       Slice key = gen.GetRand(thread->rnd, max_key_, max_log_);
+      uint32_t value_bytes = GetValueBytes(key);
       uint64_t random_op = thread->rnd.Next();
 
       timer.Start();
@@ -553,12 +645,13 @@ class CacheBench {
           if (!FLAGS_lean) {
             // do something with the data
             result += NPHash64(static_cast<char*>(cache_->Value(handle)),
-                               FLAGS_value_bytes);
+                               value_bytes);
           }
         } else {
           // do insert
-          Status s = cache_->Insert(key, createValue(thread->rnd), &helper2,
-                                    FLAGS_value_bytes, &handle);
+          Status s = cache_->Insert(
+              key, createValue(thread->rnd, value_bytes, allocator), &helper2,
+              value_bytes, &handle);
           assert(s.ok());
         }
       } else if (random_op < insert_threshold_) {
@@ -567,8 +660,9 @@ class CacheBench {
           handle = nullptr;
         }
         // do insert
-        Status s = cache_->Insert(key, createValue(thread->rnd), &helper3,
-                                  FLAGS_value_bytes, &handle);
+        Status s = cache_->Insert(
+            key, createValue(thread->rnd, value_bytes, allocator), &helper3,
+            value_bytes, &handle);
         assert(s.ok());
       } else if (random_op < lookup_threshold_) {
         if (handle) {
@@ -582,7 +676,7 @@ class CacheBench {
           if (!FLAGS_lean) {
             // do something with the data
             result += NPHash64(static_cast<char*>(cache_->Value(handle)),
-                               FLAGS_value_bytes);
+                               value_bytes);
           }
         }
       } else if (random_op < erase_threshold_) {
@@ -622,6 +716,8 @@ class CacheBench {
            BytesToHumanString(FLAGS_cache_size).c_str());
     printf("Num shard bits      : %u\n", FLAGS_num_shard_bits);
     printf("Max key             : %" PRIu64 "\n", max_key_);
+    printf("Value bytes         : %u%s\n", FLAGS_value_bytes,
+           FLAGS_mixed_value_bytes ? " (mixed)" : "");
     printf("Resident ratio      : %g\n", FLAGS_resident_ratio);
     printf("Skew degree         : %u\n", FLAGS_skew);
     printf("Populate cache      : %d\n", int{FLAGS_populate_cache});
@@ -629,6 +725,8 @@ class CacheBench {
     printf("Insert percentage   : %u%%\n", FLAGS_insert_percent);
     printf("Lookup percentage   : %u%%\n", FLAGS_lookup_percent);
     printf("Erase percentage    : %u%%\n", FLAGS_erase_percent);
+    printf("Memory allocator    : %s\n",
+           memory_allocator ? memory_allocator->GetId().c_str() : "default");
     std::ostringstream stats;
     if (FLAGS_gather_stats) {
       stats << "enabled (" << FLAGS_gather_stats_sleep_ms << "ms, "
@@ -495,6 +495,69 @@ TEST_P(CacheTest, EvictionPolicy) {
   ASSERT_EQ(-1, Lookup(200));
 }
 
+TEST_P(CacheTest, FrequencyAdmission) {
+  constexpr int kCapacity = 100;
+  constexpr int kWorkingSet = 50;
+  std::shared_ptr<Cache> cache;
+  if (GetParam() == kLRU) {
+    LRUCacheOptions co(kCapacity, 0 /*num_shard_bits*/,
+                       false /*strict_capacity_limit*/,
+                       0.0 /*high_pri_pool_ratio*/);
+    co.metadata_charge_policy = kDontChargeCacheMetadata;
+    co.frequency_admission = true;
+    cache = NewLRUCache(co);
+  } else {
+    HyperClockCacheOptions co(kCapacity, 1 /*estimated_value_size*/,
+                              0 /*num_shard_bits*/);
+    co.metadata_charge_policy = kDontChargeCacheMetadata;
+    co.frequency_admission = true;
+    cache = co.MakeSharedCache();
+  }
+
+  // A working set accessed several times
+  for (int round = 0; round < 4; round++) {
+    for (int i = 0; i < kWorkingSet; i++) {
+      if (Lookup(cache, i) == -1) {
+        Insert(cache, i, 1000 + i);
+      }
+    }
+  }
+  // A scan of keys accessed once must not push out the working set
+  for (int i = 0; i < 3 * kCapacity; i++) {
+    int key = 10000 + i;
+    if (Lookup(cache, key) == -1) {
+      Insert(cache, key, key);
+    }
+  }
+  int num_present = 0;
+  for (int i = 0; i < kWorkingSet; i++) {
+    int value = Lookup(cache, i);
+    if (value != -1) {
+      ASSERT_EQ(1000 + i, value);
+      num_present++;
+    }
+  }
+  if (GetParam() == kLRU) {
+    // Compares with the actual LRU entry
+    ASSERT_EQ(kWorkingSet, num_present);
+  } else {
+    // Compares with the most recently evicted entry, and the first entries
+    // to evict are admitted
+    ASSERT_GE(num_present, kWorkingSet * 9 / 10);
+  }
+  ASSERT_LE(cache->GetUsage(), size_t{kCapacity});
+
+  // An entry that is not admitted is still returned in a handle when one is
+  // requested
+  Cache::Handle* handle = nullptr;
+  ASSERT_OK(cache->Insert(EncodeKey(20000), EncodeValue(20000), &kHelper, 1,
+                          &handle));
+  ASSERT_NE(handle, nullptr);
+  ASSERT_EQ(20000, DecodeValue(cache->Value(handle)));
+  cache->Release(handle);
+  ASSERT_LE(cache->GetUsage(), size_t{kCapacity});
+}
+
 TEST_P(CacheTest, ExternalRefPinsEntries) {
   Insert(100, 101);
   Cache::Handle* h = cache_->Lookup(EncodeKey(100));
@@ -125,17 +125,48 @@ HyperClockTable::HyperClockTable(
     size_t capacity, bool /*strict_capacity_limit*/,
     CacheMetadataChargePolicy metadata_charge_policy,
     MemoryAllocator* allocator, const Opts& opts)
-    : length_bits_(CalcHashBits(capacity, opts.estimated_value_size,
-                                metadata_charge_policy)),
-      length_bits_mask_((size_t{1} << length_bits_) - 1),
-      occupancy_limit_(static_cast<size_t>((uint64_t{1} << length_bits_) *
-                                           kStrictLoadFactor)),
-      array_(new HandleImpl[size_t{1} << length_bits_]),
+    : min_length_bits_(CalcHashBits(capacity,
+                                    opts.estimated_value_size > 0
+                                        ? opts.estimated_value_size
+                                        : kGrowableInitialEntryCharge,
+                                    metadata_charge_policy)),
+      max_length_bits_(min_length_bits_),
+      length_bits_(min_length_bits_),
+      charge_metadata_(metadata_charge_policy ==
+                       CacheMetadataChargePolicy::kFullChargeCacheMetadata),
       allocator_(allocator) {
-  if (metadata_charge_policy ==
-      CacheMetadataChargePolicy::kFullChargeCacheMetadata) {
+  if (opts.estimated_value_size == 0) {
+    // Reserve the slots for the smallest average entry charge we support,
+    // settling for less if that much address space is not available.
+    int max_length_bits = std::max(
+        min_length_bits_, CalcHashBits(capacity, kGrowableMinEntryCharge,
+                                       metadata_charge_policy));
+    for (; max_length_bits > min_length_bits_; --max_length_bits) {
+      std::unique_ptr<MemMapping> mapping(new MemMapping(
+          MemMapping::AllocateLazyZeroed(sizeof(HandleImpl)
+                                         << max_length_bits)));
+      if (mapping->Get() != nullptr) {
+        max_length_bits_ = max_length_bits;
+        growable_array_ = std::move(mapping);
+        break;
+      }
+    }
+  }
+  if (growable_array_) {
+    // Zeroed memory is the same as default constructed slots
+    array_ = static_cast<HandleImpl*>(growable_array_->Get());
+    generation_occupancy_.reset(
+        new std::atomic<size_t>[max_length_bits_ - min_length_bits_ + 1]{});
+  } else {
+    fixed_array_.reset(new HandleImpl[size_t{1} << min_length_bits_]);
+    array_ = fixed_array_.get();
+  }
+  if (charge_metadata_) {
     usage_ += size_t{GetTableSize()} * sizeof(HandleImpl);
   }
+  if (opts.frequency_admission) {
+    admission_sketch_.reset(new FrequencySketch(GetMaxTableSize()));
+  }
 
   static_assert(sizeof(HandleImpl) == 64U,
                 "Expecting size / alignment with common cache line size");
@@ -155,7 +186,7 @@ HyperClockTable::~HyperClockTable() {
         assert(GetRefcount(h.meta) == 0);
         h.FreeData(allocator_);
 #ifndef NDEBUG
-        Rollback(h.hashed_key, &h);
+        RollbackEntry(h.hashed_key, &h, h.length_bits);
         ReclaimEntryUsage(h.GetTotalCharge());
 #endif
         break;
@@ -385,6 +416,22 @@ inline HyperClockTable::HandleImpl* HyperClockTable::DetachedInsert(
 Status HyperClockTable::Insert(const ClockHandleBasicData& proto,
                                HandleImpl** handle, Cache::Priority priority,
                                size_t capacity, bool strict_capacity_limit) {
+  const size_t total_charge = proto.GetTotalCharge();
+  if (admission_sketch_ != nullptr &&
+      usage_.load(std::memory_order_relaxed) + total_charge > capacity &&
+      (handle == nullptr || !strict_capacity_limit) &&
+      admission_sketch_->Estimate(proto.hashed_key[0]) <
+          victim_frequency_.load(std::memory_order_relaxed)) {
+    // Rejected by admission, as if inserted and evicted immediately
+    if (handle == nullptr) {
+      proto.FreeData(allocator_);
+    } else {
+      usage_.fetch_add(total_charge, std::memory_order_relaxed);
+      *handle = DetachedInsert(proto);
+    }
+    return Status::OK();
+  }
+  int length_bits = length_bits_.load(std::memory_order_acquire);
   // Do we have the available occupancy? Optimistically assume we do
   // and deal with it if we don't.
   size_t old_occupancy = occupancy_.fetch_add(1, std::memory_order_acquire);
@@ -392,12 +439,17 @@ Status HyperClockTable::Insert(const ClockHandleBasicData& proto,
     occupancy_.fetch_sub(1, std::memory_order_relaxed);
   };
   // Whether we over-committed and need an eviction to make up for it
-  bool need_evict_for_occupancy = old_occupancy >= occupancy_limit_;
+  bool need_evict_for_occupancy = old_occupancy >= OccupancyLimit(length_bits);
+  if (UNLIKELY(need_evict_for_occupancy) &&
+      MaybeGrow(length_bits, total_charge, capacity)) {
+    // Made room by growing the table instead
+    need_evict_for_occupancy = false;
+    length_bits = length_bits_.load(std::memory_order_acquire);
+  }
 
   // Usage/capacity handling is somewhat different depending on
   // strict_capacity_limit, but mostly pessimistic.
   bool use_detached_insert = false;
-  const size_t total_charge = proto.GetTotalCharge();
   if (strict_capacity_limit) {
     Status s = ChargeUsageMaybeEvictStrict(total_charge, capacity,
                                            need_evict_for_occupancy);
@@ -443,7 +495,7 @@ Status HyperClockTable::Insert(const ClockHandleBasicData& proto,
 
     size_t probe = 0;
     HandleImpl* e = FindSlot(
-        proto.hashed_key,
+        proto.hashed_key, length_bits,
         [&](HandleImpl* h) {
           // Optimistically transition the slot from "empty" to
           // "under construction" (no effect on other states)
@@ -458,6 +510,8 @@ Status HyperClockTable::Insert(const ClockHandleBasicData& proto,
             // ownership Save data fields
             ClockHandleBasicData* h_alias = h;
             *h_alias = proto;
+            h->length_bits = static_cast<uint8_t>(length_bits);
+            AddToGeneration(length_bits);
 
             // Transition from "under construction" state to "visible" state
             uint64_t new_meta = uint64_t{ClockHandle::kStateVisible}
@@ -538,7 +592,7 @@ Status HyperClockTable::Insert(const ClockHandleBasicData& proto,
       // should be no higher than pow(kStrictLoadFactor, n) for n slots.
       // That should be infeasible for roughly n >= 256, so if this assertion
       // fails, that suggests something is going wrong.
-      assert(GetTableSize() < 256);
+      assert((size_t{1} << length_bits) < 256);
       use_detached_insert = true;
     }
     if (!use_detached_insert) {
@@ -549,7 +603,7 @@ Status HyperClockTable::Insert(const ClockHandleBasicData& proto,
       return Status::OK();
     }
     // Roll back table insertion
-    Rollback(proto.hashed_key, e);
+    Rollback(proto.hashed_key, e, length_bits);
     revert_occupancy_fn();
     // Maybe fall back on detached insert
     if (handle == nullptr) {
@@ -575,68 +629,85 @@ Status HyperClockTable::Insert(const ClockHandleBasicData& proto,
 
 HyperClockTable::HandleImpl* HyperClockTable::Lookup(
     const UniqueId64x2& hashed_key) {
-  size_t probe = 0;
-  HandleImpl* e = FindSlot(
-      hashed_key,
-      [&](HandleImpl* h) {
-        // Mostly branch-free version (similar performance)
-        /*
-        uint64_t old_meta = h->meta.fetch_add(ClockHandle::kAcquireIncrement,
-                                     std::memory_order_acquire);
-        bool Shareable = (old_meta >> (ClockHandle::kStateShift + 1)) & 1U;
-        bool visible = (old_meta >> ClockHandle::kStateShift) & 1U;
-        bool match = (h->key == key) & visible;
-        h->meta.fetch_sub(static_cast<uint64_t>(Shareable & !match) <<
-        ClockHandle::kAcquireCounterShift, std::memory_order_release); return
-        match;
-        */
-        // Optimistic lookup should pay off when the table is relatively
-        // sparse.
-        constexpr bool kOptimisticLookup = true;
-        uint64_t old_meta;
-        if (!kOptimisticLookup) {
-          old_meta = h->meta.load(std::memory_order_acquire);
-          if ((old_meta >> ClockHandle::kStateShift) !=
-              ClockHandle::kStateVisible) {
-            return false;
-          }
-        }
-        // (Optimistically) increment acquire counter
-        old_meta = h->meta.fetch_add(ClockHandle::kAcquireIncrement,
-                                     std::memory_order_acquire);
-        // Check if it's an entry visible to lookups
-        if ((old_meta >> ClockHandle::kStateShift) ==
-            ClockHandle::kStateVisible) {
-          // Acquired a read reference
-          if (h->hashed_key == hashed_key) {
-            // Match
-            return true;
-          } else {
-            // Mismatch. Pretend we never took the reference
-            old_meta = h->meta.fetch_sub(ClockHandle::kAcquireIncrement,
-                                         std::memory_order_release);
-          }
-        } else if (UNLIKELY((old_meta >> ClockHandle::kStateShift) ==
-                            ClockHandle::kStateInvisible)) {
-          // Pretend we never took the reference
-          // WART: there's a tiny chance we release last ref to invisible
-          // entry here. If that happens, we let eviction take care of it.
-          old_meta = h->meta.fetch_sub(ClockHandle::kAcquireIncrement,
-                                       std::memory_order_release);
-        } else {
-          // For other states, incrementing the acquire counter has no effect
-          // so we don't need to undo it. Furthermore, we cannot safely undo
-          // it because we did not acquire a read reference to lock the
-          // entry in a Shareable state.
-        }
-        (void)old_meta;
+  if (admission_sketch_ != nullptr &&
+      admission_sketch_->Increment(hashed_key[0])) {
+    // Age the count of the last victim along with the counts in the sketch
+    victim_frequency_.store(victim_frequency_.load(std::memory_order_relaxed) /
+                                2,
+                            std::memory_order_relaxed);
+  }
+  auto match_fn = [&](HandleImpl* h) {
+    // Mostly branch-free version (similar performance)
+    /*
+    uint64_t old_meta = h->meta.fetch_add(ClockHandle::kAcquireIncrement,
+                                 std::memory_order_acquire);
+    bool Shareable = (old_meta >> (ClockHandle::kStateShift + 1)) & 1U;
+    bool visible = (old_meta >> ClockHandle::kStateShift) & 1U;
+    bool match = (h->key == key) & visible;
+    h->meta.fetch_sub(static_cast<uint64_t>(Shareable & !match) <<
+    ClockHandle::kAcquireCounterShift, std::memory_order_release); return
+    match;
+    */
+    // Optimistic lookup should pay off when the table is relatively
+    // sparse.
+    constexpr bool kOptimisticLookup = true;
+    uint64_t old_meta;
+    if (!kOptimisticLookup) {
+      old_meta = h->meta.load(std::memory_order_acquire);
+      if ((old_meta >> ClockHandle::kStateShift) !=
+          ClockHandle::kStateVisible) {
         return false;
-      },
-      [&](HandleImpl* h) {
-        return h->displacements.load(std::memory_order_relaxed) == 0;
-      },
-      [&](HandleImpl* /*h*/) {}, probe);
+      }
+    }
+    // (Optimistically) increment acquire counter
+    old_meta = h->meta.fetch_add(ClockHandle::kAcquireIncrement,
+                                 std::memory_order_acquire);
+    // Check if it's an entry visible to lookups
+    if ((old_meta >> ClockHandle::kStateShift) == ClockHandle::kStateVisible) {
+      // Acquired a read reference
+      if (h->hashed_key == hashed_key) {
+        // Match
+        return true;
+      } else {
+        // Mismatch. Pretend we never took the reference
+        old_meta = h->meta.fetch_sub(ClockHandle::kAcquireIncrement,
+                                     std::memory_order_release);
+      }
+    } else if (UNLIKELY((old_meta >> ClockHandle::kStateShift) ==
+                        ClockHandle::kStateInvisible)) {
+      // Pretend we never took the reference
+      // WART: there's a tiny chance we release last ref to invisible
+      // entry here. If that happens, we let eviction take care of it.
+      old_meta = h->meta.fetch_sub(ClockHandle::kAcquireIncrement,
+                                   std::memory_order_release);
+    } else {
+      // For other states, incrementing the acquire counter has no effect
+      // so we don't need to undo it. Furthermore, we cannot safely undo
+      // it because we did not acquire a read reference to lock the
+      // entry in a Shareable state.
+    }
+    (void)old_meta;
+    return false;
+  };
+  auto abort_fn = [&](HandleImpl* h) {
+    return h->displacements.load(std::memory_order_relaxed) == 0;
+  };
+  auto update_fn = [&](HandleImpl* /*h*/) {};
 
+  int length_bits = length_bits_.load(std::memory_order_acquire);
+  size_t probe = 0;
+  HandleImpl* e =
+      FindSlot(hashed_key, length_bits, match_fn, abort_fn, update_fn, probe);
+  // Entries inserted before the table grew are in the probe sequences for
+  // smaller tables
+  while (UNLIKELY(e == nullptr) && length_bits > min_length_bits_) {
+    --length_bits;
+    if (GenerationHasEntries(length_bits)) {
+      probe = 0;
+      e = FindSlot(hashed_key, length_bits, match_fn, abort_fn, update_fn,
+                   probe);
+    }
+  }
   return e;
 }
 
@@ -703,7 +774,7 @@ bool HyperClockTable::Release(HandleImpl* h, bool useful,
       detached_usage_.fetch_sub(total_charge, std::memory_order_relaxed);
       usage_.fetch_sub(total_charge, std::memory_order_relaxed);
     } else {
-      Rollback(h->hashed_key, h);
+      RollbackEntry(h->hashed_key, h, h->length_bits);
       FreeDataMarkEmpty(*h, allocator_);
       ReclaimEntryUsage(total_charge);
     }
@@ -751,74 +822,85 @@ void HyperClockTable::TEST_ReleaseN(HandleImpl* h, size_t n) {
 }
 
 void HyperClockTable::Erase(const UniqueId64x2& hashed_key) {
-  size_t probe = 0;
-  (void)FindSlot(
-      hashed_key,
-      [&](HandleImpl* h) {
-        // Could be multiple entries in rare cases. Erase them all.
-        // Optimistically increment acquire counter
-        uint64_t old_meta = h->meta.fetch_add(ClockHandle::kAcquireIncrement,
-                                              std::memory_order_acquire);
-        // Check if it's an entry visible to lookups
-        if ((old_meta >> ClockHandle::kStateShift) ==
-            ClockHandle::kStateVisible) {
-          // Acquired a read reference
-          if (h->hashed_key == hashed_key) {
-            // Match. Set invisible.
-            old_meta =
-                h->meta.fetch_and(~(uint64_t{ClockHandle::kStateVisibleBit}
-                                    << ClockHandle::kStateShift),
-                                  std::memory_order_acq_rel);
-            // Apply update to local copy
-            old_meta &= ~(uint64_t{ClockHandle::kStateVisibleBit}
-                          << ClockHandle::kStateShift);
-            for (;;) {
-              uint64_t refcount = GetRefcount(old_meta);
-              assert(refcount > 0);
-              if (refcount > 1) {
-                // Not last ref at some point in time during this Erase call
-                // Pretend we never took the reference
-                h->meta.fetch_sub(ClockHandle::kAcquireIncrement,
-                                  std::memory_order_release);
-                break;
-              } else if (h->meta.compare_exchange_weak(
-                             old_meta,
-                             uint64_t{ClockHandle::kStateConstruction}
-                                 << ClockHandle::kStateShift,
-                             std::memory_order_acq_rel)) {
-                // Took ownership
-                assert(hashed_key == h->hashed_key);
-                size_t total_charge = h->GetTotalCharge();
-                FreeDataMarkEmpty(*h, allocator_);
-                ReclaimEntryUsage(total_charge);
-                // We already have a copy of hashed_key in this case, so OK to
-                // delay Rollback until after releasing the entry
-                Rollback(hashed_key, h);
-                break;
-              }
-            }
-          } else {
-            // Mismatch. Pretend we never took the reference
+  auto match_fn = [&](HandleImpl* h) {
+    // Could be multiple entries in rare cases. Erase them all.
+    // Optimistically increment acquire counter
+    uint64_t old_meta = h->meta.fetch_add(ClockHandle::kAcquireIncrement,
+                                          std::memory_order_acquire);
+    // Check if it's an entry visible to lookups
+    if ((old_meta >> ClockHandle::kStateShift) == ClockHandle::kStateVisible) {
+      // Acquired a read reference
+      if (h->hashed_key == hashed_key) {
+        // Match. Set invisible.
+        old_meta =
+            h->meta.fetch_and(~(uint64_t{ClockHandle::kStateVisibleBit}
+                                << ClockHandle::kStateShift),
+                              std::memory_order_acq_rel);
+        // Apply update to local copy
+        old_meta &= ~(uint64_t{ClockHandle::kStateVisibleBit}
+                      << ClockHandle::kStateShift);
+        for (;;) {
+          uint64_t refcount = GetRefcount(old_meta);
+          assert(refcount > 0);
+          if (refcount > 1) {
+            // Not last ref at some point in time during this Erase call
+            // Pretend we never took the reference
             h->meta.fetch_sub(ClockHandle::kAcquireIncrement,
                               std::memory_order_release);
+            break;
+          } else if (h->meta.compare_exchange_weak(
+                         old_meta,
+                         uint64_t{ClockHandle::kStateConstruction}
+                             << ClockHandle::kStateShift,
+                         std::memory_order_acq_rel)) {
+            // Took ownership
+            assert(hashed_key == h->hashed_key);
+            size_t total_charge = h->GetTotalCharge();
+            int entry_length_bits = h->length_bits;
+            FreeDataMarkEmpty(*h, allocator_);
+            ReclaimEntryUsage(total_charge);
+            // We already have a copy of hashed_key in this case, so OK to
+            // delay Rollback until after releasing the entry
+            RollbackEntry(hashed_key, h, entry_length_bits);
+            break;
           }
-        } else if (UNLIKELY((old_meta >> ClockHandle::kStateShift) ==
-                            ClockHandle::kStateInvisible)) {
-          // Pretend we never took the reference
-          // WART: there's a tiny chance we release last ref to invisible
-          // entry here. If that happens, we let eviction take care of it.
-          h->meta.fetch_sub(ClockHandle::kAcquireIncrement,
-                            std::memory_order_release);
-        } else {
-          // For other states, incrementing the acquire counter has no effect
-          // so we don't need to undo it.
         }
-        return false;
-      },
-      [&](HandleImpl* h) {
-        return h->displacements.load(std::memory_order_relaxed) == 0;
-      },
-      [&](HandleImpl* /*h*/) {}, probe);
+      } else {
+        // Mismatch. Pretend we never took the reference
+        h->meta.fetch_sub(ClockHandle::kAcquireIncrement,
+                          std::memory_order_release);
+      }
+    } else if (UNLIKELY((old_meta >> ClockHandle::kStateShift) ==
+                        ClockHandle::kStateInvisible)) {
+      // Pretend we never took the reference
+      // WART: there's a tiny chance we release last ref to invisible
+      // entry here. If that happens, we let eviction take care of it.
+      h->meta.fetch_sub(ClockHandle::kAcquireIncrement,
+                        std::memory_order_release);
+    } else {
+      // For other states, incrementing the acquire counter has no effect
+      // so we don't need to undo it.
+    }
+    return false;
+  };
+  auto abort_fn = [&](HandleImpl* h) {
+    return h->displacements.load(std::memory_order_relaxed) == 0;
+  };
+  auto update_fn = [&](HandleImpl* /*h*/) {};
+
+  // Including the probe sequences for smaller tables, if the table grew
+  int length_bits = length_bits_.load(std::memory_order_acquire);
+  for (;;) {
+    size_t probe = 0;
+    (void)FindSlot(hashed_key, length_bits, match_fn, abort_fn, update_fn,
+                   probe);
+    do {
+      if (length_bits == min_length_bits_) {
+        return;
+      }
+      --length_bits;
+    } while (!GenerationHasEntries(length_bits));
+  }
 }
 
 void HyperClockTable::ConstApplyToEntriesRange(
@@ -863,7 +945,8 @@ void HyperClockTable::ConstApplyToEntriesRange(
 }
 
 void HyperClockTable::EraseUnRefEntries() {
-  for (size_t i = 0; i <= this->length_bits_mask_; i++) {
+  const size_t table_size = GetTableSize();
+  for (size_t i = 0; i < table_size; i++) {
     HandleImpl& h = array_[i];
 
     uint64_t old_meta = h.meta.load(std::memory_order_relaxed);
@@ -876,7 +959,7 @@ void HyperClockTable::EraseUnRefEntries() {
                                        std::memory_order_acquire)) {
       // Took ownership
       size_t total_charge = h.GetTotalCharge();
-      Rollback(h.hashed_key, &h);
+      RollbackEntry(h.hashed_key, &h, h.length_bits);
       FreeDataMarkEmpty(h, allocator_);
       ReclaimEntryUsage(total_charge);
     }
@@ -884,7 +967,8 @@ void HyperClockTable::EraseUnRefEntries() {
 }
 
 inline HyperClockTable::HandleImpl* HyperClockTable::FindSlot(
-    const UniqueId64x2& hashed_key, std::function<bool(HandleImpl*)> match_fn,
+    const UniqueId64x2& hashed_key, int length_bits,
+    std::function<bool(HandleImpl*)> match_fn,
     std::function<bool(HandleImpl*)> abort_fn,
     std::function<void(HandleImpl*)> update_fn, size_t& probe) {
   // NOTE: upper 32 bits of hashed_key[0] is used for sharding
@@ -900,8 +984,9 @@ inline HyperClockTable::HandleImpl* HyperClockTable::FindSlot(
   // TODO: we could also reconsider linear probing, though locality benefits
   // are limited because each slot is a full cache line
   size_t increment = static_cast<size_t>(hashed_key[0]) | 1U;
-  size_t current = ModTableSize(base + probe * increment);
-  while (probe <= length_bits_mask_) {
+  size_t current = ModTableSize(base + probe * increment, length_bits);
+  const size_t length_bits_mask = (size_t{1} << length_bits) - 1;
+  while (probe <= length_bits_mask) {
     HandleImpl* h = &array_[current];
     if (match_fn(h)) {
       probe++;
@@ -912,20 +997,70 @@ inline HyperClockTable::HandleImpl* HyperClockTable::FindSlot(
     }
     probe++;
     update_fn(h);
-    current = ModTableSize(current + increment);
+    current = ModTableSize(current + increment, length_bits);
   }
   // We looped back.
   return nullptr;
 }
 
 inline void HyperClockTable::Rollback(const UniqueId64x2& hashed_key,
-                                      const HandleImpl* h) {
-  size_t current = ModTableSize(hashed_key[1]);
+                                      const HandleImpl* h, int length_bits) {
+  size_t current = ModTableSize(hashed_key[1], length_bits);
   size_t increment = static_cast<size_t>(hashed_key[0]) | 1U;
   while (&array_[current] != h) {
     array_[current].displacements.fetch_sub(1, std::memory_order_relaxed);
-    current = ModTableSize(current + increment);
+    current = ModTableSize(current + increment, length_bits);
+  }
+}
+
+inline void HyperClockTable::RollbackEntry(const UniqueId64x2& hashed_key,
+                                           const HandleImpl* h,
+                                           int length_bits) {
+  Rollback(hashed_key, h, length_bits);
+  RemoveFromGeneration(length_bits);
+}
+
+inline bool HyperClockTable::MaybeGrow(int length_bits, size_t total_charge,
+                                       size_t capacity) {
+  if (length_bits >= max_length_bits_) {
+    return false;
   }
+  const size_t new_metadata_charge =
+      charge_metadata_ ? sizeof(HandleImpl) << length_bits : 0;
+  if (usage_.load(std::memory_order_relaxed) + total_charge +
+          new_metadata_charge >
+      capacity) {
+    // Out of capacity rather than slots, so evict
+    return false;
+  }
+  if (length_bits_.compare_exchange_strong(length_bits, length_bits + 1,
+                                           std::memory_order_acq_rel)) {
+    usage_.fetch_add(new_metadata_charge, std::memory_order_relaxed);
+  }
+  // Otherwise, another thread grew the table
+  return true;
+}
+
+inline void HyperClockTable::AddToGeneration(int length_bits) {
+  if (generation_occupancy_) {
+    generation_occupancy_[length_bits - min_length_bits_].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+}
+
+inline void HyperClockTable::RemoveFromGeneration(int length_bits) {
+  if (generation_occupancy_) {
+    auto old_count =
+        generation_occupancy_[length_bits - min_length_bits_].fetch_sub(
+            1, std::memory_order_relaxed);
+    (void)old_count;
+    assert(old_count > 0);
+  }
+}
+
+inline bool HyperClockTable::GenerationHasEntries(int length_bits) const {
+  return generation_occupancy_[length_bits - min_length_bits_].load(
+             std::memory_order_relaxed) > 0;
 }
 
 inline void HyperClockTable::ReclaimEntryUsage(size_t total_charge) {
@@ -950,6 +1085,7 @@ inline void HyperClockTable::Evict(size_t requested_charge,
   // First (concurrent) increment clock pointer
   uint64_t old_clock_pointer =
       clock_pointer_.fetch_add(step_size, std::memory_order_relaxed);
+  const int length_bits = length_bits_.load(std::memory_order_acquire);
 
   // Cap the eviction effort at this thread (along with those operating in
   // parallel) circling through the whole structure kMaxCountdown times.
@@ -957,14 +1093,20 @@ inline void HyperClockTable::Evict(size_t requested_charge,
   // unreferenced at start of and during the eviction run that isn't reclaimed
   // by a concurrent eviction run.
   uint64_t max_clock_pointer =
-      old_clock_pointer + (ClockHandle::kMaxCountdown << length_bits_);
+      old_clock_pointer + (ClockHandle::kMaxCountdown << length_bits);
 
   for (;;) {
     for (size_t i = 0; i < step_size; i++) {
-      HandleImpl& h = array_[ModTableSize(Lower32of64(old_clock_pointer + i))];
+      HandleImpl& h = array_[ModTableSize(Lower32of64(old_clock_pointer + i),
+                                          length_bits)];
       bool evicting = ClockUpdate(h);
       if (evicting) {
-        Rollback(h.hashed_key, &h);
+        RollbackEntry(h.hashed_key, &h, h.length_bits);
+        if (admission_sketch_ != nullptr) {
+          victim_frequency_.store(
+              admission_sketch_->Estimate(h.hashed_key[0]),
+              std::memory_order_relaxed);
+        }
         *freed_charge += h.GetTotalCharge();
         *freed_count += 1;
         FreeDataMarkEmpty(h, allocator_);
@@ -1209,6 +1351,11 @@ size_t ClockCacheShard<Table>::GetTableAddressCount() const {
   return table_.GetTableSize();
 }
 
+template <class Table>
+size_t ClockCacheShard<Table>::GetMaxTableAddressCount() const {
+  return table_.GetMaxTableSize();
+}
+
 // Explicit instantiation
 template class ClockCacheShard<HyperClockTable>;
 
@@ -1216,11 +1363,10 @@ HyperClockCache::HyperClockCache(
     size_t capacity, size_t estimated_value_size, int num_shard_bits,
     bool strict_capacity_limit,
     CacheMetadataChargePolicy metadata_charge_policy,
-    std::shared_ptr<MemoryAllocator> memory_allocator)
+    std::shared_ptr<MemoryAllocator> memory_allocator,
+    bool frequency_admission)
     : ShardedCache(capacity, num_shard_bits, strict_capacity_limit,
                    std::move(memory_allocator)) {
-  assert(estimated_value_size > 0 ||
-         metadata_charge_policy != kDontChargeCacheMetadata);
   // TODO: should not need to go through two levels of pointer indirection to
   // get to table entries
   size_t per_shard = GetPerShardCapacity();
@@ -1228,6 +1374,7 @@ HyperClockCache::HyperClockCache(
   InitShards([=](Shard* cs) {
     HyperClockTable::Opts opts;
     opts.estimated_value_size = estimated_value_size;
+    opts.frequency_admission = frequency_admission;
     new (cs) Shard(per_shard, strict_capacity_limit, metadata_charge_policy,
                    alloc, opts);
   });
@@ -1255,7 +1402,8 @@ namespace {
 // "at limit", which we define as high actual usage (>80% of capacity)
 // or actual occupancy very close to limit (>95% of limit).
 // Also, for each shard compute the recommended estimated_entry_charge,
-// and keep the minimum one for use as overall recommendation.
+// and keep the minimum one for use as overall recommendation. A growable
+// table is only a problem once it can't grow anymore.
 void AddShardEvaluation(const HyperClockCache::Shard& shard,
                         std::vector<double>& predicted_load_factors,
                         size_t& min_recommendation) {
@@ -1266,7 +1414,8 @@ void AddShardEvaluation(const HyperClockCache::Shard& shard,
   size_t occupancy = shard.GetOccupancyCount();
   size_t occ_limit = shard.GetOccupancyLimit();
   double occ_ratio = 1.0 * occupancy / occ_limit;
-  if (usage == 0 || occupancy == 0 || (usage_ratio < 0.8 && occ_ratio < 0.95)) {
+  if (usage == 0 || occupancy == 0 || (usage_ratio < 0.8 && occ_ratio < 0.95) ||
+      shard.GetTableAddressCount() < shard.GetMaxTableAddressCount()) {
     // Skip as described above
     return;
   }
@@ -1401,7 +1550,8 @@ std::shared_ptr<Cache> HyperClockCacheOptions::MakeSharedCache() const {
   }
   return std::make_shared<clock_cache::HyperClockCache>(
       capacity, estimated_entry_charge, my_num_shard_bits,
-      strict_capacity_limit, metadata_charge_policy, memory_allocator);
+      strict_capacity_limit, metadata_charge_policy, memory_allocator,
+      frequency_admission);
 }
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -17,9 +17,11 @@
 #include <string>
 
 #include "cache/cache_key.h"
+#include "cache/frequency_sketch.h"
 #include "cache/sharded_cache.h"
 #include "port/lang.h"
 #include "port/malloc.h"
+#include "port/mmap.h"
 #include "port/port.h"
 #include "rocksdb/cache.h"
 #include "rocksdb/secondary_cache.h"
@@ -47,9 +49,10 @@ class ClockCacheTest;
 //
 // Costs
 // -----
-// * Hash table is not resizable (for lock-free efficiency) so capacity is not
-// dynamically changeable. Rely on an estimated average value (block) size for
-// space+time efficiency. (See estimated_entry_charge option details.)
+// * Hash table slots never move (for lock-free efficiency), so with an
+// estimated average value (block) size, the table size is fixed and capacity
+// is not dynamically changeable. Without an estimate, the table grows in place
+// (see "Growable table" below), which can add probes to lookups.
 // * Insert usually does not (but might) overwrite a previous entry associated
 // with a cache key. This is OK for RocksDB uses of Cache.
 // * Only supports keys of exactly 16 bytes, which is what RocksDB uses for
@@ -278,7 +281,21 @@ class ClockCacheTest;
 // a best effort to immediately release an Invisible entry that reaches zero
 // refs, but there are some corner cases where it will only be freed by the
 // clock eviction process.
-
+//
+// Growable table
+// --------------
+// With estimated_entry_charge == 0, the slots for the largest table size we
+// might need are reserved up front as lazily zeroed memory, and the table
+// starts small. When an Insert finds the table at its occupancy limit but the
+// shard still has capacity for the entry, it doubles the table size with a
+// single compare-exchange, which extends the array over slots that are
+// already there and empty. Entries don't move, so handles stay valid and
+// nothing has to be locked, but an entry's probe sequence depends on the
+// table size when it was inserted. Each entry therefore remembers that size
+// for rolling back its displacements, and we count the entries inserted at
+// each size, so that Lookup and Erase also probe the sequences of the
+// smaller sizes that still have entries. Those are drained by eviction, so
+// only entries that stay hot from before a resize need the extra probes.
 // ----------------------------------------------------------------------- //
 
 // The load factor p is a real number in (0, 1) such that at all
@@ -304,6 +321,13 @@ constexpr double kLoadFactor = 0.7;
 // strict upper bound on the load factor.
 constexpr double kStrictLoadFactor = 0.84;
 
+// For a table growing as needed (estimated_value_size == 0), the average
+// entry charges assumed for the initial table size and for the largest table
+// size to reserve. Starting small keeps the table from being oversized for
+// large entries, and few resizes are needed for typical block sizes.
+constexpr size_t kGrowableInitialEntryCharge = 8 * 1024;
+constexpr size_t kGrowableMinEntryCharge = 256;
+
 struct ClockHandleBasicData {
   Cache::ObjectPtr value = nullptr;
   const Cache::CacheItemHelper* helper = nullptr;
@@ -400,13 +424,20 @@ class HyperClockTable {
     // regression.
     bool detached = false;
 
+    // The number of hash bits of the table when the entry was inserted, which
+    // determines its probe sequence.
+    uint8_t length_bits = 0;
+
     inline bool IsDetached() const { return detached; }
 
     inline void SetDetached() { detached = true; }
   };  // struct HandleImpl
 
   struct Opts {
+    // 0 for a table that grows as needed
     size_t estimated_value_size;
+    // See ShardedCacheOptions::frequency_admission
+    bool frequency_admission = false;
   };
 
   HyperClockTable(size_t capacity, bool strict_capacity_limit,
@@ -432,15 +463,19 @@ class HyperClockTable {
 
   void EraseUnRefEntries();
 
-  size_t GetTableSize() const { return size_t{1} << length_bits_; }
+  size_t GetTableSize() const { return size_t{1} << GetLengthBits(); }
 
-  int GetLengthBits() const { return length_bits_; }
+  int GetLengthBits() const {
+    return length_bits_.load(std::memory_order_acquire);
+  }
+
+  size_t GetMaxTableSize() const { return size_t{1} << max_length_bits_; }
 
   size_t GetOccupancy() const {
     return occupancy_.load(std::memory_order_relaxed);
   }
 
-  size_t GetOccupancyLimit() const { return occupancy_limit_; }
+  size_t GetOccupancyLimit() const { return OccupancyLimit(GetLengthBits()); }
 
   size_t GetUsage() const { return usage_.load(std::memory_order_relaxed); }
 
@@ -453,11 +488,29 @@ class HyperClockTable {
   void TEST_ReleaseN(HandleImpl* handle, size_t n);
 
  private:  // functions
-  // Returns x mod 2^{length_bits_}.
-  inline size_t ModTableSize(uint64_t x) {
-    return static_cast<size_t>(x) & length_bits_mask_;
+  // Returns x mod 2^{length_bits}.
+  static inline size_t ModTableSize(uint64_t x, int length_bits) {
+    return static_cast<size_t>(x) & ((size_t{1} << length_bits) - 1);
+  }
+
+  static inline size_t OccupancyLimit(int length_bits) {
+    return static_cast<size_t>((uint64_t{1} << length_bits) *
+                               kStrictLoadFactor);
   }
 
+  // For a growable table, tries to double the table size from 2^length_bits
+  // instead of evicting for occupancy, which is only done if the shard has
+  // the capacity for an entry of `total_charge` (and the metadata of the new
+  // slots, if charged). Returns true if the table is now larger, whether or
+  // not another thread grew it.
+  inline bool MaybeGrow(int length_bits, size_t total_charge, size_t capacity);
+
+  // Tracking of the entries inserted with each table size, for growable
+  // tables
+  inline void AddToGeneration(int length_bits);
+  inline void RemoveFromGeneration(int length_bits);
+  inline bool GenerationHasEntries(int length_bits) const;
+
   // Runs the clock eviction algorithm trying to reclaim at least
   // requested_charge. Returns how much is evicted, which could be less
   // if it appears impossible to evict the requested amount without blocking.
@@ -475,15 +528,22 @@ class HyperClockTable {
   // value of probe is one more than the last non-aborting probe during the
   // call. This is so that that the variable can be used to keep track of
   // progress across consecutive calls to FindSlot.
-  inline HandleImpl* FindSlot(const UniqueId64x2& hashed_key,
+  // The probe sequence is the one for a table of 2^length_bits slots.
+  inline HandleImpl* FindSlot(const UniqueId64x2& hashed_key, int length_bits,
                               std::function<bool(HandleImpl*)> match,
                               std::function<bool(HandleImpl*)> stop,
                               std::function<void(HandleImpl*)> update,
                               size_t& probe);
 
-  // Re-decrement all displacements in probe path starting from beginning
-  // until (not including) the given handle
-  inline void Rollback(const UniqueId64x2& hashed_key, const HandleImpl* h);
+  // Re-decrement all displacements in probe path (for 2^length_bits slots)
+  // starting from beginning until (not including) the given handle
+  inline void Rollback(const UniqueId64x2& hashed_key, const HandleImpl* h,
+                       int length_bits);
+
+  // Rollback() for an entry being removed from the table, which also
+  // untracks it from the entries inserted with its table size
+  inline void RollbackEntry(const UniqueId64x2& hashed_key,
+                            const HandleImpl* h, int length_bits);
 
   // Subtracts `total_charge` from `usage_` and 1 from `occupancy_`.
   // Ideally this comes after releasing the entry itself so that we
@@ -527,22 +587,39 @@ class HyperClockTable {
                           CacheMetadataChargePolicy metadata_charge_policy);
 
  private:  // data
+  // Range of the number of hash bits used for table index. These are the
+  // same unless the table grows as needed.
+  const int min_length_bits_;
+  int max_length_bits_;
+
   // Number of hash bits used for table index.
   // The size of the table is 1 << length_bits_.
-  const int length_bits_;
+  std::atomic<int> length_bits_;
 
-  // For faster computation of ModTableSize.
-  const size_t length_bits_mask_;
+  // Whether metadata is charged to usage, including for grown slots
+  const bool charge_metadata_;
 
-  // Maximum number of elements the user can store in the table.
-  const size_t occupancy_limit_;
+  // Backing memory for the slots of a fixed size table, or of a growable
+  // table, which reserves max_length_bits_ but only maps what is touched.
+  std::unique_ptr<HandleImpl[]> fixed_array_;
+  std::unique_ptr<MemMapping> growable_array_;
 
   // Array of slots comprising the hash table.
-  const std::unique_ptr<HandleImpl[]> array_;
+  HandleImpl* array_;
+
+  // For a growable table, the number of entries in the table that were
+  // inserted with each table size, indexed by length_bits - min_length_bits_
+  std::unique_ptr<std::atomic<size_t>[]> generation_occupancy_;
 
   // From Cache, for deleter
   MemoryAllocator* const allocator_;
 
+  // For frequency_admission, the access counts of keys, and the count of the
+  // most recently evicted entry, which inserts that need to evict compare
+  // with
+  std::unique_ptr<FrequencySketch> admission_sketch_;
+  std::atomic<uint32_t> victim_frequency_{};
+
   // We partition the following members into different cache lines
   // to avoid false sharing among Lookup, Release, Erase and Insert
   // operations in ClockCacheShard.
@@ -599,8 +676,8 @@ class ALIGN_AS(CACHE_LINE_SIZE) ClockCacheShard final : public CacheShardBase {
   }
 
   // Although capacity is dynamically changeable, the number of table slots is
-  // not, so growing capacity substantially could lead to hitting occupancy
-  // limit.
+  // not (beyond the size reserved by a growable table), so growing capacity
+  // substantially could lead to hitting occupancy limit.
   void SetCapacity(size_t capacity);
 
   void SetStrictCapacityLimit(bool strict_capacity_limit);
@@ -633,6 +710,9 @@ class ALIGN_AS(CACHE_LINE_SIZE) ClockCacheShard final : public CacheShardBase {
 
   size_t GetTableAddressCount() const;
 
+  // The largest table size a growable table can reach, or the table size
+  size_t GetMaxTableAddressCount() const;
+
   void ApplyToSomeEntries(
       const std::function<void(const Slice& key, Cache::ObjectPtr obj,
                                size_t charge,
@@ -680,7 +760,8 @@ class HyperClockCache
   HyperClockCache(size_t capacity, size_t estimated_value_size,
                   int num_shard_bits, bool strict_capacity_limit,
                   CacheMetadataChargePolicy metadata_charge_policy,
-                  std::shared_ptr<MemoryAllocator> memory_allocator);
+                  std::shared_ptr<MemoryAllocator> memory_allocator,
+                  bool frequency_admission = false);
 
   const char* Name() const override { return "HyperClockCache"; }
 
@@ -6,6 +6,7 @@
 #include "cache/compressed_secondary_cache.h"
 
 #include <algorithm>
+#include <cinttypes>
 #include <cstdint>
 #include <memory>
 
@@ -16,6 +17,39 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+namespace {
+// The ZSTD dictionary trainer wants samples of about 100 times the size of
+// the dictionary
+constexpr size_t kZstdTrainingBytesPerDictByte = 100;
+}  // namespace
+
+CompressedSecondaryCacheResultHandle::~CompressedSecondaryCacheResultHandle() {
+  if (lru_handle_ != nullptr) {
+    // Never waited for
+    cache_->cache_->Release(lru_handle_, erase_on_release_);
+  }
+}
+
+void CompressedSecondaryCacheResultHandle::Wait() {
+  if (lru_handle_ != nullptr) {
+    UncompressionContext uncompression_context(
+        cache_->cache_options_.compression_type);
+    cache_->CompletePending(this, &uncompression_context);
+  }
+}
+
+CompressedSecondaryCache::CompressedSecondaryCache(
+    const CompressedSecondaryCacheOptions& opts)
+    : cache_options_(opts) {
+  cache_ = NewLRUCache(opts.capacity, opts.num_shard_bits,
+                       opts.strict_capacity_limit, opts.high_pri_pool_ratio,
+                       opts.memory_allocator, opts.use_adaptive_mutex,
+                       opts.metadata_charge_policy, opts.low_pri_pool_ratio);
+  for (auto& role_dict : role_dicts_) {
+    role_dict.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
 CompressedSecondaryCache::CompressedSecondaryCache(
     size_t capacity, int num_shard_bits, bool strict_capacity_limit,
     double high_pri_pool_ratio, double low_pri_pool_ratio,
@@ -23,22 +57,22 @@ CompressedSecondaryCache::CompressedSecondaryCache(
     CacheMetadataChargePolicy metadata_charge_policy,
     CompressionType compression_type, uint32_t compress_format_version,
     bool enable_custom_split_merge)
-    : cache_options_(capacity, num_shard_bits, strict_capacity_limit,
-                     high_pri_pool_ratio, low_pri_pool_ratio, memory_allocator,
-                     use_adaptive_mutex, metadata_charge_policy,
-                     compression_type, compress_format_version,
-                     enable_custom_split_merge) {
-  cache_ =
-      NewLRUCache(capacity, num_shard_bits, strict_capacity_limit,
-                  high_pri_pool_ratio, memory_allocator, use_adaptive_mutex,
-                  metadata_charge_policy, low_pri_pool_ratio);
+    : CompressedSecondaryCache(CompressedSecondaryCacheOptions(
+          capacity, num_shard_bits, strict_capacity_limit, high_pri_pool_ratio,
+          low_pri_pool_ratio, memory_allocator, use_adaptive_mutex,
+          metadata_charge_policy, compression_type, compress_format_version,
+          enable_custom_split_merge)) {}
+
+CompressedSecondaryCache::~CompressedSecondaryCache() {
+  cache_.reset();
+  for (auto& role_dict : role_dicts_) {
+    delete role_dict.load(std::memory_order_relaxed);
+  }
 }
 
-CompressedSecondaryCache::~CompressedSecondaryCache() { cache_.reset(); }
-
 std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
     const Slice& key, const Cache::CacheItemHelper* helper,
-    Cache::CreateContext* create_context, bool /*wait*/, bool advise_erase,
+    Cache::CreateContext* create_context, bool wait, bool advise_erase,
     bool& is_in_sec_cache) {
   assert(helper);
   std::unique_ptr<SecondaryCacheResultHandle> handle;
@@ -54,45 +88,29 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
     return nullptr;
   }
 
-  CacheAllocationPtr* ptr{nullptr};
-  CacheAllocationPtr merged_value;
-  size_t handle_value_charge{0};
-  if (cache_options_.enable_custom_split_merge) {
-    CacheValueChunk* value_chunk_ptr =
-        reinterpret_cast<CacheValueChunk*>(handle_value);
-    merged_value = MergeChunksIntoValue(value_chunk_ptr, handle_value_charge);
-    ptr = &merged_value;
-  } else {
-    ptr = reinterpret_cast<CacheAllocationPtr*>(handle_value);
-    handle_value_charge = cache_->GetCharge(lru_handle);
+  if (!wait) {
+    // Leave the decompression to Wait() or WaitAll(), holding on to the
+    // compressed value until then even if a dummy handle replaces it
+    if (advise_erase) {
+      cache_
+          ->Insert(key, /*obj=*/nullptr,
+                   GetHelper(cache_options_.enable_custom_split_merge),
+                   /*charge=*/0)
+          .PermitUncheckedError();
+    } else {
+      is_in_sec_cache = true;
+    }
+    handle.reset(new CompressedSecondaryCacheResultHandle(
+        this, lru_handle, /*erase_on_release=*/advise_erase, helper,
+        create_context));
+    return handle;
   }
-  MemoryAllocator* allocator = cache_options_.memory_allocator.get();
 
-  Status s;
   Cache::ObjectPtr value{nullptr};
   size_t charge{0};
-  if (cache_options_.compression_type == kNoCompression) {
-    s = helper->create_cb(Slice(ptr->get(), handle_value_charge),
-                          create_context, allocator, &value, &charge);
-  } else {
-    UncompressionContext uncompression_context(cache_options_.compression_type);
-    UncompressionInfo uncompression_info(uncompression_context,
-                                         UncompressionDict::GetEmptyDict(),
-                                         cache_options_.compression_type);
-
-    size_t uncompressed_size{0};
-    CacheAllocationPtr uncompressed = UncompressData(
-        uncompression_info, (char*)ptr->get(), handle_value_charge,
-        &uncompressed_size, cache_options_.compress_format_version, allocator);
-
-    if (!uncompressed) {
-      cache_->Release(lru_handle, /*erase_if_last_ref=*/true);
-      return nullptr;
-    }
-    s = helper->create_cb(Slice(uncompressed.get(), uncompressed_size),
-                          create_context, allocator, &value, &charge);
-  }
-
+  UncompressionContext uncompression_context(cache_options_.compression_type);
+  Status s = CreateValue(lru_handle, helper, create_context,
+                         &uncompression_context, &value, &charge);
   if (!s.ok()) {
     cache_->Release(lru_handle, /*erase_if_last_ref=*/true);
     return nullptr;
@@ -114,6 +132,134 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
   return handle;
 }
 
+Status CompressedSecondaryCache::CreateValue(
+    Cache::Handle* lru_handle, const Cache::CacheItemHelper* helper,
+    Cache::CreateContext* create_context,
+    UncompressionContext* uncompression_context, Cache::ObjectPtr* value,
+    size_t* charge) {
+  void* handle_value = cache_->Value(lru_handle);
+  CacheAllocationPtr* ptr{nullptr};
+  CacheAllocationPtr merged_value;
+  size_t handle_value_charge{0};
+  if (cache_options_.enable_custom_split_merge) {
+    CacheValueChunk* value_chunk_ptr =
+        reinterpret_cast<CacheValueChunk*>(handle_value);
+    merged_value = MergeChunksIntoValue(value_chunk_ptr, handle_value_charge);
+    ptr = &merged_value;
+  } else {
+    ptr = reinterpret_cast<CacheAllocationPtr*>(handle_value);
+    handle_value_charge = cache_->GetCharge(lru_handle);
+  }
+  MemoryAllocator* allocator = cache_options_.memory_allocator.get();
+
+  if (cache_options_.compression_type == kNoCompression) {
+    return helper->create_cb(Slice(ptr->get(), handle_value_charge),
+                             create_context, allocator, value, charge);
+  }
+
+  const char* compressed = ptr->get();
+  size_t compressed_size = handle_value_charge;
+  const UncompressionDict* dict = &UncompressionDict::GetEmptyDict();
+  if (UseDicts()) {
+    if (compressed_size == 0) {
+      return Status::Corruption("Missing dictionary byte");
+    }
+    const uint8_t dict_byte = static_cast<uint8_t>(compressed[0]);
+    compressed++;
+    compressed_size--;
+    if (dict_byte > 0) {
+      // Dictionaries are never dropped once built
+      RoleDict* role_dict =
+          dict_byte <= kNumCacheEntryRoles
+              ? role_dicts_[dict_byte - 1].load(std::memory_order_acquire)
+              : nullptr;
+      if (role_dict == nullptr) {
+        return Status::Corruption("Unknown compression dictionary");
+      }
+      dict = &role_dict->uncompression_dict;
+    }
+  }
+  UncompressionInfo uncompression_info(*uncompression_context, *dict,
+                                       cache_options_.compression_type);
+
+  size_t uncompressed_size{0};
+  CacheAllocationPtr uncompressed = UncompressData(
+      uncompression_info, compressed, compressed_size, &uncompressed_size,
+      cache_options_.compress_format_version, allocator);
+
+  if (!uncompressed) {
+    return Status::Corruption("Error uncompressing value.");
+  }
+  return helper->create_cb(Slice(uncompressed.get(), uncompressed_size),
+                           create_context, allocator, value, charge);
+}
+
+void CompressedSecondaryCache::CompletePending(
+    CompressedSecondaryCacheResultHandle* handle,
+    UncompressionContext* uncompression_context) {
+  assert(handle->lru_handle_ != nullptr);
+  Status s = CreateValue(handle->lru_handle_, handle->helper_,
+                         handle->create_context_, uncompression_context,
+                         &handle->value_, &handle->size_);
+  if (!s.ok()) {
+    handle->value_ = nullptr;
+    handle->size_ = 0;
+  }
+  cache_->Release(handle->lru_handle_,
+                  /*erase_if_last_ref=*/!s.ok() || handle->erase_on_release_);
+  handle->lru_handle_ = nullptr;
+}
+
+void CompressedSecondaryCache::WaitAll(
+    std::vector<SecondaryCacheResultHandle*> handles) {
+  UncompressionContext uncompression_context(cache_options_.compression_type);
+  for (SecondaryCacheResultHandle* handle : handles) {
+    auto sec_handle = static_cast<CompressedSecondaryCacheResultHandle*>(handle);
+    if (!sec_handle->IsReady()) {
+      CompletePending(sec_handle, &uncompression_context);
+    }
+  }
+}
+
+void CompressedSecondaryCache::MaybeSampleForDict(CacheEntryRole role,
+                                                  const Slice& value) {
+  const size_t max_dict_bytes = cache_options_.max_dict_bytes;
+  const CompressionType type = cache_options_.compression_type;
+  const bool train = (type == kZSTD || type == kZSTDNotFinalCompression) &&
+                     ZSTD_TrainDictionarySupported();
+  DictSamples& dict_samples = dict_samples_[static_cast<size_t>(role)];
+  std::string samples;
+  std::vector<size_t> sample_lens;
+  {
+    MutexLock l(&dict_samples.mutex);
+    if (dict_samples.done) {
+      return;
+    }
+    dict_samples.samples.append(value.data(), value.size());
+    dict_samples.sample_lens.push_back(value.size());
+    if (dict_samples.samples.size() <
+        max_dict_bytes * (train ? kZstdTrainingBytesPerDictByte : 1)) {
+      return;
+    }
+    dict_samples.done = true;
+    samples.swap(dict_samples.samples);
+    sample_lens.swap(dict_samples.sample_lens);
+  }
+
+  std::string dict;
+  if (train) {
+    dict = ZSTD_TrainDictionary(samples, sample_lens, max_dict_bytes);
+  }
+  if (dict.empty()) {
+    // Use the most recent samples as they are
+    const size_t dict_size = std::min(samples.size(), max_dict_bytes);
+    dict = samples.substr(samples.size() - dict_size);
+  }
+  role_dicts_[static_cast<size_t>(role)].store(
+      new RoleDict(std::move(dict), type, cache_options_.compression_level),
+      std::memory_order_release);
+}
+
 Status CompressedSecondaryCache::Insert(const Slice& key,
                                         Cache::ObjectPtr value,
                                         const Cache::CacheItemHelper* helper) {
@@ -146,10 +292,23 @@ Status CompressedSecondaryCache::Insert(const Slice& key,
   if (cache_options_.compression_type != kNoCompression) {
     PERF_COUNTER_ADD(compressed_sec_cache_uncompressed_bytes, size);
     CompressionOptions compression_opts;
+    compression_opts.level = cache_options_.compression_level;
     CompressionContext compression_context(cache_options_.compression_type);
     uint64_t sample_for_compression{0};
+    const CompressionDict* dict = &CompressionDict::GetEmptyDict();
+    char dict_byte = 0;
+    if (UseDicts()) {
+      const size_t role = static_cast<size_t>(helper->role);
+      RoleDict* role_dict = role_dicts_[role].load(std::memory_order_acquire);
+      if (role_dict != nullptr) {
+        dict = &role_dict->compression_dict;
+        dict_byte = static_cast<char>(role + 1);
+      } else {
+        MaybeSampleForDict(helper->role, val);
+      }
+    }
     CompressionInfo compression_info(
-        compression_opts, compression_context, CompressionDict::GetEmptyDict(),
+        compression_opts, compression_context, *dict,
         cache_options_.compression_type, sample_for_compression);
 
     bool success =
@@ -159,6 +318,9 @@ Status CompressedSecondaryCache::Insert(const Slice& key,
     if (!success) {
       return Status::Corruption("Error compressing value.");
     }
+    if (UseDicts()) {
+      compressed_val.insert(compressed_val.begin(), dict_byte);
+    }
 
     val = Slice(compressed_val);
     size = compressed_val.size();
@@ -209,6 +371,12 @@ std::string CompressedSecondaryCache::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "    compress_format_version : %d\n",
            cache_options_.compress_format_version);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    compression_level : %d\n",
+           cache_options_.compression_level);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    max_dict_bytes : %" PRIu32 "\n",
+           cache_options_.max_dict_bytes);
+  ret.append(buffer);
   return ret;
 }
 
@@ -326,12 +494,7 @@ std::shared_ptr<SecondaryCache> NewCompressedSecondaryCache(
     const CompressedSecondaryCacheOptions& opts) {
   // The secondary_cache is disabled for this LRUCache instance.
   assert(opts.secondary_cache == nullptr);
-  return NewCompressedSecondaryCache(
-      opts.capacity, opts.num_shard_bits, opts.strict_capacity_limit,
-      opts.high_pri_pool_ratio, opts.low_pri_pool_ratio, opts.memory_allocator,
-      opts.use_adaptive_mutex, opts.metadata_charge_policy,
-      opts.compression_type, opts.compress_format_version,
-      opts.enable_custom_split_merge);
+  return std::make_shared<CompressedSecondaryCache>(opts);
 }
 
 }  // namespace ROCKSDB_NAMESPACE
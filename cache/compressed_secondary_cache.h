@@ -6,8 +6,11 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "cache/lru_cache.h"
 #include "memory/memory_allocator.h"
@@ -19,28 +22,52 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+class CompressedSecondaryCache;
+
+// A handle for a lookup in CompressedSecondaryCache. Lookup() with wait =
+// true returns a ready handle. Otherwise, the handle holds a reference to the
+// compressed value, which is only decompressed by Wait(), or along with the
+// other handles passed to CompressedSecondaryCache::WaitAll().
 class CompressedSecondaryCacheResultHandle : public SecondaryCacheResultHandle {
  public:
   CompressedSecondaryCacheResultHandle(Cache::ObjectPtr value, size_t size)
       : value_(value), size_(size) {}
-  ~CompressedSecondaryCacheResultHandle() override = default;
+  CompressedSecondaryCacheResultHandle(CompressedSecondaryCache* cache,
+                                       Cache::Handle* lru_handle,
+                                       bool erase_on_release,
+                                       const Cache::CacheItemHelper* helper,
+                                       Cache::CreateContext* create_context)
+      : cache_(cache),
+        lru_handle_(lru_handle),
+        erase_on_release_(erase_on_release),
+        helper_(helper),
+        create_context_(create_context) {}
+  ~CompressedSecondaryCacheResultHandle() override;
 
   CompressedSecondaryCacheResultHandle(
       const CompressedSecondaryCacheResultHandle&) = delete;
   CompressedSecondaryCacheResultHandle& operator=(
       const CompressedSecondaryCacheResultHandle&) = delete;
 
-  bool IsReady() override { return true; }
+  bool IsReady() override { return lru_handle_ == nullptr; }
 
-  void Wait() override {}
+  void Wait() override;
 
   Cache::ObjectPtr Value() override { return value_; }
 
   size_t Size() override { return size_; }
 
  private:
-  Cache::ObjectPtr value_;
-  size_t size_;
+  friend class CompressedSecondaryCache;
+
+  Cache::ObjectPtr value_ = nullptr;
+  size_t size_ = 0;
+  // Set while the value is not decompressed yet
+  CompressedSecondaryCache* cache_ = nullptr;
+  Cache::Handle* lru_handle_ = nullptr;
+  bool erase_on_release_ = false;
+  const Cache::CacheItemHelper* helper_ = nullptr;
+  Cache::CreateContext* create_context_ = nullptr;
 };
 
 // The CompressedSecondaryCache is a concrete implementation of
@@ -60,6 +87,11 @@ class CompressedSecondaryCacheResultHandle : public SecondaryCacheResultHandle {
 //    CompressedSecondaryCache.
 // 2. If not, we just insert a dummy block (size 0) in CompressedSecondaryCache.
 //
+// With CompressedSecondaryCacheOptions::max_dict_bytes, values are
+// compressed with a dictionary of their CacheEntryRole, built once from the
+// first values of the role inserted. Each compressed value then starts with
+// a byte naming the dictionary it was compressed with, if any.
+//
 // Users can also cast a pointer to CompressedSecondaryCache and call methods on
 // it directly, especially custom methods that may be added
 // in the future.  For example -
@@ -69,6 +101,8 @@ class CompressedSecondaryCacheResultHandle : public SecondaryCacheResultHandle {
 
 class CompressedSecondaryCache : public SecondaryCache {
  public:
+  explicit CompressedSecondaryCache(
+      const CompressedSecondaryCacheOptions& opts);
   CompressedSecondaryCache(
       size_t capacity, int num_shard_bits, bool strict_capacity_limit,
       double high_pri_pool_ratio, double low_pri_pool_ratio,
@@ -88,14 +122,16 @@ class CompressedSecondaryCache : public SecondaryCache {
 
   std::unique_ptr<SecondaryCacheResultHandle> Lookup(
       const Slice& key, const Cache::CacheItemHelper* helper,
-      Cache::CreateContext* create_context, bool /*wait*/, bool advise_erase,
+      Cache::CreateContext* create_context, bool wait, bool advise_erase,
       bool& is_in_sec_cache) override;
 
   bool SupportForceErase() const override { return true; }
 
   void Erase(const Slice& key) override;
 
-  void WaitAll(std::vector<SecondaryCacheResultHandle*> /*handles*/) override {}
+  // Decompresses the values of the pending handles, sharing the
+  // decompression context
+  void WaitAll(std::vector<SecondaryCacheResultHandle*> handles) override;
 
   Status SetCapacity(size_t capacity) override;
 
@@ -105,6 +141,7 @@ class CompressedSecondaryCache : public SecondaryCache {
 
  private:
   friend class CompressedSecondaryCacheTest;
+  friend class CompressedSecondaryCacheResultHandle;
   static constexpr std::array<uint16_t, 8> malloc_bin_sizes_{
       128, 256, 512, 1024, 2048, 4096, 8192, 16384};
 
@@ -132,9 +169,49 @@ class CompressedSecondaryCache : public SecondaryCache {
 
   // TODO: clean up to use cleaner interfaces in typed_cache.h
   const Cache::CacheItemHelper* GetHelper(bool enable_custom_split_merge) const;
+
+  // The dictionary of a CacheEntryRole, immutable once built
+  struct RoleDict {
+    RoleDict(std::string dict, CompressionType type, int level)
+        : compression_dict(dict, type, level),
+          uncompression_dict(std::move(dict),
+                             type == kZSTD || type == kZSTDNotFinalCompression) {
+    }
+    CompressionDict compression_dict;
+    UncompressionDict uncompression_dict;
+  };
+  // Values of a role sampled until its dictionary is built
+  struct DictSamples {
+    port::Mutex mutex;
+    std::string samples;
+    std::vector<size_t> sample_lens;
+    bool done = false;
+  };
+
+  bool UseDicts() const {
+    return cache_options_.max_dict_bytes > 0 &&
+           cache_options_.compression_type != kNoCompression;
+  }
+  // Samples `value` for the dictionary of `role`, building the dictionary
+  // once enough values were sampled
+  void MaybeSampleForDict(CacheEntryRole role, const Slice& value);
+
+  // Creates the object of the value of `lru_handle`, decompressing it with
+  // `uncompression_context`
+  Status CreateValue(Cache::Handle* lru_handle,
+                     const Cache::CacheItemHelper* helper,
+                     Cache::CreateContext* create_context,
+                     UncompressionContext* uncompression_context,
+                     Cache::ObjectPtr* value, size_t* charge);
+  // Decompresses the value of a pending handle and releases its reference
+  void CompletePending(CompressedSecondaryCacheResultHandle* handle,
+                       UncompressionContext* uncompression_context);
+
   std::shared_ptr<Cache> cache_;
   CompressedSecondaryCacheOptions cache_options_;
   mutable port::Mutex capacity_mutex_;
+  std::array<std::atomic<RoleDict*>, kNumCacheEntryRoles> role_dicts_{};
+  std::array<DictSamples, kNumCacheEntryRoles> dict_samples_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
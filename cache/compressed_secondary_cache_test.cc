@@ -908,10 +908,126 @@ TEST_P(CompressedSecondaryCacheTestWithCompressionParam,
   IntegrationFullCapacityTest(sec_cache_is_compressed_);
 }
 
+TEST_P(CompressedSecondaryCacheTestWithCompressionParam, WaitAllTest) {
+  CompressedSecondaryCacheOptions opts;
+  opts.capacity = 1 << 20;
+  opts.num_shard_bits = 0;
+  if (!sec_cache_is_compressed_) {
+    opts.compression_type = CompressionType::kNoCompression;
+  } else if (!LZ4_Supported()) {
+    ROCKSDB_GTEST_SKIP("This test requires LZ4 support.");
+    return;
+  }
+  std::shared_ptr<SecondaryCache> sec_cache = NewCompressedSecondaryCache(opts);
+
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 4; ++i) {
+    values.push_back(rnd.RandomString(1000));
+    TestItem item(values.back().data(), values.back().size());
+    // The first insert only inserts a dummy handle
+    ASSERT_OK(sec_cache->Insert("k" + std::to_string(i), &item, &kHelper));
+    ASSERT_OK(sec_cache->Insert("k" + std::to_string(i), &item, &kHelper));
+  }
+
+  bool is_in_sec_cache{false};
+  std::vector<std::unique_ptr<SecondaryCacheResultHandle>> handles;
+  for (int i = 0; i < 4; ++i) {
+    handles.push_back(sec_cache->Lookup("k" + std::to_string(i), &kHelper,
+                                        this, /*wait=*/false,
+                                        /*advise_erase=*/i % 2 == 0,
+                                        is_in_sec_cache));
+    ASSERT_NE(handles.back(), nullptr);
+    ASSERT_FALSE(handles.back()->IsReady());
+    ASSERT_EQ(is_in_sec_cache, i % 2 != 0);
+  }
+
+  // Wait for one of them on its own, and never wait for the last one
+  handles[0]->Wait();
+  ASSERT_TRUE(handles[0]->IsReady());
+  sec_cache->WaitAll({handles[0].get(), handles[1].get(), handles[2].get()});
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(handles[i]->IsReady());
+    std::unique_ptr<TestItem> val(static_cast<TestItem*>(handles[i]->Value()));
+    ASSERT_NE(val, nullptr);
+    ASSERT_EQ(handles[i]->Size(), values[i].size());
+    ASSERT_EQ(Slice(val->Buf(), val->Size()), values[i]);
+  }
+  handles[3].reset();
+
+  // The values looked up with advise_erase were replaced by dummy handles
+  for (int i = 0; i < 4; ++i) {
+    std::unique_ptr<SecondaryCacheResultHandle> handle =
+        sec_cache->Lookup("k" + std::to_string(i), &kHelper, this,
+                          /*wait=*/true, /*advise_erase=*/false,
+                          is_in_sec_cache);
+    ASSERT_EQ(handle != nullptr, i % 2 != 0);
+    if (handle != nullptr) {
+      delete static_cast<TestItem*>(handle->Value());
+    }
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(CompressedSecCacheTests,
                         CompressedSecondaryCacheTestWithCompressionParam,
                         testing::Bool());
 
+class CompressedSecCacheTestWithDictParam
+    : public CompressedSecondaryCacheTest,
+      public ::testing::WithParamInterface<std::tuple<CompressionType, bool>> {
+};
+
+TEST_P(CompressedSecCacheTestWithDictParam, DictionaryTest) {
+  CompressedSecondaryCacheOptions opts;
+  opts.capacity = 4 << 20;
+  opts.num_shard_bits = 0;
+  opts.compression_type = std::get<0>(GetParam());
+  opts.enable_custom_split_merge = std::get<1>(GetParam());
+  opts.max_dict_bytes = 1024;
+  if (!CompressionTypeSupported(opts.compression_type)) {
+    ROCKSDB_GTEST_SKIP("This test requires compression support.");
+    return;
+  }
+  std::shared_ptr<SecondaryCache> sec_cache = NewCompressedSecondaryCache(opts);
+
+  // The values share most of their content, which only a dictionary helps
+  // compressing
+  Random rnd(301);
+  const std::string common = rnd.RandomString(800);
+  std::vector<std::string> values;
+  std::vector<uint64_t> compressed_sizes;
+  for (int i = 0; i < 300; ++i) {
+    values.push_back(common + rnd.RandomString(200));
+    TestItem item(values.back().data(), values.back().size());
+    ASSERT_OK(sec_cache->Insert("k" + std::to_string(i), &item, &kHelper));
+    get_perf_context()->Reset();
+    ASSERT_OK(sec_cache->Insert("k" + std::to_string(i), &item, &kHelper));
+    compressed_sizes.push_back(
+        get_perf_context()->compressed_sec_cache_compressed_bytes);
+  }
+  ASSERT_GT(compressed_sizes.front(), values.front().size());
+  ASSERT_LT(compressed_sizes.back(), values.back().size() / 2);
+
+  // Values compressed with and without the dictionary read back fine
+  bool is_in_sec_cache{false};
+  for (size_t i = 0; i < values.size(); ++i) {
+    std::unique_ptr<SecondaryCacheResultHandle> handle =
+        sec_cache->Lookup("k" + std::to_string(i), &kHelper, this,
+                          /*wait=*/i % 2 == 0, /*advise_erase=*/true,
+                          is_in_sec_cache);
+    ASSERT_NE(handle, nullptr);
+    handle->Wait();
+    std::unique_ptr<TestItem> val(static_cast<TestItem*>(handle->Value()));
+    ASSERT_NE(val, nullptr);
+    ASSERT_EQ(Slice(val->Buf(), val->Size()), values[i]);
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(
+    CompressedSecCacheTests, CompressedSecCacheTestWithDictParam,
+    ::testing::Combine(::testing::Values(kLZ4Compression, kZSTD),
+                       testing::Bool()));
+
 class CompressedSecCacheTestWithCompressAndSplitParam
     : public CompressedSecondaryCacheTest,
       public ::testing::WithParamInterface<std::tuple<bool, bool>> {
@@ -0,0 +1,389 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/file_secondary_cache.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+
+#include "util/coding.h"
+#include "util/crc32c.h"
+#include "util/hash.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// A record is the masked CRC32C of the rest of the record, the varint32 size
+// of the key, the key and the block.
+constexpr size_t kChecksumSize = sizeof(uint32_t);
+
+const char* kFileSuffix = ".sec";
+
+// Returns the block in `record` after verifying the record is that of `key`
+bool ParseRecord(const Slice& key, Slice record, Slice* block) {
+  if (record.size() < kChecksumSize) {
+    return false;
+  }
+  const uint32_t expected = crc32c::Unmask(DecodeFixed32(record.data()));
+  record.remove_prefix(kChecksumSize);
+  if (crc32c::Value(record.data(), record.size()) != expected) {
+    return false;
+  }
+  Slice record_key;
+  if (!GetLengthPrefixedSlice(&record, &record_key) || record_key != key) {
+    return false;
+  }
+  *block = record;
+  return true;
+}
+}  // namespace
+
+bool FileSecondaryCacheResultHandle::IsReady() {
+  MutexLock l(&state_->mutex);
+  return state_->done;
+}
+
+void FileSecondaryCacheResultHandle::Wait() {
+  MutexLock l(&state_->mutex);
+  while (!state_->done) {
+    state_->cv.Wait();
+  }
+}
+
+Cache::ObjectPtr FileSecondaryCacheResultHandle::Value() {
+  if (!created_) {
+    created_ = true;
+    Wait();
+    Slice block;
+    if (state_->io_status.ok() &&
+        ParseRecord(key_, Slice(state_->buf.get(), state_->size), &block)) {
+      Status s = helper_->create_cb(block, create_context_,
+                                    /*allocator=*/nullptr, &value_, &charge_);
+      if (!s.ok()) {
+        value_ = nullptr;
+        charge_ = 0;
+      }
+    }
+    state_->buf.reset();
+  }
+  return value_;
+}
+
+size_t FileSecondaryCacheResultHandle::Size() {
+  Value();
+  return charge_;
+}
+
+FileSecondaryCache::FileSecondaryCache(const FileSecondaryCacheOptions& opts)
+    : opts_(opts),
+      fs_(opts.file_system != nullptr ? opts.file_system
+                                      : FileSystem::Default()),
+      file_size_(std::max(uint64_t{1},
+                          std::min(opts.file_size, opts.capacity / 4))),
+      capacity_(opts.capacity),
+      // Assuming blocks of a few KB
+      sketch_(static_cast<size_t>(opts.capacity / 4096)) {
+  if (opts.num_read_threads > 0) {
+    read_pool_.reset(NewThreadPool(opts.num_read_threads));
+  }
+}
+
+FileSecondaryCache::~FileSecondaryCache() {
+  if (read_pool_) {
+    read_pool_->WaitForJobsAndJoinAllThreads();
+  }
+  if (writer_) {
+    writer_->Close(IOOptions(), nullptr).PermitUncheckedError();
+  }
+  // Without the index, the files are of no use to anyone
+  for (const auto& file : files_) {
+    fs_->DeleteFile(FileName(file.first), IOOptions(), nullptr)
+        .PermitUncheckedError();
+  }
+}
+
+std::string FileSecondaryCache::FileName(uint64_t number) const {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "/%06" PRIu64 "%s", number, kFileSuffix);
+  return opts_.path + buf;
+}
+
+Status FileSecondaryCache::Open() {
+  if (opts_.path.empty()) {
+    return Status::InvalidArgument("FileSecondaryCache needs a path");
+  }
+  IOStatus s = fs_->CreateDirIfMissing(opts_.path, IOOptions(), nullptr);
+  std::vector<std::string> children;
+  if (s.ok()) {
+    s = fs_->GetChildren(opts_.path, IOOptions(), &children, nullptr);
+  }
+  if (!s.ok()) {
+    return s;
+  }
+  const size_t suffix_len = strlen(kFileSuffix);
+  for (const std::string& child : children) {
+    if (child.size() > suffix_len &&
+        child.compare(child.size() - suffix_len, suffix_len, kFileSuffix) ==
+            0) {
+      s = fs_->DeleteFile(opts_.path + "/" + child, IOOptions(), nullptr);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+  }
+  MutexLock l(&mutex_);
+  return StartNewFile();
+}
+
+IOStatus FileSecondaryCache::FlushBuffer() {
+  mutex_.AssertHeld();
+  assert(writer_);
+  IOStatus s = writer_->Append(buffer_, IOOptions(), nullptr);
+  if (s.ok()) {
+    s = writer_->Flush(IOOptions(), nullptr);
+  }
+  // Blocks that did not make it to the file fail their checksum on lookup
+  buffer_offset_ += buffer_.size();
+  buffer_.clear();
+  return s;
+}
+
+IOStatus FileSecondaryCache::StartNewFile() {
+  mutex_.AssertHeld();
+  if (writer_) {
+    if (!buffer_.empty()) {
+      FlushBuffer().PermitUncheckedError();
+    }
+    writer_->Close(IOOptions(), nullptr).PermitUncheckedError();
+    writer_.reset();
+  }
+  const uint64_t number = next_file_number_++;
+  const std::string fname = FileName(number);
+  FileOptions file_opts;
+  std::unique_ptr<FSRandomAccessFile> reader;
+  IOStatus s = fs_->NewWritableFile(fname, file_opts, &writer_, nullptr);
+  if (s.ok()) {
+    s = fs_->NewRandomAccessFile(fname, file_opts, &reader, nullptr);
+  }
+  if (!s.ok()) {
+    writer_.reset();
+    fs_->DeleteFile(fname, IOOptions(), nullptr).PermitUncheckedError();
+    return s;
+  }
+  auto file = std::make_shared<File>();
+  file->number = number;
+  file->reader = std::move(reader);
+  files_.emplace(number, std::move(file));
+  buffer_offset_ = 0;
+  return s;
+}
+
+void FileSecondaryCache::DropOldFilesAbove(uint64_t capacity) {
+  mutex_.AssertHeld();
+  // Never drop the file being written to
+  while (total_size_ > capacity && files_.size() > 1) {
+    auto oldest = files_.begin();
+    const File& file = *oldest->second;
+    for (const std::string& key : file.keys) {
+      auto it = index_.find(key);
+      if (it != index_.end() && it->second.file_number == file.number) {
+        index_.erase(it);
+      }
+    }
+    total_size_ -= file.size;
+    // Lookups reading from the file keep it open
+    fs_->DeleteFile(FileName(file.number), IOOptions(), nullptr)
+        .PermitUncheckedError();
+    files_.erase(oldest);
+  }
+}
+
+Status FileSecondaryCache::Insert(const Slice& key, Cache::ObjectPtr value,
+                                  const Cache::CacheItemHelper* helper) {
+  if (value == nullptr) {
+    return Status::InvalidArgument();
+  }
+  std::string key_str = key.ToString();
+  {
+    MutexLock l(&mutex_);
+    if (index_.find(key_str) != index_.end()) {
+      // Lookup hits leave blocks in the files, so they often come back
+      return Status::OK();
+    }
+    if (opts_.admission_min_frequency > 1 &&
+        sketch_.Estimate(GetSliceNPHash64(key)) <
+            opts_.admission_min_frequency) {
+      return Status::OK();
+    }
+  }
+
+  const size_t size = (*helper->size_cb)(value);
+  std::string record(kChecksumSize, '\0');
+  PutLengthPrefixedSlice(&record, key);
+  const size_t block_offset = record.size();
+  record.resize(block_offset + size);
+  Status s = (*helper->saveto_cb)(value, 0, size, &record[block_offset]);
+  if (!s.ok()) {
+    return s;
+  }
+  EncodeFixed32(&record[0],
+                crc32c::Mask(crc32c::Value(record.data() + kChecksumSize,
+                                           record.size() - kChecksumSize)));
+  if (record.size() > file_size_) {
+    return Status::OK();
+  }
+
+  MutexLock l(&mutex_);
+  if (index_.find(key_str) != index_.end()) {
+    return Status::OK();
+  }
+  IOStatus io_s;
+  if (!writer_ || files_.rbegin()->second->size + record.size() > file_size_) {
+    io_s = StartNewFile();
+    if (!io_s.ok()) {
+      return io_s;
+    }
+  }
+  File& file = *files_.rbegin()->second;
+  index_.emplace(key_str, Location{file.number, file.size, record.size()});
+  file.keys.emplace_back(std::move(key_str));
+  file.size += record.size();
+  total_size_ += record.size();
+  buffer_.append(record);
+  if (buffer_.size() >= opts_.write_buffer_size) {
+    io_s = FlushBuffer();
+    if (!io_s.ok()) {
+      // Later blocks would land at the wrong offsets in this file
+      StartNewFile().PermitUncheckedError();
+    }
+  }
+  DropOldFilesAbove(capacity_);
+  return io_s;
+}
+
+std::unique_ptr<SecondaryCacheResultHandle> FileSecondaryCache::Lookup(
+    const Slice& key, const Cache::CacheItemHelper* helper,
+    Cache::CreateContext* create_context, bool wait, bool /*advise_erase*/,
+    bool& is_in_sec_cache) {
+  assert(helper);
+  is_in_sec_cache = false;
+  std::string key_str = key.ToString();
+  auto state = std::make_shared<FileSecondaryCacheResultHandle::ReadState>();
+  std::shared_ptr<FSRandomAccessFile> reader;
+  Location loc;
+  {
+    MutexLock l(&mutex_);
+    auto it = index_.find(key_str);
+    if (it == index_.end()) {
+      sketch_.Increment(GetSliceNPHash64(key));
+      return nullptr;
+    }
+    loc = it->second;
+    if (writer_ && loc.file_number == files_.rbegin()->first &&
+        loc.offset >= buffer_offset_) {
+      state->buf.reset(new char[loc.size]);
+      memcpy(state->buf.get(), buffer_.data() + (loc.offset - buffer_offset_),
+             loc.size);
+      state->size = loc.size;
+      state->done = true;
+    } else {
+      reader = files_[loc.file_number]->reader;
+    }
+  }
+  is_in_sec_cache = true;
+
+  if (!state->done) {
+    auto read = [state, reader, loc]() {
+      std::unique_ptr<char[]> buf(new char[loc.size]);
+      Slice result;
+      IOStatus s = reader->Read(loc.offset, loc.size, IOOptions(), &result,
+                                buf.get(), nullptr);
+      if (s.ok() && result.size() != loc.size) {
+        s = IOStatus::Corruption("Truncated secondary cache file");
+      } else if (s.ok() && result.data() != buf.get()) {
+        memcpy(buf.get(), result.data(), loc.size);
+      }
+      MutexLock l(&state->mutex);
+      state->buf = std::move(buf);
+      state->size = loc.size;
+      state->io_status = s;
+      state->done = true;
+      state->cv.SignalAll();
+    };
+    if (wait || !read_pool_) {
+      read();
+    } else {
+      read_pool_->SubmitJob(std::move(read));
+    }
+  }
+  return std::unique_ptr<SecondaryCacheResultHandle>(
+      new FileSecondaryCacheResultHandle(std::move(key_str), helper,
+                                         create_context, std::move(state)));
+}
+
+void FileSecondaryCache::Erase(const Slice& key) {
+  MutexLock l(&mutex_);
+  index_.erase(key.ToString());
+}
+
+void FileSecondaryCache::WaitAll(
+    std::vector<SecondaryCacheResultHandle*> handles) {
+  for (SecondaryCacheResultHandle* handle : handles) {
+    handle->Wait();
+  }
+}
+
+Status FileSecondaryCache::SetCapacity(size_t capacity) {
+  MutexLock l(&mutex_);
+  capacity_ = capacity;
+  DropOldFilesAbove(capacity_);
+  return Status::OK();
+}
+
+Status FileSecondaryCache::GetCapacity(size_t& capacity) {
+  MutexLock l(&mutex_);
+  capacity = static_cast<size_t>(capacity_);
+  return Status::OK();
+}
+
+std::string FileSecondaryCache::GetPrintableOptions() const {
+  std::string ret;
+  ret.reserve(20000);
+  const int kBufferSize{200};
+  char buffer[kBufferSize];
+  snprintf(buffer, kBufferSize, "    path : %s\n", opts_.path.c_str());
+  ret.append(buffer);
+  {
+    MutexLock l(&mutex_);
+    snprintf(buffer, kBufferSize, "    capacity : %" PRIu64 "\n", capacity_);
+  }
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    file_size : %" PRIu64 "\n", file_size_);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    write_buffer_size : %" ROCKSDB_PRIszt "\n",
+           opts_.write_buffer_size);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    admission_min_frequency : %u\n",
+           opts_.admission_min_frequency);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    num_read_threads : %d\n",
+           opts_.num_read_threads);
+  ret.append(buffer);
+  return ret;
+}
+
+Status NewFileSecondaryCache(const FileSecondaryCacheOptions& opts,
+                             std::shared_ptr<SecondaryCache>* cache) {
+  auto file_cache = std::make_shared<FileSecondaryCache>(opts);
+  Status s = file_cache->Open();
+  if (s.ok()) {
+    *cache = std::move(file_cache);
+  }
+  return s;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,157 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cache/frequency_sketch.h"
+#include "port/port.h"
+#include "rocksdb/file_system.h"
+#include "rocksdb/secondary_cache.h"
+#include "rocksdb/threadpool.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A handle for a lookup in FileSecondaryCache. The block is read into a
+// buffer, possibly on a background thread, and the object is only created
+// from it by the first call to Value(), on the thread waiting for the
+// handle.
+class FileSecondaryCacheResultHandle : public SecondaryCacheResultHandle {
+ public:
+  // The state shared with the background read
+  struct ReadState {
+    port::Mutex mutex;
+    port::CondVar cv{&mutex};
+    bool done = false;
+    std::unique_ptr<char[]> buf;
+    size_t size = 0;
+    IOStatus io_status;
+  };
+
+  FileSecondaryCacheResultHandle(std::string&& key,
+                                 const Cache::CacheItemHelper* helper,
+                                 Cache::CreateContext* create_context,
+                                 std::shared_ptr<ReadState>&& state)
+      : key_(std::move(key)),
+        helper_(helper),
+        create_context_(create_context),
+        state_(std::move(state)) {}
+  ~FileSecondaryCacheResultHandle() override = default;
+
+  FileSecondaryCacheResultHandle(const FileSecondaryCacheResultHandle&) =
+      delete;
+  FileSecondaryCacheResultHandle& operator=(
+      const FileSecondaryCacheResultHandle&) = delete;
+
+  bool IsReady() override;
+
+  void Wait() override;
+
+  Cache::ObjectPtr Value() override;
+
+  size_t Size() override;
+
+ private:
+  const std::string key_;
+  const Cache::CacheItemHelper* const helper_;
+  Cache::CreateContext* const create_context_;
+  std::shared_ptr<ReadState> state_;
+  bool created_ = false;
+  Cache::ObjectPtr value_ = nullptr;
+  size_t charge_ = 0;
+};
+
+// The FileSecondaryCache is a SecondaryCache that appends the blocks
+// inserted into it, in records checksummed with CRC32C, to fixed-size files
+// in a directory, and keeps the location of each block in an in-memory
+// index. When the files exceed the capacity, the oldest one is deleted
+// along with the index entries of its blocks, so space is reclaimed without
+// rewriting anything, FIFO across files.
+//
+// Blocks are only written once they pass a frequency-based admission check
+// (see FileSecondaryCacheOptions::admission_min_frequency). A lookup hit
+// leaves the block in the files, so that the block can be dropped again
+// from the primary cache without writing it again.
+//
+// Lookups read from the files outside of the mutex, on a background thread
+// for Lookup() with wait = false.
+class FileSecondaryCache : public SecondaryCache {
+ public:
+  explicit FileSecondaryCache(const FileSecondaryCacheOptions& opts);
+  ~FileSecondaryCache() override;
+
+  // Sets up the cache directory. Must be called before any other method.
+  Status Open();
+
+  const char* Name() const override { return "FileSecondaryCache"; }
+
+  Status Insert(const Slice& key, Cache::ObjectPtr value,
+                const Cache::CacheItemHelper* helper) override;
+
+  std::unique_ptr<SecondaryCacheResultHandle> Lookup(
+      const Slice& key, const Cache::CacheItemHelper* helper,
+      Cache::CreateContext* create_context, bool wait, bool advise_erase,
+      bool& is_in_sec_cache) override;
+
+  bool SupportForceErase() const override { return false; }
+
+  void Erase(const Slice& key) override;
+
+  void WaitAll(std::vector<SecondaryCacheResultHandle*> handles) override;
+
+  Status SetCapacity(size_t capacity) override;
+
+  Status GetCapacity(size_t& capacity) override;
+
+  std::string GetPrintableOptions() const override;
+
+ private:
+  struct File {
+    uint64_t number;
+    std::shared_ptr<FSRandomAccessFile> reader;
+    // Bytes written to the file, plus buffered bytes for the current file
+    uint64_t size = 0;
+    // Keys of the blocks in the file, for dropping them with it
+    std::vector<std::string> keys;
+  };
+
+  struct Location {
+    uint64_t file_number;
+    uint64_t offset;
+    size_t size;
+  };
+
+  std::string FileName(uint64_t number) const;
+
+  // REQUIRES: mutex_ is held
+  IOStatus FlushBuffer();
+  IOStatus StartNewFile();
+  void DropOldFilesAbove(uint64_t capacity);
+
+  const FileSecondaryCacheOptions opts_;
+  const std::shared_ptr<FileSystem> fs_;
+  const uint64_t file_size_;
+  std::unique_ptr<ThreadPool> read_pool_;
+
+  mutable port::Mutex mutex_;
+  uint64_t capacity_;
+  uint64_t total_size_ = 0;
+  FrequencySketch sketch_;
+  std::unordered_map<std::string, Location> index_;
+  // Oldest first. The last one is being written to.
+  std::map<uint64_t, std::shared_ptr<File>> files_;
+  uint64_t next_file_number_ = 1;
+  std::unique_ptr<FSWritableFile> writer_;
+  std::string buffer_;
+  // File offset of buffer_
+  uint64_t buffer_offset_ = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
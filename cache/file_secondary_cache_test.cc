@@ -0,0 +1,314 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/file_secondary_cache.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "file/file_util.h"
+#include "rocksdb/convenience.h"
+#include "rocksdb/env.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class FileSecondaryCacheTest : public testing::Test,
+                               public Cache::CreateContext {
+ public:
+  FileSecondaryCacheTest()
+      : env_(Env::Default()),
+        path_(test::PerThreadDBPath(env_, "file_secondary_cache_test")) {}
+
+  ~FileSecondaryCacheTest() override {
+    EXPECT_OK(DestroyDir(env_, path_));
+  }
+
+ protected:
+  class TestItem {
+   public:
+    TestItem(const char* buf, size_t size) : buf_(buf, size) {}
+
+    const std::string& Buf() const { return buf_; }
+
+   private:
+    std::string buf_;
+  };
+
+  static size_t SizeCallback(Cache::ObjectPtr obj) {
+    return static_cast<TestItem*>(obj)->Buf().size();
+  }
+
+  static Status SaveToCallback(Cache::ObjectPtr from_obj, size_t from_offset,
+                               size_t length, char* out) {
+    const std::string& buf = static_cast<TestItem*>(from_obj)->Buf();
+    EXPECT_EQ(from_offset, size_t{0});
+    EXPECT_EQ(length, buf.size());
+    memcpy(out, buf.data(), length);
+    return Status::OK();
+  }
+
+  static void DeletionCallback(Cache::ObjectPtr obj,
+                               MemoryAllocator* /*alloc*/) {
+    delete static_cast<TestItem*>(obj);
+  }
+
+  static Status CreateCallback(const Slice& data,
+                               Cache::CreateContext* /*context*/,
+                               MemoryAllocator* /*allocator*/,
+                               Cache::ObjectPtr* out_obj, size_t* out_charge) {
+    *out_obj = new TestItem(data.data(), data.size());
+    *out_charge = data.size();
+    return Status::OK();
+  }
+
+  static constexpr Cache::CacheItemHelper kHelper{
+      CacheEntryRole::kMisc, &DeletionCallback, &SizeCallback, &SaveToCallback,
+      &CreateCallback};
+
+  FileSecondaryCacheOptions Options() const {
+    FileSecondaryCacheOptions opts;
+    opts.path = path_;
+    opts.capacity = 1 << 20;
+    opts.file_size = 64 << 10;
+    opts.write_buffer_size = 4 << 10;
+    return opts;
+  }
+
+  std::shared_ptr<SecondaryCache> NewCache(
+      const FileSecondaryCacheOptions& opts) {
+    std::shared_ptr<SecondaryCache> sec_cache;
+    EXPECT_OK(NewFileSecondaryCache(opts, &sec_cache));
+    return sec_cache;
+  }
+
+  // Returns the value found for `key`, or "NOT_FOUND"
+  std::string Lookup(SecondaryCache* sec_cache, const std::string& key,
+                     bool wait = true) {
+    bool is_in_sec_cache = false;
+    std::unique_ptr<SecondaryCacheResultHandle> handle = sec_cache->Lookup(
+        key, &kHelper, this, wait, /*advise_erase=*/true, is_in_sec_cache);
+    if (handle == nullptr) {
+      EXPECT_FALSE(is_in_sec_cache);
+      return "NOT_FOUND";
+    }
+    EXPECT_TRUE(is_in_sec_cache);
+    if (wait) {
+      EXPECT_TRUE(handle->IsReady());
+    }
+    sec_cache->WaitAll({handle.get()});
+    EXPECT_TRUE(handle->IsReady());
+    std::unique_ptr<TestItem> item(static_cast<TestItem*>(handle->Value()));
+    if (item == nullptr) {
+      return "CORRUPT";
+    }
+    EXPECT_EQ(item->Buf().size(), handle->Size());
+    return item->Buf();
+  }
+
+  size_t CountCacheFiles() {
+    std::vector<std::string> children;
+    EXPECT_OK(env_->GetChildren(path_, &children));
+    size_t count = 0;
+    for (const auto& child : children) {
+      if (child.find(".sec") != std::string::npos) {
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  Env* env_;
+  std::string path_;
+};
+
+TEST_F(FileSecondaryCacheTest, Admission) {
+  std::shared_ptr<SecondaryCache> sec_cache = NewCache(Options());
+  Random rnd(301);
+  TestItem item1(rnd.RandomString(1000).c_str(), 1000);
+
+  // Not admitted without any lookup miss, nor after one
+  ASSERT_OK(sec_cache->Insert("k1", &item1, &kHelper));
+  ASSERT_EQ("NOT_FOUND", Lookup(sec_cache.get(), "k1"));
+  ASSERT_OK(sec_cache->Insert("k1", &item1, &kHelper));
+  ASSERT_EQ("NOT_FOUND", Lookup(sec_cache.get(), "k1"));
+  // Admitted after the second miss
+  ASSERT_OK(sec_cache->Insert("k1", &item1, &kHelper));
+  ASSERT_EQ(item1.Buf(), Lookup(sec_cache.get(), "k1"));
+  // Hits leave the block in the cache
+  ASSERT_EQ(item1.Buf(), Lookup(sec_cache.get(), "k1"));
+
+  sec_cache->Erase("k1");
+  ASSERT_EQ("NOT_FOUND", Lookup(sec_cache.get(), "k1"));
+
+  sec_cache.reset();
+  ASSERT_EQ(CountCacheFiles(), size_t{0});
+  FileSecondaryCacheOptions opts = Options();
+  opts.admission_min_frequency = 0;
+  sec_cache = NewCache(opts);
+  ASSERT_EQ(CountCacheFiles(), size_t{1});
+  ASSERT_OK(sec_cache->Insert("k1", &item1, &kHelper));
+  ASSERT_EQ(item1.Buf(), Lookup(sec_cache.get(), "k1"));
+}
+
+TEST_F(FileSecondaryCacheTest, AsyncLookup) {
+  FileSecondaryCacheOptions opts = Options();
+  opts.admission_min_frequency = 0;
+  for (int num_read_threads : {0, 1, 4}) {
+    opts.num_read_threads = num_read_threads;
+    std::shared_ptr<SecondaryCache> sec_cache = NewCache(opts);
+    Random rnd(301);
+    std::vector<std::string> values;
+    for (int i = 0; i < 100; ++i) {
+      values.push_back(rnd.RandomString(static_cast<int>(rnd.Uniform(2000))));
+      TestItem item(values.back().data(), values.back().size());
+      ASSERT_OK(sec_cache->Insert(std::to_string(i), &item, &kHelper));
+    }
+
+    // Some blocks are in files, some in the write buffer
+    std::vector<std::unique_ptr<SecondaryCacheResultHandle>> handles;
+    for (int i = 0; i < 100; ++i) {
+      bool is_in_sec_cache = false;
+      handles.push_back(sec_cache->Lookup(std::to_string(i), &kHelper, this,
+                                          /*wait=*/false,
+                                          /*advise_erase=*/true,
+                                          is_in_sec_cache));
+      ASSERT_NE(handles.back(), nullptr);
+      ASSERT_TRUE(is_in_sec_cache);
+    }
+    std::vector<SecondaryCacheResultHandle*> to_wait;
+    for (auto& handle : handles) {
+      to_wait.push_back(handle.get());
+    }
+    sec_cache->WaitAll(to_wait);
+    for (int i = 0; i < 100; ++i) {
+      ASSERT_TRUE(handles[i]->IsReady());
+      std::unique_ptr<TestItem> item(
+          static_cast<TestItem*>(handles[i]->Value()));
+      ASSERT_NE(item, nullptr);
+      ASSERT_EQ(values[i], item->Buf());
+      ASSERT_EQ(values[i].size(), handles[i]->Size());
+    }
+
+    // A handle can be dropped before its read finishes
+    bool is_in_sec_cache = false;
+    sec_cache->Lookup("0", &kHelper, this, /*wait=*/false,
+                      /*advise_erase=*/true, is_in_sec_cache);
+  }
+}
+
+TEST_F(FileSecondaryCacheTest, Capacity) {
+  FileSecondaryCacheOptions opts = Options();
+  opts.admission_min_frequency = 0;
+  std::shared_ptr<SecondaryCache> sec_cache = NewCache(opts);
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 2000; ++i) {
+    values.push_back(rnd.RandomString(1000));
+    TestItem item(values.back().data(), values.back().size());
+    ASSERT_OK(sec_cache->Insert(std::to_string(i), &item, &kHelper));
+  }
+  // The oldest files were dropped, and the newest kept
+  ASSERT_LE(CountCacheFiles(), opts.capacity / opts.file_size + 1);
+  ASSERT_EQ("NOT_FOUND", Lookup(sec_cache.get(), "0"));
+  for (int i = 1500; i < 2000; ++i) {
+    ASSERT_EQ(values[i], Lookup(sec_cache.get(), std::to_string(i)));
+  }
+
+  size_t capacity = 0;
+  ASSERT_OK(sec_cache->SetCapacity(opts.capacity / 4));
+  ASSERT_OK(sec_cache->GetCapacity(capacity));
+  ASSERT_EQ(capacity, opts.capacity / 4);
+  ASSERT_LE(CountCacheFiles(), opts.capacity / 4 / opts.file_size + 1);
+  ASSERT_EQ("NOT_FOUND", Lookup(sec_cache.get(), "1500"));
+  ASSERT_EQ(values[1999], Lookup(sec_cache.get(), "1999"));
+
+  sec_cache.reset();
+  ASSERT_EQ(CountCacheFiles(), size_t{0});
+}
+
+TEST_F(FileSecondaryCacheTest, Corruption) {
+  FileSecondaryCacheOptions opts = Options();
+  opts.admission_min_frequency = 0;
+  opts.write_buffer_size = 1;
+  std::shared_ptr<SecondaryCache> sec_cache = NewCache(opts);
+  std::string value(1000, 'v');
+  TestItem item(value.data(), value.size());
+  ASSERT_OK(sec_cache->Insert("k1", &item, &kHelper));
+  ASSERT_EQ(value, Lookup(sec_cache.get(), "k1"));
+
+  std::vector<std::string> children;
+  ASSERT_OK(env_->GetChildren(path_, &children));
+  for (const auto& child : children) {
+    if (child.find(".sec") != std::string::npos) {
+      ASSERT_OK(test::CorruptFile(env_, path_ + "/" + child, 500, 1,
+                                  /*verify_checksum=*/false));
+    }
+  }
+  ASSERT_EQ("CORRUPT", Lookup(sec_cache.get(), "k1"));
+}
+
+TEST_F(FileSecondaryCacheTest, FromString) {
+  std::string sec_cache_uri = "file_secondary_cache://path=" + path_ +
+                              ";capacity=1048576;file_size=65536;"
+                              "admission_min_frequency=0;num_read_threads=2";
+  std::shared_ptr<SecondaryCache> sec_cache;
+  ASSERT_OK(SecondaryCache::CreateFromString(ConfigOptions(), sec_cache_uri,
+                                             &sec_cache));
+  ASSERT_NE(sec_cache, nullptr);
+  ASSERT_STREQ(sec_cache->Name(), "FileSecondaryCache");
+  size_t capacity = 0;
+  ASSERT_OK(sec_cache->GetCapacity(capacity));
+  ASSERT_EQ(capacity, size_t{1048576});
+  ASSERT_NE(sec_cache->GetPrintableOptions().find("num_read_threads : 2"),
+            std::string::npos);
+}
+
+TEST_F(FileSecondaryCacheTest, BasicIntegration) {
+  FileSecondaryCacheOptions opts = Options();
+  opts.admission_min_frequency = 0;
+  std::shared_ptr<SecondaryCache> sec_cache = NewCache(opts);
+  LRUCacheOptions lru_opts(2300, 0, /*_strict_capacity_limit=*/true, 0.5,
+                           nullptr, kDefaultToAdaptiveMutex,
+                           kDontChargeCacheMetadata);
+  lru_opts.secondary_cache = sec_cache;
+  std::shared_ptr<Cache> cache = NewLRUCache(lru_opts);
+
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 10; ++i) {
+    values.push_back(rnd.RandomString(1000));
+    auto item = new TestItem(values.back().data(), values.back().size());
+    ASSERT_OK(cache->Insert(std::to_string(i), item, &kHelper,
+                            values.back().size()));
+  }
+  // Blocks evicted from the primary cache are served by the secondary cache
+  for (int i = 0; i < 10; ++i) {
+    SCOPED_TRACE(i);
+    Cache::Handle* handle =
+        cache->Lookup(std::to_string(i), &kHelper, this, Cache::Priority::LOW,
+                      /*wait=*/i % 2 == 0);
+    ASSERT_NE(handle, nullptr);
+    if (i % 2 == 1) {
+      std::vector<Cache::Handle*> handles{handle};
+      cache->WaitAll(handles);
+    }
+    auto item = static_cast<TestItem*>(cache->Value(handle));
+    ASSERT_NE(item, nullptr);
+    ASSERT_EQ(values[i], item->Buf());
+    cache->Release(handle);
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,76 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/frequency_sketch.h"
+
+#include <algorithm>
+
+#include "util/hash.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+FrequencySketch::FrequencySketch(size_t expected_keys) {
+  size_t size = 1024;
+  while (size < expected_keys && size < (size_t{1} << 26)) {
+    size <<= 1;
+  }
+  counters_.reset(new std::atomic<uint8_t>[size]);
+  for (size_t i = 0; i < size; ++i) {
+    counters_[i].store(0, std::memory_order_relaxed);
+  }
+  mask_ = size - 1;
+  reset_increments_ = size * 10;
+}
+
+size_t FrequencySketch::Index(uint64_t hash, int probe) const {
+  // Callers may pass hashes with only 32 useful bits, some of them fixed
+  // (e.g. by the shard), so remix before deriving the probes
+  const uint64_t mixed = hash * 0x9E3779B97F4A7C15U;
+  const uint32_t h1 = Upper32of64(mixed);
+  const uint32_t h2 = Lower32of64(mixed) | 1;
+  return (h1 + static_cast<uint32_t>(probe) * h2) & mask_;
+}
+
+bool FrequencySketch::Increment(uint64_t hash) {
+  // Only increment the smallest counters ("conservative update"), which
+  // makes the estimates of rare keys more accurate
+  uint8_t min_count = kMaxCount;
+  for (int probe = 0; probe < kNumProbes; ++probe) {
+    const uint8_t count =
+        counters_[Index(hash, probe)].load(std::memory_order_relaxed);
+    min_count = std::min(min_count, count);
+  }
+  if (min_count < kMaxCount) {
+    for (int probe = 0; probe < kNumProbes; ++probe) {
+      uint8_t expected = min_count;
+      counters_[Index(hash, probe)].compare_exchange_strong(
+          expected, static_cast<uint8_t>(min_count + 1),
+          std::memory_order_relaxed);
+    }
+  }
+  if (num_increments_.fetch_add(1, std::memory_order_relaxed) + 1 ==
+      reset_increments_) {
+    for (size_t i = 0; i <= mask_; ++i) {
+      counters_[i].store(counters_[i].load(std::memory_order_relaxed) >> 1,
+                         std::memory_order_relaxed);
+    }
+    num_increments_.fetch_sub(reset_increments_ / 2,
+                              std::memory_order_relaxed);
+    return true;
+  }
+  return false;
+}
+
+uint32_t FrequencySketch::Estimate(uint64_t hash) const {
+  uint8_t min_count = kMaxCount;
+  for (int probe = 0; probe < kNumProbes; ++probe) {
+    const uint8_t count =
+        counters_[Index(hash, probe)].load(std::memory_order_relaxed);
+    min_count = std::min(min_count, count);
+  }
+  return min_count;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
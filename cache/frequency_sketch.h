@@ -0,0 +1,51 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "rocksdb/rocksdb_namespace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Approximate counts of how often keys were seen, in a count-min sketch of
+// saturating 4-bit counters (kept a byte each), as used by TinyLFU cache
+// admission. All the counters are halved once the number of increments
+// reaches ten times the number of counters, so that keys that were popular
+// a long time ago lose their counts.
+//
+// Thread-safe without locking. Concurrent updates can be lost, which only
+// makes the counts a little less accurate.
+class FrequencySketch {
+ public:
+  // `expected_keys` is the number of distinct keys expected to be tracked at
+  // a time, typically the number of entries of the cache.
+  explicit FrequencySketch(size_t expected_keys);
+
+  // Any hash of the key will do, including a 32-bit one. Returns true if
+  // this increment halved all the counters.
+  bool Increment(uint64_t hash);
+
+  uint32_t Estimate(uint64_t hash) const;
+
+  size_t NumCounters() const { return mask_ + 1; }
+
+ private:
+  static constexpr int kNumProbes = 4;
+  static constexpr uint8_t kMaxCount = 15;
+
+  size_t Index(uint64_t hash, int probe) const;
+
+  std::unique_ptr<std::atomic<uint8_t>[]> counters_;
+  size_t mask_;
+  size_t reset_increments_;
+  std::atomic<size_t> num_increments_{0};
+};
+
+}  // namespace ROCKSDB_NAMESPACE
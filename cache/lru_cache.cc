@@ -9,14 +9,17 @@
 
 #include "cache/lru_cache.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 
 #include "monitoring/perf_context_imp.h"
 #include "monitoring/statistics.h"
 #include "port/lang.h"
+#include "test_util/sync_point.h"
 #include "util/distributed_mutex.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -127,7 +130,8 @@ LRUCacheShard::LRUCacheShard(size_t capacity, bool strict_capacity_limit,
                              CacheMetadataChargePolicy metadata_charge_policy,
                              int max_upper_hash_bits,
                              MemoryAllocator* allocator,
-                             SecondaryCache* secondary_cache)
+                             SecondaryCache* secondary_cache,
+                             bool frequency_admission)
     : CacheShardBase(metadata_charge_policy),
       capacity_(0),
       high_pri_pool_usage_(0),
@@ -148,6 +152,10 @@ LRUCacheShard::LRUCacheShard(size_t capacity, bool strict_capacity_limit,
   lru_low_pri_ = &lru_;
   lru_bottom_pri_ = &lru_;
   SetCapacity(capacity);
+  if (frequency_admission) {
+    // Sized for entries of a typical block size
+    admission_sketch_.reset(new FrequencySketch(capacity / 4096));
+  }
 }
 
 void LRUCacheShard::EraseUnRefEntries() {
@@ -161,8 +169,7 @@ void LRUCacheShard::EraseUnRefEntries() {
       LRU_Remove(old);
       table_.Remove(old->key(), old->hash);
       old->SetInCache(false);
-      assert(usage_ >= old->total_charge);
-      usage_ -= old->total_charge;
+      SubtractUsage(old);
       last_reference_list.push_back(old);
     }
   }
@@ -326,21 +333,55 @@ void LRUCacheShard::MaintainPoolSize() {
   }
 }
 
+void LRUCacheShard::Evict(LRUHandle* e, autovector<LRUHandle*>* deleted) {
+  // LRU list contains only elements which can be evicted.
+  assert(e->InCache() && !e->HasRefs());
+  LRU_Remove(e);
+  table_.Remove(e->key(), e->hash);
+  e->SetInCache(false);
+  SubtractUsage(e);
+  deleted->push_back(e);
+}
+
 void LRUCacheShard::EvictFromLRU(size_t charge,
                                  autovector<LRUHandle*>* deleted) {
+  if (!has_min_shares_) {
+    while ((usage_ + charge) > capacity_ && lru_.next != &lru_) {
+      Evict(lru_.next, deleted);
+    }
+    return;
+  }
+  // Skip the entries of groups within their minimum share, unless going
+  // through the whole list did not free enough
+  bool skip_protected = true;
+  LRUHandle* old = lru_.next;
   while ((usage_ + charge) > capacity_ && lru_.next != &lru_) {
-    LRUHandle* old = lru_.next;
-    // LRU list contains only elements which can be evicted.
-    assert(old->InCache() && !old->HasRefs());
-    LRU_Remove(old);
-    table_.Remove(old->key(), old->hash);
-    old->SetInCache(false);
-    assert(usage_ >= old->total_charge);
-    usage_ -= old->total_charge;
-    deleted->push_back(old);
+    if (old == &lru_) {
+      skip_protected = false;
+      old = lru_.next;
+    }
+    LRUHandle* next = old->next;
+    if (!skip_protected || !IsProtected(old)) {
+      Evict(old, deleted);
+    }
+    old = next;
   }
 }
 
+bool LRUCacheShard::EvictFromGroup(uint8_t group, size_t charge,
+                                   autovector<LRUHandle*>* deleted) {
+  Group& g = groups_[group];
+  LRUHandle* old = lru_.next;
+  while (g.usage + charge > g.max_usage && old != &lru_) {
+    LRUHandle* next = old->next;
+    if (old->group == group) {
+      Evict(old, deleted);
+    }
+    old = next;
+  }
+  return g.usage + charge <= g.max_usage;
+}
+
 void LRUCacheShard::TryInsertIntoSecondaryCache(
     autovector<LRUHandle*> evicted_handles) {
   for (auto entry : evicted_handles) {
@@ -361,12 +402,43 @@ void LRUCacheShard::SetCapacity(size_t capacity) {
     capacity_ = capacity;
     high_pri_pool_capacity_ = capacity_ * high_pri_pool_ratio_;
     low_pri_pool_capacity_ = capacity_ * low_pri_pool_ratio_;
+    UpdateGroupBounds();
     EvictFromLRU(0, &last_reference_list);
   }
 
   TryInsertIntoSecondaryCache(last_reference_list);
 }
 
+void LRUCacheShard::UpdateGroupBounds() {
+  has_min_shares_ = false;
+  for (Group& group : groups_) {
+    group.min_usage = static_cast<size_t>(capacity_ * group.share.min_ratio);
+    group.max_usage = group.share.max_ratio >= 1.0
+                          ? SIZE_MAX
+                          : static_cast<size_t>(capacity_ *
+                                                group.share.max_ratio);
+    has_min_shares_ |= group.min_usage > 0;
+  }
+}
+
+void LRUCacheShard::SetGroupShare(uint8_t group, const CacheShare& share) {
+  assert(group > 0 && group < kNumGroups);
+  autovector<LRUHandle*> last_reference_list;
+  {
+    DMutexLock l(mutex_);
+    groups_[group].share = share;
+    UpdateGroupBounds();
+    EvictFromGroup(group, 0, &last_reference_list);
+  }
+
+  TryInsertIntoSecondaryCache(last_reference_list);
+}
+
+size_t LRUCacheShard::GetGroupUsage(uint8_t group) const {
+  DMutexLock l(mutex_);
+  return groups_[group].usage;
+}
+
 void LRUCacheShard::SetStrictCapacityLimit(bool strict_capacity_limit) {
   DMutexLock l(mutex_);
   strict_capacity_limit_ = strict_capacity_limit;
@@ -380,17 +452,48 @@ Status LRUCacheShard::InsertItem(LRUHandle* e, LRUHandle** handle,
   {
     DMutexLock l(mutex_);
 
+    // With frequency_admission, an entry that would need to evict the LRU
+    // entry is not admitted unless it has been accessed more often
+    bool rejected = admission_sketch_ != nullptr &&
+                    (usage_ + e->total_charge) > capacity_ &&
+                    lru_.next != &lru_ &&
+                    (handle == nullptr || !strict_capacity_limit_) &&
+                    admission_sketch_->Estimate(e->hash) <
+                        admission_sketch_->Estimate(lru_.next->hash) &&
+                    table_.Lookup(e->key(), e->hash) == nullptr;
+
+    // Keep the group of the entry within its maximum share, evicting its
+    // own entries first
+    bool over_share = false;
+    const Group& group = groups_[e->group];
+    if (!rejected && group.usage + e->total_charge > group.max_usage) {
+      over_share =
+          !EvictFromGroup(e->group, e->total_charge, &last_reference_list) &&
+          (strict_capacity_limit_ || handle == nullptr);
+    }
+
     // Free the space following strict LRU policy until enough space
     // is freed or the lru list is empty.
-    EvictFromLRU(e->total_charge, &last_reference_list);
+    if (!rejected && !over_share) {
+      EvictFromLRU(e->total_charge, &last_reference_list);
+    }
 
-    if ((usage_ + e->total_charge) > capacity_ &&
-        (strict_capacity_limit_ || handle == nullptr)) {
+    if (rejected || over_share ||
+        ((usage_ + e->total_charge) > capacity_ &&
+         (strict_capacity_limit_ || handle == nullptr))) {
       e->SetInCache(false);
       if (handle == nullptr) {
         // Don't insert the entry but still return ok, as if the entry inserted
         // into cache and get evicted immediately.
         last_reference_list.push_back(e);
+      } else if (rejected) {
+        // Return a handle to an entry outside of the cache, which is freed
+        // on its last Release()
+        if (!e->HasRefs()) {
+          e->Ref();
+        }
+        AddUsage(e);
+        *handle = e;
       } else {
         if (free_handle_on_fail) {
           free(e);
@@ -402,7 +505,7 @@ Status LRUCacheShard::InsertItem(LRUHandle* e, LRUHandle** handle,
       // Insert into the cache. Note that the cache might get larger than its
       // capacity if not enough space was freed up.
       LRUHandle* old = table_.Insert(e);
-      usage_ += e->total_charge;
+      AddUsage(e);
       if (old != nullptr) {
         s = Status::OkOverwritten();
         assert(old->InCache());
@@ -410,8 +513,7 @@ Status LRUCacheShard::InsertItem(LRUHandle* e, LRUHandle** handle,
         if (!old->HasRefs()) {
           // old is on LRU because it's in cache and its reference count is 0.
           LRU_Remove(old);
-          assert(usage_ >= old->total_charge);
-          usage_ -= old->total_charge;
+          SubtractUsage(old);
           last_reference_list.push_back(old);
         }
       }
@@ -464,7 +566,7 @@ void LRUCacheShard::Promote(LRUHandle* e) {
         if ((usage_ + e->total_charge) > capacity_ && strict_capacity_limit_) {
           free_standalone_handle = true;
         } else {
-          usage_ += e->total_charge;
+          AddUsage(e);
         }
       }
 
@@ -522,6 +624,9 @@ LRUHandle* LRUCacheShard::Lookup(const Slice& key, uint32_t hash,
   bool found_dummy_entry{false};
   {
     DMutexLock l(mutex_);
+    if (admission_sketch_ != nullptr) {
+      admission_sketch_->Increment(hash);
+    }
     e = table_.Lookup(key, hash);
     if (e != nullptr) {
       assert(e->InCache());
@@ -565,6 +670,7 @@ LRUHandle* LRUCacheShard::Lookup(const Slice& key, uint32_t hash,
       e->m_flags = 0;
       e->im_flags = 0;
       e->helper = helper;
+      e->group = GroupOf(helper, 0);
       e->key_length = key.size();
       e->hash = hash;
       e->refs = 0;
@@ -662,8 +768,7 @@ bool LRUCacheShard::Release(LRUHandle* e, bool /*useful*/,
     }
     // If it was the last reference, then decrement the cache usage.
     if (last_reference) {
-      assert(usage_ >= e->total_charge);
-      usage_ -= e->total_charge;
+      SubtractUsage(e);
     }
   }
 
@@ -678,7 +783,7 @@ Status LRUCacheShard::Insert(const Slice& key, uint32_t hash,
                              Cache::ObjectPtr value,
                              const Cache::CacheItemHelper* helper,
                              size_t charge, LRUHandle** handle,
-                             Cache::Priority priority) {
+                             Cache::Priority priority, uint8_t tenant_group) {
   assert(helper);
 
   // Allocate the memory here outside of the mutex.
@@ -691,6 +796,7 @@ Status LRUCacheShard::Insert(const Slice& key, uint32_t hash,
   e->m_flags = 0;
   e->im_flags = 0;
   e->helper = helper;
+  e->group = GroupOf(helper, tenant_group);
   e->key_length = key.size();
   e->hash = hash;
   e->refs = 0;
@@ -719,8 +825,7 @@ void LRUCacheShard::Erase(const Slice& key, uint32_t hash) {
       if (!e->HasRefs()) {
         // The entry is in LRU since it's in hash and has no external references
         LRU_Remove(e);
-        assert(usage_ >= e->total_charge);
-        usage_ -= e->total_charge;
+        SubtractUsage(e);
         last_reference = true;
       }
     }
@@ -783,10 +888,16 @@ LRUCache::LRUCache(size_t capacity, int num_shard_bits,
                    std::shared_ptr<MemoryAllocator> allocator,
                    bool use_adaptive_mutex,
                    CacheMetadataChargePolicy metadata_charge_policy,
-                   std::shared_ptr<SecondaryCache> _secondary_cache)
+                   std::shared_ptr<SecondaryCache> _secondary_cache,
+                   bool frequency_admission, int num_numa_nodes,
+                   const std::array<CacheShare, kNumCacheEntryRoles>&
+                       role_shares)
     : ShardedCache(capacity, num_shard_bits, strict_capacity_limit,
                    std::move(allocator)),
-      secondary_cache_(std::move(_secondary_cache)) {
+      secondary_cache_(std::move(_secondary_cache)),
+      num_numa_nodes_(std::min(
+          static_cast<uint32_t>(std::max(num_numa_nodes, 1)),
+          uint32_t{1} << num_shard_bits)) {
   size_t per_shard = GetPerShardCapacity();
   SecondaryCache* secondary_cache = secondary_cache_.get();
   MemoryAllocator* alloc = memory_allocator();
@@ -794,8 +905,106 @@ LRUCache::LRUCache(size_t capacity, int num_shard_bits,
     new (cs) LRUCacheShard(
         per_shard, strict_capacity_limit, high_pri_pool_ratio,
         low_pri_pool_ratio, use_adaptive_mutex, metadata_charge_policy,
-        /* max_upper_hash_bits */ 32 - num_shard_bits, alloc, secondary_cache);
+        /* max_upper_hash_bits */ 32 - num_shard_bits, alloc, secondary_cache,
+        frequency_admission);
   });
+  for (uint32_t role = 0; role < kNumCacheEntryRoles; ++role) {
+    if (!role_shares[role].IsDefault()) {
+      auto group =
+          static_cast<uint8_t>(LRUCacheShard::kFirstRoleGroup + role);
+      ForEachShard([&](LRUCacheShard* cs) {
+        cs->SetGroupShare(group, role_shares[role]);
+      });
+    }
+  }
+}
+
+uint32_t LRUCache::NumaReplicaHash(uint32_t hash, uint32_t node) const {
+  assert(node < num_numa_nodes_);
+  uint32_t shards_of_node =
+      (GetNumShards() - node + num_numa_nodes_ - 1) / num_numa_nodes_;
+  uint32_t shard = node + num_numa_nodes_ * ((hash & shard_mask_) %
+                                             shards_of_node);
+  return (hash & ~shard_mask_) | shard;
+}
+
+uint32_t LRUCache::CurrentNumaNode() const {
+  int node = port::NumaNodeOfCurrentCore();
+  TEST_SYNC_POINT_CALLBACK("LRUCache::CurrentNumaNode", &node);
+  return static_cast<uint32_t>(std::max(node, 0)) % num_numa_nodes_;
+}
+
+Status LRUCache::Insert(const Slice& key, ObjectPtr value,
+                        const CacheItemHelper* helper, size_t charge,
+                        Handle** handle, Priority priority) {
+  if (num_numa_nodes_ <= 1 || priority != Priority::HIGH) {
+    return ShardedCache::Insert(key, value, helper, charge, handle, priority);
+  }
+  return InsertForTenant(/*tenant_group=*/0, key, value, helper, charge,
+                         handle, priority);
+}
+
+Status LRUCache::InsertForTenant(uint8_t tenant_group, const Slice& key,
+                                 ObjectPtr value,
+                                 const CacheItemHelper* helper, size_t charge,
+                                 Handle** handle, Priority priority) {
+  assert(helper);
+  uint32_t hash = LRUCacheShard::ComputeHash(key);
+  if (num_numa_nodes_ > 1 && priority == Priority::HIGH) {
+    hash = NumaReplicaHash(hash, CurrentNumaNode());
+  }
+  auto h_out = reinterpret_cast<LRUHandle**>(handle);
+  return GetShard(hash).Insert(key, hash, value, helper, charge, h_out,
+                               priority, tenant_group);
+}
+
+uint8_t LRUCache::NewTenantGroup(const CacheShare& share) {
+  uint8_t group;
+  {
+    std::lock_guard<std::mutex> l(tenants_mutex_);
+    if (next_tenant_group_ >= LRUCacheShard::kNumGroups) {
+      return 0;
+    }
+    group = next_tenant_group_++;
+  }
+  ForEachShard([&](LRUCacheShard* cs) { cs->SetGroupShare(group, share); });
+  return group;
+}
+
+size_t LRUCache::GetTenantUsage(uint8_t tenant_group) const {
+  return SumOverShards([tenant_group](LRUCacheShard& cs) {
+    return cs.GetGroupUsage(tenant_group);
+  });
+}
+
+Cache::Handle* LRUCache::Lookup(const Slice& key,
+                                const CacheItemHelper* helper,
+                                CreateContext* create_context,
+                                Priority priority, bool wait,
+                                Statistics* stats) {
+  if (num_numa_nodes_ <= 1 || priority != Priority::HIGH) {
+    return ShardedCache::Lookup(key, helper, create_context, priority, wait,
+                                stats);
+  }
+  uint32_t hash = NumaReplicaHash(LRUCacheShard::ComputeHash(key),
+                                  CurrentNumaNode());
+  LRUHandle* result = GetShard(hash).Lookup(key, hash, helper, create_context,
+                                            priority, wait, stats);
+  return reinterpret_cast<Handle*>(result);
+}
+
+void LRUCache::Erase(const Slice& key) {
+  uint32_t hash = LRUCacheShard::ComputeHash(key);
+  GetShard(hash).Erase(key, hash);
+  if (num_numa_nodes_ > 1) {
+    // The entry might have been inserted with high priority on any node
+    for (uint32_t node = 0; node < num_numa_nodes_; ++node) {
+      uint32_t replica_hash = NumaReplicaHash(hash, node);
+      if (replica_hash != hash) {
+        GetShard(replica_hash).Erase(key, replica_hash);
+      }
+    }
+  }
 }
 
 Cache::ObjectPtr LRUCache::Value(Handle* handle) {
@@ -860,8 +1069,38 @@ void LRUCache::AppendPrintableOptions(std::string& str) const {
   }
 }
 
+LRUCacheTenant::LRUCacheTenant(std::shared_ptr<LRUCache> cache, uint8_t group,
+                               const CacheShare& share)
+    // Shares ownership of the cache for its allocator
+    : Cache(std::shared_ptr<MemoryAllocator>(cache,
+                                             cache->memory_allocator())),
+      cache_(cache),
+      lru_cache_(cache.get()),
+      group_(group),
+      share_(share) {}
+
+std::string LRUCacheTenant::GetPrintableOptions() const {
+  std::string ret = cache_->GetPrintableOptions();
+  const int kBufferSize = 200;
+  char buffer[kBufferSize];
+  snprintf(buffer, kBufferSize, "    tenant_min_ratio: %.3lf\n",
+           share_.min_ratio);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    tenant_max_ratio: %.3lf\n",
+           share_.max_ratio);
+  ret.append(buffer);
+  return ret;
+}
+
 }  // namespace lru_cache
 
+namespace {
+bool IsValidShare(const CacheShare& share) {
+  return share.min_ratio >= 0.0 && share.min_ratio <= share.max_ratio &&
+         share.max_ratio >= 0.0;
+}
+}  // namespace
+
 std::shared_ptr<Cache> NewLRUCache(
     size_t capacity, int num_shard_bits, bool strict_capacity_limit,
     double high_pri_pool_ratio,
@@ -869,37 +1108,63 @@ std::shared_ptr<Cache> NewLRUCache(
     CacheMetadataChargePolicy metadata_charge_policy,
     const std::shared_ptr<SecondaryCache>& secondary_cache,
     double low_pri_pool_ratio) {
+  LRUCacheOptions cache_opts(capacity, num_shard_bits, strict_capacity_limit,
+                             high_pri_pool_ratio, std::move(memory_allocator),
+                             use_adaptive_mutex, metadata_charge_policy,
+                             low_pri_pool_ratio);
+  cache_opts.secondary_cache = secondary_cache;
+  return NewLRUCache(cache_opts);
+}
+
+std::shared_ptr<Cache> NewLRUCache(const LRUCacheOptions& cache_opts) {
+  int num_shard_bits = cache_opts.num_shard_bits;
   if (num_shard_bits >= 20) {
     return nullptr;  // The cache cannot be sharded into too many fine pieces.
   }
-  if (high_pri_pool_ratio < 0.0 || high_pri_pool_ratio > 1.0) {
+  if (cache_opts.high_pri_pool_ratio < 0.0 ||
+      cache_opts.high_pri_pool_ratio > 1.0) {
     // Invalid high_pri_pool_ratio
     return nullptr;
   }
-  if (low_pri_pool_ratio < 0.0 || low_pri_pool_ratio > 1.0) {
+  if (cache_opts.low_pri_pool_ratio < 0.0 ||
+      cache_opts.low_pri_pool_ratio > 1.0) {
     // Invalid low_pri_pool_ratio
     return nullptr;
   }
-  if (low_pri_pool_ratio + high_pri_pool_ratio > 1.0) {
+  if (cache_opts.low_pri_pool_ratio + cache_opts.high_pri_pool_ratio > 1.0) {
     // Invalid high_pri_pool_ratio and low_pri_pool_ratio combination
     return nullptr;
   }
+  for (const CacheShare& share : cache_opts.role_shares) {
+    if (!IsValidShare(share)) {
+      return nullptr;
+    }
+  }
   if (num_shard_bits < 0) {
-    num_shard_bits = GetDefaultCacheShardBits(capacity);
+    num_shard_bits = GetDefaultCacheShardBits(cache_opts.capacity);
   }
   return std::make_shared<LRUCache>(
-      capacity, num_shard_bits, strict_capacity_limit, high_pri_pool_ratio,
-      low_pri_pool_ratio, std::move(memory_allocator), use_adaptive_mutex,
-      metadata_charge_policy, secondary_cache);
+      cache_opts.capacity, num_shard_bits, cache_opts.strict_capacity_limit,
+      cache_opts.high_pri_pool_ratio, cache_opts.low_pri_pool_ratio,
+      cache_opts.memory_allocator, cache_opts.use_adaptive_mutex,
+      cache_opts.metadata_charge_policy, cache_opts.secondary_cache,
+      cache_opts.frequency_admission,
+      cache_opts.numa_aware ? port::NumaNodeCount() : 1,
+      cache_opts.role_shares);
 }
 
-std::shared_ptr<Cache> NewLRUCache(const LRUCacheOptions& cache_opts) {
-  return NewLRUCache(cache_opts.capacity, cache_opts.num_shard_bits,
-                     cache_opts.strict_capacity_limit,
-                     cache_opts.high_pri_pool_ratio,
-                     cache_opts.memory_allocator, cache_opts.use_adaptive_mutex,
-                     cache_opts.metadata_charge_policy,
-                     cache_opts.secondary_cache, cache_opts.low_pri_pool_ratio);
+std::shared_ptr<Cache> NewLRUCacheTenant(
+    const std::shared_ptr<Cache>& lru_cache, const CacheShare& share) {
+  if (lru_cache == nullptr || strcmp(lru_cache->Name(), "LRUCache") != 0 ||
+      !IsValidShare(share)) {
+    return nullptr;
+  }
+  auto cache = std::static_pointer_cast<LRUCache>(lru_cache);
+  uint8_t group = cache->NewTenantGroup(share);
+  if (group == 0) {
+    return nullptr;
+  }
+  return std::make_shared<LRUCacheTenant>(std::move(cache), group, share);
 }
 
 std::shared_ptr<Cache> NewLRUCache(
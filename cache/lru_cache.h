@@ -8,9 +8,12 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #pragma once
 
+#include <array>
 #include <memory>
+#include <mutex>
 #include <string>
 
+#include "cache/frequency_sketch.h"
 #include "cache/sharded_cache.h"
 #include "port/lang.h"
 #include "port/likely.h"
@@ -97,6 +100,10 @@ struct LRUHandle {
     IM_IS_STANDALONE = (1 << 4),
   };
 
+  // The class of the entry for LRUCacheShard::groups_. "Immutable" like
+  // im_flags.
+  uint8_t group;
+
   // Beginning of the key (MUST BE THE LAST FIELD IN THIS STRUCT!)
   char key_data[1];
 
@@ -308,7 +315,8 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
                 bool use_adaptive_mutex,
                 CacheMetadataChargePolicy metadata_charge_policy,
                 int max_upper_hash_bits, MemoryAllocator* allocator,
-                SecondaryCache* secondary_cache);
+                SecondaryCache* secondary_cache,
+                bool frequency_admission = false);
 
  public:  // Type definitions expected as parameter to ShardedCache
   using HandleImpl = LRUHandle;
@@ -334,10 +342,22 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
   // Set percentage of capacity reserved for low-pri cache entries.
   void SetLowPriorityPoolRatio(double low_pri_pool_ratio);
 
-  // Like Cache methods, but with an extra "hash" parameter.
+  // Classes of entries with a CacheShare. Entries of a tenant are in its
+  // group, and others in the group of their role.
+  static constexpr uint8_t kFirstRoleGroup = 1;
+  static constexpr uint8_t kFirstTenantGroup =
+      kFirstRoleGroup + kNumCacheEntryRoles;
+  static constexpr size_t kNumGroups = kFirstTenantGroup + kMaxLRUCacheTenants;
+
+  void SetGroupShare(uint8_t group, const CacheShare& share);
+  size_t GetGroupUsage(uint8_t group) const;
+
+  // Like Cache methods, but with an extra "hash" parameter, and for Insert()
+  // the group of a tenant inserting the entry, if any.
   Status Insert(const Slice& key, uint32_t hash, Cache::ObjectPtr value,
                 const Cache::CacheItemHelper* helper, size_t charge,
-                LRUHandle** handle, Cache::Priority priority);
+                LRUHandle** handle, Cache::Priority priority,
+                uint8_t tenant_group = 0);
 
   LRUHandle* Lookup(const Slice& key, uint32_t hash,
                     const Cache::CacheItemHelper* helper,
@@ -410,9 +430,47 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
   // Free some space following strict LRU policy until enough space
   // to hold (usage_ + charge) is freed or the lru list is empty
   // This function is not thread safe - it needs to be executed while
-  // holding the mutex_.
+  // holding the mutex_. Entries of groups within their minimum share are
+  // only evicted if no other entries are left.
   void EvictFromLRU(size_t charge, autovector<LRUHandle*>* deleted);
 
+  // Like EvictFromLRU(), but only evicts entries of `group` until it can
+  // hold `charge` more within its maximum share. Returns whether it can.
+  bool EvictFromGroup(uint8_t group, size_t charge,
+                      autovector<LRUHandle*>* deleted);
+
+  // Removes an entry on the LRU list from the cache.
+  void Evict(LRUHandle* e, autovector<LRUHandle*>* deleted);
+
+  // Account for an entry added to or removed from usage_.
+  void AddUsage(const LRUHandle* e) {
+    usage_ += e->total_charge;
+    groups_[e->group].usage += e->total_charge;
+  }
+  void SubtractUsage(const LRUHandle* e) {
+    assert(usage_ >= e->total_charge);
+    usage_ -= e->total_charge;
+    assert(groups_[e->group].usage >= e->total_charge);
+    groups_[e->group].usage -= e->total_charge;
+  }
+
+  bool IsProtected(const LRUHandle* e) const {
+    const Group& group = groups_[e->group];
+    return group.min_usage > 0 && group.usage <= group.min_usage;
+  }
+
+  uint8_t GroupOf(const Cache::CacheItemHelper* helper,
+                  uint8_t tenant_group) const {
+    if (tenant_group != 0) {
+      return tenant_group;
+    }
+    return static_cast<uint8_t>(kFirstRoleGroup +
+                                static_cast<uint32_t>(helper->role));
+  }
+
+  // Recompute the bounds of the groups from capacity_
+  void UpdateGroupBounds();
+
   // Try to insert the evicted handles into the secondary cache.
   void TryInsertIntoSecondaryCache(autovector<LRUHandle*> evicted_handles);
 
@@ -479,6 +537,23 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
 
   // Owned by LRUCache
   SecondaryCache* secondary_cache_;
+
+  // For frequency_admission, the access counts of keys. Protected by mutex_
+  // (the counters themselves are atomic).
+  std::unique_ptr<FrequencySketch> admission_sketch_;
+
+  // The usage and bounds of each class of entries, for the shares of roles
+  // and tenants. Group 0 has no share. Protected by mutex_.
+  struct Group {
+    size_t usage = 0;
+    CacheShare share;
+    // 0 for no minimum
+    size_t min_usage = 0;
+    size_t max_usage = SIZE_MAX;
+  };
+  std::array<Group, kNumGroups> groups_;
+  // Whether any group has a minimum share, for a fast path in EvictFromLRU()
+  bool has_min_shares_ = false;
 };
 
 class LRUCache
@@ -493,8 +568,35 @@ class LRUCache
            bool use_adaptive_mutex = kDefaultToAdaptiveMutex,
            CacheMetadataChargePolicy metadata_charge_policy =
                kDontChargeCacheMetadata,
-           std::shared_ptr<SecondaryCache> secondary_cache = nullptr);
+           std::shared_ptr<SecondaryCache> secondary_cache = nullptr,
+           bool frequency_admission = false, int num_numa_nodes = 1,
+           const std::array<CacheShare, kNumCacheEntryRoles>& role_shares = {});
   const char* Name() const override { return "LRUCache"; }
+
+  // Like Insert(), for the entries of a tenant in `tenant_group`
+  Status InsertForTenant(uint8_t tenant_group, const Slice& key,
+                         ObjectPtr value, const CacheItemHelper* helper,
+                         size_t charge, Handle** handle, Priority priority);
+
+  // Reserves a group for a new tenant with `share`. Returns 0 if there are
+  // too many tenants.
+  uint8_t NewTenantGroup(const CacheShare& share);
+  size_t GetTenantUsage(uint8_t tenant_group) const;
+
+  // With more than one NUMA node, high priority entries are kept in a copy
+  // per node, in the shards of the node of the core calling, so the
+  // frequently read index and filter blocks are read from memory (and
+  // contend on shard mutexes) only on the node reading them.
+  Status Insert(const Slice& key, ObjectPtr value,
+                const CacheItemHelper* helper, size_t charge,
+                Handle** handle = nullptr,
+                Priority priority = Priority::LOW) override;
+  Handle* Lookup(const Slice& key, const CacheItemHelper* helper = nullptr,
+                 CreateContext* create_context = nullptr,
+                 Priority priority = Priority::LOW, bool wait = true,
+                 Statistics* stats = nullptr) override;
+  void Erase(const Slice& key) override;
+
   ObjectPtr Value(Handle* handle) override;
   size_t GetCharge(Handle* handle) const override;
   const CacheItemHelper* GetCacheItemHelper(Handle* handle) const override;
@@ -508,7 +610,118 @@ class LRUCache
   void AppendPrintableOptions(std::string& str) const override;
 
  private:
+  // The hash of the copy of an entry with `hash` for `node`, with the shard
+  // bits changed to pick one of the shards of the node. Shard s belongs to
+  // node s % num_numa_nodes_.
+  uint32_t NumaReplicaHash(uint32_t hash, uint32_t node) const;
+  uint32_t CurrentNumaNode() const;
+
   std::shared_ptr<SecondaryCache> secondary_cache_;
+  // At most the number of shards. 1 unless numa_aware
+  const uint32_t num_numa_nodes_;
+
+  std::mutex tenants_mutex_;
+  uint8_t next_tenant_group_ = LRUCacheShard::kFirstTenantGroup;
+};
+
+// See NewLRUCacheTenant(). Forwards all calls to the LRUCache, inserting
+// entries in the group of the tenant.
+class LRUCacheTenant : public Cache {
+ public:
+  LRUCacheTenant(std::shared_ptr<LRUCache> cache, uint8_t group,
+                 const CacheShare& share);
+  ~LRUCacheTenant() override = default;
+
+  static const char* kClassName() { return "LRUCacheTenant"; }
+  const char* Name() const override { return kClassName(); }
+
+  Status Insert(const Slice& key, ObjectPtr value,
+                const CacheItemHelper* helper, size_t charge,
+                Handle** handle = nullptr,
+                Priority priority = Priority::LOW) override {
+    return lru_cache_->InsertForTenant(group_, key, value, helper, charge,
+                                       handle, priority);
+  }
+
+  Handle* Lookup(const Slice& key, const CacheItemHelper* helper = nullptr,
+                 CreateContext* create_context = nullptr,
+                 Priority priority = Priority::LOW, bool wait = true,
+                 Statistics* stats = nullptr) override {
+    return cache_->Lookup(key, helper, create_context, priority, wait, stats);
+  }
+
+  bool Release(Handle* handle, bool useful,
+               bool erase_if_last_ref = false) override {
+    return cache_->Release(handle, useful, erase_if_last_ref);
+  }
+  bool Release(Handle* handle, bool erase_if_last_ref = false) override {
+    return cache_->Release(handle, erase_if_last_ref);
+  }
+
+  void Erase(const Slice& key) override { cache_->Erase(key); }
+  void EraseUnRefEntries() override { cache_->EraseUnRefEntries(); }
+
+  uint64_t NewId() override { return cache_->NewId(); }
+
+  void SetCapacity(size_t capacity) override { cache_->SetCapacity(capacity); }
+
+  void SetStrictCapacityLimit(bool strict_capacity_limit) override {
+    cache_->SetStrictCapacityLimit(strict_capacity_limit);
+  }
+
+  bool HasStrictCapacityLimit() const override {
+    return cache_->HasStrictCapacityLimit();
+  }
+
+  ObjectPtr Value(Handle* handle) override { return cache_->Value(handle); }
+
+  bool IsReady(Handle* handle) override { return cache_->IsReady(handle); }
+
+  void Wait(Handle* handle) override { cache_->Wait(handle); }
+
+  void WaitAll(std::vector<Handle*>& handles) override {
+    cache_->WaitAll(handles);
+  }
+
+  bool Ref(Handle* handle) override { return cache_->Ref(handle); }
+
+  size_t GetCapacity() const override { return cache_->GetCapacity(); }
+
+  // Only the entries of the tenant
+  size_t GetUsage() const override {
+    return lru_cache_->GetTenantUsage(group_);
+  }
+
+  size_t GetUsage(Handle* handle) const override {
+    return cache_->GetUsage(handle);
+  }
+
+  size_t GetPinnedUsage() const override { return cache_->GetPinnedUsage(); }
+
+  size_t GetCharge(Handle* handle) const override {
+    return cache_->GetCharge(handle);
+  }
+
+  const CacheItemHelper* GetCacheItemHelper(Handle* handle) const override {
+    return cache_->GetCacheItemHelper(handle);
+  }
+
+  void ApplyToAllEntries(
+      const std::function<void(const Slice& key, ObjectPtr value, size_t charge,
+                               const CacheItemHelper* helper)>& callback,
+      const ApplyToAllEntriesOptions& opts) override {
+    cache_->ApplyToAllEntries(callback, opts);
+  }
+
+  std::string GetPrintableOptions() const override;
+
+  void DisownData() override { cache_->DisownData(); }
+
+ private:
+  std::shared_ptr<Cache> cache_;
+  LRUCache* const lru_cache_;
+  const uint8_t group_;
+  const CacheShare share_;
 };
 
 }  // namespace lru_cache
@@ -516,5 +729,6 @@ class LRUCache
 using LRUCache = lru_cache::LRUCache;
 using LRUHandle = lru_cache::LRUHandle;
 using LRUCacheShard = lru_cache::LRUCacheShard;
+using LRUCacheTenant = lru_cache::LRUCacheTenant;
 
 }  // namespace ROCKSDB_NAMESPACE
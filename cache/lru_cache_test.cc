@@ -367,6 +367,188 @@ TEST_F(LRUCacheTest, EntriesWithPriority) {
   ValidateLRUList({"x", "y", "g", "z", "d", "m"}, 2, 2, 2);
 }
 
+TEST_F(LRUCacheTest, NumaReplicas) {
+  LRUCache cache(/*capacity=*/100, /*num_shard_bits=*/2,
+                 /*strict_capacity_limit=*/false,
+                 /*high_pri_pool_ratio=*/0.5, /*low_pri_pool_ratio=*/0.0,
+                 /*memory_allocator=*/nullptr, kDefaultToAdaptiveMutex,
+                 kDontChargeCacheMetadata, /*secondary_cache=*/nullptr,
+                 /*frequency_admission=*/false, /*num_numa_nodes=*/2);
+  int node = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "LRUCache::CurrentNumaNode",
+      [&](void* arg) { *static_cast<int*>(arg) = node; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  auto lookup = [&](const std::string& key, Cache::Priority priority) {
+    Cache::Handle* h = cache.Lookup(key, nullptr, nullptr, priority);
+    if (h) {
+      cache.Release(h);
+    }
+    return h != nullptr;
+  };
+
+  for (int i = 0; i < 10; ++i) {
+    std::string key = "k" + std::to_string(i);
+    // High priority entries are cached per node
+    node = 0;
+    ASSERT_OK(cache.Insert(key, nullptr, &kNoopCacheItemHelper, 1, nullptr,
+                           Cache::Priority::HIGH));
+    ASSERT_TRUE(lookup(key, Cache::Priority::HIGH));
+    node = 1;
+    ASSERT_FALSE(lookup(key, Cache::Priority::HIGH));
+    ASSERT_OK(cache.Insert(key, nullptr, &kNoopCacheItemHelper, 1, nullptr,
+                           Cache::Priority::HIGH));
+    ASSERT_TRUE(lookup(key, Cache::Priority::HIGH));
+    ASSERT_EQ(2, cache.GetUsage());
+
+    // Others are not
+    ASSERT_OK(cache.Insert("low", nullptr, &kNoopCacheItemHelper, 1));
+    node = 0;
+    ASSERT_TRUE(lookup("low", Cache::Priority::LOW));
+    ASSERT_EQ(3, cache.GetUsage());
+
+    // Erase drops all copies
+    cache.Erase(key);
+    cache.Erase("low");
+    ASSERT_EQ(0, cache.GetUsage());
+    ASSERT_FALSE(lookup(key, Cache::Priority::HIGH));
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
+TEST_F(LRUCacheTest, RoleShares) {
+  std::array<CacheShare, kNumCacheEntryRoles> role_shares{};
+  role_shares[static_cast<size_t>(CacheEntryRole::kFilterBlock)].min_ratio =
+      0.3;
+  role_shares[static_cast<size_t>(CacheEntryRole::kBlobValue)].max_ratio = 0.2;
+  LRUCache cache(/*capacity=*/10, /*num_shard_bits=*/0,
+                 /*strict_capacity_limit=*/false,
+                 /*high_pri_pool_ratio=*/0.0, /*low_pri_pool_ratio=*/0.0,
+                 /*memory_allocator=*/nullptr, kDefaultToAdaptiveMutex,
+                 kDontChargeCacheMetadata, /*secondary_cache=*/nullptr,
+                 /*frequency_admission=*/false, /*num_numa_nodes=*/1,
+                 role_shares);
+  static constexpr Cache::CacheItemHelper kFilterHelper{
+      CacheEntryRole::kFilterBlock};
+  static constexpr Cache::CacheItemHelper kBlobHelper{
+      CacheEntryRole::kBlobValue};
+  static constexpr Cache::CacheItemHelper kDataHelper{
+      CacheEntryRole::kDataBlock};
+
+  auto insert = [&](const std::string& key,
+                    const Cache::CacheItemHelper* helper) {
+    ASSERT_OK(cache.Insert(key, nullptr, helper, 1));
+  };
+  auto lookup = [&](const std::string& key) {
+    Cache::Handle* h = cache.Lookup(key);
+    if (h) {
+      cache.Release(h);
+    }
+    return h != nullptr;
+  };
+
+  // Filter blocks within their minimum share are not evicted for others
+  for (int i = 0; i < 3; ++i) {
+    insert("f" + std::to_string(i), &kFilterHelper);
+  }
+  for (int i = 0; i < 10; ++i) {
+    insert("d" + std::to_string(i), &kDataHelper);
+  }
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(lookup("f" + std::to_string(i)));
+    ASSERT_FALSE(lookup("d" + std::to_string(i)));
+  }
+  for (int i = 3; i < 10; ++i) {
+    ASSERT_TRUE(lookup("d" + std::to_string(i)));
+  }
+
+  // Blob values beyond their maximum share evict each other
+  for (int i = 0; i < 5; ++i) {
+    insert("b" + std::to_string(i), &kBlobHelper);
+  }
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_FALSE(lookup("b" + std::to_string(i)));
+    ASSERT_TRUE(lookup("f" + std::to_string(i)));
+  }
+  ASSERT_TRUE(lookup("b3"));
+  ASSERT_TRUE(lookup("b4"));
+  ASSERT_FALSE(lookup("d3"));
+  ASSERT_FALSE(lookup("d4"));
+  for (int i = 5; i < 10; ++i) {
+    ASSERT_TRUE(lookup("d" + std::to_string(i)));
+  }
+  ASSERT_EQ(10, cache.GetUsage());
+
+  // Filter blocks beyond their minimum share are evicted like others
+  insert("f3", &kFilterHelper);
+  insert("f4", &kFilterHelper);
+  for (int i = 0; i < 10; ++i) {
+    insert("x" + std::to_string(i), &kDataHelper);
+  }
+  int filters = 0;
+  for (int i = 0; i < 5; ++i) {
+    filters += lookup("f" + std::to_string(i)) ? 1 : 0;
+  }
+  ASSERT_EQ(3, filters);
+  ASSERT_EQ(10, cache.GetUsage());
+}
+
+TEST_F(LRUCacheTest, Tenants) {
+  LRUCacheOptions opts(/*capacity=*/10, /*num_shard_bits=*/0,
+                       /*strict_capacity_limit=*/false,
+                       /*high_pri_pool_ratio=*/0.0);
+  opts.metadata_charge_policy = kDontChargeCacheMetadata;
+  std::shared_ptr<Cache> cache = NewLRUCache(opts);
+  std::shared_ptr<Cache> protected_tenant =
+      NewLRUCacheTenant(cache, CacheShare{0.5, 1.0});
+  std::shared_ptr<Cache> capped_tenant =
+      NewLRUCacheTenant(cache, CacheShare{0.0, 0.3});
+  ASSERT_NE(protected_tenant, nullptr);
+  ASSERT_NE(capped_tenant, nullptr);
+
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_OK(protected_tenant->Insert("p" + std::to_string(i), nullptr,
+                                       &kNoopCacheItemHelper, 1));
+  }
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_OK(capped_tenant->Insert("c" + std::to_string(i), nullptr,
+                                    &kNoopCacheItemHelper, 1));
+  }
+  ASSERT_EQ(5, protected_tenant->GetUsage());
+  ASSERT_EQ(3, capped_tenant->GetUsage());
+  ASSERT_EQ(8, cache->GetUsage());
+
+  // Entries of the tenants are in the shared cache
+  Cache::Handle* h = protected_tenant->Lookup("p0");
+  ASSERT_NE(h, nullptr);
+  protected_tenant->Release(h);
+  h = cache->Lookup("c19");
+  ASSERT_NE(h, nullptr);
+  cache->Release(h);
+
+  // Other entries can only evict those beyond the minimum shares
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_OK(cache->Insert("o" + std::to_string(i), nullptr,
+                            &kNoopCacheItemHelper, 1));
+  }
+  ASSERT_EQ(5, protected_tenant->GetUsage());
+  ASSERT_EQ(0, capped_tenant->GetUsage());
+  ASSERT_EQ(10, cache->GetUsage());
+
+  // Not supported
+  ASSERT_EQ(NewLRUCacheTenant(protected_tenant, CacheShare()), nullptr);
+  ASSERT_EQ(NewLRUCacheTenant(cache, CacheShare{0.5, 0.2}), nullptr);
+  std::vector<std::shared_ptr<Cache>> tenants;
+  for (uint32_t i = 2; i < kMaxLRUCacheTenants; ++i) {
+    tenants.push_back(NewLRUCacheTenant(cache, CacheShare()));
+    ASSERT_NE(tenants.back(), nullptr);
+  }
+  ASSERT_EQ(NewLRUCacheTenant(cache, CacheShare()), nullptr);
+}
+
 namespace clock_cache {
 
 class ClockCacheTest : public testing::Test {
@@ -386,15 +568,18 @@ class ClockCacheTest : public testing::Test {
     }
   }
 
-  void NewShard(size_t capacity, bool strict_capacity_limit = true) {
+  void NewShard(size_t capacity, bool strict_capacity_limit = true,
+                size_t estimated_value_size = 1,
+                CacheMetadataChargePolicy metadata_charge_policy =
+                    kDontChargeCacheMetadata) {
     DeleteShard();
     shard_ =
         reinterpret_cast<Shard*>(port::cacheline_aligned_alloc(sizeof(Shard)));
 
     Table::Opts opts;
-    opts.estimated_value_size = 1;
-    new (shard_) Shard(capacity, strict_capacity_limit,
-                       kDontChargeCacheMetadata, /*allocator*/ nullptr, opts);
+    opts.estimated_value_size = estimated_value_size;
+    new (shard_) Shard(capacity, strict_capacity_limit, metadata_charge_policy,
+                       /*allocator*/ nullptr, opts);
   }
 
   Status Insert(const UniqueId64x2& hashed_key,
@@ -838,6 +1023,132 @@ TEST_F(ClockCacheTest, CollidingInsertEraseTest) {
   ASSERT_EQ(nullptr, tmp_h);
 }
 
+TEST_F(ClockCacheTest, GrowableTableTest) {
+  constexpr size_t kCapacity = 1 << 20;
+  // Much smaller than the initial assumption
+  constexpr size_t kCharge = 512;
+  constexpr size_t kCount = kCapacity / kCharge;
+  NewShard(kCapacity, /*strict_capacity_limit*/ false,
+           /*estimated_value_size*/ 0);
+  const size_t initial_table_size = shard_->GetTableAddressCount();
+  ASSERT_LT(initial_table_size * kLoadFactor, kCount);
+  ASSERT_GE(shard_->GetMaxTableAddressCount() * kLoadFactor, kCount);
+
+  Random64 rnd(301);
+  std::vector<UniqueId64x2> hkeys(kCount);
+  std::vector<HandleImpl*> handles;
+  DeleteCounter val;
+  for (size_t i = 0; i < kCount; ++i) {
+    hkeys[i] = {rnd.Next(), rnd.Next()};
+    // Keep some entries of every table size referenced
+    HandleImpl* h = nullptr;
+    ASSERT_OK(shard_->Insert(TestKey(hkeys[i]), hkeys[i], &val,
+                             &kDeleteCounterHelper, kCharge,
+                             i % 100 == 0 ? &h : nullptr,
+                             Cache::Priority::LOW));
+    if (h) {
+      handles.push_back(h);
+    }
+  }
+  // The table grew instead of evicting
+  EXPECT_GT(shard_->GetTableAddressCount(), initial_table_size);
+  EXPECT_EQ(shard_->GetOccupancyCount(), kCount);
+  EXPECT_EQ(shard_->GetUsage(), kCapacity);
+  EXPECT_EQ(val.deleted, 0);
+  for (size_t i = 0; i < kCount; ++i) {
+    ASSERT_TRUE(Lookup(hkeys[i])) << i;
+  }
+
+  // Erase entries inserted with all the table sizes
+  for (size_t i = 0; i < kCount; i += 2) {
+    shard_->Erase(TestKey(hkeys[i]), hkeys[i]);
+  }
+  for (size_t i = 0; i < kCount; ++i) {
+    ASSERT_EQ(Lookup(hkeys[i]), i % 2 == 1) << i;
+  }
+  for (HandleImpl* h : handles) {
+    shard_->Release(h);
+  }
+  EXPECT_EQ(val.deleted, kCount / 2);
+  EXPECT_EQ(shard_->GetOccupancyCount(), kCount / 2);
+
+  // Once at capacity, entries are evicted rather than growing the table
+  const size_t table_size = shard_->GetTableAddressCount();
+  for (size_t i = 0; i < kCount; ++i) {
+    UniqueId64x2 hkey = {rnd.Next(), rnd.Next()};
+    ASSERT_OK(shard_->Insert(TestKey(hkey), hkey, &val, &kDeleteCounterHelper,
+                             kCharge, nullptr, Cache::Priority::LOW));
+    ASSERT_TRUE(Lookup(hkey));
+  }
+  EXPECT_EQ(shard_->GetTableAddressCount(), table_size);
+  EXPECT_LE(shard_->GetUsage(), kCapacity);
+  EXPECT_GT(val.deleted, kCount / 2);
+
+  shard_->EraseUnRefEntries();
+  EXPECT_EQ(shard_->GetOccupancyCount(), 0U);
+  EXPECT_EQ(shard_->GetUsage(), 0U);
+  EXPECT_EQ(val.deleted, 2 * kCount);
+}
+
+TEST_F(ClockCacheTest, GrowableTableMetadataChargeTest) {
+  constexpr size_t kCapacity = 1 << 20;
+  NewShard(kCapacity, /*strict_capacity_limit*/ false,
+           /*estimated_value_size*/ 0, kFullChargeCacheMetadata);
+  const size_t initial_table_size = shard_->GetTableAddressCount();
+  EXPECT_EQ(shard_->GetUsage(), initial_table_size * sizeof(HandleImpl));
+
+  Random64 rnd(301);
+  for (size_t i = 0; i < kCapacity / 512; ++i) {
+    UniqueId64x2 hkey = {rnd.Next(), rnd.Next()};
+    ASSERT_OK(shard_->Insert(TestKey(hkey), hkey, nullptr /*value*/,
+                             &kNoopCacheItemHelper, 512, nullptr,
+                             Cache::Priority::LOW));
+  }
+  EXPECT_GT(shard_->GetTableAddressCount(), initial_table_size);
+  // The grown slots are charged
+  EXPECT_LE(shard_->GetUsage(), kCapacity);
+  shard_->EraseUnRefEntries();
+  EXPECT_EQ(shard_->GetUsage(),
+            shard_->GetTableAddressCount() * sizeof(HandleImpl));
+}
+
+TEST_F(ClockCacheTest, GrowableTableConcurrentTest) {
+  constexpr size_t kCapacity = 4 << 20;
+  constexpr int kThreads = 4;
+  constexpr size_t kPerThread = 2000;
+  NewShard(kCapacity, /*strict_capacity_limit*/ false,
+           /*estimated_value_size*/ 0);
+  const size_t initial_table_size = shard_->GetTableAddressCount();
+
+  // Entries are found right after being inserted while the table grows
+  std::atomic<size_t> not_found{0};
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      Random64 rnd(t);
+      std::vector<UniqueId64x2> hkeys;
+      for (size_t i = 0; i < kPerThread; ++i) {
+        hkeys.push_back({rnd.Next(), rnd.Next()});
+        shard_->Insert(TestKey(hkeys.back()), hkeys.back(), nullptr /*value*/,
+                       &kNoopCacheItemHelper, 256, nullptr,
+                       Cache::Priority::LOW)
+            .PermitUncheckedError();
+        for (size_t j = i % 16; j <= i; j += 16) {
+          if (!Lookup(hkeys[j])) {
+            not_found.fetch_add(1);
+          }
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(not_found.load(), 0U);
+  EXPECT_GT(shard_->GetTableAddressCount(), initial_table_size);
+  EXPECT_EQ(shard_->GetOccupancyCount(), kThreads * kPerThread);
+}
+
 // This uses the public API to effectively test CalcHashBits etc.
 TEST_F(ClockCacheTest, TableSizesTest) {
   for (size_t est_val_size : {1U, 5U, 123U, 2345U, 345678U}) {
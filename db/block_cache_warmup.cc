@@ -0,0 +1,168 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/block_cache_warmup.h"
+
+#include <algorithm>
+
+#include "file/filename.h"
+#include "test_util/sync_point.h"
+#include "util/coding.h"
+#include "util/crc32c.h"
+#include "util/hash.h"
+#include "util/mutexlock.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+constexpr uint64_t kHotBlocksFileMagic = 0x736b636f6c62746fULL;
+}  // namespace
+
+size_t HotBlockCounter::KeyHash::operator()(const Key& key) const {
+  char buf[16];
+  EncodeFixed64(buf, key.file_number);
+  EncodeFixed64(buf + 8, key.offset);
+  return static_cast<size_t>(Hash64(buf, sizeof(buf)));
+}
+
+HotBlockCounter::HotBlockCounter(size_t max_blocks)
+    : max_blocks_(max_blocks),
+      max_blocks_per_shard_(max_blocks * 4 / kNumShards + 1) {
+  TEST_SYNC_POINT_CALLBACK("HotBlockCounter::HotBlockCounter:SampleOneIn",
+                           &sample_one_in_);
+}
+
+bool HotBlockCounter::ShouldSample() const {
+  return Random::GetTLSInstance()->OneIn(sample_one_in_);
+}
+
+void HotBlockCounter::Record(uint64_t file_number, uint64_t offset,
+                             uint64_t size, uint32_t count) {
+  Key key{file_number, offset};
+  size_t hash = KeyHash()(key);
+  Shard& shard = shards_[(hash >> 32) % kNumShards];
+  MutexLock l(&shard.mutex);
+  auto it = shard.blocks.find(key);
+  if (it != shard.blocks.end()) {
+    it->second.count += count;
+  } else if (shard.blocks.size() < max_blocks_per_shard_) {
+    // Once full, new blocks have to wait for Decay() to make room
+    shard.blocks.emplace(key, Value{size, count});
+  }
+}
+
+std::vector<HotBlock> HotBlockCounter::GetHotBlocks() const {
+  std::vector<HotBlock> blocks;
+  for (const Shard& shard : shards_) {
+    MutexLock l(&shard.mutex);
+    for (const auto& entry : shard.blocks) {
+      blocks.push_back(HotBlock{entry.first.file_number, entry.first.offset,
+                                entry.second.size, entry.second.count});
+    }
+  }
+  auto hotter = [](const HotBlock& a, const HotBlock& b) {
+    return a.count > b.count;
+  };
+  if (blocks.size() > max_blocks_) {
+    std::nth_element(blocks.begin(), blocks.begin() + max_blocks_,
+                     blocks.end(), hotter);
+    blocks.resize(max_blocks_);
+  }
+  std::sort(blocks.begin(), blocks.end(), hotter);
+  return blocks;
+}
+
+void HotBlockCounter::Decay() {
+  for (Shard& shard : shards_) {
+    MutexLock l(&shard.mutex);
+    for (auto it = shard.blocks.begin(); it != shard.blocks.end();) {
+      it->second.count /= 2;
+      if (it->second.count == 0) {
+        it = shard.blocks.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
+// File format:
+//   fixed64: magic
+//   varint64: number of blocks
+//   for each block: varint64 file number, varint64 offset, varint64 size,
+//                   varint32 count
+//   fixed32: masked crc32c of the above
+Status WriteHotBlocksFile(FileSystem* fs, const std::string& dbname,
+                          const std::vector<HotBlock>& blocks) {
+  std::string data;
+  PutFixed64(&data, kHotBlocksFileMagic);
+  PutVarint64(&data, blocks.size());
+  for (const HotBlock& block : blocks) {
+    PutVarint64Varint64(&data, block.file_number, block.offset);
+    PutVarint64(&data, block.size);
+    PutVarint32(&data, block.count);
+  }
+  PutFixed32(&data, crc32c::Mask(crc32c::Value(data.data(), data.size())));
+
+  // Replace the file atomically
+  const std::string fname = HotBlocksFileName(dbname);
+  const std::string tmp = fname + "." + kTempFileNameSuffix;
+  Status s = WriteStringToFile(fs, data, tmp, /*should_sync=*/true);
+  if (s.ok()) {
+    s = fs->RenameFile(tmp, fname, IOOptions(), nullptr);
+  }
+  if (!s.ok()) {
+    fs->DeleteFile(tmp, IOOptions(), nullptr).PermitUncheckedError();
+  }
+  return s;
+}
+
+Status ReadHotBlocksFile(FileSystem* fs, const std::string& dbname,
+                         std::vector<HotBlock>* blocks) {
+  const std::string fname = HotBlocksFileName(dbname);
+  std::string data;
+  Status s = ReadFileToString(fs, fname, &data);
+  if (!s.ok()) {
+    return s;
+  }
+  if (data.size() < 12 || DecodeFixed64(data.data()) != kHotBlocksFileMagic) {
+    return Status::Corruption("Not a hot blocks file", fname);
+  }
+  const size_t body_size = data.size() - 4;
+  if (crc32c::Unmask(DecodeFixed32(data.data() + body_size)) !=
+      crc32c::Value(data.data(), body_size)) {
+    return Status::Corruption("Hot blocks file checksum mismatch", fname);
+  }
+  Slice input(data.data() + 8, body_size - 8);
+  uint64_t num_blocks;
+  if (!GetVarint64(&input, &num_blocks)) {
+    return Status::Corruption("Truncated hot blocks file", fname);
+  }
+  blocks->clear();
+  for (uint64_t i = 0; i < num_blocks; ++i) {
+    HotBlock block;
+    if (!GetVarint64(&input, &block.file_number) ||
+        !GetVarint64(&input, &block.offset) ||
+        !GetVarint64(&input, &block.size) ||
+        !GetVarint32(&input, &block.count)) {
+      return Status::Corruption("Truncated hot blocks file", fname);
+    }
+    blocks->push_back(block);
+  }
+  return Status::OK();
+}
+
+void BlockCacheWarmupState::GetProgress(
+    BlockCacheWarmupProgress* progress) const {
+  progress->total_blocks = total_blocks.load(std::memory_order_relaxed);
+  progress->loaded_blocks = loaded_blocks.load(std::memory_order_relaxed);
+  progress->loaded_bytes = loaded_bytes.load(std::memory_order_relaxed);
+  progress->skipped_blocks = skipped_blocks.load(std::memory_order_relaxed);
+  progress->cancelled = cancelled.load(std::memory_order_relaxed);
+  progress->done = done.load(std::memory_order_acquire);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
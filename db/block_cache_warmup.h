@@ -0,0 +1,104 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/db.h"
+#include "rocksdb/file_system.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A data block of a table file, and how often it was accessed
+struct HotBlock {
+  uint64_t file_number;
+  uint64_t offset;
+  // Without the block trailer, like BlockHandle::size()
+  uint64_t size;
+  uint32_t count;
+};
+
+// Approximate access counts of the data blocks of a DB, from a sample of the
+// accesses, for DBOptions::hot_block_persist_period_sec. Counts are halved
+// by Decay(), so that blocks that stopped being read drop out over time.
+class HotBlockCounter {
+ public:
+  // Tracks up to a few times `max_blocks` blocks
+  explicit HotBlockCounter(size_t max_blocks);
+
+  // Whether the current access should be recorded. Cheap enough for every
+  // block read.
+  bool ShouldSample() const;
+
+  void Record(uint64_t file_number, uint64_t offset, uint64_t size,
+              uint32_t count = 1);
+
+  // The up to `max_blocks` blocks with the highest counts, highest first
+  std::vector<HotBlock> GetHotBlocks() const;
+
+  // Halves all counts, forgetting blocks down to 0
+  void Decay();
+
+ private:
+  static constexpr size_t kNumShards = 16;
+
+  struct Key {
+    uint64_t file_number;
+    uint64_t offset;
+    bool operator==(const Key& other) const {
+      return file_number == other.file_number && offset == other.offset;
+    }
+  };
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+  struct Value {
+    uint64_t size;
+    uint32_t count;
+  };
+  struct Shard {
+    mutable port::Mutex mutex;
+    std::unordered_map<Key, Value, KeyHash> blocks;
+  };
+
+  const size_t max_blocks_;
+  const size_t max_blocks_per_shard_;
+  int sample_one_in_ = 16;
+  std::array<Shard, kNumShards> shards_;
+};
+
+// The HOT_BLOCKS file of a DB lists the blocks returned by
+// HotBlockCounter::GetHotBlocks(), hottest first.
+Status WriteHotBlocksFile(FileSystem* fs, const std::string& dbname,
+                          const std::vector<HotBlock>& blocks);
+// Returns NotFound if there is no such file
+Status ReadHotBlocksFile(FileSystem* fs, const std::string& dbname,
+                         std::vector<HotBlock>* blocks);
+
+// The state of the warm-up of the block caches of a DB on open, see
+// DBOptions::warm_block_cache_on_open
+struct BlockCacheWarmupState {
+  std::atomic<uint64_t> total_blocks{0};
+  std::atomic<uint64_t> loaded_blocks{0};
+  std::atomic<uint64_t> loaded_bytes{0};
+  std::atomic<uint64_t> skipped_blocks{0};
+  std::atomic<bool> done{false};
+  // Requests the warm-up to stop
+  std::atomic<bool> cancel{false};
+  // Whether the warm-up stopped before going through all the blocks
+  std::atomic<bool> cancelled{false};
+
+  void GetProgress(BlockCacheWarmupProgress* progress) const;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -1383,6 +1383,12 @@ Status ColumnFamilyData::ValidateOptions(
     s = Status::InvalidArgument(
         "max_successive_merges > 0 is incompatible with unordered_write");
   }
+  if (s.ok() && db_options.write_queue_shards > 1 &&
+      cf_options.max_successive_merges != 0) {
+    s = Status::InvalidArgument(
+        "max_successive_merges > 0 is incompatible with write_queue_shards > "
+        "1");
+  }
   if (s.ok()) {
     s = CheckCFPathsSupported(db_options, cf_options);
   }
@@ -1117,6 +1117,51 @@ TEST_F(DBBasicTest, MmapAndBufferOptions) {
   options.use_direct_reads = false;
   ASSERT_OK(TryReopen(options));
 }
+
+TEST_F(DBBasicTest, PinMmapValues) {
+  if (!IsMemoryMappedAccessSupported()) {
+    return;
+  }
+  Options options = CurrentOptions();
+  options.allow_mmap_reads = true;
+  options.compression = kNoCompression;
+  // Tables are immortal with unlimited open files
+  options.max_open_files = 100;
+  options.statistics = CreateDBStatistics();
+  Reopen(options);
+
+  ASSERT_OK(Put("foo", "bar"));
+  ASSERT_OK(Flush());
+
+  ReadOptions ro;
+  PinnableSlice value;
+  ASSERT_OK(db_->Get(ro, db_->DefaultColumnFamily(), "foo", &value));
+  ASSERT_EQ(value, "bar");
+  ASSERT_FALSE(value.IsPinned());
+  ASSERT_EQ(1, TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+  value.Reset();
+
+  ro.pin_mmap_values = true;
+  ASSERT_OK(db_->Get(ro, db_->DefaultColumnFamily(), "foo", &value));
+  ASSERT_EQ(value, "bar");
+  ASSERT_TRUE(value.IsPinned());
+  // Served from the mapped file without looking up the block cache
+  ASSERT_EQ(1, TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+  ASSERT_EQ(0, TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD));
+
+  // The value keeps the table reader alive after its file is compacted away
+  ASSERT_OK(Put("foo", "baz"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  ASSERT_EQ(value, "bar");
+  value.Reset();
+
+  ASSERT_OK(db_->Get(ro, db_->DefaultColumnFamily(), "foo", &value));
+  ASSERT_EQ(value, "baz");
+  ASSERT_TRUE(value.IsPinned());
+  value.Reset();
+}
 #endif
 
 class TestEnv : public EnvWrapper {
@@ -2150,6 +2195,69 @@ TEST_P(DBMultiGetTestWithParam, MultiGetBatchedValueSizeMultiLevelMerge) {
 INSTANTIATE_TEST_CASE_P(DBMultiGetTestWithParam, DBMultiGetTestWithParam,
                         testing::Combine(testing::Bool(), testing::Bool()));
 
+#ifndef USE_COROUTINES
+TEST_F(DBBasicTest, MultiGetAsyncIOWithoutCoroutines) {
+  std::shared_ptr<Statistics> statistics = CreateDBStatistics();
+  BlockBasedTableOptions bbto;
+  bbto.filter_policy.reset(NewBloomFilterPolicy(10));
+  bbto.block_cache = NewLRUCache(8 << 20);
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.statistics = statistics;
+  options.table_factory.reset(NewBlockBasedTableFactory(bbto));
+  Reopen(options);
+
+  for (int i = 0; i < 256; ++i) {
+    ASSERT_OK(Put(Key(i), "val_" + std::to_string(i)));
+    if (i % 8 == 7) {
+      ASSERT_OK(Flush());
+    }
+  }
+  MoveFilesToLevel(1);
+
+  std::vector<std::string> key_strs{Key(33), Key(54), Key(102), Key(300)};
+  std::vector<Slice> keys(key_strs.begin(), key_strs.end());
+  ReadOptions ro;
+  ro.async_io = true;
+  for (int iter = 0; iter < 2; ++iter) {
+    std::vector<PinnableSlice> values(keys.size());
+    std::vector<Status> statuses(keys.size());
+    dbfull()->MultiGet(ro, dbfull()->DefaultColumnFamily(), keys.size(),
+                       keys.data(), values.data(), statuses.data());
+    ASSERT_OK(statuses[0]);
+    ASSERT_OK(statuses[1]);
+    ASSERT_OK(statuses[2]);
+    ASSERT_TRUE(statuses[3].IsNotFound());
+    ASSERT_EQ(values[0], "val_33");
+    ASSERT_EQ(values[1], "val_54");
+    ASSERT_EQ(values[2], "val_102");
+
+    // The data blocks of the 3 files were read in a single batch, and were
+    // cached for the second MultiGet
+    HistogramData multiget_io_batch_size;
+    statistics->histogramData(MULTIGET_IO_BATCH_SIZE, &multiget_io_batch_size);
+    ASSERT_EQ(multiget_io_batch_size.count, 1);
+    ASSERT_EQ(multiget_io_batch_size.max, 3);
+  }
+
+  // Blocks are not prefetched if they could not be cached
+  ro.fill_cache = false;
+  bbto.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(bbto));
+  Reopen(options);
+  ASSERT_OK(options.statistics->Reset());
+  std::vector<PinnableSlice> values(keys.size());
+  std::vector<Status> statuses(keys.size());
+  dbfull()->MultiGet(ro, dbfull()->DefaultColumnFamily(), keys.size(),
+                     keys.data(), values.data(), statuses.data());
+  ASSERT_OK(statuses[0]);
+  ASSERT_EQ(values[2], "val_102");
+  HistogramData multiget_io_batch_size;
+  statistics->histogramData(MULTIGET_IO_BATCH_SIZE, &multiget_io_batch_size);
+  ASSERT_EQ(multiget_io_batch_size.count, 3);
+}
+#endif  // USE_COROUTINES
+
 #if USE_COROUTINES
 class DBMultiGetAsyncIOTest : public DBBasicTest,
                               public ::testing::WithParamInterface<bool> {
@@ -19,6 +19,7 @@
 #include "db/db_impl/db_impl.h"
 #include "db/db_test_util.h"
 #include "env/unique_id_gen.h"
+#include "file/filename.h"
 #include "port/stack_trace.h"
 #include "rocksdb/persistent_cache.h"
 #include "rocksdb/statistics.h"
@@ -808,6 +809,136 @@ TEST_F(DBBlockCacheTest, DynamicallyWarmCacheDuringFlush) {
               options.statistics->getAndResetTickerCount(BLOCK_CACHE_DATA_HIT));
   }
 }
+
+TEST_F(DBBlockCacheTest, WarmUpHotBlocksOnOpen) {
+  SyncPoint::GetInstance()->SetCallBack(
+      "HotBlockCounter::HotBlockCounter:SampleOneIn",
+      [](void* arg) { *static_cast<int*>(arg) = 1; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  // Only written when closing
+  options.hot_block_persist_period_sec = 3600;
+  options.disable_auto_compactions = true;
+
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+  table_options.cache_index_and_filter_blocks = false;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // A file, and a data block, per key
+  std::string value(kValueSize, 'a');
+  for (size_t i = 1; i <= kNumBlocks; i++) {
+    ASSERT_OK(Put(std::to_string(i), value));
+    ASSERT_OK(Flush());
+  }
+  for (int round = 0; round < 3; round++) {
+    for (size_t i = 1; i <= 4; i++) {
+      ASSERT_EQ(value, Get(std::to_string(i)));
+    }
+  }
+  BlockCacheWarmupProgress progress;
+  ASSERT_TRUE(db_->GetBlockCacheWarmupProgress(&progress).IsNotSupported());
+  Close();
+  ASSERT_OK(env_->FileExists(HotBlocksFileName(dbname_)));
+
+  // With an empty cache
+  options.warm_block_cache_on_open = true;
+  table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+  do {
+    env_->SleepForMicroseconds(1000);
+    ASSERT_OK(db_->GetBlockCacheWarmupProgress(&progress));
+  } while (!progress.done);
+  ASSERT_FALSE(progress.cancelled);
+  ASSERT_EQ(4, progress.total_blocks);
+  ASSERT_EQ(4, progress.loaded_blocks);
+  ASSERT_EQ(0, progress.skipped_blocks);
+  ASSERT_GT(progress.loaded_bytes, 4 * kValueSize);
+
+  options.statistics->Reset();
+  for (size_t i = 1; i <= 4; i++) {
+    ASSERT_EQ(value, Get(std::to_string(i)));
+  }
+  ASSERT_EQ(4, options.statistics->getTickerCount(BLOCK_CACHE_DATA_HIT));
+  ASSERT_EQ(0, options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS));
+  ASSERT_EQ(value, Get(std::to_string(kNumBlocks)));
+  ASSERT_EQ(1, options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS));
+
+  // Blocks of files compacted away are skipped
+  CompactRangeOptions cro;
+  cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  Close();
+  table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  Reopen(options);
+  do {
+    env_->SleepForMicroseconds(1000);
+    ASSERT_OK(db_->GetBlockCacheWarmupProgress(&progress));
+  } while (!progress.done);
+  ASSERT_EQ(5, progress.total_blocks);
+  ASSERT_EQ(5, progress.skipped_blocks);
+  ASSERT_EQ(0, progress.loaded_blocks);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
+TEST_F(DBBlockCacheTest, CancelBlockCacheWarmup) {
+  SyncPoint::GetInstance()->SetCallBack(
+      "HotBlockCounter::HotBlockCounter:SampleOneIn",
+      [](void* arg) { *static_cast<int*>(arg) = 1; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.hot_block_persist_period_sec = 3600;
+  options.warm_block_cache_on_open = true;
+  options.disable_auto_compactions = true;
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // Nothing to warm up yet
+  BlockCacheWarmupProgress progress;
+  ASSERT_OK(db_->GetBlockCacheWarmupProgress(&progress));
+  ASSERT_TRUE(progress.done);
+  ASSERT_EQ(0, progress.total_blocks);
+
+  std::string value(kValueSize, 'a');
+  for (size_t i = 1; i <= kNumBlocks; i++) {
+    ASSERT_OK(Put(std::to_string(i), value));
+    ASSERT_OK(Flush());
+    ASSERT_EQ(value, Get(std::to_string(i)));
+  }
+  Close();
+
+  SyncPoint::GetInstance()->LoadDependency(
+      {{"DBBlockCacheTest::CancelBlockCacheWarmup:Cancelled",
+        "DBImpl::WarmUpBlockCache:Batch"}});
+  table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+  ASSERT_OK(db_->CancelBlockCacheWarmup());
+  TEST_SYNC_POINT("DBBlockCacheTest::CancelBlockCacheWarmup:Cancelled");
+  do {
+    env_->SleepForMicroseconds(1000);
+    ASSERT_OK(db_->GetBlockCacheWarmupProgress(&progress));
+  } while (!progress.done);
+  ASSERT_TRUE(progress.cancelled);
+  ASSERT_EQ(kNumBlocks, progress.total_blocks);
+  ASSERT_EQ(0, progress.loaded_blocks);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
 #endif
 
 namespace {
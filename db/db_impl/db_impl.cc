@@ -26,6 +26,7 @@
 #include <vector>
 
 #include "db/arena_wrapped_db_iter.h"
+#include "db/block_cache_warmup.h"
 #include "db/builder.h"
 #include "db/compaction/compaction_job.h"
 #include "db/db_info_dumper.h"
@@ -36,6 +37,7 @@
 #include "db/external_sst_file_ingestion_job.h"
 #include "db/flush_job.h"
 #include "db/forward_iterator.h"
+#include "db/hot_key_cache.h"
 #include "db/import_column_family_job.h"
 #include "db/job_context.h"
 #include "db/log_reader.h"
@@ -78,6 +80,7 @@
 #include "rocksdb/db.h"
 #include "rocksdb/env.h"
 #include "rocksdb/merge_operator.h"
+#include "rocksdb/rate_limiter.h"
 #include "rocksdb/statistics.h"
 #include "rocksdb/stats_history.h"
 #include "rocksdb/status.h"
@@ -86,6 +89,7 @@
 #include "rocksdb/write_buffer_manager.h"
 #include "table/block_based/block.h"
 #include "table/block_based/block_based_table_factory.h"
+#include "table/block_based/block_based_table_reader.h"
 #include "table/get_context.h"
 #include "table/merging_iterator.h"
 #include "table/multiget_context.h"
@@ -275,6 +279,8 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
   periodic_task_functions_.emplace(
       PeriodicTaskType::kRecordSeqnoTime,
       [this]() { this->RecordSeqnoToTimeMapping(); });
+  periodic_task_functions_.emplace(PeriodicTaskType::kPersistHotBlocks,
+                                   [this]() { this->PersistHotBlocks(); });
 #endif  // ROCKSDB_LITE
 
   versions_.reset(new VersionSet(dbname_, &immutable_db_options_, file_options_,
@@ -284,6 +290,21 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
   column_family_memtables_.reset(
       new ColumnFamilyMemTablesImpl(versions_->GetColumnFamilySet()));
 
+  // Entries are invalidated before writes become visible, which does not
+  // hold with unordered writes or with writes of prepared transactions.
+  if (immutable_db_options_.hot_key_cache != nullptr &&
+      !immutable_db_options_.unordered_write && !seq_per_batch_) {
+    hot_key_cache_.reset(
+        new HotKeyCache(immutable_db_options_.hot_key_cache, stats_));
+  }
+
+  if (immutable_db_options_.write_queue_shards > 1) {
+    for (size_t i = 1; i < immutable_db_options_.write_queue_shards; ++i) {
+      write_queue_shards_.emplace_back(new WriteThread(immutable_db_options_));
+    }
+    write_thread_.SetUnbatchedGate(&write_queue_shard_gate_);
+  }
+
   DumpRocksDBBuildVersion(immutable_db_options_.info_log.get());
   DumpDBFileSummary(immutable_db_options_, dbname_, db_session_id_);
   immutable_db_options_.Dump(immutable_db_options_.info_log.get());
@@ -574,6 +595,9 @@ Status DBImpl::CloseHelper() {
   // (to consider: moving all the waiting into CancelAllBackgroundWork(true))
   CancelAllBackgroundWork(false);
 
+  // After the periodic tasks, so that nothing else writes the file
+  StopHotBlockTracking();
+
   // Cancel manual compaction if there's any
   if (HasPendingManualCompaction()) {
     DisableManualCompaction();
@@ -2017,6 +2041,34 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
     }
   }
 
+  // Only plain reads of values at the latest sequence number are cached
+  const bool use_hot_key_cache =
+      hot_key_cache_ != nullptr && get_impl_options.value != nullptr &&
+      get_impl_options.get_value && get_impl_options.callback == nullptr &&
+      get_impl_options.value_found == nullptr &&
+      get_impl_options.is_blob_index == nullptr &&
+      read_options.snapshot == nullptr && read_options.timestamp == nullptr &&
+      read_options.read_tier == kReadAllTier &&
+      !read_options.ignore_range_deletions && HotKeyCache::Supports(*cfd);
+  uint64_t hot_key_epoch = 0;
+  if (use_hot_key_cache) {
+    // Before the SuperVersion, so that the read does not see files changed
+    // after the epoch
+    hot_key_epoch = hot_key_cache_->GetEpoch(cfd->GetID());
+    Status s;
+    if (hot_key_cache_->Lookup(cfd->GetID(), key, GetLastPublishedSequence(),
+                               get_impl_options.value, &s)) {
+      RecordTick(stats_, NUMBER_KEYS_READ);
+      size_t size = s.ok() ? get_impl_options.value->size() : 0;
+      if (s.ok()) {
+        RecordTick(stats_, BYTES_READ, size);
+        PERF_COUNTER_ADD(get_read_bytes, size);
+      }
+      RecordInHistogram(stats_, BYTES_PER_READ, size);
+      return s;
+    }
+  }
+
   // Acquire SuperVersion
   SuperVersion* sv = GetAndRefSuperVersion(cfd);
 
@@ -2144,6 +2196,10 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
     }
     if (!done && !s.ok() && !s.IsMergeInProgress()) {
       ReturnAndCleanupSuperVersion(cfd, sv);
+      if (use_hot_key_cache) {
+        hot_key_cache_->Insert(cfd->GetID(), key, snapshot, hot_key_epoch, s,
+                               Slice());
+      }
       return s;
     }
   }
@@ -2249,6 +2305,10 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
 
     RecordInHistogram(stats_, BYTES_PER_READ, size);
   }
+  if (use_hot_key_cache) {
+    hot_key_cache_->Insert(cfd->GetID(), key, snapshot, hot_key_epoch, s,
+                           *get_impl_options.value);
+  }
   return s;
 }
 
@@ -4254,6 +4314,9 @@ Status DBImpl::DeleteFile(std::string name) {
       InstallSuperVersionAndScheduleWork(cfd,
                                          &job_context.superversion_contexts[0],
                                          *cfd->GetLatestMutableCFOptions());
+      if (hot_key_cache_ != nullptr) {
+        hot_key_cache_->BumpEpoch(cfd->GetID());
+      }
     }
     FindObsoleteFiles(&job_context, false);
   }  // lock released here
@@ -4341,6 +4404,9 @@ Status DBImpl::DeleteFilesInRanges(ColumnFamilyHandle* column_family,
       InstallSuperVersionAndScheduleWork(cfd,
                                          &job_context.superversion_contexts[0],
                                          *cfd->GetLatestMutableCFOptions());
+      if (hot_key_cache_ != nullptr) {
+        hot_key_cache_->BumpEpoch(cfd->GetID());
+      }
     }
     for (auto* deleted_file : deleted_files) {
       deleted_file->being_compacted = false;
@@ -4651,6 +4717,8 @@ Status DestroyDB(const std::string& dbname, const Options& options,
         }
       }
     }
+    // Not a file ParseFileName() recognizes, and might not exist
+    env->DeleteFile(HotBlocksFileName(dbname)).PermitUncheckedError();
 
     std::set<std::string> paths;
     for (const DbPath& db_path : options.db_paths) {
@@ -5401,6 +5469,9 @@ Status DBImpl::IngestExternalFiles(
         if (!cfd->IsDropped()) {
           InstallSuperVersionAndScheduleWork(cfd, &sv_ctxs[i],
                                              *cfd->GetLatestMutableCFOptions());
+          if (hot_key_cache_ != nullptr) {
+            hot_key_cache_->BumpEpoch(cfd->GetID());
+          }
 #ifndef NDEBUG
           if (0 == i && num_cfs > 1) {
             TEST_SYNC_POINT(
@@ -5926,4 +5997,244 @@ void DBImpl::RecordSeqnoToTimeMapping() {
 }
 #endif  // ROCKSDB_LITE
 
+void DBImpl::PersistHotBlocks() {
+  if (hot_block_counter_ == nullptr) {
+    return;
+  }
+  std::vector<HotBlock> blocks = hot_block_counter_->GetHotBlocks();
+  // Make room for the blocks that became hot since
+  hot_block_counter_->Decay();
+  if (blocks.empty()) {
+    return;
+  }
+  Status s = WriteHotBlocksFile(fs_.get(), dbname_, blocks);
+  if (!s.ok()) {
+    ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                   "Failed to write hot blocks file: %s",
+                   s.ToString().c_str());
+  }
+}
+
+void DBImpl::StartHotBlockTracking() {
+  if (immutable_db_options_.hot_block_persist_period_sec > 0) {
+    hot_block_counter_.reset(
+        new HotBlockCounter(immutable_db_options_.max_hot_blocks));
+    block_cache_tracer_.SetHotBlockCounter(hot_block_counter_.get());
+#ifndef ROCKSDB_LITE
+    Status s = periodic_task_scheduler_.Register(
+        PeriodicTaskType::kPersistHotBlocks,
+        periodic_task_functions_.at(PeriodicTaskType::kPersistHotBlocks),
+        immutable_db_options_.hot_block_persist_period_sec);
+    if (!s.ok()) {
+      ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                     "Failed to schedule writing hot blocks: %s",
+                     s.ToString().c_str());
+    }
+#endif  // !ROCKSDB_LITE
+  }
+  if (!immutable_db_options_.warm_block_cache_on_open) {
+    return;
+  }
+
+  block_cache_warmup_.reset(new BlockCacheWarmupState());
+  std::vector<HotBlock> blocks;
+  Status s = ReadHotBlocksFile(fs_.get(), dbname_, &blocks);
+  if (!s.ok() && !s.IsNotFound()) {
+    ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                   "Failed to read hot blocks file: %s", s.ToString().c_str());
+  }
+  if (blocks.empty()) {
+    block_cache_warmup_->done.store(true, std::memory_order_release);
+    return;
+  }
+  // Blocks that were hot before still count, so that a restart does not
+  // lose them from the next file
+  if (hot_block_counter_ != nullptr) {
+    for (const HotBlock& block : blocks) {
+      hot_block_counter_->Record(block.file_number, block.offset, block.size,
+                                 block.count);
+    }
+  }
+  block_cache_warmup_->total_blocks.store(blocks.size(),
+                                          std::memory_order_relaxed);
+  ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                 "Warming up the block cache with %" ROCKSDB_PRIszt " blocks",
+                 blocks.size());
+  block_cache_warmup_thread_ =
+      port::Thread([this, b = std::move(blocks)]() mutable {
+        WarmUpBlockCache(std::move(b));
+      });
+}
+
+void DBImpl::WarmUpBlockCache(std::vector<HotBlock> blocks) {
+  BlockCacheWarmupState& state = *block_cache_warmup_;
+  auto should_stop = [&]() {
+    return state.cancel.load(std::memory_order_relaxed) ||
+           shutting_down_.load(std::memory_order_acquire);
+  };
+  std::unique_ptr<RateLimiter> rate_limiter;
+  if (immutable_db_options_.block_cache_warmup_bytes_per_sec > 0) {
+    rate_limiter.reset(NewGenericRateLimiter(static_cast<int64_t>(
+        immutable_db_options_.block_cache_warmup_bytes_per_sec)));
+  }
+  ReadOptions read_options;
+  read_options.rate_limiter_priority = Env::IO_LOW;
+
+  // In batches, hottest first, so that the hottest blocks are cached soonest
+  // while each batch reads nearby blocks of a file together
+  constexpr size_t kBatchSize = 64;
+  for (size_t begin = 0; begin < blocks.size(); begin += kBatchSize) {
+    TEST_SYNC_POINT("DBImpl::WarmUpBlockCache:Batch");
+    if (should_stop()) {
+      break;
+    }
+    const auto batch_begin = blocks.begin() + begin;
+    const auto batch_end = blocks.begin() + std::min(begin + kBatchSize,
+                                                     blocks.size());
+    std::sort(batch_begin, batch_end,
+              [](const HotBlock& a, const HotBlock& b) {
+                return a.file_number != b.file_number
+                           ? a.file_number < b.file_number
+                           : a.offset < b.offset;
+              });
+
+    if (rate_limiter) {
+      int64_t bytes = 0;
+      for (auto it = batch_begin; it != batch_end; ++it) {
+        bytes += static_cast<int64_t>(it->size +
+                                      BlockBasedTable::kBlockTrailerSize);
+      }
+      while (bytes > 0 && !should_stop()) {
+        const int64_t request =
+            std::min(bytes, rate_limiter->GetSingleBurstBytes());
+        rate_limiter->Request(request, Env::IO_LOW, nullptr /* stats */,
+                              RateLimiter::OpType::kRead);
+        bytes -= request;
+      }
+    }
+
+    // The files of the blocks, if still in the DB
+    std::vector<ColumnFamilyData*> cfd_list;
+    {
+      InstrumentedMutexLock l(&mutex_);
+      for (auto cfd : *versions_->GetColumnFamilySet()) {
+        if (!cfd->IsDropped() && cfd->initialized()) {
+          cfd->Ref();
+          cfd_list.push_back(cfd);
+        }
+      }
+    }
+    std::vector<SuperVersion*> sv_list;
+    std::unordered_map<uint64_t, std::pair<SuperVersion*, FileMetaData*>>
+        files;
+    for (auto cfd : cfd_list) {
+      SuperVersion* sv = cfd->GetReferencedSuperVersion(this);
+      sv_list.push_back(sv);
+      VersionStorageInfo* vstorage = sv->current->storage_info();
+      for (int level = 0; level < vstorage->num_non_empty_levels(); ++level) {
+        for (FileMetaData* meta : vstorage->LevelFiles(level)) {
+          files.emplace(meta->fd.GetNumber(), std::make_pair(sv, meta));
+        }
+      }
+    }
+
+    std::vector<BlockHandle> handles;
+    for (auto file_begin = batch_begin; file_begin != batch_end;) {
+      auto file_end = file_begin;
+      handles.clear();
+      while (file_end != batch_end &&
+             file_end->file_number == file_begin->file_number) {
+        handles.emplace_back(file_end->offset, file_end->size);
+        ++file_end;
+      }
+      uint64_t loaded_blocks = 0;
+      uint64_t loaded_bytes = 0;
+      auto file = files.find(file_begin->file_number);
+      if (file != files.end() && !should_stop()) {
+        SuperVersion* sv = file->second.first;
+        ColumnFamilyData* cfd = sv->current->cfd();
+        cfd->table_cache()
+            ->WarmUpBlocks(read_options, cfd->internal_comparator(),
+                           *file->second.second, handles, &loaded_blocks,
+                           &loaded_bytes,
+                           sv->mutable_cf_options.prefix_extractor)
+            .PermitUncheckedError();
+      }
+      state.loaded_blocks.fetch_add(loaded_blocks, std::memory_order_relaxed);
+      state.loaded_bytes.fetch_add(loaded_bytes, std::memory_order_relaxed);
+      state.skipped_blocks.fetch_add(handles.size() - loaded_blocks,
+                                     std::memory_order_relaxed);
+      file_begin = file_end;
+    }
+
+    bool defer_purge = immutable_db_options().avoid_unnecessary_blocking_io;
+    {
+      InstrumentedMutexLock l(&mutex_);
+      for (auto sv : sv_list) {
+        if (sv && sv->Unref()) {
+          sv->Cleanup();
+          if (defer_purge) {
+            AddSuperVersionsToFreeQueue(sv);
+          } else {
+            delete sv;
+          }
+        }
+      }
+      if (defer_purge) {
+        SchedulePurge();
+      }
+      for (auto cfd : cfd_list) {
+        cfd->UnrefAndTryDelete();
+      }
+    }
+  }
+
+  const BlockCacheWarmupProgress progress = [&]() {
+    BlockCacheWarmupProgress p;
+    state.GetProgress(&p);
+    return p;
+  }();
+  const bool cancelled =
+      progress.loaded_blocks + progress.skipped_blocks < progress.total_blocks;
+  state.cancelled.store(cancelled, std::memory_order_relaxed);
+  state.done.store(true, std::memory_order_release);
+  ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                 "Block cache warm-up %s: %" PRIu64 " blocks (%" PRIu64
+                 " bytes) loaded, %" PRIu64 " skipped",
+                 cancelled ? "cancelled" : "done", progress.loaded_blocks,
+                 progress.loaded_bytes, progress.skipped_blocks);
+}
+
+void DBImpl::StopHotBlockTracking() {
+  if (block_cache_warmup_ != nullptr) {
+    block_cache_warmup_->cancel.store(true, std::memory_order_relaxed);
+    if (block_cache_warmup_thread_.joinable()) {
+      block_cache_warmup_thread_.join();
+    }
+  }
+  if (hot_block_counter_ != nullptr) {
+    PersistHotBlocks();
+    block_cache_tracer_.SetHotBlockCounter(nullptr);
+  }
+}
+
+Status DBImpl::GetBlockCacheWarmupProgress(BlockCacheWarmupProgress* progress) {
+  if (progress == nullptr) {
+    return Status::InvalidArgument("progress must be non-null");
+  }
+  if (block_cache_warmup_ == nullptr) {
+    return Status::NotSupported("warm_block_cache_on_open is not set");
+  }
+  block_cache_warmup_->GetProgress(progress);
+  return Status::OK();
+}
+
+Status DBImpl::CancelBlockCacheWarmup() {
+  if (block_cache_warmup_ == nullptr) {
+    return Status::NotSupported("warm_block_cache_on_open is not set");
+  }
+  block_cache_warmup_->cancel.store(true, std::memory_order_relaxed);
+  return Status::OK();
+}
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -74,6 +74,10 @@ namespace ROCKSDB_NAMESPACE {
 
 class Arena;
 class ArenaWrappedDBIter;
+class HotKeyCache;
+class HotBlockCounter;
+struct HotBlock;
+struct BlockCacheWarmupState;
 class InMemoryStatsHistoryIterator;
 class MemTable;
 class PersistentStatsHistoryIterator;
@@ -556,6 +560,10 @@ class DBImpl : public DB {
                                 const std::string& fpath,
                                 const ReadOptions& read_options);
 
+  Status GetBlockCacheWarmupProgress(
+      BlockCacheWarmupProgress* progress) override;
+  Status CancelBlockCacheWarmup() override;
+
   using DB::StartTrace;
   virtual Status StartTrace(
       const TraceOptions& options,
@@ -1021,6 +1029,9 @@ class DBImpl : public DB {
 
   InstrumentedMutex* mutex() const { return &mutex_; }
 
+  // nullptr if DBOptions::hot_key_cache is not set or cannot be used
+  HotKeyCache* hot_key_cache() const { return hot_key_cache_.get(); }
+
   // Initialize a brand new DB. The DB directory is expected to be empty before
   // calling it. Push new manifest file name into `new_filenames`.
   Status NewDB(std::vector<std::string>* new_filenames);
@@ -1194,6 +1205,9 @@ class DBImpl : public DB {
   // record current sequence number to time mapping
   void RecordSeqnoToTimeMapping();
 
+  // write the most read blocks to the HOT_BLOCKS file
+  void PersistHotBlocks();
+
   // Interface to block and signal the DB in case of stalling writes by
   // WriteBufferManager. Each DBImpl object contains ptr to WBMStallInterface.
   // When DB needs to be blocked or signalled by WriteBufferManager,
@@ -1294,6 +1308,19 @@ class DBImpl : public DB {
   // table_cache_ provides its own synchronization
   std::shared_ptr<Cache> table_cache_;
 
+  // Invalidated by the writes themselves, so it provides its own
+  // synchronization
+  std::unique_ptr<HotKeyCache> hot_key_cache_;
+
+  // Counts the reads of data blocks if DBOptions::hot_block_persist_period_sec
+  // is set. Provides its own synchronization.
+  std::unique_ptr<HotBlockCounter> hot_block_counter_;
+
+  // Set if DB::Open() started a warm-up of the block cache, see
+  // DBOptions::warm_block_cache_on_open
+  std::unique_ptr<BlockCacheWarmupState> block_cache_warmup_;
+  port::Thread block_cache_warmup_thread_;
+
   ErrorHandler error_handler_;
 
   // Unified interface for logging events
@@ -1401,6 +1428,8 @@ class DBImpl : public DB {
   void NotifyOnMemTableSealed(ColumnFamilyData* cfd,
                               const MemTableInfo& mem_table_info);
 
+  void NotifyOnWalRecoveryCompleted(const WalRecoveryInfo& info);
+
 #ifndef ROCKSDB_LITE
   void NotifyOnExternalFileIngested(
       ColumnFamilyData* cfd, const ExternalSstFileIngestionJob& ingestion_job);
@@ -1443,6 +1472,24 @@ class DBImpl : public DB {
                             bool disable_memtable = false,
                             uint64_t* seq_used = nullptr);
 
+  // The write path when DBOptions::write_queue_shards > 1
+  Status ShardedWriteImpl(const WriteOptions& write_options,
+                          WriteBatch* my_batch, WriteCallback* callback,
+                          uint64_t* log_used, uint64_t log_ref,
+                          bool disable_memtable, uint64_t* seq_used,
+                          size_t batch_cnt,
+                          PreReleaseCallback* pre_release_callback,
+                          PostMemTableCallback* post_memtable_callback);
+
+  // Returns the write queue shard for the writers of the current CPU core
+  WriteThread* GetWriteQueueShard();
+
+  // Waits until all sequence numbers up to `first_sequence - 1` are visible
+  // and then makes the ones up to `last_sequence` visible, for the write
+  // groups of write queue shards to publish their sequence numbers in order.
+  void PublishShardedWriteSequence(SequenceNumber first_sequence,
+                                   SequenceNumber last_sequence);
+
   // Write only to memtables without joining any write queue
   Status UnorderedWriteMemtable(const WriteOptions& write_options,
                                 WriteBatch* my_batch, WriteCallback* callback,
@@ -1872,11 +1919,13 @@ class DBImpl : public DB {
 
   // num_bytes: for slowdown case, delay time is calculated based on
   //            `num_bytes` going through.
-  Status DelayWrite(uint64_t num_bytes, const WriteOptions& write_options);
+  // write_thread: the write queue the caller leads, to be stalled.
+  Status DelayWrite(uint64_t num_bytes, WriteThread& write_thread,
+                    const WriteOptions& write_options);
 
   // Begin stalling of writes when memory usage increases beyond a certain
   // threshold.
-  void WriteBufferManagerStallWrites();
+  void WriteBufferManagerStallWrites(WriteThread& write_thread);
 
   Status ThrottleLowPriWritesIfNeeded(const WriteOptions& write_options,
                                       WriteBatch* my_batch);
@@ -1981,7 +2030,12 @@ class DBImpl : public DB {
 
   // REQUIRES: mutex locked
   Status PreprocessWrite(const WriteOptions& write_options,
-                         LogContext* log_context, WriteContext* write_context);
+                         LogContext* log_context, WriteContext* write_context,
+                         WriteThread& write_thread);
+
+  // Whether PreprocessWrite() could have work to do, i.e. whether a write
+  // group of a write queue shard needs to enter it exclusively.
+  bool PreprocessWriteNeeded();
 
   // Merge write batches in the write group into merged_batch.
   // Returns OK if merge is successful.
@@ -2091,6 +2145,15 @@ class DBImpl : public DB {
 
   Status RegisterRecordSeqnoTimeWorker();
 
+  // Starts counting the reads of data blocks and warming up the block cache,
+  // as configured by the DBOptions. Called at the end of DB::Open().
+  void StartHotBlockTracking();
+  // Body of block_cache_warmup_thread_
+  void WarmUpBlockCache(std::vector<HotBlock> blocks);
+  // Stops the warm-up, waits for it, and writes the HOT_BLOCKS file a last
+  // time. Called when closing.
+  void StopHotBlockTracking();
+
   void PrintStatistics();
 
   size_t EstimateInMemoryStatsHistorySize() const;
@@ -2458,6 +2521,16 @@ class DBImpl : public DB {
   // in 2PC to batch the prepares separately from the serial commit.
   WriteThread nonmem_write_thread_;
 
+  // With DBOptions::write_queue_shards > 1, the write queue shards other than
+  // write_thread_, which is the first one and also serves unbatched writers.
+  // The write groups of all the shards enter write_queue_shard_gate_.
+  std::vector<std::unique_ptr<WriteThread>> write_queue_shards_;
+  WriteQueueShardGate write_queue_shard_gate_;
+  // Signaled when the write group of a write queue shard published its
+  // sequence numbers, see PublishShardedWriteSequence()
+  std::mutex sharded_publish_mutex_;
+  std::condition_variable sharded_publish_cv_;
+
   WriteController write_controller_;
 
   // Size of the last batch group. In slowdown mode, next write needs to
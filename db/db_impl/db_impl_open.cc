@@ -12,6 +12,7 @@
 #include "db/db_impl/db_impl.h"
 #include "db/error_handler.h"
 #include "db/periodic_task_scheduler.h"
+#include "db/wal_record_prefetcher.h"
 #include "env/composite_env_wrapper.h"
 #include "file/filename.h"
 #include "file/read_write_util.h"
@@ -26,6 +27,12 @@
 #include "util/rate_limiter.h"
 
 namespace ROCKSDB_NAMESPACE {
+namespace {
+// Upper bound on the size of the records each background WAL reader buffers
+// ahead of memtable insertion during recovery
+constexpr size_t kWalRecoveryMaxBufferedBytes = 8 << 20;
+}  // namespace
+
 Options SanitizeOptions(const std::string& dbname, const Options& src,
                         bool read_only, Status* logger_creation_s) {
   auto db_options =
@@ -279,6 +286,20 @@ Status DBImpl::ValidateOptions(const DBOptions& db_options) {
         "unordered_write is incompatible with enable_pipelined_write");
   }
 
+  if (db_options.write_queue_shards > 1) {
+    if (!db_options.allow_concurrent_memtable_write) {
+      return Status::InvalidArgument(
+          "write_queue_shards > 1 is incompatible with "
+          "!allow_concurrent_memtable_write");
+    }
+    if (db_options.enable_pipelined_write || db_options.unordered_write ||
+        db_options.two_write_queues) {
+      return Status::InvalidArgument(
+          "write_queue_shards > 1 is incompatible with enable_pipelined_write, "
+          "unordered_write and two_write_queues");
+    }
+  }
+
   if (db_options.atomic_flush && db_options.enable_pipelined_write) {
     return Status::InvalidArgument(
         "atomic_flush is incompatible with enable_pipelined_write");
@@ -1024,7 +1045,46 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
     min_wal_number =
         std::max(min_wal_number, versions_->MinLogNumberWithUnflushedData());
   }
-  for (auto wal_number : wal_numbers) {
+  // Readers of the WALs at and after the one being replayed, keyed by their
+  // index in wal_numbers. With wal_recovery_threads > 0, up to that many WALs
+  // are read, verified and decoded on background threads ahead of memtable
+  // insertion.
+  struct PendingWal {
+    Status open_status;
+    std::unique_ptr<WalRecordPrefetcher> prefetcher;
+  };
+  std::map<size_t, PendingWal> pending_wals;
+  const size_t wal_recovery_threads = static_cast<size_t>(
+      std::max(immutable_db_options_.wal_recovery_threads, 0));
+  const bool stop_on_corruption =
+      immutable_db_options_.paranoid_checks &&
+      immutable_db_options_.wal_recovery_mode !=
+          WALRecoveryMode::kSkipAnyCorruptedRecords;
+  auto open_wal = [&](uint64_t wal_number, PendingWal* pending) {
+    std::string fname =
+        LogFileName(immutable_db_options_.GetWalDir(), wal_number);
+    std::unique_ptr<FSSequentialFile> file;
+    pending->open_status = fs_->NewSequentialFile(
+        fname, fs_->OptimizeForLogRead(file_options_), &file, nullptr);
+    if (!pending->open_status.ok()) {
+      return;
+    }
+    std::unique_ptr<SequentialFileReader> file_reader(new SequentialFileReader(
+        std::move(file), fname, immutable_db_options_.log_readahead_size,
+        io_tracer_));
+    pending->prefetcher.reset(new WalRecordPrefetcher(
+        std::move(file_reader), fname, wal_number,
+        immutable_db_options_.info_log,
+        immutable_db_options_.wal_recovery_mode, stop_on_corruption,
+        immutable_db_options_.clock, kWalRecoveryMaxBufferedBytes));
+  };
+  SystemClock* clock = immutable_db_options_.clock;
+  const uint64_t recovery_start_micros = clock->NowMicros();
+  WalRecoveryInfo recovery_info;
+  recovery_info.db_name = dbname_;
+
+  for (size_t wal_idx = 0; wal_idx < wal_numbers.size(); ++wal_idx) {
+    const uint64_t wal_number = wal_numbers[wal_idx];
     if (wal_number < min_wal_number) {
       ROCKS_LOG_INFO(immutable_db_options_.info_log,
                      "Skipping log #%" PRIu64
@@ -1056,82 +1116,63 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
       continue;
     }
 
-    std::unique_ptr<SequentialFileReader> file_reader;
-    {
-      std::unique_ptr<FSSequentialFile> file;
-      status = fs_->NewSequentialFile(
-          fname, fs_->OptimizeForLogRead(file_options_), &file, nullptr);
+    // Keep the background readers busy on the following WALs
+    for (size_t i = wal_idx;
+         i < wal_numbers.size() && i < wal_idx + wal_recovery_threads; ++i) {
+      if (wal_numbers[i] < min_wal_number || pending_wals.count(i) > 0) {
+        continue;
+      }
+      PendingWal& pending = pending_wals[i];
+      open_wal(wal_numbers[i], &pending);
+      if (pending.open_status.ok()) {
+        pending.prefetcher->StartAsync();
+      }
+    }
+    PendingWal current;
+    auto pending_iter = pending_wals.find(wal_idx);
+    if (pending_iter != pending_wals.end()) {
+      current = std::move(pending_iter->second);
+      pending_wals.erase(pending_iter);
+    } else {
+      open_wal(wal_number, &current);
+    }
+    status = current.open_status;
+    if (!status.ok()) {
+      MaybeIgnoreError(&status);
       if (!status.ok()) {
-        MaybeIgnoreError(&status);
-        if (!status.ok()) {
-          return status;
-        } else {
-          // Fail with one log file, but that's ok.
-          // Try next one.
-          continue;
-        }
+        return status;
+      } else {
+        // Fail with one log file, but that's ok.
+        // Try next one.
+        continue;
       }
-      file_reader.reset(new SequentialFileReader(
-          std::move(file), fname, immutable_db_options_.log_readahead_size,
-          io_tracer_));
     }
+    WalRecordPrefetcher* prefetcher = current.prefetcher.get();
+    recovery_info.wal_numbers.push_back(wal_number);
 
-    // Create the log reader.
+    // Reports corruptions found while applying records
     LogReporter reporter;
     reporter.env = env_;
     reporter.info_log = immutable_db_options_.info_log.get();
     reporter.fname = fname.c_str();
-    if (!immutable_db_options_.paranoid_checks ||
-        immutable_db_options_.wal_recovery_mode ==
-            WALRecoveryMode::kSkipAnyCorruptedRecords) {
-      reporter.status = nullptr;
-    } else {
+    if (stop_on_corruption) {
       reporter.status = &status;
+    } else {
+      reporter.status = nullptr;
     }
-    // We intentially make log::Reader do checksumming even if
-    // paranoid_checks==false so that corruptions cause entire commits
-    // to be skipped instead of propagating bad information (like overly
-    // large sequence numbers).
-    log::Reader reader(immutable_db_options_.info_log, std::move(file_reader),
-                       &reporter, true /*checksum*/, wal_number);
-
-    // Determine if we should tolerate incomplete records at the tail end of the
-    // Read all the records and add to a memtable
-    std::string scratch;
-    Slice record;
 
     TEST_SYNC_POINT_CALLBACK("DBImpl::RecoverLogFiles:BeforeReadWal",
                              /*arg=*/nullptr);
-    uint64_t record_checksum;
-    while (!stop_replay_by_wal_filter &&
-           reader.ReadRecord(&record, &scratch,
-                             immutable_db_options_.wal_recovery_mode,
-                             &record_checksum) &&
-           status.ok()) {
-      if (record.size() < WriteBatchInternal::kHeader) {
-        reporter.Corruption(record.size(),
-                            Status::Corruption("log record too small"));
-        continue;
-      }
-
-      // We create a new batch and initialize with a valid prot_info_ to store
-      // the data checksums
-      WriteBatch batch;
-
-      status = WriteBatchInternal::SetContents(&batch, record);
-      if (!status.ok()) {
-        return status;
+    while (!stop_replay_by_wal_filter && status.ok()) {
+      WalRecordPrefetcher::Record record;
+      if (!prefetcher->Next(&record)) {
+        status = prefetcher->status();
+        break;
       }
-      TEST_SYNC_POINT_CALLBACK(
-          "DBImpl::RecoverLogFiles:BeforeUpdateProtectionInfo:batch", &batch);
-      TEST_SYNC_POINT_CALLBACK(
-          "DBImpl::RecoverLogFiles:BeforeUpdateProtectionInfo:checksum",
-          &record_checksum);
-      status = WriteBatchInternal::UpdateProtectionInfo(
-          &batch, 8 /* bytes_per_key */, &record_checksum);
-      if (!status.ok()) {
-        return status;
+      if (!record.status.ok()) {
+        return record.status;
       }
+      WriteBatch& batch = record.batch;
 
       SequenceNumber sequence = WriteBatchInternal::Sequence(&batch);
 
@@ -1164,16 +1205,18 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
       // we just ignore the update.
       // That's why we set ignore missing column families to true
       bool has_valid_writes = false;
+      uint64_t insert_start_micros = clock->NowMicros();
       status = WriteBatchInternal::InsertInto(
           &batch, column_family_memtables_.get(), &flush_scheduler_,
           &trim_history_scheduler_, true, wal_number, this,
           false /* concurrent_memtable_writes */, next_sequence,
           &has_valid_writes, seq_per_batch_, batch_per_txn_);
+      recovery_info.insert_micros += clock->NowMicros() - insert_start_micros;
       MaybeIgnoreError(&status);
       if (!status.ok()) {
         // We are treating this as a failure while reading since we read valid
         // blocks that do not form coherent data
-        reporter.Corruption(record.size(), status);
+        reporter.Corruption(record.record_size, status);
         continue;
       }
 
@@ -1190,7 +1233,9 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
           auto iter = version_edits.find(cfd->GetID());
           assert(iter != version_edits.end());
           VersionEdit* edit = &iter->second;
+          uint64_t flush_start_micros = clock->NowMicros();
           status = WriteLevel0TableForRecovery(job_id, cfd, cfd->mem(), edit);
+          recovery_info.flush_micros += clock->NowMicros() - flush_start_micros;
           if (!status.ok()) {
             // Reflect errors immediately so that conditions like full
             // file-systems cause the DB::Open() to fail.
@@ -1204,6 +1249,13 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
       }
     }
 
+    prefetcher->Stop();
+    recovery_info.num_records += prefetcher->num_records();
+    recovery_info.num_bytes += prefetcher->num_bytes();
+    recovery_info.read_micros += prefetcher->read_micros();
+    recovery_info.decode_micros += prefetcher->decode_micros();
+    recovery_info.wait_micros += prefetcher->wait_micros();
+
     if (!status.ok()) {
       if (status.IsNotSupported()) {
         // We should not treat NotSupported as corruption. It is rather a clear
@@ -1398,12 +1450,42 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
     }
   }
 
+  recovery_info.total_micros = clock->NowMicros() - recovery_start_micros;
   event_logger_.Log() << "job" << job_id << "event"
-                      << "recovery_finished";
+                      << "recovery_finished"
+                      << "num_records" << recovery_info.num_records
+                      << "num_bytes" << recovery_info.num_bytes
+                      << "read_micros" << recovery_info.read_micros
+                      << "decode_micros" << recovery_info.decode_micros
+                      << "wait_micros" << recovery_info.wait_micros
+                      << "insert_micros" << recovery_info.insert_micros
+                      << "flush_micros" << recovery_info.flush_micros
+                      << "total_micros" << recovery_info.total_micros;
+
+  if (status.ok()) {
+    NotifyOnWalRecoveryCompleted(recovery_info);
+  }
 
   return status;
 }
 
+void DBImpl::NotifyOnWalRecoveryCompleted(const WalRecoveryInfo& info) {
+#ifndef ROCKSDB_LITE
+  mutex_.AssertHeld();
+  if (immutable_db_options_.listeners.empty()) {
+    return;
+  }
+  // release lock while notifying events
+  mutex_.Unlock();
+  for (auto& listener : immutable_db_options_.listeners) {
+    listener->OnWalRecoveryCompleted(info);
+  }
+  mutex_.Lock();
+#else
+  (void)info;
+#endif  // ROCKSDB_LITE
+}
+
 Status DBImpl::GetLogSizeAndMaybeTruncate(uint64_t wal_number, bool truncate,
                                           LogFileNumberSize* log_ptr) {
   LogFileNumberSize log(wal_number);
@@ -2097,6 +2179,9 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
   if (s.ok()) {
     s = impl->RegisterRecordSeqnoTimeWorker();
   }
+  if (s.ok()) {
+    impl->StartHotBlockTracking();
+  }
   if (!s.ok()) {
     for (auto* h : *handles) {
       delete h;
@@ -16,6 +16,7 @@
 #include "options/options_helper.h"
 #include "test_util/sync_point.h"
 #include "util/cast_util.h"
+#include "util/random.h"
 
 namespace ROCKSDB_NAMESPACE {
 // Convenience methods
@@ -304,6 +305,12 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
                               log_ref, disable_memtable, seq_used);
   }
 
+  if (!write_queue_shards_.empty()) {
+    return ShardedWriteImpl(write_options, my_batch, callback, log_used,
+                            log_ref, disable_memtable, seq_used, batch_cnt,
+                            pre_release_callback, post_memtable_callback);
+  }
+
   PERF_TIMER_GUARD(write_pre_and_post_process_time);
   WriteThread::Writer w(write_options, my_batch, callback, log_ref,
                         disable_memtable, batch_cnt, pre_release_callback,
@@ -383,7 +390,8 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     // PreprocessWrite does its own perf timing.
     PERF_TIMER_STOP(write_pre_and_post_process_time);
 
-    status = PreprocessWrite(write_options, &log_context, &write_context);
+    status = PreprocessWrite(write_options, &log_context, &write_context,
+                             write_thread_);
     if (!two_write_queues_) {
       // Assign it after ::PreprocessWrite since the sequence might advance
       // inside it by WriteRecoverableState
@@ -676,7 +684,8 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
     LogContext log_context(!write_options.disableWAL && write_options.sync);
     // PreprocessWrite does its own perf timing.
     PERF_TIMER_STOP(write_pre_and_post_process_time);
-    w.status = PreprocessWrite(write_options, &log_context, &write_context);
+    w.status = PreprocessWrite(write_options, &log_context, &write_context,
+                               write_thread_);
     PERF_TIMER_START(write_pre_and_post_process_time);
 
     // This can set non-OK status if callback fail.
@@ -826,6 +835,331 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
   return w.FinalStatus();
 }
 
+Status DBImpl::ShardedWriteImpl(const WriteOptions& write_options,
+                                WriteBatch* my_batch, WriteCallback* callback,
+                                uint64_t* log_used, uint64_t log_ref,
+                                bool disable_memtable, uint64_t* seq_used,
+                                size_t batch_cnt,
+                                PreReleaseCallback* pre_release_callback,
+                                PostMemTableCallback* post_memtable_callback) {
+  PERF_TIMER_GUARD(write_pre_and_post_process_time);
+  StopWatch write_sw(immutable_db_options_.clock, stats_, DB_WRITE);
+
+  WriteThread& write_thread = *GetWriteQueueShard();
+  WriteThread::Writer w(write_options, my_batch, callback, log_ref,
+                        disable_memtable, batch_cnt, pre_release_callback,
+                        post_memtable_callback);
+  write_thread.JoinBatchGroup(&w);
+  if (w.state == WriteThread::STATE_COMPLETED) {
+    if (log_used != nullptr) {
+      *log_used = w.log_used;
+    }
+    if (seq_used != nullptr) {
+      *seq_used = w.sequence;
+    }
+    // write is complete and leader has published the sequence
+    return w.FinalStatus();
+  }
+  // else we are the leader of the write batch group
+  assert(w.state == WriteThread::STATE_GROUP_LEADER);
+  Status status;
+  WriteContext write_context;
+  WriteThread::WriteGroup write_group;
+
+  // Callbacks observe or extend the state left by the writes ordered before
+  // theirs, so they must not run concurrently with the groups of other shards.
+  auto needs_exclusive = [](const WriteThread::Writer* writer) {
+    return writer->callback != nullptr ||
+           writer->pre_release_callback != nullptr ||
+           writer->post_memtable_callback != nullptr;
+  };
+  // The groups of the other shards run concurrently with this one, unless
+  // this group may have to change state shared by all writers, e.g. to switch
+  // memtables, which PreprocessWrite() does.
+  bool exclusive = needs_exclusive(&w);
+  bool entered_gate = false;
+  if (!exclusive) {
+    write_queue_shard_gate_.EnterShared();
+    // Checking after entering the gate ensures that a write stop set up by an
+    // exclusive writer, e.g. LockWAL(), is not missed.
+    if (PreprocessWriteNeeded()) {
+      write_queue_shard_gate_.ExitShared();
+      exclusive = true;
+    } else {
+      entered_gate = true;
+    }
+  }
+  if (exclusive) {
+    if (write_options.no_slowdown && (write_controller_.IsStopped() ||
+                                      write_buffer_manager_->ShouldStall())) {
+      // Do not wait at the gate for a stalled group of another shard
+      status = Status::Incomplete("Write stall");
+    } else {
+      write_queue_shard_gate_.EnterExclusive();
+      entered_gate = true;
+      LogContext log_context;
+      // PreprocessWrite does its own perf timing.
+      PERF_TIMER_STOP(write_pre_and_post_process_time);
+      status = PreprocessWrite(write_options, &log_context, &write_context,
+                               write_thread);
+      PERF_TIMER_START(write_pre_and_post_process_time);
+    }
+  }
+
+  size_t group_size = write_thread.EnterAsBatchGroupLeader(&w, &write_group);
+  if (exclusive && entered_gate) {
+    last_batch_group_size_ = group_size;
+  }
+
+  if (status.ok() && !exclusive) {
+    for (auto* writer : write_group) {
+      if (needs_exclusive(writer)) {
+        exclusive = true;
+        break;
+      }
+    }
+    if (exclusive) {
+      write_queue_shard_gate_.ExitShared();
+      write_queue_shard_gate_.EnterExclusive();
+    }
+  }
+
+  IOStatus io_s;
+  Status pre_release_cb_status;
+  Status memtable_status;
+  // The sequence numbers allocated to the group, if any
+  SequenceNumber current_sequence = kMaxSequenceNumber;
+  SequenceNumber last_sequence = kMaxSequenceNumber;
+  if (status.ok()) {
+    // TODO: this use of operator bool on `tracer_` can avoid unnecessary lock
+    // grabs but does not seem thread-safe.
+    if (tracer_) {
+      InstrumentedMutexLock lock(&trace_mutex_);
+      if (tracer_ && tracer_->IsWriteOrderPreserved()) {
+        for (auto* writer : write_group) {
+          // TODO: maybe handle the tracing status?
+          tracer_->Write(writer->batch).PermitUncheckedError();
+        }
+      }
+    }
+    size_t total_count = 0;
+    size_t valid_batches = 0;
+    size_t total_byte_size = 0;
+    size_t pre_release_callback_cnt = 0;
+    for (auto* writer : write_group) {
+      assert(writer);
+      if (writer->CheckCallback(this)) {
+        valid_batches += writer->batch_cnt;
+        if (writer->ShouldWriteToMemtable()) {
+          total_count += WriteBatchInternal::Count(writer->batch);
+        }
+        total_byte_size = WriteBatchInternal::AppendedByteSize(
+            total_byte_size, WriteBatchInternal::ByteSize(writer->batch));
+        if (writer->pre_release_callback) {
+          pre_release_callback_cnt++;
+        }
+      }
+    }
+    // See WriteImpl() for seq_per_batch_
+    size_t seq_inc = seq_per_batch_ ? valid_batches : total_count;
+
+    const bool concurrent_update = true;
+    auto stats = default_cf_internal_stats_;
+    stats->AddDBStats(InternalStats::kIntStatsNumKeysWritten, total_count,
+                      concurrent_update);
+    RecordTick(stats_, NUMBER_KEYS_WRITTEN, total_count);
+    stats->AddDBStats(InternalStats::kIntStatsBytesWritten, total_byte_size,
+                      concurrent_update);
+    RecordTick(stats_, BYTES_WRITTEN, total_byte_size);
+    stats->AddDBStats(InternalStats::kIntStatsWriteDoneBySelf, 1,
+                      concurrent_update);
+    RecordTick(stats_, WRITE_DONE_BY_SELF);
+    auto write_done_by_other = write_group.size - 1;
+    if (write_done_by_other > 0) {
+      stats->AddDBStats(InternalStats::kIntStatsWriteDoneByOther,
+                        write_done_by_other, concurrent_update);
+      RecordTick(stats_, WRITE_DONE_BY_OTHER, write_done_by_other);
+    }
+    RecordInHistogram(stats_, BYTES_PER_WRITE, total_byte_size);
+
+    if (write_options.disableWAL) {
+      has_unpersisted_data_.store(true, std::memory_order_relaxed);
+    }
+
+    PERF_TIMER_STOP(write_pre_and_post_process_time);
+
+    if (!write_options.disableWAL) {
+      PERF_TIMER_GUARD(write_wal_time);
+      // LastAllocatedSequence is increased inside ConcurrentWriteToWAL under
+      // log_write_mutex_, so the WAL is ordered by sequence number
+      io_s = ConcurrentWriteToWAL(write_group, log_used, &last_sequence,
+                                  seq_inc);
+      status = io_s;
+      if (io_s.ok() && write_options.sync) {
+        // The groups of other shards may be appending to the WAL, so sync it
+        // the way two_write_queues_ does.
+        if (manual_wal_flush_) {
+          status = FlushWAL(true);
+        } else {
+          status = SyncWAL();
+        }
+      }
+    } else {
+      last_sequence = versions_->FetchAddLastAllocatedSequence(seq_inc);
+    }
+    if (last_sequence != kMaxSequenceNumber) {
+      current_sequence = last_sequence + 1;
+      last_sequence += seq_inc;
+    }
+
+    // PreReleaseCallback is called after WAL write and before memtable write
+    if (status.ok()) {
+      SequenceNumber next_sequence = current_sequence;
+      size_t index = 0;
+      for (auto* writer : write_group) {
+        if (writer->CallbackFailed()) {
+          continue;
+        }
+        writer->sequence = next_sequence;
+        if (writer->pre_release_callback) {
+          Status ws = writer->pre_release_callback->Callback(
+              writer->sequence, disable_memtable, writer->log_used, index++,
+              pre_release_callback_cnt);
+          if (!ws.ok()) {
+            status = pre_release_cb_status = ws;
+            break;
+          }
+        }
+        if (seq_per_batch_) {
+          assert(writer->batch_cnt);
+          next_sequence += writer->batch_cnt;
+        } else if (writer->ShouldWriteToMemtable()) {
+          next_sequence += WriteBatchInternal::Count(writer->batch);
+        }
+      }
+    }
+
+    if (status.ok()) {
+      PERF_TIMER_GUARD(write_memtable_time);
+      ColumnFamilyMemTablesImpl column_family_memtables(
+          versions_->GetColumnFamilySet());
+      if (exclusive) {
+        memtable_status = WriteBatchInternal::InsertInto(
+            write_group, current_sequence, &column_family_memtables,
+            &flush_scheduler_, &trim_history_scheduler_,
+            write_options.ignore_missing_column_families,
+            0 /*recovery_log_number*/, this,
+            false /*concurrent_memtable_writes*/, seq_per_batch_,
+            batch_per_txn_);
+      } else {
+        // Other shards are inserting into the same memtables
+        for (auto* writer : write_group) {
+          if (!writer->ShouldWriteToMemtable()) {
+            continue;
+          }
+          writer->status = WriteBatchInternal::InsertInto(
+              writer, writer->sequence, &column_family_memtables,
+              &flush_scheduler_, &trim_history_scheduler_,
+              write_options.ignore_missing_column_families, 0 /*log_number*/,
+              this, true /*concurrent_memtable_writes*/, seq_per_batch_,
+              writer->batch_cnt, batch_per_txn_,
+              write_options.memtable_insert_hint_per_batch);
+          if (memtable_status.ok()) {
+            memtable_status = writer->status;
+          }
+        }
+      }
+      if (seq_used != nullptr) {
+        *seq_used = w.sequence;
+      }
+    }
+    PERF_TIMER_START(write_pre_and_post_process_time);
+  }
+
+  if (!io_s.ok()) {
+    // Check WriteToWAL status
+    IOStatusCheck(io_s);
+  }
+  if (!w.CallbackFailed()) {
+    if (!io_s.ok()) {
+      assert(pre_release_cb_status.ok());
+    } else {
+      WriteStatusCheck(pre_release_cb_status);
+    }
+  } else {
+    assert(pre_release_cb_status.ok());
+  }
+
+  if (current_sequence != kMaxSequenceNumber) {
+    if (status.ok()) {
+      for (auto* tmp_w : write_group) {
+        assert(tmp_w);
+        if (tmp_w->post_memtable_callback) {
+          Status tmp_s =
+              (*tmp_w->post_memtable_callback)(last_sequence, disable_memtable);
+          // TODO: propagate the execution status of post_memtable_callback to
+          // caller.
+          assert(tmp_s.ok());
+        }
+      }
+    }
+    // Publish even if the write failed, since the groups with later sequence
+    // numbers wait for this one. The failed sequence numbers have no data.
+    PublishShardedWriteSequence(current_sequence, last_sequence);
+  }
+  if (entered_gate) {
+    if (exclusive) {
+      write_queue_shard_gate_.ExitExclusive();
+    } else {
+      write_queue_shard_gate_.ExitShared();
+    }
+  }
+  MemTableInsertStatusCheck(memtable_status);
+  write_thread.ExitAsBatchGroupLeader(write_group, status);
+
+  if (status.ok()) {
+    status = w.FinalStatus();
+  }
+  return status;
+}
+
+WriteThread* DBImpl::GetWriteQueueShard() {
+  const size_t num_shards = write_queue_shards_.size() + 1;
+  int cpuid = port::PhysicalCoreID();
+  size_t shard;
+  if (UNLIKELY(cpuid < 0)) {
+    // cpu id unavailable, just pick randomly
+    shard = Random::GetTLSInstance()->Uniform(static_cast<int>(num_shards));
+  } else {
+    shard = static_cast<size_t>(cpuid) % num_shards;
+  }
+  return shard == 0 ? &write_thread_ : write_queue_shards_[shard - 1].get();
+}
+
+void DBImpl::PublishShardedWriteSequence(SequenceNumber first_sequence,
+                                         SequenceNumber last_sequence) {
+  std::unique_lock<std::mutex> lock(sharded_publish_mutex_);
+  // A post_memtable_callback of an exclusive group may have published its
+  // sequence numbers already
+  sharded_publish_cv_.wait(lock, [&] {
+    return versions_->LastSequence() + 1 >= first_sequence;
+  });
+  if (last_sequence > versions_->LastSequence()) {
+    versions_->SetLastSequence(last_sequence);
+  }
+  sharded_publish_cv_.notify_all();
+}
+
+bool DBImpl::PreprocessWriteNeeded() {
+  // The same conditions PreprocessWrite() checks before doing any work
+  return error_handler_.IsDBStopped() ||
+         total_log_size_ > GetMaxTotalWalSize() ||
+         write_buffer_manager_->ShouldFlush() ||
+         !trim_history_scheduler_.Empty() || !flush_scheduler_.Empty() ||
+         write_controller_.IsStopped() || write_controller_.NeedsDelay() ||
+         write_buffer_manager_->ShouldStall();
+}
+
 Status DBImpl::UnorderedWriteMemtable(const WriteOptions& write_options,
                                       WriteBatch* my_batch,
                                       WriteCallback* callback, uint64_t log_ref,
@@ -915,7 +1249,8 @@ Status DBImpl::WriteImplWALOnly(
     // without paying the cost of obtaining the mutex.
     if (status.ok()) {
       LogContext log_context;
-      status = PreprocessWrite(write_options, &log_context, &write_context);
+      status = PreprocessWrite(write_options, &log_context, &write_context,
+                               write_thread_);
       WriteStatusCheckOnLocked(status);
     }
     if (!status.ok()) {
@@ -926,7 +1261,8 @@ Status DBImpl::WriteImplWALOnly(
     }
   } else {
     InstrumentedMutexLock lock(&mutex_);
-    Status status = DelayWrite(/*num_bytes=*/0ull, write_options);
+    Status status =
+        DelayWrite(/*num_bytes=*/0ull, write_thread_, write_options);
     if (!status.ok()) {
       WriteThread::WriteGroup write_group;
       write_thread->EnterAsBatchGroupLeader(&w, &write_group);
@@ -1142,7 +1478,8 @@ void DBImpl::MemTableInsertStatusCheck(const Status& status) {
 
 Status DBImpl::PreprocessWrite(const WriteOptions& write_options,
                                LogContext* log_context,
-                               WriteContext* write_context) {
+                               WriteContext* write_context,
+                               WriteThread& write_thread) {
   assert(write_context != nullptr && log_context != nullptr);
   Status status;
 
@@ -1201,7 +1538,7 @@ Status DBImpl::PreprocessWrite(const WriteOptions& write_options,
     // might happen for smaller writes but larger writes can go through.
     // Can optimize it if it is an issue.
     InstrumentedMutexLock l(&mutex_);
-    status = DelayWrite(last_batch_group_size_, write_options);
+    status = DelayWrite(last_batch_group_size_, write_thread, write_options);
     PERF_TIMER_START(write_pre_and_post_process_time);
   }
 
@@ -1216,7 +1553,7 @@ Status DBImpl::PreprocessWrite(const WriteOptions& write_options,
       status = Status::Incomplete("Write stall");
     } else {
       InstrumentedMutexLock l(&mutex_);
-      WriteBufferManagerStallWrites();
+      WriteBufferManagerStallWrites(write_thread);
     }
   }
   InstrumentedMutexLock l(&log_write_mutex_);
@@ -1312,10 +1649,12 @@ IOStatus DBImpl::WriteToWAL(const WriteBatch& merged_batch,
   }
   *log_size = log_entry.size();
   // When two_write_queues_ WriteToWAL has to be protected from concurretn calls
-  // from the two queues anyway and log_write_mutex_ is already held. Otherwise
-  // if manual_wal_flush_ is enabled we need to protect log_writer->AddRecord
-  // from possible concurrent calls via the FlushWAL by the application.
-  const bool needs_locking = manual_wal_flush_ && !two_write_queues_;
+  // from the two queues anyway and log_write_mutex_ is already held. The same
+  // holds for the write queue shards. Otherwise if manual_wal_flush_ is enabled
+  // we need to protect log_writer->AddRecord from possible concurrent calls via
+  // the FlushWAL by the application.
+  const bool needs_locking =
+      manual_wal_flush_ && !two_write_queues_ && write_queue_shards_.empty();
   // Due to performance cocerns of missed branch prediction penalize the new
   // manual_wal_flush_ feature (by UNLIKELY) instead of the more common case
   // when we do not need any locking.
@@ -1437,7 +1776,8 @@ IOStatus DBImpl::ConcurrentWriteToWAL(
     SequenceNumber* last_sequence, size_t seq_inc) {
   IOStatus io_s;
 
-  assert(two_write_queues_ || immutable_db_options_.unordered_write);
+  assert(two_write_queues_ || immutable_db_options_.unordered_write ||
+         !write_queue_shards_.empty());
   assert(!write_group.leader->disable_wal);
   // Same holds for all in the batch group
   WriteBatch tmp_batch;
@@ -1497,11 +1837,14 @@ Status DBImpl::WriteRecoverableState() {
   if (!cached_recoverable_state_empty_) {
     bool dont_care_bool;
     SequenceNumber next_seq;
-    if (two_write_queues_) {
+    // The write queue shards allocate sequence numbers like the two write
+    // queues do
+    const bool allocate_seq = two_write_queues_ || !write_queue_shards_.empty();
+    if (allocate_seq) {
       log_write_mutex_.Lock();
     }
     SequenceNumber seq;
-    if (two_write_queues_) {
+    if (allocate_seq) {
       seq = versions_->FetchAddLastAllocatedSequence(0);
     } else {
       seq = versions_->LastSequence();
@@ -1513,12 +1856,12 @@ Status DBImpl::WriteRecoverableState() {
         0 /*recovery_log_number*/, this, false /* concurrent_memtable_writes */,
         &next_seq, &dont_care_bool, seq_per_batch_);
     auto last_seq = next_seq - 1;
-    if (two_write_queues_) {
+    if (allocate_seq) {
       versions_->FetchAddLastAllocatedSequence(last_seq - seq);
       versions_->SetLastPublishedSequence(last_seq);
     }
     versions_->SetLastSequence(last_seq);
-    if (two_write_queues_) {
+    if (allocate_seq) {
       log_write_mutex_.Unlock();
     }
     if (status.ok() && recoverable_state_pre_release_callback_) {
@@ -1770,7 +2113,7 @@ uint64_t DBImpl::GetMaxTotalWalSize() const {
 
 // REQUIRES: mutex_ is held
 // REQUIRES: this thread is currently at the front of the writer queue
-Status DBImpl::DelayWrite(uint64_t num_bytes,
+Status DBImpl::DelayWrite(uint64_t num_bytes, WriteThread& write_thread,
                           const WriteOptions& write_options) {
   mutex_.AssertHeld();
   uint64_t time_delayed = 0;
@@ -1787,9 +2130,9 @@ Status DBImpl::DelayWrite(uint64_t num_bytes,
       }
       TEST_SYNC_POINT("DBImpl::DelayWrite:Sleep");
 
-      // Notify write_thread_ about the stall so it can setup a barrier and
+      // Notify write_thread about the stall so it can setup a barrier and
       // fail any pending writers with no_slowdown
-      write_thread_.BeginWriteStall();
+      write_thread.BeginWriteStall();
       mutex_.Unlock();
       TEST_SYNC_POINT("DBImpl::DelayWrite:BeginWriteStallDone");
       // We will delay the write until we have slept for `delay` microseconds
@@ -1809,7 +2152,7 @@ Status DBImpl::DelayWrite(uint64_t num_bytes,
         immutable_db_options_.clock->SleepForMicroseconds(kDelayInterval);
       }
       mutex_.Lock();
-      write_thread_.EndWriteStall();
+      write_thread.EndWriteStall();
     }
 
     // Don't wait if there's a background error, even if its a soft error. We
@@ -1823,12 +2166,12 @@ Status DBImpl::DelayWrite(uint64_t num_bytes,
       }
       delayed = true;
 
-      // Notify write_thread_ about the stall so it can setup a barrier and
+      // Notify write_thread about the stall so it can setup a barrier and
       // fail any pending writers with no_slowdown
-      write_thread_.BeginWriteStall();
+      write_thread.BeginWriteStall();
       TEST_SYNC_POINT("DBImpl::DelayWrite:Wait");
       bg_cv_.Wait();
-      write_thread_.EndWriteStall();
+      write_thread.EndWriteStall();
     }
   }
   assert(!delayed || !write_options.no_slowdown);
@@ -1859,11 +2202,11 @@ Status DBImpl::DelayWrite(uint64_t num_bytes,
 
 // REQUIRES: mutex_ is held
 // REQUIRES: this thread is currently at the front of the writer queue
-void DBImpl::WriteBufferManagerStallWrites() {
+void DBImpl::WriteBufferManagerStallWrites(WriteThread& write_thread) {
   mutex_.AssertHeld();
   // First block future writer threads who want to add themselves to the queue
   // of WriteThread.
-  write_thread_.BeginWriteStall();
+  write_thread.BeginWriteStall();
   mutex_.Unlock();
 
   // Change the state to State::Blocked.
@@ -1877,7 +2220,7 @@ void DBImpl::WriteBufferManagerStallWrites() {
   mutex_.Lock();
   // Stall has ended. Signal writer threads so that they can add
   // themselves to the WriteThread queue for writes.
-  write_thread_.EndWriteStall();
+  write_thread.EndWriteStall();
 }
 
 Status DBImpl::ThrottleLowPriWritesIfNeeded(const WriteOptions& write_options,
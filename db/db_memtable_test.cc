@@ -4,6 +4,7 @@
 //  (found in the LICENSE.Apache file in the root directory).
 
 #include <memory>
+#include <set>
 #include <string>
 
 #include "db/db_test_util.h"
@@ -335,6 +336,187 @@ TEST_F(DBMemTableTest, ColumnFamilyId) {
   }
 }
 
+#ifndef ROCKSDB_LITE
+namespace {
+// Inserts and reads entries of an AdaptiveRep and checks the reads against a
+// std::set of the inserted entries
+class AdaptiveRepTester {
+ public:
+  AdaptiveRepTester()
+      : icmp_(BytewiseComparator()),
+        cmp_(icmp_),
+        model_(KeyLess{&icmp_}),
+        rep_(AdaptiveRepFactory().CreateMemTableRep(cmp_, &arena_, nullptr,
+                                                   nullptr)) {}
+
+  void Insert(uint64_t k) {
+    std::string ikey;
+    AppendInternalKey(&ikey, ParsedInternalKey(Key(k), ++seq_, kTypeValue));
+    char* buf = nullptr;
+    KeyHandle handle =
+        rep_->Allocate(VarintLength(ikey.size()) + ikey.size(), &buf);
+    char* p = EncodeVarint32(buf, static_cast<uint32_t>(ikey.size()));
+    memcpy(p, ikey.data(), ikey.size());
+    rep_->Insert(handle);
+    model_.insert(ikey);
+  }
+
+  void MarkReadOnly() { rep_->MarkReadOnly(); }
+
+  void Verify(Random* rnd) {
+    std::unique_ptr<MemTableRep::Iterator> iter(rep_->GetIterator(nullptr));
+    auto it = model_.begin();
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++it) {
+      ASSERT_TRUE(it != model_.end());
+      ASSERT_EQ(*it, GetLengthPrefixedSlice(iter->key()).ToString());
+    }
+    ASSERT_TRUE(it == model_.end());
+    auto rit = model_.rbegin();
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev(), ++rit) {
+      ASSERT_TRUE(rit != model_.rend());
+      ASSERT_EQ(*rit, GetLengthPrefixedSlice(iter->key()).ToString());
+    }
+    ASSERT_TRUE(rit == model_.rend());
+
+    for (int i = 0; i < 100; ++i) {
+      std::string target;
+      AppendInternalKey(&target, ParsedInternalKey(Key(rnd->Uniform(1000)),
+                                                   kMaxSequenceNumber,
+                                                   kValueTypeForSeek));
+      auto lb = model_.lower_bound(target);
+      iter->Seek(target, nullptr);
+      ASSERT_EQ(lb != model_.end(), iter->Valid());
+      if (iter->Valid()) {
+        ASSERT_EQ(*lb, GetLengthPrefixedSlice(iter->key()).ToString());
+        std::string memtable_key;
+        ASSERT_TRUE(rep_->Contains(EncodeKey(&memtable_key, *lb)));
+      }
+      auto ub = model_.upper_bound(target);
+      iter->SeekForPrev(target, nullptr);
+      ASSERT_EQ(ub != model_.begin(), iter->Valid());
+      if (iter->Valid()) {
+        ASSERT_EQ(*std::prev(ub),
+                  GetLengthPrefixedSlice(iter->key()).ToString());
+      }
+
+      // Get() visits the entries from the first one not less than the key
+      LookupKey lkey(ExtractUserKey(target), kMaxSequenceNumber);
+      std::pair<std::set<std::string, KeyLess>::iterator, bool> state{
+          lb, lb == model_.end()};
+      rep_->Get(lkey, &state, [](void* arg, const char* entry) {
+        auto* st = static_cast<decltype(state)*>(arg);
+        EXPECT_FALSE(st->second);
+        EXPECT_EQ(*st->first, GetLengthPrefixedSlice(entry).ToString());
+        ++st->first;
+        return false;
+      });
+    }
+  }
+
+ private:
+  struct KeyLess {
+    const InternalKeyComparator* icmp;
+    bool operator()(const std::string& a, const std::string& b) const {
+      return icmp->Compare(a, b) < 0;
+    }
+  };
+
+  static std::string Key(uint64_t k) {
+    std::string key;
+    PutFixed64(&key, k);
+    std::reverse(key.begin(), key.end());
+    return key;
+  }
+
+  InternalKeyComparator icmp_;
+  MemTable::KeyComparator cmp_;
+  Arena arena_;
+  std::set<std::string, KeyLess> model_;
+  std::unique_ptr<MemTableRep> rep_;
+  SequenceNumber seq_ = 0;
+};
+}  // namespace
+
+TEST_F(DBMemTableTest, AdaptiveRep) {
+  Random rnd(301);
+  for (bool in_order : {true, false}) {
+    for (bool read_before_disorder : {true, false}) {
+      for (bool read_only : {true, false}) {
+        SCOPED_TRACE(std::to_string(in_order) + " " +
+                     std::to_string(read_before_disorder) + " " +
+                     std::to_string(read_only));
+        AdaptiveRepTester tester;
+        uint64_t k = 0;
+        for (int i = 0; i < 300; ++i) {
+          tester.Insert(in_order ? k++ : rnd.Uniform(1000));
+        }
+        if (read_before_disorder) {
+          tester.Verify(&rnd);
+        }
+        for (int i = 0; i < 300; ++i) {
+          tester.Insert(rnd.Uniform(1000));
+          if (read_before_disorder && i % 100 == 0) {
+            tester.Verify(&rnd);
+          }
+        }
+        if (read_only) {
+          tester.MarkReadOnly();
+        }
+        tester.Verify(&rnd);
+        tester.Verify(&rnd);
+      }
+    }
+  }
+}
+
+TEST_F(DBMemTableTest, AdaptiveRepDB) {
+  Options options = CurrentOptions();
+  options.memtable_factory.reset(new AdaptiveRepFactory());
+  options.allow_concurrent_memtable_write = false;
+  options.write_buffer_size = 64 << 10;
+  options.max_write_buffer_number = 4;
+  options.level0_file_num_compaction_trigger = 100;
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  std::map<std::string, std::string> model;
+  // A sequential load, then mixed random reads and writes
+  for (int i = 0; i < 2000; ++i) {
+    std::string key = Key(i);
+    std::string value = rnd.RandomString(20);
+    ASSERT_OK(Put(key, value));
+    model[key] = value;
+  }
+  for (int i = 0; i < 4000; ++i) {
+    std::string key = Key(rnd.Uniform(4000));
+    if (i % 2 == 0) {
+      std::string value = rnd.RandomString(20);
+      ASSERT_OK(Put(key, value));
+      model[key] = value;
+    } else {
+      auto it = model.find(key);
+      ASSERT_EQ(it != model.end() ? it->second : "NOT_FOUND", Get(key));
+    }
+  }
+  auto verify = [&]() {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    auto it = model.begin();
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++it) {
+      ASSERT_TRUE(it != model.end());
+      ASSERT_EQ(it->first, iter->key());
+      ASSERT_EQ(it->second, iter->value());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_TRUE(it == model.end());
+  };
+  verify();
+  ASSERT_OK(Flush());
+  verify();
+  Reopen(options);
+  verify();
+}
+#endif  // ROCKSDB_LITE
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
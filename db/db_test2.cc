@@ -5839,6 +5839,120 @@ TEST_F(DBTest2, RowCacheSnapshot) {
 }
 #endif  // ROCKSDB_LITE
 
+#ifndef ROCKSDB_LITE
+TEST_F(DBTest2, HotKeyCache) {
+  Options options = CurrentOptions();
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  options.hot_key_cache = NewLRUCache(8 * 8192);
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("foo", "bar1"));
+  ASSERT_EQ(Get("foo"), "bar1");
+  ASSERT_EQ(TestGetTickerCount(options, HOT_KEY_CACHE_HIT), 0);
+  ASSERT_EQ(TestGetTickerCount(options, HOT_KEY_CACHE_MISS), 1);
+  ASSERT_EQ(Get("foo"), "bar1");
+  ASSERT_EQ(TestGetTickerCount(options, HOT_KEY_CACHE_HIT), 1);
+
+  // Entries survive flushes and compactions
+  ASSERT_OK(Flush());
+  ASSERT_EQ(Get("foo"), "bar1");
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(Get("foo"), "bar1");
+  ASSERT_EQ(TestGetTickerCount(options, HOT_KEY_CACHE_HIT), 3);
+  ASSERT_EQ(TestGetTickerCount(options, HOT_KEY_CACHE_MISS), 1);
+
+  // But not writes of their keys
+  ASSERT_OK(Put("foo", "bar2"));
+  ASSERT_EQ(Get("foo"), "bar2");
+  ASSERT_EQ(Get("foo"), "bar2");
+  ASSERT_OK(Delete("foo"));
+  ASSERT_EQ(Get("foo"), "NOT_FOUND");
+  ASSERT_EQ(Get("foo"), "NOT_FOUND");
+  ASSERT_EQ(TestGetTickerCount(options, HOT_KEY_CACHE_HIT), 5);
+  ASSERT_EQ(TestGetTickerCount(options, HOT_KEY_CACHE_MISS), 3);
+
+  // Nor range deletions
+  ASSERT_OK(Put("foo", "bar3"));
+  ASSERT_EQ(Get("foo"), "bar3");
+  ASSERT_EQ(Get("foo"), "bar3");
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "a",
+                             "z"));
+  ASSERT_EQ(Get("foo"), "NOT_FOUND");
+  ASSERT_EQ(TestGetTickerCount(options, HOT_KEY_CACHE_HIT), 6);
+  ASSERT_EQ(TestGetTickerCount(options, HOT_KEY_CACHE_MISS), 5);
+
+  // Nor deleting files
+  ASSERT_OK(Put("foo", "bar4"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(Get("foo"), "bar4");
+  ASSERT_EQ(Get("foo"), "bar4");
+  Slice begin("a");
+  Slice end("z");
+  ASSERT_OK(DeleteFilesInRange(db_, db_->DefaultColumnFamily(), &begin, &end));
+  ASSERT_EQ(Get("foo"), "NOT_FOUND");
+  ASSERT_EQ(TestGetTickerCount(options, HOT_KEY_CACHE_HIT), 7);
+  ASSERT_EQ(TestGetTickerCount(options, HOT_KEY_CACHE_MISS), 7);
+
+  // Reads at a snapshot bypass the cache
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_EQ(Get("foo", snapshot), "NOT_FOUND");
+  db_->ReleaseSnapshot(snapshot);
+  ASSERT_EQ(TestGetTickerCount(options, HOT_KEY_CACHE_HIT), 7);
+  ASSERT_EQ(TestGetTickerCount(options, HOT_KEY_CACHE_MISS), 7);
+}
+
+TEST_F(DBTest2, HotKeyCacheWriteDuringGet) {
+  Options options = CurrentOptions();
+  options.hot_key_cache = NewLRUCache(8 * 8192);
+  DestroyAndReopen(options);
+  ASSERT_OK(Put("foo", "bar1"));
+
+  // The write lands after the Get() read the old value, before it inserts
+  // the value into the cache
+  SyncPoint::GetInstance()->LoadDependency(
+      {{"DBImpl::GetImpl:PostMemTableGet:0",
+        "DBTest2::HotKeyCacheWriteDuringGet:Write"},
+       {"DBTest2::HotKeyCacheWriteDuringGet:Written",
+        "DBImpl::GetImpl:PostMemTableGet:1"}});
+  SyncPoint::GetInstance()->EnableProcessing();
+  port::Thread reader([&]() { ASSERT_EQ(Get("foo"), "bar1"); });
+  TEST_SYNC_POINT("DBTest2::HotKeyCacheWriteDuringGet:Write");
+  ASSERT_OK(Put("foo", "bar2"));
+  TEST_SYNC_POINT("DBTest2::HotKeyCacheWriteDuringGet:Written");
+  reader.join();
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_EQ(Get("foo"), "bar2");
+  ASSERT_EQ(Get("foo"), "bar2");
+}
+
+TEST_F(DBTest2, HotKeyCacheNotUsedWithCompactionFilter) {
+  class KeepFilter : public CompactionFilter {
+   public:
+    bool Filter(int /*level*/, const Slice& /*key*/, const Slice& /*value*/,
+                std::string* /*new_value*/,
+                bool* /*value_changed*/) const override {
+      return false;
+    }
+    const char* Name() const override { return "KeepFilter"; }
+  };
+  KeepFilter filter;
+  Options options = CurrentOptions();
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  options.hot_key_cache = NewLRUCache(8 * 8192);
+  options.compaction_filter = &filter;
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("foo", "bar"));
+  ASSERT_EQ(Get("foo"), "bar");
+  ASSERT_EQ(Get("foo"), "bar");
+  ASSERT_EQ(TestGetTickerCount(options, HOT_KEY_CACHE_HIT), 0);
+  ASSERT_EQ(TestGetTickerCount(options, HOT_KEY_CACHE_MISS), 0);
+}
+#endif  // ROCKSDB_LITE
+
 // When DB is reopened with multiple column families, the manifest file
 // is written after the first CF is flushed, and it is written again
 // after each flush. If DB crashes between the flushes, the flushed CF
@@ -580,6 +580,10 @@ Options DBTestBase::GetOptions(
       options.unordered_write = false;
       break;
     }
+    case kShardedWriteQueues: {
+      options.write_queue_shards = 4;
+      break;
+    }
 
     default:
       break;
@@ -1075,6 +1075,7 @@ class DBTestBase : public testing::Test {
     kPartitionedFilterWithNewTableReaderForCompactions,
     kUniversalSubcompactions,
     kUnorderedWrite,
+    kShardedWriteQueues,
     // This must be the last line
     kEnd,
   };
@@ -1822,6 +1822,67 @@ TEST_P(DBWALTestWithParams, kSkipAnyCorruptedRecords) {
   }
 }
 
+TEST_F(DBWALTest, RecoverWithWalRecoveryThreads) {
+  class WalRecoveryListener : public EventListener {
+   public:
+    void OnWalRecoveryCompleted(const WalRecoveryInfo& info) override {
+      infos.push_back(info);
+    }
+    std::vector<WalRecoveryInfo> infos;
+  };
+
+  Options options = CurrentOptions();
+  const size_t row_count = RecoveryTestHelper::FillData(this, &options);
+
+  auto listener = std::make_shared<WalRecoveryListener>();
+  options.listeners.push_back(listener);
+  options.wal_recovery_threads = 3;
+  // Make the memtable fill up during replay
+  options.write_buffer_size = 64 << 10;
+  options.create_if_missing = false;
+  ASSERT_OK(TryReopen(options));
+
+  ASSERT_EQ(row_count, RecoveryTestHelper::GetData(this));
+  ASSERT_EQ(1, listener->infos.size());
+  const WalRecoveryInfo& info = listener->infos[0];
+  // The WALs written by FillData() follow the empty WAL of the initial open
+  ASSERT_GE(info.wal_numbers.size(),
+            static_cast<size_t>(RecoveryTestHelper::kWALFilesCount));
+  const size_t first_filled =
+      info.wal_numbers.size() - RecoveryTestHelper::kWALFilesCount;
+  for (size_t i = 0; i < RecoveryTestHelper::kWALFilesCount; ++i) {
+    ASSERT_EQ(RecoveryTestHelper::kWALFileOffset + i,
+              info.wal_numbers[first_filled + i]);
+  }
+  ASSERT_EQ(row_count, info.num_records);
+  ASSERT_GT(info.num_bytes, 0);
+  ASSERT_GT(TotalTableFiles(), 1);
+}
+
+TEST_F(DBWALTest, PointInTimeRecoveryWithWalRecoveryThreads) {
+  const int wal_file_id = RecoveryTestHelper::kWALFileOffset + 4;
+  Options options = CurrentOptions();
+  RecoveryTestHelper::FillData(this, &options);
+  RecoveryTestHelper::CorruptWAL(this, options, /*off=*/.5, /*len%=*/.1,
+                                 wal_file_id);
+
+  options.wal_recovery_mode = WALRecoveryMode::kPointInTimeRecovery;
+  options.wal_recovery_threads = 4;
+  options.create_if_missing = false;
+  ASSERT_OK(TryReopen(options));
+
+  // Exactly the records before the corruption are recovered, even though
+  // later WALs were read ahead
+  size_t recovered_row_count = RecoveryTestHelper::GetData(this);
+  const size_t min = RecoveryTestHelper::kKeysPerWALFile *
+                     (wal_file_id - RecoveryTestHelper::kWALFileOffset);
+  ASSERT_GE(recovered_row_count, min);
+  ASSERT_LT(recovered_row_count, min + RecoveryTestHelper::kKeysPerWALFile);
+  for (size_t k = 0; k < recovered_row_count; ++k) {
+    ASSERT_NE("NOT_FOUND", Get("key" + std::to_string(k)));
+  }
+}
+
 TEST_F(DBWALTest, AvoidFlushDuringRecovery) {
   Options options = CurrentOptions();
   options.disable_auto_compactions = true;
@@ -664,10 +664,86 @@ TEST_P(DBWriteTest, ConcurrentlyDisabledWAL) {
   ASSERT_LE(bytes_num, 1024 * 100);
 }
 
+TEST_F(DBWriteTestUnparameterized, ShardedWriteQueues) {
+  Options options = CurrentOptions();
+  options.write_queue_shards = 4;
+  // Switch memtables often so that exclusive groups interleave with shared
+  // ones
+  options.write_buffer_size = 64 << 10;
+  DestroyAndReopen(options);
+
+  const int kNumThreads = 8;
+  const int kNumKeysPerThread = 500;
+  const int kNumKeys =
+      kNumThreads * (kNumKeysPerThread + kNumKeysPerThread / 10);
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t] {
+      WriteOptions write_options;
+      write_options.sync = (t == 0);
+      write_options.disableWAL = (t == 1);
+      for (int i = 0; i < kNumKeysPerThread; i++) {
+        std::string key = "k" + std::to_string(t) + "_" + std::to_string(i);
+        if (i % 10 == 0) {
+          WriteBatch batch;
+          ASSERT_OK(batch.Put(key, "v"));
+          ASSERT_OK(batch.Put(key + "_batch", "v"));
+          ASSERT_OK(dbfull()->Write(write_options, &batch));
+        } else {
+          ASSERT_OK(dbfull()->Put(write_options, key, "v"));
+        }
+        // Read your own write
+        ASSERT_EQ("v", Get(key));
+      }
+    });
+  }
+  // Snapshots must not change while the groups of other shards are in
+  // progress
+  int count = 0;
+  while (count < kNumKeys) {
+    const Snapshot* snapshot = db_->GetSnapshot();
+    ReadOptions read_options;
+    read_options.snapshot = snapshot;
+    auto count_keys = [&] {
+      std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+      int num_keys = 0;
+      for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        num_keys++;
+      }
+      EXPECT_OK(iter->status());
+      return num_keys;
+    };
+    count = count_keys();
+    std::this_thread::yield();
+    ASSERT_EQ(count, count_keys());
+    db_->ReleaseSnapshot(snapshot);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // One sequence number per key, all published
+  ASSERT_EQ(static_cast<uint64_t>(kNumKeys),
+            dbfull()->GetLatestSequenceNumber());
+
+  // All but the writes without WAL are recovered
+  Reopen(options);
+  for (int t = 0; t < kNumThreads; t++) {
+    for (int i = 0; i < kNumKeysPerThread; i++) {
+      std::string key = "k" + std::to_string(t) + "_" + std::to_string(i);
+      if (t == 1) {
+        continue;
+      }
+      ASSERT_EQ("v", Get(key));
+    }
+  }
+  Close();
+}
+
 INSTANTIATE_TEST_CASE_P(DBWriteTestInstance, DBWriteTest,
                         testing::Values(DBTestBase::kDefault,
                                         DBTestBase::kConcurrentWALWrites,
-                                        DBTestBase::kPipelinedWrite));
+                                        DBTestBase::kPipelinedWrite,
+                                        DBTestBase::kShardedWriteQueues));
 
 }  // namespace ROCKSDB_NAMESPACE
 
@@ -0,0 +1,131 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/hot_key_cache.h"
+
+#include "db/column_family.h"
+#include "monitoring/statistics.h"
+#include "rocksdb/slice.h"
+#include "util/coding.h"
+#include "util/hash.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+HotKeyCache::HotKeyCache(const std::shared_ptr<Cache>& cache,
+                         Statistics* stats)
+    : cache_(cache), stats_(stats) {
+  PutVarint64(&id_, cache->NewId());
+  for (auto& seq : key_seqs_) {
+    seq.store(0, std::memory_order_relaxed);
+  }
+  for (auto& seq : cf_seqs_) {
+    seq.store(0, std::memory_order_relaxed);
+  }
+  for (auto& epoch : cf_epochs_) {
+    epoch.store(0, std::memory_order_relaxed);
+  }
+}
+
+bool HotKeyCache::Supports(const ColumnFamilyData& cfd) {
+  const ImmutableOptions& ioptions = *cfd.ioptions();
+  return ioptions.compaction_filter == nullptr &&
+         ioptions.compaction_filter_factory == nullptr &&
+         ioptions.compaction_style != kCompactionStyleFIFO;
+}
+
+size_t HotKeyCache::KeyStripe(uint32_t cf_id, const Slice& user_key) {
+  return NPHash64(user_key.data(), user_key.size(), cf_id) % kNumKeyStripes;
+}
+
+void HotKeyCache::RaiseTo(std::atomic<SequenceNumber>* seq,
+                          SequenceNumber value) {
+  SequenceNumber cur = seq->load(std::memory_order_relaxed);
+  while (cur < value &&
+         !seq->compare_exchange_weak(cur, value, std::memory_order_acq_rel)) {
+  }
+}
+
+bool HotKeyCache::WrittenAfter(uint32_t cf_id, const Slice& user_key,
+                               SequenceNumber read_seq) const {
+  return key_seqs_[KeyStripe(cf_id, user_key)].load(
+             std::memory_order_acquire) > read_seq ||
+         cf_seqs_[CfStripe(cf_id)].load(std::memory_order_acquire) > read_seq;
+}
+
+void HotKeyCache::MakeKey(uint32_t cf_id, const Slice& user_key,
+                          std::string* key) const {
+  key->reserve(id_.size() + 5 + user_key.size());
+  key->assign(id_);
+  PutVarint32(key, cf_id);
+  key->append(user_key.data(), user_key.size());
+}
+
+bool HotKeyCache::Lookup(uint32_t cf_id, const Slice& user_key,
+                         SequenceNumber read_seq, PinnableSlice* value,
+                         Status* s) {
+  std::string key;
+  MakeKey(cf_id, user_key, &key);
+  auto handle = cache_.Lookup(key);
+  if (handle == nullptr) {
+    RecordTick(stats_, HOT_KEY_CACHE_MISS);
+    return false;
+  }
+  const Entry* entry = cache_.Value(handle);
+  // An entry read after `read_seq` might have a value from a later write
+  if (entry->read_seq > read_seq || entry->epoch != GetEpoch(cf_id) ||
+      WrittenAfter(cf_id, user_key, entry->read_seq)) {
+    cache_.get()->Release(handle);
+    RecordTick(stats_, HOT_KEY_CACHE_MISS);
+    return false;
+  }
+  if (entry->found) {
+    value->PinSlice(entry->value, nullptr /* cleanable */);
+    cache_.RegisterReleaseAsCleanup(handle, *value);
+    *s = Status::OK();
+  } else {
+    cache_.get()->Release(handle);
+    *s = Status::NotFound();
+  }
+  RecordTick(stats_, HOT_KEY_CACHE_HIT);
+  return true;
+}
+
+void HotKeyCache::Insert(uint32_t cf_id, const Slice& user_key,
+                         SequenceNumber read_seq, uint64_t epoch,
+                         const Status& s, const Slice& value) {
+  if (!s.ok() && !s.IsNotFound()) {
+    return;
+  }
+  // Not worth inserting if a write already invalidated it. Otherwise a
+  // write that races with the insert is caught by Lookup().
+  if (epoch != GetEpoch(cf_id) || WrittenAfter(cf_id, user_key, read_seq)) {
+    return;
+  }
+  std::string key;
+  MakeKey(cf_id, user_key, &key);
+  auto entry = new Entry();
+  entry->read_seq = read_seq;
+  entry->epoch = epoch;
+  entry->found = s.ok();
+  if (entry->found) {
+    entry->value.assign(value.data(), value.size());
+  }
+  size_t charge = sizeof(Entry) + entry->value.capacity() + key.size();
+  cache_.Insert(key, entry, charge).PermitUncheckedError();
+}
+
+void HotKeyCache::Invalidate(uint32_t cf_id, const Slice& user_key,
+                             SequenceNumber seq) {
+  RaiseTo(&key_seqs_[KeyStripe(cf_id, user_key)], seq);
+  std::string key;
+  MakeKey(cf_id, user_key, &key);
+  cache_.get()->Erase(key);
+}
+
+void HotKeyCache::InvalidateColumnFamily(uint32_t cf_id, SequenceNumber seq) {
+  RaiseTo(&cf_seqs_[CfStripe(cf_id)], seq);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
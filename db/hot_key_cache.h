@@ -0,0 +1,108 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "cache/typed_cache.h"
+#include "db/dbformat.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/statistics.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class ColumnFamilyData;
+class PinnableSlice;
+
+// The results of Get()s at the latest sequence number, by column family and
+// user key, so that repeated reads of the same keys are served without
+// looking at the memtables or the files. See DBOptions::hot_key_cache.
+//
+// Unlike the row cache, entries survive flushes and compactions. Instead,
+// writes invalidate them: each write of a key records its sequence number in
+// one of a set of stripes selected by the hash of the key, before the write
+// becomes visible, and an entry is only used while the stripe of its key has
+// no write after the sequence number the entry was read at. Writes that
+// delete ranges do the same for the whole column family. Operations that
+// change the files without a write, such as ingesting files, bump an epoch of
+// the column family instead, which is compared with the epoch an entry was
+// read at.
+class HotKeyCache {
+ public:
+  HotKeyCache(const std::shared_ptr<Cache>& cache, Statistics* stats);
+
+  // Whether Get()s on the column family can be cached, which they cannot if
+  // compactions might change or drop values
+  static bool Supports(const ColumnFamilyData& cfd);
+
+  // To be called before a read that might be inserted with Insert()
+  uint64_t GetEpoch(uint32_t cf_id) const {
+    return cf_epochs_[CfStripe(cf_id)].load(std::memory_order_acquire);
+  }
+
+  // Returns true if the result of Get() at `read_seq` is cached, and then
+  // sets `*s` and, if found, pins the value in `*value`.
+  bool Lookup(uint32_t cf_id, const Slice& user_key, SequenceNumber read_seq,
+              PinnableSlice* value, Status* s);
+
+  // Caches the result `s` of Get() at `read_seq`, with `value` if it is OK.
+  // `epoch` is the result of GetEpoch() before the read.
+  void Insert(uint32_t cf_id, const Slice& user_key, SequenceNumber read_seq,
+              uint64_t epoch, const Status& s, const Slice& value);
+
+  // To be called by a write of `user_key` at `seq` before it is visible to
+  // readers
+  void Invalidate(uint32_t cf_id, const Slice& user_key, SequenceNumber seq);
+
+  // Like Invalidate() for a write that might affect any key
+  void InvalidateColumnFamily(uint32_t cf_id, SequenceNumber seq);
+
+  // To be called after the files of the column family changed other than by
+  // flushes and compactions, once readers see the change
+  void BumpEpoch(uint32_t cf_id) {
+    cf_epochs_[CfStripe(cf_id)].fetch_add(1, std::memory_order_acq_rel);
+  }
+
+ private:
+  struct Entry {
+    static constexpr CacheEntryRole kCacheEntryRole = CacheEntryRole::kMisc;
+
+    SequenceNumber read_seq;
+    uint64_t epoch;
+    bool found;
+    std::string value;
+  };
+  using HotKeyCacheInterface = BasicTypedSharedCacheInterface<Entry>;
+
+  static constexpr size_t kNumKeyStripes = 4096;
+  static constexpr size_t kNumCfStripes = 64;
+
+  static size_t CfStripe(uint32_t cf_id) { return cf_id % kNumCfStripes; }
+  static size_t KeyStripe(uint32_t cf_id, const Slice& user_key);
+  static void RaiseTo(std::atomic<SequenceNumber>* seq, SequenceNumber value);
+
+  // Whether a write invalidated entries of the key read at `read_seq`
+  bool WrittenAfter(uint32_t cf_id, const Slice& user_key,
+                    SequenceNumber read_seq) const;
+  void MakeKey(uint32_t cf_id, const Slice& user_key, std::string* key) const;
+
+  HotKeyCacheInterface cache_;
+  Statistics* const stats_;
+  // Distinguishes the keys of this DB in a cache shared with others
+  std::string id_;
+  // The sequence number of the last write of a key in each stripe
+  std::array<std::atomic<SequenceNumber>, kNumKeyStripes> key_seqs_;
+  // The sequence number of the last range deletion in the column families
+  // of each stripe
+  std::array<std::atomic<SequenceNumber>, kNumCfStripes> cf_seqs_;
+  std::array<std::atomic<uint64_t>, kNumCfStripes> cf_epochs_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -465,8 +465,14 @@ Status TableCache::Get(
     }
     if (s.ok()) {
       get_context->SetReplayLog(row_cache_entry);  // nullptr if no cache.
+      if (options.pin_mmap_values) {
+        get_context->SetTableCacheHandle(
+            cache_.get(),
+            handle != nullptr ? handle : file_meta.table_reader_handle);
+      }
       s = t->Get(options, k, get_context, prefix_extractor.get(), skip_filters);
       get_context->SetReplayLog(nullptr);
+      get_context->SetTableCacheHandle(nullptr, nullptr);
     } else if (options.read_tier == kBlockCacheTier && s.IsIncomplete()) {
       // Couldn't find Table in cache but treat as kFound if no_io set
       get_context->MarkKeyMayExist();
@@ -569,6 +575,44 @@ Status TableCache::MultiGetFilter(
   return s;
 }
 
+Status TableCache::MultiGetPrefetchBlocks(
+    const ReadOptions& options,
+    const InternalKeyComparator& internal_comparator,
+    const FileMetaData& file_meta,
+    const std::shared_ptr<const SliceTransform>& prefix_extractor,
+    HistogramImpl* file_read_hist, bool skip_filters, int level,
+    const MultiGetContext::Range* mget_range, TypedHandle** table_handle,
+    AsyncReadBatch* read_batch) {
+#ifndef ROCKSDB_LITE
+  // Keys found in the row cache would not need the blocks
+  KeyContext& first_key = *mget_range->begin();
+  if (ioptions_.row_cache && !first_key.get_context->NeedToReadSequence()) {
+    return Status::NotSupported();
+  }
+#endif  // ROCKSDB_LITE
+  Status s;
+  TableReader* t = file_meta.fd.table_reader;
+  if (t == nullptr) {
+    if (*table_handle == nullptr) {
+      s = FindTable(options, file_options_, internal_comparator, file_meta,
+                    table_handle, prefix_extractor,
+                    options.read_tier == kBlockCacheTier /* no_io */,
+                    true /* record_read_stats */, file_read_hist, skip_filters,
+                    level, true /* prefetch_index_and_filter_in_cache */,
+                    /*max_file_size_for_l0_meta_pin=*/0,
+                    file_meta.temperature);
+    }
+    if (s.ok()) {
+      t = cache_.Value(*table_handle);
+    }
+  }
+  if (s.ok()) {
+    s = t->MultiGetPrefetchBlocks(options, mget_range, prefix_extractor.get(),
+                                  read_batch);
+  }
+  return s;
+}
+
 Status TableCache::GetTableProperties(
     const FileOptions& file_options,
     const InternalKeyComparator& internal_comparator,
@@ -645,6 +689,33 @@ void TableCache::Evict(Cache* cache, uint64_t file_number) {
   cache->Erase(GetSliceForFileNumber(&file_number));
 }
 
+Status TableCache::WarmUpBlocks(
+    const ReadOptions& read_options,
+    const InternalKeyComparator& internal_comparator,
+    const FileMetaData& file_meta, const std::vector<BlockHandle>& handles,
+    uint64_t* loaded_blocks, uint64_t* loaded_bytes,
+    const std::shared_ptr<const SliceTransform>& prefix_extractor) {
+  Status s;
+  TableReader* table_reader = file_meta.fd.table_reader;
+  TypedHandle* table_handle = nullptr;
+  if (table_reader == nullptr) {
+    s = FindTable(read_options, file_options_, internal_comparator, file_meta,
+                  &table_handle, prefix_extractor, false /* no_io */,
+                  true /* record_read_stats */);
+    if (s.ok()) {
+      table_reader = cache_.Value(table_handle);
+    }
+  }
+  if (s.ok()) {
+    s = table_reader->WarmUpBlocks(read_options, handles, loaded_blocks,
+                                   loaded_bytes);
+  }
+  if (table_handle != nullptr) {
+    cache_.Release(table_handle);
+  }
+  return s;
+}
+
 uint64_t TableCache::ApproximateOffsetOf(
     const Slice& key, const FileMetaData& file_meta, TableReaderCaller caller,
     const InternalKeyComparator& internal_comparator,
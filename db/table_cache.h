@@ -31,6 +31,7 @@ namespace ROCKSDB_NAMESPACE {
 
 class Env;
 class Arena;
+class AsyncReadBatch;
 struct FileDescriptor;
 class GetContext;
 class HistogramImpl;
@@ -137,6 +138,22 @@ class TableCache {
       HistogramImpl* file_read_hist, int level,
       MultiGetContext::Range* mget_range, TypedHandle** table_handle);
 
+  // Call table reader's MultiGetPrefetchBlocks to submit the reads of the
+  // blocks the keys in `mget_range` need to `read_batch`. Returns
+  // Status::NotSupported() if row cache needs to be checked or the table
+  // reader does not support it. Like MultiGetFilter(), if the table cache is
+  // looked up, the handle is returned in table_handle, unless it is non-null
+  // already, and should be passed back to MultiGet() after
+  // read_batch->Wait().
+  Status MultiGetPrefetchBlocks(
+      const ReadOptions& options,
+      const InternalKeyComparator& internal_comparator,
+      const FileMetaData& file_meta,
+      const std::shared_ptr<const SliceTransform>& prefix_extractor,
+      HistogramImpl* file_read_hist, bool skip_filters, int level,
+      const MultiGetContext::Range* mget_range, TypedHandle** table_handle,
+      AsyncReadBatch* read_batch);
+
   // If a seek to internal key "k" in specified file finds an entry,
   // call get_context->SaveValue() repeatedly until
   // it returns false. As a side effect, it will insert the TableReader
@@ -199,6 +216,15 @@ class TableCache {
       const FileMetaData& file_meta,
       const std::shared_ptr<const SliceTransform>& prefix_extractor = nullptr);
 
+  // Reads the data blocks at `handles` of a file into the block cache, see
+  // TableReader::WarmUpBlocks()
+  Status WarmUpBlocks(
+      const ReadOptions& read_options,
+      const InternalKeyComparator& internal_comparator,
+      const FileMetaData& file_meta, const std::vector<BlockHandle>& handles,
+      uint64_t* loaded_blocks, uint64_t* loaded_bytes,
+      const std::shared_ptr<const SliceTransform>& prefix_extractor = nullptr);
+
   // Returns approximated offset of a key in a file represented by fd.
   uint64_t ApproximateOffsetOf(
       const Slice& key, const FileMetaData& file_meta, TableReaderCaller caller,
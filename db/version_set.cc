@@ -43,6 +43,7 @@
 #include "folly/experimental/coro/BlockingWait.h"
 #include "folly/experimental/coro/Collect.h"
 #endif
+#include "file/async_read_batch.h"
 #include "file/filename.h"
 #include "file/random_access_file_reader.h"
 #include "file/read_write_util.h"
@@ -2485,11 +2486,11 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
       // For per level stats purposes, an L0 file is treated as a level
       bool dump_stats_for_l0_file = false;
 
-      // Avoid using the coroutine version if we're looking in a L0 file, since
-      // L0 files won't be parallelized anyway. The regular synchronous version
-      // is faster.
-      if (!read_options.async_io || !using_coroutines() ||
-          fp.GetHitFileLevel() == 0 || !fp.RemainingOverlapInLevel()) {
+      // Avoid reading files of a level in parallel if we're looking in a L0
+      // file, since L0 files won't be parallelized anyway. The regular
+      // synchronous version is faster.
+      if (!read_options.async_io || fp.GetHitFileLevel() == 0 ||
+          !fp.RemainingOverlapInLevel()) {
         if (f) {
           bool skip_filters =
               IsFilterSkipped(static_cast<int>(fp.GetHitFileLevel()),
@@ -2507,6 +2508,10 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
         if (s.ok()) {
           f = fp.GetNextFileInLevel();
         }
+      } else if (!using_coroutines()) {
+        s = MultiGetFromLevelWithBatchedReads(
+            read_options, &fp, &f, blob_ctxs, num_filter_read, num_index_read,
+            num_sst_read);
 #if USE_COROUTINES
       } else {
         std::vector<folly::coro::Task<Status>> mget_tasks;
@@ -2669,6 +2674,84 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
   }
 }
 
+Status Version::MultiGetFromLevelWithBatchedReads(
+    const ReadOptions& read_options, FilePickerMultiGet* fp,
+    FdWithKeyRange** f,
+    std::unordered_map<uint64_t, BlobReadContexts>& blob_ctxs,
+    uint64_t& num_filter_read, uint64_t& num_index_read,
+    uint64_t& num_sst_read) {
+  struct FileLookup {
+    FdWithKeyRange* f;
+    MultiGetRange file_range;
+    TableCache::TypedHandle* table_handle;
+    bool skip_filters;
+    bool skip_range_deletions;
+  };
+  autovector<FileLookup, 4> lookups;
+  AsyncReadBatch read_batch(cfd_->ioptions()->fs.get(), db_statistics_);
+  const int level = static_cast<int>(fp->GetHitFileLevel());
+  Status s;
+
+  // Filter the keys of each file of the level that may contain them, and
+  // submit the reads of the blocks they need.
+  while (*f != nullptr) {
+    MultiGetRange file_range = fp->CurrentFileRange();
+    TableCache::TypedHandle* table_handle = nullptr;
+    bool skip_filters = IsFilterSkipped(level, fp->IsHitFileLastInLevel());
+    bool skip_range_deletions = false;
+    if (!skip_filters) {
+      Status status = table_cache_->MultiGetFilter(
+          read_options, *internal_comparator(), *(*f)->file_metadata,
+          mutable_cf_options_.prefix_extractor,
+          cfd_->internal_stats()->GetFileReadHist(level), level, &file_range,
+          &table_handle);
+      skip_range_deletions = true;
+      if (status.ok()) {
+        skip_filters = true;
+      } else if (!status.IsNotSupported()) {
+        s = status;
+      }
+    }
+    if (s.ok() && !file_range.empty()) {
+      Status status = table_cache_->MultiGetPrefetchBlocks(
+          read_options, *internal_comparator(), *(*f)->file_metadata,
+          mutable_cf_options_.prefix_extractor,
+          cfd_->internal_stats()->GetFileReadHist(level), skip_filters, level,
+          &file_range, &table_handle, &read_batch);
+      // MultiGetFromSST() reads whatever could not be prefetched
+      status.PermitUncheckedError();
+    }
+    if (!file_range.empty()) {
+      lookups.push_back({*f, file_range, table_handle, skip_filters,
+                         skip_range_deletions});
+    } else if (table_handle != nullptr) {
+      table_cache_->get_cache().Release(table_handle);
+    }
+    if (!s.ok() || fp->KeyMaySpanNextFile()) {
+      break;
+    }
+    *f = fp->GetNextFileInLevel();
+  }
+
+  // Wait for all reads at once, and look up the keys in the now cached
+  // blocks.
+  read_batch.Wait();
+  for (FileLookup& lookup : lookups) {
+    if (s.ok()) {
+      s = MultiGetFromSST(read_options, lookup.file_range, level,
+                          lookup.skip_filters, lookup.skip_range_deletions,
+                          lookup.f, blob_ctxs, lookup.table_handle,
+                          num_filter_read, num_index_read, num_sst_read);
+    } else if (lookup.table_handle != nullptr) {
+      table_cache_->get_cache().Release(lookup.table_handle);
+    }
+  }
+  if (s.ok() && fp->KeyMaySpanNextFile()) {
+    *f = fp->GetNextFileInLevel();
+  }
+  return s;
+}
+
 #ifdef USE_COROUTINES
 Status Version::ProcessBatch(
     const ReadOptions& read_options, FilePickerMultiGet* batch,
@@ -1025,6 +1025,18 @@ class Version {
       TableCache::TypedHandle* table_handle, uint64_t& num_filter_read,
       uint64_t& num_index_read, uint64_t& num_sst_read);
 
+  // Looks up a batch of keys in the files of a single level starting from
+  // `*f`, without coroutines. The reads of the data blocks of all the files
+  // are submitted at once and waited for with a single poll, before the keys
+  // are looked up file by file. Leaves `*f` at the next file to look up in the
+  // level, if any.
+  Status MultiGetFromLevelWithBatchedReads(
+      const ReadOptions& read_options, FilePickerMultiGet* fp,
+      FdWithKeyRange** f,
+      std::unordered_map<uint64_t, BlobReadContexts>& blob_ctxs,
+      uint64_t& num_filter_read, uint64_t& num_index_read,
+      uint64_t& num_sst_read);
+
 #ifdef USE_COROUTINES
   // MultiGet using async IO to read data blocks from SST files in parallel
   // within and across levels
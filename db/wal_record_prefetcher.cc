@@ -0,0 +1,161 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/wal_record_prefetcher.h"
+
+#include <cassert>
+
+#include "db/write_batch_internal.h"
+#include "logging/logging.h"
+#include "test_util/sync_point.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+void WalRecordPrefetcher::Reporter::Corruption(size_t bytes, const Status& s) {
+  ROCKS_LOG_WARN(info_log, "%s%s: dropping %d bytes; %s",
+                 (status == nullptr ? "(ignoring error) " : ""), fname,
+                 static_cast<int>(bytes), s.ToString().c_str());
+  if (status != nullptr && status->ok()) {
+    *status = s;
+  }
+}
+
+WalRecordPrefetcher::WalRecordPrefetcher(
+    std::unique_ptr<SequentialFileReader>&& file_reader,
+    const std::string& fname, uint64_t wal_number,
+    const std::shared_ptr<Logger>& info_log, WALRecoveryMode wal_recovery_mode,
+    bool stop_on_corruption, SystemClock* clock, size_t max_buffered_bytes)
+    : fname_(fname),
+      wal_number_(wal_number),
+      wal_recovery_mode_(wal_recovery_mode),
+      clock_(clock),
+      max_buffered_bytes_(max_buffered_bytes),
+      reporter_(),
+      // We intentially make log::Reader do checksumming even if
+      // paranoid_checks==false so that corruptions cause entire commits
+      // to be skipped instead of propagating bad information (like overly
+      // large sequence numbers).
+      reader_(info_log, std::move(file_reader), &reporter_, true /*checksum*/,
+              wal_number),
+      cv_(&mu_) {
+  reporter_.info_log = info_log.get();
+  reporter_.fname = fname_.c_str();
+  reporter_.status = stop_on_corruption ? &reader_status_ : nullptr;
+}
+
+WalRecordPrefetcher::~WalRecordPrefetcher() { Stop(); }
+
+void WalRecordPrefetcher::StartAsync() {
+  assert(!async_);
+  async_ = true;
+  thread_ = port::Thread(&WalRecordPrefetcher::BackgroundRead, this);
+}
+
+void WalRecordPrefetcher::Stop() {
+  if (!async_) {
+    return;
+  }
+  {
+    MutexLock l(&mu_);
+    stop_ = true;
+    cv_.SignalAll();
+  }
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+bool WalRecordPrefetcher::ReadNextRecord(Record* record) {
+  Slice slice;
+  uint64_t record_checksum;
+  while (true) {
+    uint64_t start = clock_->NowMicros();
+    bool read = reader_.ReadRecord(&slice, &scratch_, wal_recovery_mode_,
+                                   &record_checksum);
+    read_micros_ += clock_->NowMicros() - start;
+    if (!read || !reader_status_.ok()) {
+      return false;
+    }
+    if (slice.size() < WriteBatchInternal::kHeader) {
+      reporter_.Corruption(slice.size(),
+                           Status::Corruption("log record too small"));
+      if (!reader_status_.ok()) {
+        return false;
+      }
+      continue;
+    }
+    break;
+  }
+
+  uint64_t start = clock_->NowMicros();
+  // We create a new batch and initialize with a valid prot_info_ to store
+  // the data checksums
+  record->record_size = slice.size();
+  record->status = WriteBatchInternal::SetContents(&record->batch, slice);
+  if (record->status.ok()) {
+    TEST_SYNC_POINT_CALLBACK(
+        "DBImpl::RecoverLogFiles:BeforeUpdateProtectionInfo:batch",
+        &record->batch);
+    TEST_SYNC_POINT_CALLBACK(
+        "DBImpl::RecoverLogFiles:BeforeUpdateProtectionInfo:checksum",
+        &record_checksum);
+    record->status = WriteBatchInternal::UpdateProtectionInfo(
+        &record->batch, 8 /* bytes_per_key */, &record_checksum);
+  }
+  decode_micros_ += clock_->NowMicros() - start;
+  num_records_++;
+  num_bytes_ += slice.size();
+  return true;
+}
+
+void WalRecordPrefetcher::BackgroundRead() {
+  while (true) {
+    {
+      MutexLock l(&mu_);
+      while (buffered_bytes_ >= max_buffered_bytes_ && !stop_) {
+        cv_.Wait();
+      }
+      if (stop_) {
+        break;
+      }
+    }
+    Record record;
+    bool more = ReadNextRecord(&record);
+    MutexLock l(&mu_);
+    if (!more) {
+      break;
+    }
+    buffered_bytes_ += record.record_size;
+    queue_.push_back(std::move(record));
+    cv_.SignalAll();
+  }
+  MutexLock l(&mu_);
+  done_ = true;
+  cv_.SignalAll();
+}
+
+bool WalRecordPrefetcher::Next(Record* record) {
+  if (!async_) {
+    return ReadNextRecord(record);
+  }
+  MutexLock l(&mu_);
+  if (queue_.empty() && !done_) {
+    uint64_t start = clock_->NowMicros();
+    while (queue_.empty() && !done_) {
+      cv_.Wait();
+    }
+    wait_micros_ += clock_->NowMicros() - start;
+  }
+  if (queue_.empty()) {
+    return false;
+  }
+  *record = std::move(queue_.front());
+  queue_.pop_front();
+  buffered_bytes_ -= record->record_size;
+  cv_.SignalAll();
+  return true;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
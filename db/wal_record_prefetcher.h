@@ -0,0 +1,124 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "db/log_reader.h"
+#include "port/port.h"
+#include "rocksdb/options.h"
+#include "rocksdb/status.h"
+#include "rocksdb/system_clock.h"
+#include "rocksdb/write_batch.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class Logger;
+
+// WalRecordPrefetcher reads the records of one WAL file, verifies their
+// checksums and decodes them into WriteBatches for DB recovery. By default
+// records are read inline by Next(). After StartAsync(), a background thread
+// reads ahead of the consumer into a bounded queue, so that reading and
+// decoding of a WAL overlap with memtable insertion of earlier records (and of
+// earlier WALs). Records are always returned in log order.
+//
+// Corruptions detected by the log reader are logged. If
+// `stop_on_corruption` is true, the first one also ends the stream and is
+// returned by status(), mirroring a log::Reader::Reporter that records into
+// the recovery status.
+class WalRecordPrefetcher {
+ public:
+  struct Record {
+    WriteBatch batch;
+    size_t record_size = 0;
+    // Non-ok if the record could not be decoded into a valid WriteBatch
+    Status status;
+  };
+
+  WalRecordPrefetcher(std::unique_ptr<SequentialFileReader>&& file_reader,
+                      const std::string& fname, uint64_t wal_number,
+                      const std::shared_ptr<Logger>& info_log,
+                      WALRecoveryMode wal_recovery_mode,
+                      bool stop_on_corruption, SystemClock* clock,
+                      size_t max_buffered_bytes);
+  // No copying allowed
+  WalRecordPrefetcher(const WalRecordPrefetcher&) = delete;
+  void operator=(const WalRecordPrefetcher&) = delete;
+
+  ~WalRecordPrefetcher();
+
+  // Starts reading on a background thread. Must be called at most once and
+  // before the first Next().
+  void StartAsync();
+
+  // Fills `*record` with the next record of the log and returns true. Returns
+  // false when the end of the log was reached or reading was stopped by a
+  // corruption, see status().
+  bool Next(Record* record);
+
+  // Stops the background thread, if any, discarding records that were not
+  // consumed yet. Statistics are only stable after this call.
+  void Stop();
+
+  // The corruption that stopped reading, if any. Valid once Next() returned
+  // false.
+  const Status& status() const { return reader_status_; }
+
+  uint64_t wal_number() const { return wal_number_; }
+
+  // Time spent reading records, including checksum verification
+  uint64_t read_micros() const { return read_micros_; }
+  // Time spent decoding records into WriteBatches
+  uint64_t decode_micros() const { return decode_micros_; }
+  // Time the consumer spent blocked waiting for the background thread
+  uint64_t wait_micros() const { return wait_micros_; }
+  uint64_t num_records() const { return num_records_; }
+  uint64_t num_bytes() const { return num_bytes_; }
+
+ private:
+  struct Reporter : public log::Reader::Reporter {
+    Logger* info_log;
+    const char* fname;
+    Status* status;  // nullptr if corruptions should only be logged
+    void Corruption(size_t bytes, const Status& s) override;
+  };
+
+  // Reads and decodes the next record. Called by exactly one thread.
+  bool ReadNextRecord(Record* record);
+  void BackgroundRead();
+
+  const std::string fname_;
+  const uint64_t wal_number_;
+  const WALRecoveryMode wal_recovery_mode_;
+  SystemClock* const clock_;
+  const size_t max_buffered_bytes_;
+
+  Status reader_status_;
+  Reporter reporter_;
+  log::Reader reader_;
+  std::string scratch_;
+
+  port::Mutex mu_;
+  port::CondVar cv_;
+  // Guarded by mu_ once the background thread is running
+  std::deque<Record> queue_;
+  size_t buffered_bytes_ = 0;
+  bool done_ = false;
+  bool stop_ = false;
+  bool async_ = false;
+  port::Thread thread_;
+
+  uint64_t read_micros_ = 0;
+  uint64_t decode_micros_ = 0;
+  uint64_t wait_micros_ = 0;
+  uint64_t num_records_ = 0;
+  uint64_t num_bytes_ = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -51,6 +51,7 @@
 #include "db/db_impl/db_impl.h"
 #include "db/dbformat.h"
 #include "db/flush_scheduler.h"
+#include "db/hot_key_cache.h"
 #include "db/kv_checksum.h"
 #include "db/memtable.h"
 #include "db/merge_context.h"
@@ -1753,6 +1754,8 @@ class MemTableInserter : public WriteBatch::Handler {
   // log number that all Memtables inserted into should reference
   uint64_t log_number_ref_;
   DBImpl* db_;
+  // nullptr if the DB has no hot key cache
+  HotKeyCache* const hot_key_cache_;
   const bool concurrent_memtable_writes_;
   bool post_info_created_;
   const WriteBatch::ProtectionInfo* prot_info_;
@@ -1829,6 +1832,14 @@ class MemTableInserter : public WriteBatch::Handler {
     return res;
   }
 
+  // Called before the memtable insert of a write of `key`, so that the write
+  // is not visible to readers yet
+  void InvalidateHotKey(uint32_t column_family_id, const Slice& key) {
+    if (hot_key_cache_ != nullptr) {
+      hot_key_cache_->Invalidate(column_family_id, key, sequence_);
+    }
+  }
+
   void DecrementProtectionInfoIdxForTryAgain() {
     if (prot_info_ != nullptr) --prot_info_idx_;
   }
@@ -1867,6 +1878,7 @@ class MemTableInserter : public WriteBatch::Handler {
         recovering_log_number_(recovering_log_number),
         log_number_ref_(0),
         db_(static_cast_with_check<DBImpl>(db)),
+        hot_key_cache_(db_ != nullptr ? db_->hot_key_cache() : nullptr),
         concurrent_memtable_writes_(concurrent_memtable_writes),
         post_info_created_(false),
         prot_info_(prot_info),
@@ -2013,6 +2025,7 @@ class MemTableInserter : public WriteBatch::Handler {
       return ret_status;
     }
     assert(ret_status.ok());
+    InvalidateHotKey(column_family_id, key);
 
     MemTable* mem = cf_mems_->GetMemTable();
     auto* moptions = mem->GetImmutableMemTableOptions();
@@ -2179,9 +2192,14 @@ class MemTableInserter : public WriteBatch::Handler {
     return s;
   }
 
-  Status DeleteImpl(uint32_t /*column_family_id*/, const Slice& key,
+  Status DeleteImpl(uint32_t column_family_id, const Slice& key,
                     const Slice& value, ValueType delete_type,
                     const ProtectionInfoKVOS64* kv_prot_info) {
+    if (hot_key_cache_ != nullptr && delete_type == kTypeRangeDeletion) {
+      hot_key_cache_->InvalidateColumnFamily(column_family_id, sequence_);
+    } else {
+      InvalidateHotKey(column_family_id, key);
+    }
     Status ret_status;
     MemTable* mem = cf_mems_->GetMemTable();
     ret_status =
@@ -2450,6 +2468,7 @@ class MemTableInserter : public WriteBatch::Handler {
       return Status::InvalidArgument(
           "Merge requires `ColumnFamilyOptions::merge_operator != nullptr`");
     }
+    InvalidateHotKey(column_family_id, key);
     bool perform_merge = false;
     assert(!concurrent_memtable_writes_ ||
            moptions->max_successive_merges == 0);
@@ -16,6 +16,41 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+void WriteQueueShardGate::EnterShared() {
+  while (true) {
+    shared_count_.fetch_add(1);
+    if (!exclusive_.load()) {
+      return;
+    }
+    // Back off so that the exclusive entry cannot be starved
+    ExitShared();
+    std::unique_lock<std::mutex> lock(mu_);
+    cv_.wait(lock, [this] { return !exclusive_.load(); });
+  }
+}
+
+void WriteQueueShardGate::ExitShared() {
+  if (shared_count_.fetch_sub(1) == 1 && exclusive_.load()) {
+    // Locking mu_ ensures that the exclusive waiter either has not checked
+    // shared_count_ yet or is waiting on cv_
+    std::lock_guard<std::mutex> lock(mu_);
+    cv_.notify_all();
+  }
+}
+
+void WriteQueueShardGate::EnterExclusive() {
+  std::unique_lock<std::mutex> lock(mu_);
+  cv_.wait(lock, [this] { return !exclusive_.load(); });
+  exclusive_.store(true);
+  cv_.wait(lock, [this] { return shared_count_.load() == 0; });
+}
+
+void WriteQueueShardGate::ExitExclusive() {
+  std::lock_guard<std::mutex> lock(mu_);
+  exclusive_.store(false);
+  cv_.notify_all();
+}
+
 WriteThread::WriteThread(const ImmutableDBOptions& db_options)
     : max_yield_usec_(db_options.enable_write_thread_adaptive_yield
                           ? db_options.write_thread_max_yield_usec
@@ -787,11 +822,17 @@ void WriteThread::EnterUnbatched(Writer* w, InstrumentedMutex* mu) {
   if (enable_pipelined_write_) {
     WaitForMemTableWriters();
   }
+  if (unbatched_gate_ != nullptr) {
+    unbatched_gate_->EnterExclusive();
+  }
   mu->Lock();
 }
 
 void WriteThread::ExitUnbatched(Writer* w) {
   assert(w != nullptr);
+  if (unbatched_gate_ != nullptr) {
+    unbatched_gate_->ExitExclusive();
+  }
   Writer* newest_writer = w;
   if (!newest_writer_.compare_exchange_strong(newest_writer, nullptr)) {
     CreateMissingNewerLinks(newest_writer);
@@ -27,6 +27,27 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+// Coordinates the write groups of the write queue shards of a DB (see
+// DBOptions::write_queue_shards). Groups entering the gate shared run
+// concurrently with each other. A group or an unbatched writer entering it
+// exclusively waits for the shared groups in progress to finish, and keeps new
+// ones from starting until it exits. Shared entries are not owned by a thread.
+class WriteQueueShardGate {
+ public:
+  void EnterShared();
+  void ExitShared();
+
+  void EnterExclusive();
+  void ExitExclusive();
+
+ private:
+  std::atomic<size_t> shared_count_{0};
+  std::atomic<bool> exclusive_{false};
+  // Guards the transitions of exclusive_ and the waits on cv_
+  std::mutex mu_;
+  std::condition_variable cv_;
+};
+
 class WriteThread {
  public:
   enum State : uint8_t {
@@ -362,6 +383,11 @@ class WriteThread {
   // Remove the dummy writer and wake up waiting writers
   void EndWriteStall();
 
+  // Makes EnterUnbatched() also enter `gate` exclusively, and ExitUnbatched()
+  // exit it, so that unbatched writers exclude the write groups of all the
+  // write queue shards.
+  void SetUnbatchedGate(WriteQueueShardGate* gate) { unbatched_gate_ = gate; }
+
  private:
   // See AwaitState.
   const uint64_t max_yield_usec_;
@@ -401,6 +427,9 @@ class WriteThread {
   port::Mutex stall_mu_;
   port::CondVar stall_cv_;
 
+  // See SetUnbatchedGate()
+  WriteQueueShardGate* unbatched_gate_ = nullptr;
+
   // Waits for w->state & goal_mask using w->StateMutex().  Returns
   // the state that satisfies goal_mask.
   uint8_t BlockingAwaitState(Writer* w, uint8_t goal_mask);
@@ -0,0 +1,80 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "file/async_read_batch.h"
+
+#include <vector>
+
+#include "monitoring/statistics.h"
+#include "rocksdb/system_clock.h"
+#include "util/stop_watch.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+void AsyncReadBatch::Read(RandomAccessFileReader* file, const IOOptions& opts,
+                          uint64_t offset, size_t len, Callback&& done) {
+  assert(!file->use_direct_io());
+  reads_.emplace_back();
+  PendingRead& read = reads_.back();
+  read.buf.reset(new char[len]);
+  read.req.offset = offset;
+  read.req.len = len;
+  read.req.scratch = read.buf.get();
+  read.done = std::move(done);
+  IOStatus s = file->ReadAsync(
+      read.req, opts,
+      [](const FSReadRequest& req, void* cb_arg) {
+        PendingRead* pending = static_cast<PendingRead*>(cb_arg);
+        pending->req.status = req.status;
+        pending->req.result = req.result;
+        pending->completed = true;
+      },
+      &read, &read.io_handle, &read.del_fn, /*aligned_buf=*/nullptr);
+  if (!s.ok()) {
+    // The callback is not called in this case
+    read.req.status = s;
+    read.io_handle = nullptr;
+    read.completed = true;
+  }
+}
+
+void AsyncReadBatch::Wait() {
+  if (reads_.empty()) {
+    return;
+  }
+  std::vector<void*> io_handles;
+  io_handles.reserve(reads_.size());
+  for (PendingRead& read : reads_) {
+    if (read.io_handle != nullptr) {
+      io_handles.push_back(read.io_handle);
+    }
+  }
+  if (!io_handles.empty()) {
+    StopWatch sw(SystemClock::Default().get(), stats_, POLL_WAIT_MICROS);
+    IOStatus s = fs_->Poll(io_handles, io_handles.size());
+    if (!s.ok()) {
+      // Make sure no callback fires after the requests are gone
+      fs_->AbortIO(io_handles).PermitUncheckedError();
+      for (PendingRead& read : reads_) {
+        if (!read.completed) {
+          read.req.status = s;
+          read.completed = true;
+        }
+      }
+    }
+  }
+  for (PendingRead& read : reads_) {
+    if (read.io_handle != nullptr && read.del_fn) {
+      read.del_fn(read.io_handle);
+    }
+    Status s = read.completed ? Status(read.req.status)
+                              : Status::IOError("read not completed");
+    read.done(s, read.req.result, std::move(read.buf));
+  }
+  RecordInHistogram(stats_, MULTIGET_IO_BATCH_SIZE, reads_.size());
+  reads_.clear();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,68 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+
+#include "file/random_access_file_reader.h"
+#include "rocksdb/file_system.h"
+#include "rocksdb/statistics.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// AsyncReadBatch submits reads of any number of files with
+// RandomAccessFileReader::ReadAsync() and waits for all of them with a single
+// FileSystem::Poll(). Unlike AsyncFileReader, it does not need coroutines:
+// callers submit all their reads first, and completion callbacks run from
+// Wait(), in submission order, on the calling thread.
+//
+// All files must belong to the FileSystem passed to the constructor. The
+// object is not thread safe.
+class AsyncReadBatch {
+ public:
+  // Receives the outcome of a read. On success, `result` points into `buf`.
+  using Callback = std::function<void(const Status& s, const Slice& result,
+                                      std::unique_ptr<char[]>&& buf)>;
+
+  AsyncReadBatch(FileSystem* fs, Statistics* stats) : fs_(fs), stats_(stats) {}
+  // No copying allowed
+  AsyncReadBatch(const AsyncReadBatch&) = delete;
+  void operator=(const AsyncReadBatch&) = delete;
+
+  ~AsyncReadBatch() { Wait(); }
+
+  // Submits reading `len` bytes at `offset` of `file` into a buffer
+  // allocated here. `done` is called from the next Wait(). The file must not
+  // use direct IO.
+  void Read(RandomAccessFileReader* file, const IOOptions& opts,
+            uint64_t offset, size_t len, Callback&& done);
+
+  // Waits for all submitted reads and calls their callbacks
+  void Wait();
+
+  size_t num_pending() const { return reads_.size(); }
+
+ private:
+  struct PendingRead {
+    FSReadRequest req;
+    std::unique_ptr<char[]> buf;
+    void* io_handle = nullptr;
+    IOHandleDeleter del_fn;
+    Callback done;
+    // Set by the ReadAsync() callback
+    bool completed = false;
+  };
+
+  FileSystem* const fs_;
+  Statistics* const stats_;
+  // A deque so that requests do not move while reads are in flight
+  std::deque<PendingRead> reads_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -252,6 +252,10 @@ std::string IdentityFileName(const std::string& dbname) {
   return dbname + "/IDENTITY";
 }
 
+std::string HotBlocksFileName(const std::string& dbname) {
+  return dbname + "/HOT_BLOCKS";
+}
+
 // Owned filenames have the form:
 //    dbname/IDENTITY
 //    dbname/CURRENT
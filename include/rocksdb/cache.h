@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -26,6 +27,7 @@ namespace ROCKSDB_NAMESPACE {
 
 class Cache;
 struct ConfigOptions;
+class FileSystem;
 class Logger;
 class SecondaryCache;
 
@@ -136,6 +138,32 @@ struct ShardedCacheOptions {
   CacheMetadataChargePolicy metadata_charge_policy =
       kDefaultCacheMetadataChargePolicy;
 
+  // EXPERIMENTAL
+  // If true, each shard keeps approximate access counts of keys (looked up,
+  // whether or not found) in a count-min sketch, and an insertion that would
+  // evict an entry is rejected, as if the new entry were inserted and
+  // evicted right away, when its key was accessed less often than that of
+  // the entry it would evict (TinyLFU admission). This keeps a working set
+  // of repeatedly read entries cached through scans that read many entries
+  // once. Insertions that pass a handle get a handle to an entry that is
+  // not in the cache and is freed on release, unless
+  // strict_capacity_limit is set, in which case they are not rejected.
+  // For HyperClockCache, which has no definite next victim, the entry is
+  // compared with the most recently evicted one.
+  bool frequency_admission = false;
+
+  // EXPERIMENTAL
+  // If true and the machine has more than one NUMA node, the shards are
+  // divided among the nodes, and entries inserted with Priority::HIGH, such
+  // as index and filter blocks with
+  // cache_index_and_filter_blocks_with_high_priority, are cached separately
+  // for each node, in the shards of the node of the reading thread. Hot
+  // read-only blocks then cost a copy per node in exchange for local
+  // lookups. For the block memory to be placed on the reading node too, use
+  // a memory_allocator such as NewNumaAllocator() with numa_node = -1.
+  // Only supported by LRUCache.
+  bool numa_aware = false;
+
   ShardedCacheOptions() {}
   ShardedCacheOptions(
       size_t _capacity, int _num_shard_bits, bool _strict_capacity_limit,
@@ -149,6 +177,25 @@ struct ShardedCacheOptions {
         metadata_charge_policy(_metadata_charge_policy) {}
 };
 
+// EXPERIMENTAL
+// Bounds on the part of the capacity of an LRUCache used by a class of
+// entries: those of a CacheEntryRole (see LRUCacheOptions::role_shares) or
+// those inserted through a tenant (see NewLRUCacheTenant()). Both are
+// fractions of the capacity, enforced per shard.
+struct CacheShare {
+  // While the entries of the class use no more than this, they are not
+  // evicted to make room for other entries, unless all evictable entries
+  // are protected this way.
+  double min_ratio = 0.0;
+  // Inserting an entry of the class that would take it over this evicts
+  // the least recently used entries of the class instead of others, or, if
+  // not enough of them can be evicted, fails like an insertion into a full
+  // cache.
+  double max_ratio = 1.0;
+
+  bool IsDefault() const { return min_ratio == 0.0 && max_ratio >= 1.0; }
+};
+
 struct LRUCacheOptions : public ShardedCacheOptions {
   // Ratio of cache reserved for high-priority and low-priority entries,
   // respectively. (See Cache::Priority below more information on the levels.)
@@ -186,6 +233,13 @@ struct LRUCacheOptions : public ShardedCacheOptions {
   // A SecondaryCache instance to use a the non-volatile tier.
   std::shared_ptr<SecondaryCache> secondary_cache;
 
+  // EXPERIMENTAL
+  // Shares of the capacity for the entries of each CacheEntryRole, indexed
+  // by role, e.g. to keep filter and index blocks cached through scans of
+  // data blocks, or to cap the blob values in a cache shared with blocks.
+  // The default share puts no bounds on the entries of the role.
+  std::array<CacheShare, kNumCacheEntryRoles> role_shares{};
+
   LRUCacheOptions() {}
   LRUCacheOptions(size_t _capacity, int _num_shard_bits,
                   bool _strict_capacity_limit, double _high_pri_pool_ratio,
@@ -221,6 +275,20 @@ extern std::shared_ptr<Cache> NewLRUCache(
 
 extern std::shared_ptr<Cache> NewLRUCache(const LRUCacheOptions& cache_opts);
 
+// EXPERIMENTAL
+// Returns a Cache that stores its entries in `lru_cache`, which must have
+// been created by NewLRUCache(), within `share` of its capacity, e.g. for
+// the block cache of a column family that should neither be evicted by nor
+// evict the blocks of other column families sharing the cache. The share
+// takes precedence over that of the role of an entry. Capacity and other
+// settings are those of `lru_cache`, except that GetUsage() only counts the
+// entries inserted through the tenant. Returns nullptr if `lru_cache` is
+// not an LRUCache, if `share` is invalid, or if the cache already has the
+// maximum number of tenants (kMaxLRUCacheTenants).
+extern std::shared_ptr<Cache> NewLRUCacheTenant(
+    const std::shared_ptr<Cache>& lru_cache, const CacheShare& share);
+constexpr uint32_t kMaxLRUCacheTenants = 64;
+
 // EXPERIMENTAL
 // Options structure for configuring a SecondaryCache instance based on
 // LRUCache. The LRUCacheOptions.secondary_cache is not used and
@@ -240,6 +308,24 @@ struct CompressedSecondaryCacheOptions : LRUCacheOptions {
   // into chunks so that they may better fit jemalloc bins.
   bool enable_custom_split_merge = false;
 
+  // The compression level, as in CompressionOptions::level. The default
+  // (32767, CompressionOptions::kDefaultCompressionLevel) lets the
+  // compression library choose. Negative levels select the fast modes of
+  // kLZ4Compression, with an acceleration of -compression_level, and of
+  // kZSTD, which trade compression ratio for much faster compression and
+  // decompression.
+  int compression_level = 32767;
+
+  // If positive, a compression dictionary of up to this many bytes is built
+  // for each CacheEntryRole (data blocks, index blocks, ...) from the values
+  // of that role first inserted, and the values inserted afterwards are
+  // compressed with it. This improves the compression ratio of small blocks
+  // a lot. ZSTD dictionaries are trained with the ZSTD dictionary trainer
+  // when it is supported. Other compression types use the sampled values as
+  // the dictionary. The dictionaries are kept in memory, not charged to the
+  // cache, for as long as the cache lives.
+  uint32_t max_dict_bytes = 0;
+
   CompressedSecondaryCacheOptions() {}
   CompressedSecondaryCacheOptions(
       size_t _capacity, int _num_shard_bits, bool _strict_capacity_limit,
@@ -277,13 +363,58 @@ extern std::shared_ptr<SecondaryCache> NewCompressedSecondaryCache(
 extern std::shared_ptr<SecondaryCache> NewCompressedSecondaryCache(
     const CompressedSecondaryCacheOptions& opts);
 
+// EXPERIMENTAL
+// Options for a SecondaryCache that stores blocks evicted from the primary
+// cache in log-structured files on a local device, typically an NVMe SSD,
+// in front of slower (e.g. network) storage holding the SST files.
+struct FileSecondaryCacheOptions {
+  // Directory for the cache files. The index of the cache is only kept in
+  // memory, so files left in it by a previous instance are deleted on open.
+  std::string path;
+
+  // Maximum total size of the cache files. Once exceeded, the oldest file
+  // and all the blocks in it are dropped.
+  uint64_t capacity = 0;
+
+  // Size of each cache file. Blocks are appended to the newest file and the
+  // space is reclaimed a file at a time, so this should be a small fraction
+  // of capacity. Smaller sizes are used when capacity is less than four
+  // times this.
+  uint64_t file_size = 64 << 20;
+
+  // Blocks are appended to an in-memory buffer of this size, which is
+  // written to the current file once full. Lookups of buffered blocks are
+  // served from memory.
+  size_t write_buffer_size = 1 << 20;
+
+  // Frequency-based admission: a block evicted from the primary cache is
+  // only written once its key has missed in this cache at least this many
+  // times (approximately, as counted by a periodically aged sketch), so
+  // blocks read only once do not wear out the device. 0 or 1 admits every
+  // block.
+  uint32_t admission_min_frequency = 2;
+
+  // Number of threads serving Lookup() with wait = false, which returns a
+  // handle whose read is in progress. 0 reads in Lookup() in any case.
+  int num_read_threads = 4;
+
+  // The file system of `path`. nullptr means FileSystem::Default().
+  std::shared_ptr<FileSystem> file_system;
+};
+
+// EXPERIMENTAL
+// Create a new Secondary Cache that stores blocks in files on a local device.
+// Returns a non-OK status if the cache directory cannot be set up.
+extern Status NewFileSecondaryCache(const FileSecondaryCacheOptions& opts,
+                                    std::shared_ptr<SecondaryCache>* cache);
+
 // HyperClockCache - A lock-free Cache alternative for RocksDB block cache
 // that offers much improved CPU efficiency vs. LRUCache under high parallel
 // load or high contention, with some caveats:
 // * Not a general Cache implementation: can only be used for
 // BlockBasedTableOptions::block_cache, which RocksDB uses in a way that is
 // compatible with HyperClockCache.
-// * Requires an extra tuning parameter: see estimated_entry_charge below.
+// * Best with an extra tuning parameter: see estimated_entry_charge below.
 // Similarly, substantially changing the capacity with SetCapacity could
 // harm efficiency.
 // * SecondaryCache is not yet supported.
@@ -325,6 +456,15 @@ struct HyperClockCacheOptions : public ShardedCacheOptions {
   // GetOccupancyCount(). However, when the average value size might vary
   // (e.g. balance between metadata and data blocks in cache), it is better
   // to estimate toward the lower side than the higher side.
+  //
+  // 0 means no estimate: the table starts small and grows as needed, without
+  // blocking lookups, up to a size suitable for an average entry charge of
+  // 256 bytes (with the initial capacity). The table does not shrink. This
+  // is recommended when entry sizes vary a lot or are not known in advance,
+  // e.g. for a block cache shared by column families with different block
+  // sizes. The slots are reserved up front as address space that is only
+  // backed by memory when used. Lookups can take extra probes for entries
+  // inserted before the table last grew.
   size_t estimated_entry_charge;
 
   HyperClockCacheOptions(
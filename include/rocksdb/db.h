@@ -140,6 +140,22 @@ struct GetMergeOperandsOptions {
   int expected_max_number_of_operands = 0;
 };
 
+// Progress of loading the blocks listed in the HOT_BLOCKS file into the block
+// cache on DB::Open(). See DBOptions::warm_block_cache_on_open.
+struct BlockCacheWarmupProgress {
+  // Blocks listed in the file
+  uint64_t total_blocks = 0;
+  // Blocks read into the block cache so far, and their size
+  uint64_t loaded_blocks = 0;
+  uint64_t loaded_bytes = 0;
+  // Blocks of files no longer in the DB, already cached, or failing to load
+  uint64_t skipped_blocks = 0;
+  // Whether the warm-up finished, or stopped early because it was cancelled
+  // or the DB is closing
+  bool done = false;
+  bool cancelled = false;
+};
+
 // A collections of table properties objects, where
 //  key: is the table's file name.
 //  value: the table properties object of the given table.
@@ -1692,6 +1708,19 @@ class DB {
 
 #endif  // ROCKSDB_LITE
 
+  // Reports the progress of the block cache warm-up started by DB::Open().
+  // Returns NotSupported() if the DB did not start one.
+  virtual Status GetBlockCacheWarmupProgress(
+      BlockCacheWarmupProgress* /*progress*/) {
+    return Status::NotSupported("Block cache warm-up not supported");
+  }
+
+  // Stops the block cache warm-up started by DB::Open(), if still running.
+  // Blocks already loaded stay in the cache.
+  virtual Status CancelBlockCacheWarmup() {
+    return Status::NotSupported("Block cache warm-up not supported");
+  }
+
   // Returns the unique ID which is read from IDENTITY file during the opening
   // of database by setting in the identity variable
   // Returns Status::OK if identity could be set properly
@@ -210,6 +210,32 @@ struct WriteStallInfo {
   } condition;
 };
 
+// Statistics of the WAL replay performed by DB::Open. Reading and decoding
+// times are summed over all threads that read WAL files (see
+// DBOptions::wal_recovery_threads), so they can exceed total_micros.
+struct WalRecoveryInfo {
+  // the name of the DB
+  std::string db_name;
+  // the WAL files that were replayed, in replay order
+  std::vector<uint64_t> wal_numbers;
+  // number of WAL records replayed
+  uint64_t num_records = 0;
+  // total size of the WAL records replayed
+  uint64_t num_bytes = 0;
+  // time spent reading WAL records, including checksum verification
+  uint64_t read_micros = 0;
+  // time spent decoding WAL records into write batches
+  uint64_t decode_micros = 0;
+  // time the replaying thread waited for records from background readers
+  uint64_t wait_micros = 0;
+  // time spent inserting write batches into memtables
+  uint64_t insert_micros = 0;
+  // time spent flushing memtables that filled up during replay
+  uint64_t flush_micros = 0;
+  // wall-clock time of the whole WAL recovery
+  uint64_t total_micros = 0;
+};
+
 #ifndef ROCKSDB_LITE
 
 struct FileDeletionInfo {
@@ -840,6 +866,12 @@ class EventListener : public Customizable {
   // happens. ShouldBeNotifiedOnFileIO should be set to true to get a callback.
   virtual void OnIOError(const IOErrorInfo& /*info*/) {}
 
+  // A callback function for RocksDB which will be called once the WAL files
+  // have been replayed successfully during DB::Open(), before the DB is
+  // returned to the user. Note that the DB is not yet accessible at that
+  // point, so the callback must not call into it.
+  virtual void OnWalRecoveryCompleted(const WalRecoveryInfo& /*info*/) {}
+
   ~EventListener() override {}
 };
 
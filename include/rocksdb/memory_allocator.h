@@ -78,4 +78,53 @@ extern Status NewJemallocNodumpAllocator(
     JemallocAllocatorOptions& options,
     std::shared_ptr<MemoryAllocator>* memory_allocator);
 
+struct NumaAllocatorOptions {
+  static const char* kName() { return "NumaAllocatorOptions"; }
+  // The NUMA node to allocate on, or -1 for the node of the core that the
+  // thread calling Allocate() runs on.
+  int numa_node = -1;
+};
+
+// EXPERIMENTAL
+// Generate memory allocator which allocates on NUMA nodes through libnuma.
+// With numa_node = -1, memory is local to the thread that allocates it, e.g.
+// the thread that reads a block into the block cache (see also
+// ShardedCacheOptions::numa_aware) or that fills a memtable arena (see
+// DBOptions::memtable_memory_allocator).
+//
+// Each allocation maps whole pages, so the allocator is meant for allocations
+// of a page or more. Returns NotSupported if not built with NUMA support
+// (-DNUMA and libnuma).
+extern Status NewNumaAllocator(
+    const NumaAllocatorOptions& options,
+    std::shared_ptr<MemoryAllocator>* memory_allocator);
+
+struct SlabAllocatorOptions {
+  static const char* kName() { return "SlabAllocatorOptions"; }
+  // The size of each slab mapped from the OS. With huge pages, it should be
+  // a multiple of the huge page size.
+  size_t slab_size = 2 << 20;
+  // Allocations larger than this are not served from slabs, but by malloc().
+  size_t max_slab_allocation_size = 256 << 10;
+  // Map slabs on huge pages (MAP_HUGETLB) of the system's default huge page
+  // size, e.g. 1 GiB with default_hugepagesz=1G, as long as enough of them
+  // are reserved. Otherwise slabs are mapped on normal pages and advised to
+  // be backed by transparent huge pages.
+  bool use_huge_pages = true;
+};
+
+// EXPERIMENTAL
+// Generate memory allocator which carves allocations out of large slabs,
+// each serving one size class (four per power of two), mapped preferably on
+// huge pages. A large block cache (see LRUCacheOptions::memory_allocator)
+// then spans few TLB entries. A slab is unmapped once none of its
+// allocations are in use, e.g. after the cache capacity was reduced, except
+// for one slab kept per size class.
+//
+// Each allocation carries a 16 byte header and is rounded up to its size
+// class, so memory overhead is up to about 25% plus partially used slabs.
+extern Status NewSlabAllocator(
+    const SlabAllocatorOptions& options,
+    std::shared_ptr<MemoryAllocator>* memory_allocator);
+
 }  // namespace ROCKSDB_NAMESPACE
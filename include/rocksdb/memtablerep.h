@@ -387,6 +387,33 @@ class VectorRepFactory : public MemTableRepFactory {
                                          Logger* logger) override;
 };
 
+// This creates MemTableReps that append entries to an array while they
+// arrive in order, or in any order before the memtable is first read, which
+// sorts them in place. Entries move to a skip list once one arrives out of
+// order after a read. An immutable memtable backed by a skip list is copied
+// into a sorted array on its first read, which makes flushing and reading it
+// faster. This is useful for workloads alternating between bulk loading and
+// mixed reads and writes.
+//
+// Does not support concurrent inserts, so it requires
+// DBOptions::allow_concurrent_memtable_write = false.
+class AdaptiveRepFactory : public MemTableRepFactory {
+ public:
+  AdaptiveRepFactory();
+
+  // Methods for Configurable/Customizable class overrides
+  static const char* kClassName() { return "AdaptiveRepFactory"; }
+  static const char* kNickName() { return "adaptive"; }
+  const char* Name() const override { return kClassName(); }
+  const char* NickName() const override { return kNickName(); }
+
+  // Methods for MemTableRepFactory class overrides
+  using MemTableRepFactory::CreateMemTableRep;
+  MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator&,
+                                 Allocator*, const SliceTransform*,
+                                 Logger* logger) override;
+};
+
 // This class contains a fixed array of buckets, each
 // pointing to a skiplist (null if the bucket is empty).
 // bucket_count: number of fixed array buckets
@@ -47,6 +47,7 @@ enum InfoLogLevel : unsigned char;
 class SstFileManager;
 class FilterPolicy;
 class Logger;
+class MemoryAllocator;
 class MergeOperator;
 class Snapshot;
 class MemTableRepFactory;
@@ -921,6 +922,15 @@ struct DBOptions {
   // Default: null
   std::shared_ptr<WriteBufferManager> write_buffer_manager = nullptr;
 
+  // EXPERIMENTAL
+  // If not null, memtables allocate the blocks of their arenas through this
+  // allocator. Blocks for concurrent writers are then allocated separately
+  // by the writing thread, so that with NewNumaAllocator() the memory each
+  // core writes to is on the NUMA node of that core.
+  //
+  // Default: null
+  std::shared_ptr<MemoryAllocator> memtable_memory_allocator = nullptr;
+
   // Specify the file access pattern once a compaction is started.
   // It will be applied to all input files of a compaction.
   // Default: NORMAL
@@ -1093,6 +1103,24 @@ struct DBOptions {
   // Default: false
   bool unordered_write = false;
 
+  // If greater than 1, writers are spread over this many independent write
+  // queues by the CPU core they run on. Each queue forms its own write batch
+  // groups with its own leader, so that groups of different queues write to
+  // the WAL and to the memtables concurrently. The queues share a single WAL:
+  // a group allocates its sequence numbers while appending to it, so the WAL
+  // is ordered by sequence number and recovery is unchanged. Unlike with
+  // unordered_write, sequence numbers become visible to reads in order, so
+  // snapshots remain immutable. Groups that need exclusive access, e.g. to
+  // switch memtables, to wait on a write stall or to run a WriteCallback, wait
+  // for the groups of the other queues to finish and block new ones.
+  //
+  // Requires allow_concurrent_memtable_write and is incompatible with
+  // enable_pipelined_write, unordered_write and two_write_queues, as well as
+  // with max_successive_merges > 0. 0 is treated as 1.
+  //
+  // Default: 1
+  size_t write_queue_shards = 1;
+
   // If true, allow multi-writers to update mem tables in parallel.
   // Only some memtable_factory-s support concurrent writes; currently it
   // is implemented only for SkipListFactory.  Concurrent memtable writes
@@ -1168,6 +1196,48 @@ struct DBOptions {
   // Not supported in ROCKSDB_LITE mode!
   std::shared_ptr<Cache> row_cache = nullptr;
 
+  // A cache for the results of Get()s by column family and user key,
+  // including keys not found, at the latest sequence number. Unlike the row
+  // cache, whose entries are tied to a table file, entries survive flushes
+  // and compactions, and are invalidated by writes of their keys instead, so
+  // that repeated Get()s of hot keys do not look at the memtables, filters
+  // or index blocks at all. Consider enabling
+  // ShardedCacheOptions::frequency_admission so that keys read once do not
+  // evict hot ones.
+  //
+  // Only used by Get() without a snapshot, timestamp or read callback, on
+  // column families without a compaction filter and not using FIFO
+  // compaction. Not used with unordered_write or by WritePrepared and
+  // WriteUnprepared transaction DBs.
+  // Default: nullptr (disabled)
+  // Not supported in ROCKSDB_LITE mode!
+  std::shared_ptr<Cache> hot_key_cache = nullptr;
+
+  // If non-zero, a sample of the reads of data blocks is counted, and every
+  // this many seconds, as well as when the DB is closed, the most read blocks
+  // are written to the HOT_BLOCKS file in the DB directory, hottest first.
+  // Counts are halved each time, so that the list follows changes of the
+  // workload. See warm_block_cache_on_open.
+  // Default: 0 (disabled)
+  // The periodic writes are not supported in ROCKSDB_LITE mode!
+  uint64_t hot_block_persist_period_sec = 0;
+
+  // The number of blocks listed in the HOT_BLOCKS file at most
+  // Default: 10000
+  size_t max_hot_blocks = 10000;
+
+  // If true, DB::Open() starts a background thread loading the blocks listed
+  // in the HOT_BLOCKS file into the block cache, hottest first, so that the
+  // cache is warm soon after a restart. DB::Open() does not wait for it. See
+  // DB::GetBlockCacheWarmupProgress() and DB::CancelBlockCacheWarmup().
+  // Default: false
+  bool warm_block_cache_on_open = false;
+
+  // Limits the rate of the reads of the block cache warm-up, so that they
+  // leave room for those of the workload. 0 means no limit.
+  // Default: 0
+  uint64_t block_cache_warmup_bytes_per_sec = 0;
+
 #ifndef ROCKSDB_LITE
   // A filter object supplied to be invoked while processing write-ahead-logs
   // (WALs) during recovery. The filter provides a way to inspect log
@@ -1276,6 +1346,17 @@ struct DBOptions {
   // Default: 0
   size_t log_readahead_size = 0;
 
+  // Number of threads used during DB::Open() to read WAL files, verify their
+  // checksums and decode their records ahead of the memtable insertion, which
+  // stays on the opening thread to preserve sequence number order. Each
+  // thread reads one WAL file, so up to this many WAL files are read
+  // concurrently, each buffering a bounded amount of decoded records. This
+  // mostly helps recovering many or large WAL files after an unclean
+  // shutdown. If 0, WAL records are read inline by the opening thread.
+  //
+  // Default: 0
+  int wal_recovery_threads = 0;
+
   // If user does NOT provide the checksum generator factory, the file checksum
   // will NOT be used. A new file checksum generator object will be created
   // when a SST file is created. Therefore, each created FileChecksumGenerator
@@ -1707,6 +1788,15 @@ struct ReadOptions {
   // Default: true
   bool optimize_multiget_for_io;
 
+  // With `DBOptions::allow_mmap_reads`, Get() returns values found in
+  // uncompressed data blocks as PinnableSlices pointing into the memory-mapped
+  // file instead of copying them. Each such PinnableSlice holds a reference
+  // to the table reader in the table cache until it is reset, so it must be
+  // reset before the DB is closed.
+  //
+  // Default: false
+  bool pin_mmap_values;
+
   ReadOptions();
   ReadOptions(bool cksum, bool cache);
 };
@@ -453,6 +453,11 @@ enum Tickers : uint32_t {
   // Number of errors returned to the async read callback
   ASYNC_READ_ERROR_COUNT,
 
+  // Get()s served by DBOptions::hot_key_cache, and those that might have
+  // been but were not
+  HOT_KEY_CACHE_HIT,
+  HOT_KEY_CACHE_MISS,
+
   TICKER_ENUM_MAX
 };
 
@@ -592,6 +597,27 @@ struct HistogramData {
   double min = 0.0;
 };
 
+// Raw state of a histogram at a point in time. Unlike HistogramData, two
+// snapshots of the same histogram can be subtracted, so a metrics scraper can
+// report what was recorded between two polls without calling Reset().
+struct HistogramSnapshot {
+  uint64_t count = 0;
+  uint64_t sum = 0;
+  uint64_t sum_squares = 0;
+  uint64_t min = 0;
+  uint64_t max = 0;
+  // Number of values recorded in each bucket
+  std::vector<uint64_t> buckets;
+
+  // Returns what was recorded between `earlier` and this snapshot of the same
+  // histogram. The min and max of the result are estimated from the bucket
+  // bounds. If the histogram was reset in between, returns this snapshot.
+  HistogramSnapshot Delta(const HistogramSnapshot& earlier) const;
+
+  // Computes percentiles and the other summary values from the snapshot
+  void Data(HistogramData* const data) const;
+};
+
 // StatsLevel can be used to reduce statistics overhead by skipping certain
 // types of stats in the stats collection process.
 // Usage:
@@ -645,6 +671,13 @@ class Statistics : public Customizable {
   virtual void histogramData(uint32_t type,
                              HistogramData* const data) const = 0;
   virtual std::string getHistogramString(uint32_t /*type*/) const { return ""; }
+  // Fills `snapshot` with the cumulative state of a histogram. Does not
+  // block recording or other readers, so the snapshot might miss values that
+  // are recorded concurrently.
+  virtual Status getHistogramSnapshot(uint32_t /*type*/,
+                                      HistogramSnapshot* /*snapshot*/) const {
+    return Status::NotSupported("Not implemented");
+  }
   virtual void recordTick(uint32_t tickerType, uint64_t count = 0) = 0;
   virtual void setTickerCount(uint32_t tickerType, uint64_t count) = 0;
   virtual uint64_t getAndResetTickerCount(uint32_t tickerType) = 0;
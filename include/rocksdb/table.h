@@ -229,6 +229,18 @@ struct BlockBasedTableOptions {
     // Makes the index significantly bigger (2x or more), especially when keys
     // are long.
     kBinarySearchWithFirstKey = 0x03,
+
+    // A piecewise-linear model predicts the data block of a key from the key
+    // read as a big-endian number, and only a few blocks around the prediction
+    // are binary searched. Separators are stored as fixed-width user keys and
+    // block handles as a single end offset, so the index is much smaller than
+    // a binary search index and seeks touch fewer cache lines.
+    // Meant for fixed-width integer keys encoded big-endian. Only applies to
+    // tables using BytewiseComparator() without user-defined timestamps whose
+    // data blocks end in user keys of the same width of at most 8 bytes, with
+    // no user key spanning two data blocks and no padding between data blocks
+    // (see `block_align`). Other tables fall back to kBinarySearch.
+    kLearnedSearch = 0x04,
   };
 
   IndexType index_type = kBinarySearch;
@@ -245,6 +257,30 @@ struct BlockBasedTableOptions {
   // kDataBlockBinaryAndHash.
   double data_block_hash_table_util_ratio = 0.75;
 
+  // If true, data blocks store the first 8 bytes of the key at each restart
+  // point in a contiguous array after the restart array. Seeks within a
+  // block first narrow the binary search down to the restart points sharing
+  // the prefix of the target, comparing integers instead of decoding restart
+  // keys, which are a cache miss each. This costs 8 bytes per restart point,
+  // so it pays off most with small `block_restart_interval` and keys whose
+  // first 8 bytes are selective.
+  //
+  // Only applies to tables using BytewiseComparator() without user-defined
+  // timestamps, and to data blocks of at most 64KiB. Files written with this
+  // option cannot be read by versions that do not support it.
+  bool data_block_restart_key_prefixes = false;
+
+  // EXPERIMENTAL
+  // If true, data blocks read while a block cache is configured are expanded
+  // once, when the block is parsed: their keys are materialized in a flat
+  // array along with a table of their offsets, so that seeking and stepping
+  // through a cached block is a binary search over whole keys, without
+  // decoding delta-encoded keys or varints on every cache hit. This costs
+  // memory for a copy of the keys and 20 bytes per entry, which is charged
+  // to the block cache with the block. Iterators over files with a global
+  // sequence number (ingested files) do not use the expanded form.
+  bool cache_expanded_data_blocks = false;
+
   // Option hash_index_allow_collision is now deleted.
   // It will behave as if hash_index_allow_collision=true.
 
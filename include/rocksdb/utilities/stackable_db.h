@@ -171,6 +171,15 @@ class StackableDB : public DB {
     return db_->VerifyChecksum(options);
   }
 
+  Status GetBlockCacheWarmupProgress(
+      BlockCacheWarmupProgress* progress) override {
+    return db_->GetBlockCacheWarmupProgress(progress);
+  }
+
+  Status CancelBlockCacheWarmup() override {
+    return db_->CancelBlockCacheWarmup();
+  }
+
   using DB::KeyMayExist;
   virtual bool KeyMayExist(const ReadOptions& options,
                            ColumnFamilyHandle* column_family, const Slice& key,
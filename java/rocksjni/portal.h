@@ -5155,6 +5155,10 @@ class TickerTypeJni {
         return -0x35;
       case ROCKSDB_NAMESPACE::Tickers::ASYNC_READ_ERROR_COUNT:
         return -0x36;
+      case ROCKSDB_NAMESPACE::Tickers::HOT_KEY_CACHE_HIT:
+        return -0x37;
+      case ROCKSDB_NAMESPACE::Tickers::HOT_KEY_CACHE_MISS:
+        return -0x38;
       case ROCKSDB_NAMESPACE::Tickers::TICKER_ENUM_MAX:
         // 0x5F was the max value in the initial copy of tickers to Java.
         // Since these values are exposed directly to Java clients, we keep
@@ -5542,6 +5546,10 @@ class TickerTypeJni {
         return ROCKSDB_NAMESPACE::Tickers::READ_ASYNC_MICROS;
       case -0x36:
         return ROCKSDB_NAMESPACE::Tickers::ASYNC_READ_ERROR_COUNT;
+      case -0x37:
+        return ROCKSDB_NAMESPACE::Tickers::HOT_KEY_CACHE_HIT;
+      case -0x38:
+        return ROCKSDB_NAMESPACE::Tickers::HOT_KEY_CACHE_MISS;
       case 0x5F:
         // 0x5F was the max value in the initial copy of tickers to Java.
         // Since these values are exposed directly to Java clients, we keep
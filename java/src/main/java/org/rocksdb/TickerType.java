@@ -836,6 +836,17 @@ public enum TickerType {
      */
     BLOB_DB_CACHE_BYTES_WRITE((byte) -0x34),
 
+    /**
+     * # of Get()s served by the hot key cache.
+     */
+    HOT_KEY_CACHE_HIT((byte) -0x37),
+
+    /**
+     * # of Get()s that might have been served by the hot key cache but were
+     * not.
+     */
+    HOT_KEY_CACHE_MISS((byte) -0x38),
+
     TICKER_ENUM_MAX((byte) 0x5F);
 
     private final byte value;
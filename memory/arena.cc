@@ -33,8 +33,11 @@ size_t Arena::OptimizeBlockSize(size_t block_size) {
   return block_size;
 }
 
-Arena::Arena(size_t block_size, AllocTracker* tracker, size_t huge_page_size)
-    : kBlockSize(OptimizeBlockSize(block_size)), tracker_(tracker) {
+Arena::Arena(size_t block_size, AllocTracker* tracker, size_t huge_page_size,
+             MemoryAllocator* block_allocator)
+    : kBlockSize(OptimizeBlockSize(block_size)),
+      tracker_(tracker),
+      block_allocator_(block_allocator) {
   assert(kBlockSize >= kMinBlockSize && kBlockSize <= kMaxBlockSize &&
          kBlockSize % kAlignUnit == 0);
   TEST_SYNC_POINT_CALLBACK("Arena::Arena:0", const_cast<size_t*>(&kBlockSize));
@@ -145,21 +148,25 @@ char* Arena::AllocateAligned(size_t bytes, size_t huge_page_size,
 char* Arena::AllocateNewBlock(size_t block_bytes) {
   // NOTE: std::make_unique zero-initializes the block so is not appropriate
   // here
-  char* block = new char[block_bytes];
-  blocks_.push_back(std::unique_ptr<char[]>(block));
+  blocks_.push_back(AllocateBlock(block_bytes, block_allocator_));
+  char* block = blocks_.back().get();
 
   size_t allocated_size;
+  if (block_allocator_ != nullptr) {
+    allocated_size = block_allocator_->UsableSize(block, block_bytes);
+  } else {
 #ifdef ROCKSDB_MALLOC_USABLE_SIZE
-  allocated_size = malloc_usable_size(block);
+    allocated_size = malloc_usable_size(block);
 #ifndef NDEBUG
-  // It's hard to predict what malloc_usable_size() returns.
-  // A callback can allow users to change the costed size.
-  std::pair<size_t*, size_t*> pair(&allocated_size, &block_bytes);
-  TEST_SYNC_POINT_CALLBACK("Arena::AllocateNewBlock:0", &pair);
+    // It's hard to predict what malloc_usable_size() returns.
+    // A callback can allow users to change the costed size.
+    std::pair<size_t*, size_t*> pair(&allocated_size, &block_bytes);
+    TEST_SYNC_POINT_CALLBACK("Arena::AllocateNewBlock:0", &pair);
 #endif  // NDEBUG
 #else
-  allocated_size = block_bytes;
+    allocated_size = block_bytes;
 #endif  // ROCKSDB_MALLOC_USABLE_SIZE
+  }
   blocks_memory_ += allocated_size;
   if (tracker_ != nullptr) {
     tracker_->Allocate(allocated_size);
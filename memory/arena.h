@@ -17,6 +17,7 @@
 #include <deque>
 
 #include "memory/allocator.h"
+#include "memory/memory_allocator.h"
 #include "port/mmap.h"
 #include "rocksdb/env.h"
 
@@ -39,8 +40,11 @@ class Arena : public Allocator {
   // huge_page_size: if 0, don't use huge page TLB. If > 0 (should set to the
   // supported hugepage size of the system), block allocation will try huge
   // page TLB first. If allocation fails, will fall back to normal case.
+  // block_allocator: if not nullptr, blocks other than huge page ones are
+  // allocated through it instead of new[]. Not owned.
   explicit Arena(size_t block_size = kMinBlockSize,
-                 AllocTracker* tracker = nullptr, size_t huge_page_size = 0);
+                 AllocTracker* tracker = nullptr, size_t huge_page_size = 0,
+                 MemoryAllocator* block_allocator = nullptr);
   ~Arena();
 
   char* Allocate(size_t bytes) override;
@@ -60,6 +64,11 @@ class Arena : public Allocator {
   char* AllocateAligned(size_t bytes, size_t huge_page_size = 0,
                         Logger* logger = nullptr) override;
 
+  // Returns a new block of `bytes` of its own rather than space from the
+  // current block, e.g. for the caller to carve up on the thread that is
+  // going to use it. Aligned like AllocateAligned().
+  char* AllocateSeparateBlock(size_t bytes) { return AllocateNewBlock(bytes); }
+
   // Returns an estimate of the total memory usage of data allocated
   // by the arena (exclude the space allocated but not yet used for future
   // allocations).
@@ -92,7 +101,7 @@ class Arena : public Allocator {
   // Number of bytes allocated in one block
   const size_t kBlockSize;
   // Allocated memory blocks
-  std::deque<std::unique_ptr<char[]>> blocks_;
+  std::deque<CacheAllocationPtr> blocks_;
   // Huge page allocations
   std::deque<MemMapping> huge_blocks_;
   size_t irregular_block_num = 0;
@@ -117,6 +126,7 @@ class Arena : public Allocator {
   size_t blocks_memory_ = 0;
   // Non-owned
   AllocTracker* tracker_;
+  MemoryAllocator* const block_allocator_;
 };
 
 inline char* Arena::Allocate(size_t bytes) {
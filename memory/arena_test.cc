@@ -15,6 +15,7 @@
 #include "port/port.h"
 #include "test_util/testharness.h"
 #include "util/random.h"
+#include "utilities/memory_allocators.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -217,6 +218,37 @@ size_t PopMinorPageFaultCount() {
 #endif  // RUSAGE_SELF
 }
 
+TEST_F(ArenaTest, BlockAllocator) {
+  constexpr size_t kBlockSize = 8192;
+  CountedMemoryAllocator allocator;
+  {
+    Arena arena(kBlockSize, nullptr /*tracker*/, 0 /*huge_page_size*/,
+                &allocator);
+    // The first allocations are from the inline block
+    arena.Allocate(100);
+    ASSERT_EQ(allocator.GetNumAllocations(), 0U);
+
+    for (int i = 0; i < 100; i++) {
+      char* p = arena.AllocateAligned(1000);
+      memset(p, 1, 1000);
+    }
+    uint64_t num_blocks = allocator.GetNumAllocations();
+    ASSERT_GT(num_blocks, 0U);
+    ASSERT_TRUE(CheckMemoryAllocated(arena.MemoryAllocatedBytes(),
+                                     Arena::kInlineSize +
+                                         num_blocks * kBlockSize));
+
+    // A separate block does not touch the current one
+    size_t remaining = arena.AllocatedAndUnused();
+    char* block = arena.AllocateSeparateBlock(kBlockSize / 2);
+    memset(block, 2, kBlockSize / 2);
+    ASSERT_EQ(allocator.GetNumAllocations(), num_blocks + 1);
+    ASSERT_EQ(arena.AllocatedAndUnused(), remaining);
+    ASSERT_EQ(allocator.GetNumDeallocations(), 0U);
+  }
+  ASSERT_EQ(allocator.GetNumDeallocations(), allocator.GetNumAllocations());
+}
+
 TEST(MmapTest, AllocateLazyZeroed) {
   // Doesn't have to be page aligned
   constexpr size_t len = 1234567;
@@ -41,13 +41,18 @@ class Logger;
 // shard blocks are allocated from the underlying main arena.
 class ConcurrentArena : public Allocator {
  public:
-  // block_size and huge_page_size are the same as for Arena (and are
-  // in fact just passed to the constructor of arena_.  The core-local
-  // shards compute their shard_block_size as a fraction of block_size
-  // that varies according to the hardware concurrency level.
+  // block_size, huge_page_size and block_allocator are the same as for
+  // Arena (and are in fact just passed to the constructor of arena_.  The
+  // core-local shards compute their shard_block_size as a fraction of
+  // block_size that varies according to the hardware concurrency level.
+  // With a block_allocator, each shard block is a separate block allocated
+  // on the thread that refills the shard, so that an allocator placing
+  // memory near the allocating core (such as NewNumaAllocator()) places it
+  // near the cores that write to it.
   explicit ConcurrentArena(size_t block_size = Arena::kMinBlockSize,
                            AllocTracker* tracker = nullptr,
-                           size_t huge_page_size = 0);
+                           size_t huge_page_size = 0,
+                           MemoryAllocator* block_allocator = nullptr);
 
   char* Allocate(size_t bytes) override {
     return AllocateImpl(bytes, false /*force_arena*/,
@@ -103,6 +108,7 @@ class ConcurrentArena : public Allocator {
   char padding0[56] ROCKSDB_FIELD_UNUSED;
 
   size_t shard_block_size_;
+  const bool separate_shard_blocks_;
 
   CoreLocalArray<Shard> shards_;
 
@@ -179,10 +185,16 @@ class ConcurrentArena : public Allocator {
         return rv;
       }
 
-      avail = exact >= shard_block_size_ / 2 && exact < shard_block_size_ * 2
-                  ? exact
-                  : shard_block_size_;
-      s->free_begin_ = arena_.AllocateAligned(avail);
+      if (separate_shard_blocks_) {
+        avail = shard_block_size_;
+        s->free_begin_ = arena_.AllocateSeparateBlock(avail);
+      } else {
+        avail =
+            exact >= shard_block_size_ / 2 && exact < shard_block_size_ * 2
+                ? exact
+                : shard_block_size_;
+        s->free_begin_ = arena_.AllocateAligned(avail);
+      }
       Fixup();
     }
     s->allocated_and_unused_.store(avail - bytes, std::memory_order_relaxed);
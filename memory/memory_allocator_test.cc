@@ -8,6 +8,8 @@
 
 #include "memory/jemalloc_nodump_allocator.h"
 #include "memory/memkind_kmem_allocator.h"
+#include "memory/numa_allocator.h"
+#include "memory/slab_allocator.h"
 #include "rocksdb/cache.h"
 #include "rocksdb/convenience.h"
 #include "rocksdb/db.h"
@@ -212,9 +214,129 @@ TEST_F(CreateMemoryAllocatorTest, NewJemallocNodumpAllocator) {
   ASSERT_EQ(opts->limit_tcache_size, jopts.limit_tcache_size);
 }
 
+TEST_F(CreateMemoryAllocatorTest, NewNumaAllocator) {
+  NumaAllocatorOptions nopts;
+  std::shared_ptr<MemoryAllocator> allocator;
+
+  ASSERT_NOK(NewNumaAllocator(nopts, nullptr));
+  Status s = NewNumaAllocator(nopts, &allocator);
+  std::string msg;
+  if (!NumaAllocator::IsSupported(&msg)) {
+    ASSERT_TRUE(s.IsNotSupported());
+    ROCKSDB_GTEST_BYPASS("NUMA not supported");
+    return;
+  }
+  ASSERT_OK(s);
+  ASSERT_NE(allocator, nullptr);
+
+  nopts.numa_node = port::NumaNodeCount();
+  ASSERT_TRUE(NewNumaAllocator(nopts, &allocator).IsInvalidArgument());
+
+  nopts.numa_node = 0;
+  ASSERT_OK(NewNumaAllocator(nopts, &allocator));
+  auto opts = allocator->GetOptions<NumaAllocatorOptions>();
+  ASSERT_NE(opts, nullptr);
+  ASSERT_EQ(opts->numa_node, 0);
+
+  ASSERT_OK(MemoryAllocator::CreateFromString(
+      config_options_,
+      std::string("id=") + NumaAllocator::kClassName() + "; numa_node=0",
+      &allocator));
+  opts = allocator->GetOptions<NumaAllocatorOptions>();
+  ASSERT_NE(opts, nullptr);
+  ASSERT_EQ(opts->numa_node, 0);
+}
+
+TEST_F(CreateMemoryAllocatorTest, NewSlabAllocator) {
+  SlabAllocatorOptions sopts;
+  std::shared_ptr<MemoryAllocator> allocator;
+
+  ASSERT_NOK(NewSlabAllocator(sopts, nullptr));
+  ASSERT_OK(NewSlabAllocator(sopts, &allocator));
+  ASSERT_NE(allocator, nullptr);
+
+  sopts.slab_size = 100000;
+  ASSERT_TRUE(NewSlabAllocator(sopts, &allocator).IsInvalidArgument());
+  sopts.slab_size = 64 << 10;
+  ASSERT_TRUE(NewSlabAllocator(sopts, &allocator).IsInvalidArgument());
+  sopts.max_slab_allocation_size = 16 << 10;
+  sopts.use_huge_pages = false;
+  ASSERT_OK(NewSlabAllocator(sopts, &allocator));
+  auto opts = allocator->GetOptions<SlabAllocatorOptions>();
+  ASSERT_NE(opts, nullptr);
+  ASSERT_EQ(opts->slab_size, 64 << 10);
+
+  ASSERT_OK(MemoryAllocator::CreateFromString(
+      config_options_,
+      std::string("id=") + SlabAllocator::kClassName() +
+          "; slab_size=65536; max_slab_allocation_size=16384; "
+          "use_huge_pages=false",
+      &allocator));
+  opts = allocator->GetOptions<SlabAllocatorOptions>();
+  ASSERT_NE(opts, nullptr);
+  ASSERT_EQ(opts->max_slab_allocation_size, 16 << 10);
+  ASSERT_FALSE(opts->use_huge_pages);
+}
+
+TEST_F(CreateMemoryAllocatorTest, SlabAllocatorSlabs) {
+  SlabAllocatorOptions sopts;
+  sopts.slab_size = 64 << 10;
+  sopts.max_slab_allocation_size = 16 << 10;
+  sopts.use_huge_pages = false;
+  SlabAllocator allocator(sopts);
+  ASSERT_OK(allocator.PrepareOptions(config_options_));
+
+  // Fill 10 slabs with objects of a size class of 4 KiB + 1 KiB
+  std::vector<void*> blocks;
+  for (int i = 0; i < 120; ++i) {
+    void* p = allocator.Allocate(4100 + i % 20);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % alignof(std::max_align_t), 0);
+    ASSERT_EQ(allocator.UsableSize(p, 4100), 5120 - 16);
+    memset(p, i, 4100);
+    blocks.push_back(p);
+  }
+  SlabAllocator::Stats stats = allocator.GetStats();
+  ASSERT_EQ(stats.num_slabs, 10);
+  ASSERT_EQ(stats.mapped_bytes, 10 * sopts.slab_size);
+  ASSERT_GT(stats.allocated_bytes, 120 * 4100);
+  ASSERT_EQ(stats.num_huge_page_slabs, 0);
+
+  // Too large for slabs
+  void* large = allocator.Allocate(20000);
+  ASSERT_EQ(allocator.UsableSize(large, 20000), 20000);
+  ASSERT_EQ(allocator.GetStats().num_slabs, 10);
+  allocator.Deallocate(large);
+
+  // Freed objects are reused, and slabs are unmapped once unused, except
+  // for one
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    if (i % 12 != 0) {
+      allocator.Deallocate(blocks[i]);
+      blocks[i] = nullptr;
+    }
+  }
+  ASSERT_EQ(allocator.GetStats().num_slabs, 10);
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    if (blocks[i] == nullptr) {
+      blocks[i] = allocator.Allocate(4096);
+    }
+  }
+  ASSERT_EQ(allocator.GetStats().num_slabs, 10);
+  for (void* p : blocks) {
+    allocator.Deallocate(p);
+  }
+  stats = allocator.GetStats();
+  ASSERT_EQ(stats.num_slabs, 1);
+  ASSERT_EQ(stats.mapped_bytes, sopts.slab_size);
+  ASSERT_EQ(stats.allocated_bytes, 0);
+}
+
 INSTANTIATE_TEST_CASE_P(DefaultMemoryAllocator, MemoryAllocatorTest,
                         ::testing::Values(std::make_tuple(
                             DefaultMemoryAllocator::kClassName(), true)));
+INSTANTIATE_TEST_CASE_P(SlabAllocator, MemoryAllocatorTest,
+                        ::testing::Values(std::make_tuple(
+                            SlabAllocator::kClassName(), true)));
 #ifdef MEMKIND
 INSTANTIATE_TEST_CASE_P(
     MemkindkMemAllocator, MemoryAllocatorTest,
@@ -222,6 +344,13 @@ INSTANTIATE_TEST_CASE_P(
                                       MemkindKmemAllocator::IsSupported())));
 #endif  // MEMKIND
 
+#ifdef NUMA
+INSTANTIATE_TEST_CASE_P(
+    NumaAllocator, MemoryAllocatorTest,
+    ::testing::Values(std::make_tuple(NumaAllocator::kClassName(),
+                                      NumaAllocator::IsSupported())));
+#endif  // NUMA
+
 #ifdef ROCKSDB_JEMALLOC
 INSTANTIATE_TEST_CASE_P(
     JemallocNodumpAllocator, MemoryAllocatorTest,
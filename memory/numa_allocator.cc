@@ -0,0 +1,109 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "memory/numa_allocator.h"
+
+#ifdef NUMA
+#include <numa.h>
+#endif  // NUMA
+
+#include <cstddef>
+#include <new>
+
+#include "port/port.h"
+#include "rocksdb/utilities/options_type.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+static std::unordered_map<std::string, OptionTypeInfo> numa_type_info = {
+#ifndef ROCKSDB_LITE
+    {"numa_node",
+     {offsetof(struct NumaAllocatorOptions, numa_node), OptionType::kInt,
+      OptionVerificationType::kNormal, OptionTypeFlags::kNone}},
+#endif  // ROCKSDB_LITE
+};
+
+#ifdef NUMA
+// Precedes each allocation, for Deallocate() to know the size of the
+// mapping. Keeps the memory returned aligned like that of malloc().
+struct alignas(std::max_align_t) AllocationHeader {
+  size_t mapped_size;
+};
+#endif  // NUMA
+}  // namespace
+
+NumaAllocator::NumaAllocator(const NumaAllocatorOptions& options)
+    : options_(options) {
+  RegisterOptions(&options_, &numa_type_info);
+}
+
+bool NumaAllocator::IsSupported(std::string* why) {
+#ifdef NUMA
+  if (numa_available() < 0) {
+    *why = "NUMA is not available on this system";
+    return false;
+  }
+  return true;
+#else
+  *why = "Not compiled with NUMA";
+  return false;
+#endif  // NUMA
+}
+
+Status NumaAllocator::PrepareOptions(const ConfigOptions& config_options) {
+  std::string message;
+  if (!IsSupported(&message)) {
+    return Status::NotSupported(message);
+  }
+  if (options_.numa_node < -1 || options_.numa_node >= port::NumaNodeCount()) {
+    return Status::InvalidArgument("No such NUMA node",
+                                   std::to_string(options_.numa_node));
+  }
+  return MemoryAllocator::PrepareOptions(config_options);
+}
+
+#ifdef NUMA
+void* NumaAllocator::Allocate(size_t size) {
+  const size_t mapped_size = sizeof(AllocationHeader) + size;
+  const int node = options_.numa_node >= 0 ? options_.numa_node
+                                           : port::NumaNodeOfCurrentCore();
+  void* p = numa_alloc_onnode(mapped_size, node);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  auto header = static_cast<AllocationHeader*>(p);
+  header->mapped_size = mapped_size;
+  return header + 1;
+}
+
+void NumaAllocator::Deallocate(void* p) {
+  auto header = static_cast<AllocationHeader*>(p) - 1;
+  numa_free(header, header->mapped_size);
+}
+
+size_t NumaAllocator::UsableSize(void* p, size_t /*allocation_size*/) const {
+  // The mapping takes whole pages
+  const auto header = static_cast<const AllocationHeader*>(p) - 1;
+  const size_t page_size = static_cast<size_t>(numa_pagesize());
+  return (header->mapped_size + page_size - 1) / page_size * page_size -
+         sizeof(AllocationHeader);
+}
+#endif  // NUMA
+
+Status NewNumaAllocator(const NumaAllocatorOptions& options,
+                        std::shared_ptr<MemoryAllocator>* memory_allocator) {
+  if (memory_allocator == nullptr) {
+    return Status::InvalidArgument("memory_allocator must be non-null.");
+  }
+  std::unique_ptr<MemoryAllocator> allocator(new NumaAllocator(options));
+  Status s = allocator->PrepareOptions(ConfigOptions());
+  if (s.ok()) {
+    memory_allocator->reset(allocator.release());
+  }
+  return s;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,42 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <string>
+
+#include "rocksdb/memory_allocator.h"
+#include "utilities/memory_allocators.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A MemoryAllocator that maps each allocation on a NUMA node through libnuma,
+// either a fixed node or the node of the core of the allocating thread. See
+// NewNumaAllocator().
+class NumaAllocator : public BaseMemoryAllocator {
+ public:
+  explicit NumaAllocator(const NumaAllocatorOptions& options);
+
+  static const char* kClassName() { return "NumaAllocator"; }
+  const char* Name() const override { return kClassName(); }
+  static bool IsSupported() {
+    std::string unused;
+    return IsSupported(&unused);
+  }
+  static bool IsSupported(std::string* why);
+
+  Status PrepareOptions(const ConfigOptions& config_options) override;
+
+#ifdef NUMA
+  void* Allocate(size_t size) override;
+  void Deallocate(void* p) override;
+  size_t UsableSize(void* p, size_t allocation_size) const override;
+#endif  // NUMA
+
+ private:
+  NumaAllocatorOptions options_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,320 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "memory/slab_allocator.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "port/mmap.h"
+#include "rocksdb/utilities/options_type.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+static std::unordered_map<std::string, OptionTypeInfo> slab_type_info = {
+#ifndef ROCKSDB_LITE
+    {"slab_size",
+     {offsetof(struct SlabAllocatorOptions, slab_size), OptionType::kSizeT,
+      OptionVerificationType::kNormal, OptionTypeFlags::kNone}},
+    {"max_slab_allocation_size",
+     {offsetof(struct SlabAllocatorOptions, max_slab_allocation_size),
+      OptionType::kSizeT, OptionVerificationType::kNormal,
+      OptionTypeFlags::kNone}},
+    {"use_huge_pages",
+     {offsetof(struct SlabAllocatorOptions, use_huge_pages),
+      OptionType::kBoolean, OptionVerificationType::kNormal,
+      OptionTypeFlags::kNone}},
+#endif  // ROCKSDB_LITE
+};
+
+// Precedes each allocation. Keeps the memory returned aligned like that of
+// malloc(). Holds the free list link while the object is free.
+struct alignas(std::max_align_t) ObjectHeader {
+  // nullptr for allocations not from a slab
+  void* slab;
+  size_t size;
+};
+
+constexpr size_t kSmallestObject = 64;
+constexpr size_t kSlabAlignment = 4096;
+}  // namespace
+
+struct SlabAllocator::Slab {
+  Slab(MemMapping&& _mapping, SizeClass* _size_class, bool _huge_pages)
+      : mapping(std::move(_mapping)),
+        size_class(_size_class),
+        huge_pages(_huge_pages),
+        next_unused(static_cast<char*>(mapping.Get())),
+        end(next_unused + mapping.Length()) {}
+
+  bool HasFree(size_t object_size) const {
+    return free_list != nullptr ||
+           static_cast<size_t>(end - next_unused) >= object_size;
+  }
+
+  MemMapping mapping;
+  SizeClass* const size_class;
+  const bool huge_pages;
+  // Objects from next_unused to end were never allocated
+  char* next_unused;
+  char* const end;
+  ObjectHeader* free_list = nullptr;
+  size_t num_used = 0;
+  // Links in the list of the size class holding the slab
+  Slab* prev = nullptr;
+  Slab* next = nullptr;
+};
+
+struct SlabAllocator::SizeClass {
+  explicit SizeClass(size_t _object_size) : object_size(_object_size) {}
+
+  static void PushFront(Slab** head, Slab* slab) {
+    slab->prev = nullptr;
+    slab->next = *head;
+    if (*head != nullptr) {
+      (*head)->prev = slab;
+    }
+    *head = slab;
+  }
+
+  static void Unlink(Slab** head, Slab* slab) {
+    if (slab->prev != nullptr) {
+      slab->prev->next = slab->next;
+    } else {
+      assert(*head == slab);
+      *head = slab->next;
+    }
+    if (slab->next != nullptr) {
+      slab->next->prev = slab->prev;
+    }
+    slab->prev = slab->next = nullptr;
+  }
+
+  // Including the header
+  const size_t object_size;
+  port::Mutex mutex;
+  // Slabs with free objects, and those without
+  Slab* partial = nullptr;
+  Slab* full = nullptr;
+  // Slabs in partial without allocated objects
+  size_t num_empty = 0;
+};
+
+SlabAllocator::SlabAllocator(const SlabAllocatorOptions& options)
+    : options_(options) {
+  RegisterOptions(&options_, &slab_type_info);
+  InitSizeClasses();
+}
+
+SlabAllocator::~SlabAllocator() {
+  for (auto& size_class : size_classes_) {
+    for (Slab** list : {&size_class->partial, &size_class->full}) {
+      while (*list != nullptr) {
+        Slab* slab = *list;
+        SizeClass::Unlink(list, slab);
+        delete slab;
+      }
+    }
+  }
+}
+
+Status SlabAllocator::PrepareOptions(const ConfigOptions& config_options) {
+  if (options_.slab_size == 0 || options_.slab_size % kSlabAlignment != 0) {
+    return Status::InvalidArgument(
+        "slab_size must be a positive multiple of 4096");
+  }
+  if (options_.max_slab_allocation_size + sizeof(ObjectHeader) >
+      options_.slab_size) {
+    return Status::InvalidArgument(
+        "max_slab_allocation_size must leave room in a slab for a header");
+  }
+  // The options might have changed since construction. Nothing can be
+  // allocated yet.
+  if (num_slabs_.load(std::memory_order_relaxed) == 0) {
+    InitSizeClasses();
+  }
+  return MemoryAllocator::PrepareOptions(config_options);
+}
+
+void SlabAllocator::InitSizeClasses() {
+  size_classes_.clear();
+  const size_t largest =
+      options_.max_slab_allocation_size + sizeof(ObjectHeader);
+  for (size_t base = kSmallestObject;; base *= 2) {
+    for (size_t i = 4; i < 8; ++i) {
+      const size_t object_size = std::min(base / 4 * i, options_.slab_size);
+      size_classes_.emplace_back(new SizeClass(object_size));
+      // Slabs might not be large enough before PrepareOptions() checked
+      if (object_size >= largest || object_size == options_.slab_size) {
+        return;
+      }
+    }
+  }
+}
+
+size_t SlabAllocator::SizeClassFor(size_t size) const {
+  if (size > options_.max_slab_allocation_size) {
+    return size_classes_.size();
+  }
+  const size_t object_size = size + sizeof(ObjectHeader);
+  auto it = std::lower_bound(
+      size_classes_.begin(), size_classes_.end(), object_size,
+      [](const std::unique_ptr<SizeClass>& size_class, size_t s) {
+        return size_class->object_size < s;
+      });
+  return static_cast<size_t>(it - size_classes_.begin());
+}
+
+std::unique_ptr<SlabAllocator::Slab> SlabAllocator::NewSlab(
+    SizeClass* size_class) {
+  bool huge_pages = options_.use_huge_pages &&
+                    !huge_pages_failed_.load(std::memory_order_relaxed);
+  MemMapping mapping = huge_pages
+                           ? MemMapping::AllocateHuge(options_.slab_size)
+                           : MemMapping::AllocateLazyZeroed(options_.slab_size);
+  if (huge_pages && mapping.Get() == nullptr) {
+    huge_pages_failed_.store(true, std::memory_order_relaxed);
+    huge_pages = false;
+    mapping = MemMapping::AllocateLazyZeroed(options_.slab_size);
+  }
+  if (mapping.Get() == nullptr) {
+    throw std::bad_alloc();
+  }
+#ifdef MADV_HUGEPAGE
+  if (options_.use_huge_pages && !huge_pages) {
+    // No huge pages reserved. Ask for transparent huge pages instead.
+    madvise(mapping.Get(), mapping.Length(), MADV_HUGEPAGE);
+  }
+#endif  // MADV_HUGEPAGE
+  mapped_bytes_.fetch_add(mapping.Length(), std::memory_order_relaxed);
+  num_slabs_.fetch_add(1, std::memory_order_relaxed);
+  if (huge_pages) {
+    num_huge_page_slabs_.fetch_add(1, std::memory_order_relaxed);
+  }
+  return std::unique_ptr<Slab>(
+      new Slab(std::move(mapping), size_class, huge_pages));
+}
+
+void* SlabAllocator::Allocate(size_t size) {
+  const size_t class_index = SizeClassFor(size);
+  ObjectHeader* header;
+  if (class_index == size_classes_.size()) {
+    header = static_cast<ObjectHeader*>(malloc(sizeof(ObjectHeader) + size));
+    if (header == nullptr) {
+      throw std::bad_alloc();
+    }
+    header->slab = nullptr;
+    mapped_bytes_.fetch_add(sizeof(ObjectHeader) + size,
+                            std::memory_order_relaxed);
+  } else {
+    SizeClass* size_class = size_classes_[class_index].get();
+    const size_t object_size = size_class->object_size;
+    MutexLock l(&size_class->mutex);
+    Slab* slab = size_class->partial;
+    if (slab == nullptr) {
+      slab = NewSlab(size_class).release();
+      SizeClass::PushFront(&size_class->partial, slab);
+      size_class->num_empty++;
+    }
+    if (slab->num_used == 0) {
+      assert(size_class->num_empty > 0);
+      size_class->num_empty--;
+    }
+    if (slab->free_list != nullptr) {
+      header = slab->free_list;
+      slab->free_list = static_cast<ObjectHeader*>(header->slab);
+    } else {
+      header = reinterpret_cast<ObjectHeader*>(slab->next_unused);
+      slab->next_unused += object_size;
+    }
+    slab->num_used++;
+    if (!slab->HasFree(object_size)) {
+      SizeClass::Unlink(&size_class->partial, slab);
+      SizeClass::PushFront(&size_class->full, slab);
+    }
+    header->slab = slab;
+  }
+  header->size = size;
+  allocated_bytes_.fetch_add(size, std::memory_order_relaxed);
+  return header + 1;
+}
+
+void SlabAllocator::Deallocate(void* p) {
+  auto header = static_cast<ObjectHeader*>(p) - 1;
+  allocated_bytes_.fetch_sub(header->size, std::memory_order_relaxed);
+  auto slab = static_cast<Slab*>(header->slab);
+  if (slab == nullptr) {
+    mapped_bytes_.fetch_sub(sizeof(ObjectHeader) + header->size,
+                            std::memory_order_relaxed);
+    free(header);
+    return;
+  }
+  SizeClass* size_class = slab->size_class;
+  std::unique_ptr<Slab> to_unmap;
+  {
+    MutexLock l(&size_class->mutex);
+    if (!slab->HasFree(size_class->object_size)) {
+      SizeClass::Unlink(&size_class->full, slab);
+      SizeClass::PushFront(&size_class->partial, slab);
+    }
+    header->slab = slab->free_list;
+    slab->free_list = header;
+    assert(slab->num_used > 0);
+    if (--slab->num_used == 0) {
+      if (size_class->num_empty > 0) {
+        SizeClass::Unlink(&size_class->partial, slab);
+        to_unmap.reset(slab);
+      } else {
+        size_class->num_empty++;
+      }
+    }
+  }
+  if (to_unmap) {
+    mapped_bytes_.fetch_sub(to_unmap->mapping.Length(),
+                            std::memory_order_relaxed);
+    num_slabs_.fetch_sub(1, std::memory_order_relaxed);
+    if (to_unmap->huge_pages) {
+      num_huge_page_slabs_.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+size_t SlabAllocator::UsableSize(void* p, size_t allocation_size) const {
+  const auto header = static_cast<const ObjectHeader*>(p) - 1;
+  if (header->slab == nullptr) {
+    return allocation_size;
+  }
+  return static_cast<const Slab*>(header->slab)->size_class->object_size -
+         sizeof(ObjectHeader);
+}
+
+SlabAllocator::Stats SlabAllocator::GetStats() const {
+  Stats stats;
+  stats.allocated_bytes = allocated_bytes_.load(std::memory_order_relaxed);
+  stats.mapped_bytes = mapped_bytes_.load(std::memory_order_relaxed);
+  stats.num_slabs = num_slabs_.load(std::memory_order_relaxed);
+  stats.num_huge_page_slabs =
+      num_huge_page_slabs_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+Status NewSlabAllocator(const SlabAllocatorOptions& options,
+                        std::shared_ptr<MemoryAllocator>* memory_allocator) {
+  if (memory_allocator == nullptr) {
+    return Status::InvalidArgument("memory_allocator must be non-null.");
+  }
+  std::unique_ptr<MemoryAllocator> allocator(new SlabAllocator(options));
+  Status s = allocator->PrepareOptions(ConfigOptions());
+  if (s.ok()) {
+    memory_allocator->reset(allocator.release());
+  }
+  return s;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,75 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/memory_allocator.h"
+#include "utilities/memory_allocators.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A MemoryAllocator that carves allocations out of large slabs mapped from
+// the OS, preferably on huge pages. See NewSlabAllocator().
+//
+// Each slab serves a single size class. Allocations are rounded up to one of
+// four size classes per power of two, and an allocation is freed onto a free
+// list of its slab, found from a header in front of it. A slab none of whose
+// objects is allocated is unmapped, except for one kept per size class so
+// that an allocation right after a free does not map a slab again.
+class SlabAllocator : public BaseMemoryAllocator {
+ public:
+  explicit SlabAllocator(const SlabAllocatorOptions& options);
+  ~SlabAllocator() override;
+
+  static const char* kClassName() { return "SlabAllocator"; }
+  const char* Name() const override { return kClassName(); }
+
+  Status PrepareOptions(const ConfigOptions& config_options) override;
+
+  void* Allocate(size_t size) override;
+  void Deallocate(void* p) override;
+  size_t UsableSize(void* p, size_t allocation_size) const override;
+
+  struct Stats {
+    // Bytes requested by the allocations not yet deallocated
+    size_t allocated_bytes = 0;
+    // Bytes of the slabs currently mapped, plus those of allocations too
+    // large for a slab
+    size_t mapped_bytes = 0;
+    size_t num_slabs = 0;
+    // Slabs on explicitly requested huge pages (MAP_HUGETLB)
+    size_t num_huge_page_slabs = 0;
+  };
+  Stats GetStats() const;
+
+ private:
+  struct Slab;
+  struct SizeClass;
+
+  // The size class with the smallest objects that hold `size` bytes plus
+  // the header, or size_classes_.size() if none
+  size_t SizeClassFor(size_t size) const;
+  void InitSizeClasses();
+  std::unique_ptr<Slab> NewSlab(SizeClass* size_class);
+
+  SlabAllocatorOptions options_;
+  std::vector<std::unique_ptr<SizeClass>> size_classes_;
+  // Set once mapping huge pages failed, so that they are not requested for
+  // every new slab on systems that have none reserved
+  std::atomic<bool> huge_pages_failed_{false};
+
+  std::atomic<size_t> allocated_bytes_{0};
+  std::atomic<size_t> mapped_bytes_{0};
+  std::atomic<size_t> num_slabs_{0};
+  std::atomic<size_t> num_huge_page_slabs_{0};
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,474 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+#ifndef ROCKSDB_LITE
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "db/memtable.h"
+#include "memory/arena.h"
+#include "memtable/skiplist.h"
+#include "memtable/stl_wrappers.h"
+#include "port/port.h"
+#include "rocksdb/memtablerep.h"
+#include "util/math.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+
+// Starts as an array that entries are appended to, and moves the entries to
+// a skip list only once that is needed to serve reads and writes together:
+//
+// kAppendSorted: entries arrived in order so far. Readers binary search the
+//   array without locking while the writer appends.
+// kAppendUnsorted: entries arrived out of order before any read. The writer
+//   keeps appending under mutex_ until the first read, which sorts the
+//   appended entries in place and goes back to kAppendSorted.
+// kSkipList: an entry arrived out of order after a read. The skip list
+//   serves concurrent reads and writes like SkipListRep.
+// kSortedArray: an immutable memtable that was in kSkipList, copied into a
+//   contiguous sorted array on its first read.
+//
+// Once read, states only move forward, and the array and skip list of a
+// previous state stay valid, so readers that started in an earlier state
+// finish safely. Reads never allocate from the allocator, and the memory
+// reported for the sorted array is reported from the moment the first
+// entry enters the skip list, so usage does not grow once the memtable is
+// immutable.
+class AdaptiveRep : public MemTableRep {
+ public:
+  AdaptiveRep(const KeyComparator& compare, Allocator* allocator);
+
+  // Insert key into the collection. (The caller will pack key and value into a
+  // single buffer and pass that in as the parameter to Insert)
+  // REQUIRES: nothing that compares equal to key is currently in the
+  // collection.
+  void Insert(KeyHandle handle) override;
+
+  // Returns true iff an entry that compares equal to key is in the collection.
+  bool Contains(const char* key) const override;
+
+  void MarkReadOnly() override;
+
+  size_t ApproximateMemoryUsage() override;
+
+  void Get(const LookupKey& k, void* callback_args,
+           bool (*callback_func)(void* arg, const char* entry)) override;
+
+  uint64_t ApproximateNumEntries(const Slice& start_ikey,
+                                 const Slice& end_ikey) override;
+
+  MemTableRep::Iterator* GetIterator(Arena* arena) override;
+
+  ~AdaptiveRep() override {}
+
+ private:
+  enum State : int {
+    kAppendSorted,
+    kAppendUnsorted,
+    kSkipList,
+    kSortedArray,
+  };
+
+  using SkipListType = SkipList<const char*, const KeyComparator&>;
+
+  // Iterates over a sorted array: either the contiguous array of kSortedArray
+  // or the appended entries of kAppendSorted, which may grow meanwhile.
+  class ArrayIterator : public MemTableRep::Iterator {
+   public:
+    ArrayIterator(const AdaptiveRep* rep, const char* const* array,
+                  size_t size)
+        : rep_(rep), array_(array), size_(size), pos_(kInvalid) {}
+
+    bool Valid() const override { return pos_ < Size(); }
+
+    const char* key() const override {
+      assert(Valid());
+      return Entry(pos_);
+    }
+
+    void Next() override {
+      assert(Valid());
+      ++pos_;
+    }
+
+    void Prev() override {
+      assert(Valid());
+      pos_ = pos_ == 0 ? kInvalid : pos_ - 1;
+    }
+
+    void Seek(const Slice& internal_key, const char* memtable_key) override {
+      const char* target = memtable_key != nullptr
+                               ? memtable_key
+                               : EncodeKey(&tmp_, internal_key);
+      pos_ = rep_->LowerBound(array_, Size(), target);
+    }
+
+    void SeekForPrev(const Slice& internal_key,
+                     const char* memtable_key) override {
+      const char* target = memtable_key != nullptr
+                               ? memtable_key
+                               : EncodeKey(&tmp_, internal_key);
+      size_t pos = rep_->LowerBound(array_, Size(), target);
+      if (pos < Size() && rep_->compare_(Entry(pos), target) == 0) {
+        pos_ = pos;
+      } else {
+        pos_ = pos == 0 ? kInvalid : pos - 1;
+      }
+    }
+
+    void SeekToFirst() override { pos_ = 0; }
+
+    void SeekToLast() override {
+      const size_t size = Size();
+      pos_ = size == 0 ? kInvalid : size - 1;
+    }
+
+   private:
+    static constexpr size_t kInvalid = std::numeric_limits<size_t>::max();
+
+    size_t Size() const {
+      return array_ != nullptr
+                 ? size_
+                 : rep_->num_appended_.load(std::memory_order_acquire);
+    }
+
+    const char* Entry(size_t i) const {
+      return array_ != nullptr ? array_[i] : rep_->AppendedEntry(i);
+    }
+
+    const AdaptiveRep* const rep_;
+    const char* const* const array_;
+    const size_t size_;
+    size_t pos_;
+    std::string tmp_;  // For passing to EncodeKey
+  };
+
+  class SkipListIterator : public MemTableRep::Iterator {
+   public:
+    explicit SkipListIterator(const SkipListType* list) : iter_(list) {}
+
+    bool Valid() const override { return iter_.Valid(); }
+
+    const char* key() const override {
+      assert(Valid());
+      return iter_.key();
+    }
+
+    void Next() override {
+      assert(Valid());
+      iter_.Next();
+    }
+
+    void Prev() override {
+      assert(Valid());
+      iter_.Prev();
+    }
+
+    void Seek(const Slice& internal_key, const char* memtable_key) override {
+      iter_.Seek(memtable_key != nullptr ? memtable_key
+                                         : EncodeKey(&tmp_, internal_key));
+    }
+
+    void SeekForPrev(const Slice& internal_key,
+                     const char* memtable_key) override {
+      iter_.SeekForPrev(memtable_key != nullptr
+                            ? memtable_key
+                            : EncodeKey(&tmp_, internal_key));
+    }
+
+    void SeekToFirst() override { iter_.SeekToFirst(); }
+
+    void SeekToLast() override { iter_.SeekToLast(); }
+
+   private:
+    SkipListType::Iterator iter_;
+    std::string tmp_;  // For passing to EncodeKey
+  };
+
+  // The appended entries are kept in chunks of kFirstChunkSize, twice that,
+  // four times that, and so on, so that they never move.
+  static constexpr size_t kFirstChunkSize = 256;
+  static constexpr int kMaxChunks = 48;
+
+  const char* AppendedEntry(size_t i) const {
+    const int chunk = FloorLog2(i / kFirstChunkSize + 1);
+    return chunks_[chunk][i - kFirstChunkSize * ((size_t{1} << chunk) - 1)];
+  }
+
+  void Append(const char* key);
+
+  // Index of the first entry not less than `target` among the first `size`
+  // entries of `array`, or of the appended entries if `array` is null
+  size_t LowerBound(const char* const* array, size_t size,
+                    const char* target) const;
+
+  // Makes sure readers can be served and returns the state to read in
+  State PrepareRead() const;
+
+  // REQUIRES: mutex_ is held
+  void SortAppended() const;
+  void MoveToSkipList();
+  void MoveToSortedArray() const;
+
+  const KeyComparator& compare_;
+  std::atomic<State> mutable state_;
+  // Set under mutex_ before the first read. Entries are only appended out of
+  // order before it is set.
+  std::atomic<bool> mutable read_ = {false};
+  std::atomic<bool> read_only_ = {false};
+  // Serializes state changes. While in kAppendUnsorted, also serializes
+  // appending with the first read sorting the entries.
+  mutable port::Mutex mutex_;
+
+  mutable const char** chunks_[kMaxChunks] = {};
+  std::atomic<size_t> num_appended_ = {0};
+
+  SkipListType mutable skip_list_;
+  std::atomic<size_t> num_skip_list_entries_ = {0};
+
+  std::unique_ptr<const char*[]> mutable sorted_array_;
+  size_t mutable sorted_array_size_ = 0;
+};
+
+AdaptiveRep::AdaptiveRep(const KeyComparator& compare, Allocator* allocator)
+    : MemTableRep(allocator),
+      compare_(compare),
+      state_(kAppendSorted),
+      skip_list_(compare, allocator) {}
+
+void AdaptiveRep::Append(const char* key) {
+  const size_t n = num_appended_.load(std::memory_order_relaxed);
+  const int chunk = FloorLog2(n / kFirstChunkSize + 1);
+  const size_t offset = n - kFirstChunkSize * ((size_t{1} << chunk) - 1);
+  if (offset == 0) {
+    assert(chunk < kMaxChunks);
+    char* mem = allocator_->AllocateAligned((kFirstChunkSize << chunk) *
+                                            sizeof(const char*));
+    chunks_[chunk] = reinterpret_cast<const char**>(mem);
+  }
+  chunks_[chunk][offset] = key;
+  num_appended_.store(n + 1, std::memory_order_release);
+}
+
+void AdaptiveRep::Insert(KeyHandle handle) {
+  const char* key = static_cast<char*>(handle);
+  assert(!read_only_.load(std::memory_order_relaxed));
+  State state = state_.load(std::memory_order_acquire);
+  if (state == kAppendSorted) {
+    const size_t n = num_appended_.load(std::memory_order_relaxed);
+    if (n == 0 || compare_(AppendedEntry(n - 1), key) < 0) {
+      Append(key);
+      return;
+    }
+  }
+  if (state != kSkipList) {
+    MutexLock l(&mutex_);
+    state = state_.load(std::memory_order_relaxed);
+    if (state == kAppendUnsorted || !read_.load(std::memory_order_relaxed)) {
+      // No reader can see the appended entries until the first read sorts
+      // them
+      state_.store(kAppendUnsorted, std::memory_order_release);
+      Append(key);
+      return;
+    }
+    if (state == kAppendSorted) {
+      // A reader may have sorted the entries since the check above
+      const size_t n = num_appended_.load(std::memory_order_relaxed);
+      if (n == 0 || compare_(AppendedEntry(n - 1), key) < 0) {
+        Append(key);
+        return;
+      }
+      MoveToSkipList();
+    }
+  }
+  skip_list_.Insert(key);
+  num_skip_list_entries_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AdaptiveRep::SortAppended() const {
+  mutex_.AssertHeld();
+  assert(state_.load(std::memory_order_relaxed) == kAppendUnsorted);
+  const size_t n = num_appended_.load(std::memory_order_relaxed);
+  std::vector<const char*> entries(n);
+  for (size_t i = 0; i < n; ++i) {
+    entries[i] = AppendedEntry(i);
+  }
+  std::sort(entries.begin(), entries.end(), stl_wrappers::Compare(compare_));
+  for (size_t i = 0; i < n; ++i) {
+    const int chunk = FloorLog2(i / kFirstChunkSize + 1);
+    chunks_[chunk][i - kFirstChunkSize * ((size_t{1} << chunk) - 1)] =
+        entries[i];
+  }
+  state_.store(kAppendSorted, std::memory_order_release);
+}
+
+void AdaptiveRep::MoveToSkipList() {
+  mutex_.AssertHeld();
+  assert(state_.load(std::memory_order_relaxed) == kAppendSorted);
+  const size_t n = num_appended_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < n; ++i) {
+    skip_list_.Insert(AppendedEntry(i));
+  }
+  num_skip_list_entries_.fetch_add(n, std::memory_order_relaxed);
+  state_.store(kSkipList, std::memory_order_release);
+}
+
+void AdaptiveRep::MoveToSortedArray() const {
+  mutex_.AssertHeld();
+  assert(state_.load(std::memory_order_relaxed) == kSkipList);
+  const size_t n = num_skip_list_entries_.load(std::memory_order_relaxed);
+  sorted_array_.reset(new const char*[n]);
+  size_t i = 0;
+  SkipListType::Iterator iter(&skip_list_);
+  for (iter.SeekToFirst(); iter.Valid(); iter.Next()) {
+    assert(i < n);
+    sorted_array_[i++] = iter.key();
+  }
+  assert(i == n);
+  sorted_array_size_ = n;
+  state_.store(kSortedArray, std::memory_order_release);
+}
+
+AdaptiveRep::State AdaptiveRep::PrepareRead() const {
+  State state = state_.load(std::memory_order_acquire);
+  if (state == kSortedArray ||
+      (state == kAppendSorted && read_.load(std::memory_order_acquire)) ||
+      (state == kSkipList && !read_only_.load(std::memory_order_acquire))) {
+    return state;
+  }
+  MutexLock l(&mutex_);
+  state = state_.load(std::memory_order_relaxed);
+  if (state == kAppendUnsorted) {
+    SortAppended();
+  } else if (state == kSkipList &&
+             read_only_.load(std::memory_order_relaxed)) {
+    MoveToSortedArray();
+  }
+  read_.store(true, std::memory_order_release);
+  return state_.load(std::memory_order_relaxed);
+}
+
+size_t AdaptiveRep::LowerBound(const char* const* array, size_t size,
+                               const char* target) const {
+  size_t lo = 0;
+  size_t hi = size;
+  while (lo < hi) {
+    const size_t mid = lo + (hi - lo) / 2;
+    const char* entry = array != nullptr ? array[mid] : AppendedEntry(mid);
+    if (compare_(entry, target) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+bool AdaptiveRep::Contains(const char* key) const {
+  const State state = PrepareRead();
+  if (state == kSkipList) {
+    return skip_list_.Contains(key);
+  }
+  const char* const* array =
+      state == kSortedArray ? sorted_array_.get() : nullptr;
+  const size_t size = state == kSortedArray
+                          ? sorted_array_size_
+                          : num_appended_.load(std::memory_order_acquire);
+  const size_t pos = LowerBound(array, size, key);
+  return pos < size &&
+         compare_(array != nullptr ? array[pos] : AppendedEntry(pos), key) == 0;
+}
+
+void AdaptiveRep::MarkReadOnly() {
+  MutexLock l(&mutex_);
+  read_only_.store(true, std::memory_order_release);
+}
+
+size_t AdaptiveRep::ApproximateMemoryUsage() {
+  // Everything else is allocated through allocator. The sorted array that
+  // replaces the skip list once the memtable is immutable is counted ahead,
+  // since the memtable list expects its usage to stay put.
+  return num_skip_list_entries_.load(std::memory_order_relaxed) *
+         sizeof(const char*);
+}
+
+void AdaptiveRep::Get(const LookupKey& k, void* callback_args,
+                      bool (*callback_func)(void* arg, const char* entry)) {
+  const State state = PrepareRead();
+  if (state == kSkipList) {
+    SkipListType::Iterator iter(&skip_list_);
+    for (iter.Seek(k.memtable_key().data());
+         iter.Valid() && callback_func(callback_args, iter.key());
+         iter.Next()) {
+    }
+    return;
+  }
+  const char* const* array =
+      state == kSortedArray ? sorted_array_.get() : nullptr;
+  const size_t size = state == kSortedArray
+                          ? sorted_array_size_
+                          : num_appended_.load(std::memory_order_acquire);
+  for (size_t pos = LowerBound(array, size, k.memtable_key().data());
+       pos < size &&
+       callback_func(callback_args,
+                     array != nullptr ? array[pos] : AppendedEntry(pos));
+       ++pos) {
+  }
+}
+
+uint64_t AdaptiveRep::ApproximateNumEntries(const Slice& start_ikey,
+                                            const Slice& end_ikey) {
+  const State state = PrepareRead();
+  std::string tmp;
+  uint64_t start_count;
+  uint64_t end_count;
+  if (state == kSkipList) {
+    start_count = skip_list_.EstimateCount(EncodeKey(&tmp, start_ikey));
+    end_count = skip_list_.EstimateCount(EncodeKey(&tmp, end_ikey));
+  } else {
+    const char* const* array =
+        state == kSortedArray ? sorted_array_.get() : nullptr;
+    const size_t size = state == kSortedArray
+                            ? sorted_array_size_
+                            : num_appended_.load(std::memory_order_acquire);
+    start_count = LowerBound(array, size, EncodeKey(&tmp, start_ikey));
+    end_count = LowerBound(array, size, EncodeKey(&tmp, end_ikey));
+  }
+  return (end_count >= start_count) ? (end_count - start_count) : 0;
+}
+
+MemTableRep::Iterator* AdaptiveRep::GetIterator(Arena* arena) {
+  const State state = PrepareRead();
+  if (state == kSkipList) {
+    if (arena == nullptr) {
+      return new SkipListIterator(&skip_list_);
+    }
+    auto mem = arena->AllocateAligned(sizeof(SkipListIterator));
+    return new (mem) SkipListIterator(&skip_list_);
+  }
+  const char* const* array =
+      state == kSortedArray ? sorted_array_.get() : nullptr;
+  if (arena == nullptr) {
+    return new ArrayIterator(this, array, sorted_array_size_);
+  }
+  auto mem = arena->AllocateAligned(sizeof(ArrayIterator));
+  return new (mem) ArrayIterator(this, array, sorted_array_size_);
+}
+}  // namespace
+
+AdaptiveRepFactory::AdaptiveRepFactory() {}
+
+MemTableRep* AdaptiveRepFactory::CreateMemTableRep(
+    const MemTableRep::KeyComparator& compare, Allocator* allocator,
+    const SliceTransform*, Logger* /*logger*/) {
+  return new AdaptiveRep(compare, allocator);
+}
+}  // namespace ROCKSDB_NAMESPACE
+#endif  // ROCKSDB_LITE
@@ -18,6 +18,7 @@
 
 #include "port/port.h"
 #include "util/cast_util.h"
+#include "util/math.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -40,15 +41,24 @@ HistogramBucketMapper::HistogramBucketMapper() {
   }
   maxBucketValue_ = bucketValues_.back();
   minBucketValue_ = bucketValues_.front();
+  firstIndexForBits_[0] = 0;
+  for (int bits = 1; bits <= 64; ++bits) {
+    firstIndexForBits_[bits] =
+        std::lower_bound(bucketValues_.begin(), bucketValues_.end(),
+                         uint64_t{1} << (bits - 1)) -
+        bucketValues_.begin();
+  }
 }
 
 size_t HistogramBucketMapper::IndexForValue(const uint64_t value) const {
-  auto beg = bucketValues_.begin();
-  auto end = bucketValues_.end();
-  if (value >= maxBucketValue_)
-    return end - beg - 1;  // bucketValues_.size() - 1
-  else
-    return std::lower_bound(beg, end, value) - beg;
+  if (value >= maxBucketValue_) {
+    return bucketValues_.size() - 1;
+  }
+  size_t index = firstIndexForBits_[value == 0 ? 0 : FloorLog2(value) + 1];
+  while (bucketValues_[index] < value) {
+    ++index;
+  }
+  return index;
 }
 
 namespace {
@@ -125,6 +135,42 @@ void HistogramStat::Merge(const HistogramStat& other) {
   }
 }
 
+void HistogramStat::Merge(const HistogramSnapshot& snapshot) {
+  if (snapshot.count == 0) {
+    return;
+  }
+  assert(snapshot.buckets.size() == num_buckets_);
+  uint64_t old_min = min();
+  while (snapshot.min < old_min &&
+         !min_.compare_exchange_weak(old_min, snapshot.min)) {
+  }
+
+  uint64_t old_max = max();
+  while (snapshot.max > old_max &&
+         !max_.compare_exchange_weak(old_max, snapshot.max)) {
+  }
+
+  num_.fetch_add(snapshot.count, std::memory_order_relaxed);
+  sum_.fetch_add(snapshot.sum, std::memory_order_relaxed);
+  sum_squares_.fetch_add(snapshot.sum_squares, std::memory_order_relaxed);
+  for (unsigned int b = 0; b < num_buckets_; b++) {
+    buckets_[b].fetch_add(snapshot.buckets[b], std::memory_order_relaxed);
+  }
+}
+
+void HistogramStat::Snapshot(HistogramSnapshot* const snapshot) const {
+  assert(snapshot);
+  snapshot->count = num();
+  snapshot->sum = sum();
+  snapshot->sum_squares = sum_squares();
+  snapshot->min = snapshot->count == 0 ? 0 : min();
+  snapshot->max = snapshot->count == 0 ? 0 : max();
+  snapshot->buckets.resize(num_buckets_);
+  for (unsigned int b = 0; b < num_buckets_; b++) {
+    snapshot->buckets[b] = bucket_at(b);
+  }
+}
+
 double HistogramStat::Median() const { return Percentile(50.0); }
 
 double HistogramStat::Percentile(double p) const {
@@ -231,6 +277,54 @@ void HistogramStat::Data(HistogramData* const data) const {
   data->min = static_cast<double>(min());
 }
 
+HistogramSnapshot HistogramSnapshot::Delta(
+    const HistogramSnapshot& earlier) const {
+  if (count < earlier.count || buckets.size() != earlier.buckets.size()) {
+    return *this;
+  }
+  HistogramSnapshot delta;
+  delta.buckets.resize(buckets.size());
+  for (size_t b = 0; b < buckets.size(); b++) {
+    if (buckets[b] < earlier.buckets[b]) {
+      return *this;
+    }
+    delta.buckets[b] = buckets[b] - earlier.buckets[b];
+  }
+  delta.count = count - earlier.count;
+  delta.sum = sum - earlier.sum;
+  delta.sum_squares = sum_squares - earlier.sum_squares;
+  if (delta.count == 0) {
+    return delta;
+  }
+  size_t first = 0;
+  while (first < delta.buckets.size() && delta.buckets[first] == 0) {
+    first++;
+  }
+  size_t last = delta.buckets.size();
+  while (last > 0 && delta.buckets[last - 1] == 0) {
+    last--;
+  }
+  if (first == delta.buckets.size()) {
+    // Counters were read while values were being recorded
+    delta.min = min;
+    delta.max = max;
+    return delta;
+  }
+  delta.min = std::max(
+      min, first == 0 ? uint64_t{0} : bucketMapper.BucketLimit(first - 1) + 1);
+  delta.max = std::min(max, bucketMapper.BucketLimit(last - 1));
+  if (delta.min > delta.max) {
+    delta.min = delta.max;
+  }
+  return delta;
+}
+
+void HistogramSnapshot::Data(HistogramData* const data) const {
+  HistogramStat stat;
+  stat.Merge(*this);
+  stat.Data(data);
+}
+
 void HistogramImpl::Clear() {
   std::lock_guard<std::mutex> lock(mutex_);
   stats_.Clear();
@@ -267,4 +361,8 @@ std::string HistogramImpl::ToString() const { return stats_.ToString(); }
 
 void HistogramImpl::Data(HistogramData* const data) const { stats_.Data(data); }
 
+void HistogramImpl::Snapshot(HistogramSnapshot* const snapshot) const {
+  stats_.Snapshot(snapshot);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -22,7 +22,9 @@ class HistogramBucketMapper {
  public:
   HistogramBucketMapper();
 
-  // converts a value to the bucket index.
+  // converts a value to the bucket index. Constant time: starts from the
+  // first bucket for the bit length of value, which is at most a couple of
+  // buckets away since bucket limits grow by 1.5x.
   size_t IndexForValue(uint64_t value) const;
   // number of buckets required.
 
@@ -41,6 +43,9 @@ class HistogramBucketMapper {
   std::vector<uint64_t> bucketValues_;
   uint64_t maxBucketValue_;
   uint64_t minBucketValue_;
+  // firstIndexForBits_[b] is the index of the first bucket that can hold a
+  // value of b significant bits
+  size_t firstIndexForBits_[65];
 };
 
 struct HistogramStat {
@@ -54,6 +59,8 @@ struct HistogramStat {
   bool Empty() const;
   void Add(uint64_t value);
   void Merge(const HistogramStat& other);
+  void Merge(const HistogramSnapshot& snapshot);
+  void Snapshot(HistogramSnapshot* const snapshot) const;
 
   inline uint64_t min() const { return min_.load(std::memory_order_relaxed); }
   inline uint64_t max() const { return max_.load(std::memory_order_relaxed); }
@@ -130,6 +137,7 @@ class HistogramImpl : public Histogram {
   virtual double Average() const override;
   virtual double StandardDeviation() const override;
   virtual void Data(HistogramData* const data) const override;
+  void Snapshot(HistogramSnapshot* const snapshot) const;
 
   virtual ~HistogramImpl() {}
 
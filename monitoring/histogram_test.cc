@@ -6,6 +6,7 @@
 #include "monitoring/histogram.h"
 
 #include <cmath>
+#include <limits>
 
 #include "monitoring/histogram_windowing.h"
 #include "rocksdb/system_clock.h"
@@ -245,6 +246,86 @@ TEST_F(HistogramTest, LostUpdateStandardDeviation) {
   ASSERT_GE(histogram.StandardDeviation(), 0.0);
 }
 
+TEST_F(HistogramTest, IndexForValue) {
+  auto expected = [](uint64_t value) -> size_t {
+    if (value >= bucketMapper.LastValue()) {
+      return bucketMapper.BucketCount() - 1;
+    }
+    size_t b = 0;
+    while (bucketMapper.BucketLimit(b) < value) {
+      b++;
+    }
+    return b;
+  };
+  for (size_t b = 0; b < bucketMapper.BucketCount(); b++) {
+    const uint64_t limit = bucketMapper.BucketLimit(b);
+    for (uint64_t value : {limit - 1, limit, limit + 1}) {
+      ASSERT_EQ(bucketMapper.IndexForValue(value), expected(value)) << value;
+    }
+  }
+  for (int bits = 0; bits < 64; bits++) {
+    for (uint64_t value : {(uint64_t{1} << bits) - 1, uint64_t{1} << bits,
+                           (uint64_t{1} << bits) + 1}) {
+      ASSERT_EQ(bucketMapper.IndexForValue(value), expected(value)) << value;
+    }
+  }
+  ASSERT_EQ(
+      bucketMapper.IndexForValue(std::numeric_limits<uint64_t>::max()),
+      bucketMapper.BucketCount() - 1);
+  Random64 rnd(301);
+  for (int i = 0; i < 10000; i++) {
+    const uint64_t value = rnd.Next() >> rnd.Uniform(64);
+    ASSERT_EQ(bucketMapper.IndexForValue(value), expected(value)) << value;
+  }
+}
+
+TEST_F(HistogramTest, SnapshotDelta) {
+  HistogramImpl histogram;
+  HistogramSnapshot empty;
+  histogram.Snapshot(&empty);
+  ASSERT_EQ(empty.count, 0);
+  ASSERT_EQ(empty.min, 0);
+  ASSERT_EQ(empty.buckets.size(), bucketMapper.BucketCount());
+
+  PopulateHistogram(histogram, 1, 100);
+  HistogramSnapshot first;
+  histogram.Snapshot(&first);
+  PopulateHistogram(histogram, 1000, 1099);
+  HistogramSnapshot second;
+  histogram.Snapshot(&second);
+
+  HistogramSnapshot delta = second.Delta(first);
+  ASSERT_EQ(delta.count, 100);
+  ASSERT_EQ(delta.sum, 104950);  // 1000 + ... + 1099
+  ASSERT_GE(delta.min, 101);
+  ASSERT_LE(delta.min, 1000);
+  ASSERT_GE(delta.max, 1099);
+  ASSERT_LE(delta.max, second.max);
+
+  HistogramData data;
+  delta.Data(&data);
+  ASSERT_EQ(data.count, 100);
+  ASSERT_EQ(data.average, 1049.5);
+  ASSERT_GE(data.median, 1000.0);
+  ASSERT_LE(data.median, 1099.0);
+
+  // Nothing recorded in between
+  delta = second.Delta(second);
+  ASSERT_EQ(delta.count, 0);
+  delta.Data(&data);
+  ASSERT_EQ(data.count, 0);
+
+  // Reset in between
+  histogram.Clear();
+  PopulateHistogram(histogram, 5, 5);
+  HistogramSnapshot third;
+  histogram.Snapshot(&third);
+  delta = third.Delta(second);
+  ASSERT_EQ(delta.count, 1);
+  ASSERT_EQ(delta.min, 5);
+  ASSERT_EQ(delta.max, 5);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
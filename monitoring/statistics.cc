@@ -235,7 +235,9 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
     {BLOB_DB_CACHE_BYTES_READ, "rocksdb.blobdb.cache.bytes.read"},
     {BLOB_DB_CACHE_BYTES_WRITE, "rocksdb.blobdb.cache.bytes.write"},
     {READ_ASYNC_MICROS, "rocksdb.read.async.micros"},
-    {ASYNC_READ_ERROR_COUNT, "rocksdb.async.read.error.count"}};
+    {ASYNC_READ_ERROR_COUNT, "rocksdb.async.read.error.count"},
+    {HOT_KEY_CACHE_HIT, "rocksdb.hot.key.cache.hit"},
+    {HOT_KEY_CACHE_MISS, "rocksdb.hot.key.cache.miss"}};
 
 const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
     {DB_GET, "rocksdb.db.get.micros"},
@@ -389,6 +391,23 @@ std::string StatisticsImpl::getHistogramString(uint32_t histogramType) const {
   return getHistogramImplLocked(histogramType)->ToString();
 }
 
+Status StatisticsImpl::getHistogramSnapshot(
+    uint32_t histogramType, HistogramSnapshot* snapshot) const {
+  assert(snapshot);
+  if (histogramType >= HISTOGRAM_ENUM_MAX) {
+    return Status::InvalidArgument("Unknown histogram type");
+  }
+  // Merging the per-core histograms only reads them, so unlike the other
+  // readers this does not need aggregate_lock_.
+  HistogramImpl res_hist;
+  for (size_t core_idx = 0; core_idx < per_core_stats_.Size(); ++core_idx) {
+    res_hist.Merge(
+        per_core_stats_.AccessAtCore(core_idx)->histograms_[histogramType]);
+  }
+  res_hist.Snapshot(snapshot);
+  return Status::OK();
+}
+
 void StatisticsImpl::setTickerCount(uint32_t tickerType, uint64_t count) {
   {
     MutexLock lock(&aggregate_lock_);
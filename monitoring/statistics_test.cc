@@ -83,6 +83,42 @@ TEST_F(StatisticsTest, NoNameStats) {
   ASSERT_NE("", stats->inner->ToString(options));  // ... even if it does...
 #endif                                             // ROCKSDB_LITE
 }
+
+TEST_F(StatisticsTest, HistogramSnapshot) {
+  auto stats = CreateDBStatistics();
+  HistogramSnapshot first;
+  ASSERT_OK(stats->getHistogramSnapshot(DB_GET, &first));
+  ASSERT_EQ(first.count, 0);
+
+  for (uint64_t i = 1; i <= 10; i++) {
+    stats->recordInHistogram(DB_GET, i);
+  }
+  HistogramSnapshot second;
+  ASSERT_OK(stats->getHistogramSnapshot(DB_GET, &second));
+  ASSERT_EQ(second.count, 10);
+  ASSERT_EQ(second.sum, 55);
+  ASSERT_EQ(second.min, 1);
+  ASSERT_EQ(second.max, 10);
+
+  stats->recordInHistogram(DB_GET, 100);
+  HistogramSnapshot third;
+  ASSERT_OK(stats->getHistogramSnapshot(DB_GET, &third));
+  HistogramSnapshot delta = third.Delta(second);
+  ASSERT_EQ(delta.count, 1);
+  ASSERT_EQ(delta.sum, 100);
+  ASSERT_EQ(delta.max, 100);
+
+  HistogramData data;
+  stats->histogramData(DB_GET, &data);
+  HistogramData snapshot_data;
+  third.Data(&snapshot_data);
+  ASSERT_EQ(data.count, snapshot_data.count);
+  ASSERT_EQ(data.median, snapshot_data.median);
+  ASSERT_EQ(data.percentile99, snapshot_data.percentile99);
+
+  ASSERT_TRUE(stats->getHistogramSnapshot(HISTOGRAM_ENUM_MAX, &delta)
+                  .IsInvalidArgument());
+}
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -16,6 +16,7 @@
 #include "rocksdb/env.h"
 #include "rocksdb/file_system.h"
 #include "rocksdb/listener.h"
+#include "rocksdb/memory_allocator.h"
 #include "rocksdb/rate_limiter.h"
 #include "rocksdb/sst_file_manager.h"
 #include "rocksdb/statistics.h"
@@ -136,6 +137,7 @@ static std::unordered_map<std::string, OptionTypeInfo>
         /*
          // not yet supported
           std::shared_ptr<Cache> row_cache;
+          std::shared_ptr<Cache> hot_key_cache;
           std::shared_ptr<DeleteScheduler> delete_scheduler;
           std::shared_ptr<Logger> info_log;
           std::shared_ptr<RateLimiter> rate_limiter;
@@ -323,6 +325,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, unordered_write),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"write_queue_shards",
+         {offsetof(struct ImmutableDBOptions, write_queue_shards),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"allow_concurrent_memtable_write",
          {offsetof(struct ImmutableDBOptions, allow_concurrent_memtable_write),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -406,6 +412,27 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, log_readahead_size),
           OptionType::kSizeT, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"wal_recovery_threads",
+         {offsetof(struct ImmutableDBOptions, wal_recovery_threads),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"hot_block_persist_period_sec",
+         {offsetof(struct ImmutableDBOptions, hot_block_persist_period_sec),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"max_hot_blocks",
+         {offsetof(struct ImmutableDBOptions, max_hot_blocks),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"warm_block_cache_on_open",
+         {offsetof(struct ImmutableDBOptions, warm_block_cache_on_open),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"block_cache_warmup_bytes_per_sec",
+         {offsetof(struct ImmutableDBOptions,
+                   block_cache_warmup_bytes_per_sec),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"best_efforts_recovery",
          {offsetof(struct ImmutableDBOptions, best_efforts_recovery),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -716,6 +743,7 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       advise_random_on_open(options.advise_random_on_open),
       db_write_buffer_size(options.db_write_buffer_size),
       write_buffer_manager(options.write_buffer_manager),
+      memtable_memory_allocator(options.memtable_memory_allocator),
       access_hint_on_compaction_start(options.access_hint_on_compaction_start),
       random_access_max_buffer_size(options.random_access_max_buffer_size),
       use_adaptive_mutex(options.use_adaptive_mutex),
@@ -723,6 +751,7 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       enable_thread_tracking(options.enable_thread_tracking),
       enable_pipelined_write(options.enable_pipelined_write),
       unordered_write(options.unordered_write),
+      write_queue_shards(options.write_queue_shards),
       allow_concurrent_memtable_write(options.allow_concurrent_memtable_write),
       enable_write_thread_adaptive_yield(
           options.enable_write_thread_adaptive_yield),
@@ -734,6 +763,12 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       wal_recovery_mode(options.wal_recovery_mode),
       allow_2pc(options.allow_2pc),
       row_cache(options.row_cache),
+      hot_key_cache(options.hot_key_cache),
+      hot_block_persist_period_sec(options.hot_block_persist_period_sec),
+      max_hot_blocks(options.max_hot_blocks),
+      warm_block_cache_on_open(options.warm_block_cache_on_open),
+      block_cache_warmup_bytes_per_sec(
+          options.block_cache_warmup_bytes_per_sec),
 #ifndef ROCKSDB_LITE
       wal_filter(options.wal_filter),
 #endif  // ROCKSDB_LITE
@@ -749,6 +784,7 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       persist_stats_to_disk(options.persist_stats_to_disk),
       write_dbid_to_manifest(options.write_dbid_to_manifest),
       log_readahead_size(options.log_readahead_size),
+      wal_recovery_threads(options.wal_recovery_threads),
       file_checksum_gen_factory(options.file_checksum_gen_factory),
       best_efforts_recovery(options.best_efforts_recovery),
       max_bgerror_resume_count(options.max_bgerror_resume_count),
@@ -849,6 +885,9 @@ void ImmutableDBOptions::Dump(Logger* log) const {
       db_write_buffer_size);
   ROCKS_LOG_HEADER(log, "                   Options.write_buffer_manager: %p",
                    write_buffer_manager.get());
+  ROCKS_LOG_HEADER(log, "              Options.memtable_memory_allocator: %s",
+                   memtable_memory_allocator ? memtable_memory_allocator->Name()
+                                             : "None");
   ROCKS_LOG_HEADER(log, "        Options.access_hint_on_compaction_start: %d",
                    static_cast<int>(access_hint_on_compaction_start));
   ROCKS_LOG_HEADER(
@@ -869,6 +908,9 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    enable_pipelined_write);
   ROCKS_LOG_HEADER(log, "                 Options.unordered_write: %d",
                    unordered_write);
+  ROCKS_LOG_HEADER(
+      log, "                     Options.write_queue_shards: %" ROCKSDB_PRIszt,
+      write_queue_shards);
   ROCKS_LOG_HEADER(log, "        Options.allow_concurrent_memtable_write: %d",
                    allow_concurrent_memtable_write);
   ROCKS_LOG_HEADER(log, "     Options.enable_write_thread_adaptive_yield: %d",
@@ -888,6 +930,26 @@ void ImmutableDBOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(log,
                      "                              Options.row_cache: None");
   }
+  if (hot_key_cache) {
+    ROCKS_LOG_HEADER(
+        log,
+        "                          Options.hot_key_cache: %" ROCKSDB_PRIszt,
+        hot_key_cache->GetCapacity());
+  } else {
+    ROCKS_LOG_HEADER(log,
+                     "                          Options.hot_key_cache: None");
+  }
+  ROCKS_LOG_HEADER(
+      log, "           Options.hot_block_persist_period_sec: %" PRIu64,
+      hot_block_persist_period_sec);
+  ROCKS_LOG_HEADER(
+      log, "                         Options.max_hot_blocks: %" ROCKSDB_PRIszt,
+      max_hot_blocks);
+  ROCKS_LOG_HEADER(log, "               Options.warm_block_cache_on_open: %d",
+                   warm_block_cache_on_open);
+  ROCKS_LOG_HEADER(
+      log, "       Options.block_cache_warmup_bytes_per_sec: %" PRIu64,
+      block_cache_warmup_bytes_per_sec);
 #ifndef ROCKSDB_LITE
   ROCKS_LOG_HEADER(log, "                             Options.wal_filter: %s",
                    wal_filter ? wal_filter->Name() : "None");
@@ -914,6 +976,8 @@ void ImmutableDBOptions::Dump(Logger* log) const {
   ROCKS_LOG_HEADER(
       log, "                Options.log_readahead_size: %" ROCKSDB_PRIszt,
       log_readahead_size);
+  ROCKS_LOG_HEADER(log, "                Options.wal_recovery_threads: %d",
+                   wal_recovery_threads);
   ROCKS_LOG_HEADER(log, "                Options.file_checksum_gen_factory: %s",
                    file_checksum_gen_factory ? file_checksum_gen_factory->Name()
                                              : kUnknownFileChecksumFuncName);
@@ -123,6 +123,8 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.advise_random_on_open = immutable_db_options.advise_random_on_open;
   options.db_write_buffer_size = immutable_db_options.db_write_buffer_size;
   options.write_buffer_manager = immutable_db_options.write_buffer_manager;
+  options.memtable_memory_allocator =
+      immutable_db_options.memtable_memory_allocator;
   options.access_hint_on_compaction_start =
       immutable_db_options.access_hint_on_compaction_start;
   options.compaction_readahead_size =
@@ -137,6 +139,7 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.delayed_write_rate = mutable_db_options.delayed_write_rate;
   options.enable_pipelined_write = immutable_db_options.enable_pipelined_write;
   options.unordered_write = immutable_db_options.unordered_write;
+  options.write_queue_shards = immutable_db_options.write_queue_shards;
   options.allow_concurrent_memtable_write =
       immutable_db_options.allow_concurrent_memtable_write;
   options.enable_write_thread_adaptive_yield =
@@ -154,6 +157,14 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.wal_recovery_mode = immutable_db_options.wal_recovery_mode;
   options.allow_2pc = immutable_db_options.allow_2pc;
   options.row_cache = immutable_db_options.row_cache;
+  options.hot_key_cache = immutable_db_options.hot_key_cache;
+  options.hot_block_persist_period_sec =
+      immutable_db_options.hot_block_persist_period_sec;
+  options.max_hot_blocks = immutable_db_options.max_hot_blocks;
+  options.warm_block_cache_on_open =
+      immutable_db_options.warm_block_cache_on_open;
+  options.block_cache_warmup_bytes_per_sec =
+      immutable_db_options.block_cache_warmup_bytes_per_sec;
 #ifndef ROCKSDB_LITE
   options.wal_filter = immutable_db_options.wal_filter;
 #endif  // ROCKSDB_LITE
@@ -172,6 +183,7 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.avoid_unnecessary_blocking_io =
       immutable_db_options.avoid_unnecessary_blocking_io;
   options.log_readahead_size = immutable_db_options.log_readahead_size;
+  options.wal_recovery_threads = immutable_db_options.wal_recovery_threads;
   options.file_checksum_gen_factory =
       immutable_db_options.file_checksum_gen_factory;
   options.best_efforts_recovery = immutable_db_options.best_efforts_recovery;
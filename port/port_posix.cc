@@ -16,6 +16,9 @@
 #include <cpuid.h>
 #endif
 #include <errno.h>
+#ifdef NUMA
+#include <numa.h>
+#endif  // NUMA
 #include <sched.h>
 #include <signal.h>
 #include <stdio.h>
@@ -24,9 +27,11 @@
 #include <sys/time.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <fstream>
 #include <string>
+#include <vector>
 
 #include "util/string_util.h"
 
@@ -198,6 +203,53 @@ int PhysicalCoreID() {
 #endif
 }
 
+#ifdef NUMA
+namespace {
+struct NumaTopology {
+  int num_nodes = 1;
+  std::vector<int> node_of_cpu;
+
+  NumaTopology() {
+    if (numa_available() < 0) {
+      return;
+    }
+    num_nodes = std::max(1, numa_num_configured_nodes());
+    int num_cpus = numa_num_configured_cpus();
+    for (int cpu = 0; cpu < num_cpus; ++cpu) {
+      int node = numa_node_of_cpu(cpu);
+      node_of_cpu.push_back(node >= 0 && node < num_nodes ? node : 0);
+    }
+  }
+};
+
+const NumaTopology& GetNumaTopology() {
+  static const NumaTopology topology;
+  return topology;
+}
+}  // namespace
+#endif  // NUMA
+
+int NumaNodeCount() {
+#ifdef NUMA
+  return GetNumaTopology().num_nodes;
+#else
+  return 1;
+#endif  // NUMA
+}
+
+int NumaNodeOfCurrentCore() {
+#if defined(NUMA) && defined(ROCKSDB_SCHED_GETCPU_PRESENT)
+  const NumaTopology& topology = GetNumaTopology();
+  if (topology.num_nodes > 1) {
+    int cpu = sched_getcpu();
+    if (cpu >= 0 && static_cast<size_t>(cpu) < topology.node_of_cpu.size()) {
+      return topology.node_of_cpu[cpu];
+    }
+  }
+#endif
+  return 0;
+}
+
 void InitOnce(OnceType* once, void (*initializer)()) {
   PthreadCall("once", pthread_once(once, initializer));
 }
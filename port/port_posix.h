@@ -178,6 +178,13 @@ static inline void AsmVolatilePause() {
 // Returns -1 if not available on this platform
 extern int PhysicalCoreID();
 
+// Number of NUMA nodes of the machine, or 1 if not built with NUMA support
+extern int NumaNodeCount();
+
+// The NUMA node of the core the calling thread runs on, in
+// [0, NumaNodeCount()). Returns 0 if not known.
+extern int NumaNodeOfCurrentCore();
+
 using OnceType = pthread_once_t;
 #define LEVELDB_ONCE_INIT PTHREAD_ONCE_INIT
 extern void InitOnce(OnceType* once, void (*initializer)());
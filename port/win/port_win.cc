@@ -132,6 +132,24 @@ void CondVar::SignalAll() { cv_.notify_all(); }
 
 int PhysicalCoreID() { return GetCurrentProcessorNumber(); }
 
+int NumaNodeCount() {
+  ULONG highest_node = 0;
+  if (!GetNumaHighestNodeNumber(&highest_node)) {
+    return 1;
+  }
+  return static_cast<int>(highest_node) + 1;
+}
+
+int NumaNodeOfCurrentCore() {
+  PROCESSOR_NUMBER processor;
+  GetCurrentProcessorNumberEx(&processor);
+  USHORT node = 0;
+  if (!GetNumaProcessorNodeEx(&processor, &node) || node == 0xffff) {
+    return 0;
+  }
+  return static_cast<int>(node);
+}
+
 void InitOnce(OnceType* once, void (*initializer)()) {
   std::call_once(once->flag_, initializer);
 }
@@ -251,6 +251,13 @@ static inline void AsmVolatilePause() {
 
 extern int PhysicalCoreID();
 
+// Number of NUMA nodes of the machine
+extern int NumaNodeCount();
+
+// The NUMA node of the core the calling thread runs on, in
+// [0, NumaNodeCount()). Returns 0 if not known.
+extern int NumaNodeOfCurrentCore();
+
 // For Thread Local Storage abstraction
 using pthread_key_t = DWORD;
 
@@ -22,6 +22,7 @@
 #include "rocksdb/comparator.h"
 #include "table/block_based/block_prefix_index.h"
 #include "table/block_based/data_block_footer.h"
+#include "table/block_based/data_block_restart_key_prefixes.h"
 #include "table/format.h"
 #include "util/coding.h"
 
@@ -137,7 +138,39 @@ struct DecodeEntryV4 {
     return DecodeKeyV4()(p, limit, shared, non_shared);
   }
 };
+void DataBlockIter::SetExpandedEntry(uint32_t index) {
+  assert(expanded_entries_ != nullptr);
+  expanded_index_ = index;
+  if (index >= expanded_entries_->num_entries) {
+    current_ = restarts_;
+    return;
+  }
+  const ExpandedDataBlockEntries::Entry& entry =
+      expanded_entries_->entries[index];
+  current_ = entry.entry_offset;
+  raw_key_.SetKey(expanded_entries_->Key(index), false /* copy */);
+  value_ = Slice(data_ + entry.value_offset, entry.value_size);
+}
+
+uint32_t DataBlockIter::ExpandedLowerBound(const Slice& target) const {
+  uint32_t left = 0;
+  uint32_t right = expanded_entries_->num_entries;
+  while (left < right) {
+    uint32_t mid = left + (right - left) / 2;
+    if (icmp_->Compare(expanded_entries_->Key(mid), target) < 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return left;
+}
+
 void DataBlockIter::NextImpl() {
+  if (expanded_entries_ != nullptr) {
+    SetExpandedEntry(expanded_index_ + 1);
+    return;
+  }
   bool is_shared = false;
   ParseNextDataKey(&is_shared);
 }
@@ -192,6 +225,11 @@ void MetaBlockIter::PrevImpl() {
 // Similar to IndexBlockIter::PrevImpl but also caches the prev entries
 void DataBlockIter::PrevImpl() {
   assert(Valid());
+  if (expanded_entries_ != nullptr) {
+    SetExpandedEntry(expanded_index_ == 0 ? expanded_entries_->num_entries
+                                          : expanded_index_ - 1);
+    return;
+  }
 
   assert(prev_entries_idx_ == -1 ||
          static_cast<size_t>(prev_entries_idx_) < prev_entries_.size());
@@ -271,15 +309,32 @@ void DataBlockIter::PrevImpl() {
   prev_entries_idx_ = static_cast<int32_t>(prev_entries_.size()) - 1;
 }
 
+bool DataBlockIter::DataBinarySeek(const Slice& target, uint32_t* index,
+                                   bool* skip_linear_scan) {
+  if (restart_key_prefixes_ == nullptr) {
+    return BinarySeek<DecodeKey>(target, index, skip_linear_scan);
+  }
+  uint32_t begin = 0;
+  uint32_t end = 0;
+  FindRestartKeyPrefixRange(restart_key_prefixes_, num_restarts_,
+                            GetRestartKeyPrefix(ExtractUserKey(target)),
+                            &begin, &end);
+  return BinarySeek<DecodeKey>(target, index, skip_linear_scan, begin, end);
+}
+
 void DataBlockIter::SeekImpl(const Slice& target) {
   Slice seek_key = target;
   PERF_TIMER_GUARD(block_seek_nanos);
   if (data_ == nullptr) {  // Not init yet
     return;
   }
+  if (expanded_entries_ != nullptr) {
+    SetExpandedEntry(ExpandedLowerBound(seek_key));
+    return;
+  }
   uint32_t index = 0;
   bool skip_linear_scan = false;
-  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
+  bool ok = DataBinarySeek(seek_key, &index, &skip_linear_scan);
 
   if (!ok) {
     return;
@@ -330,6 +385,9 @@ void MetaBlockIter::SeekImpl(const Slice& target) {
 bool DataBlockIter::SeekForGetImpl(const Slice& target) {
   Slice target_user_key = ExtractUserKey(target);
   uint32_t map_offset = restarts_ + num_restarts_ * sizeof(uint32_t);
+  if (restart_key_prefixes_ != nullptr) {
+    map_offset += num_restarts_ * static_cast<uint32_t>(kRestartKeyPrefixSize);
+  }
   uint8_t entry =
       data_block_hash_index_->Lookup(data_, map_offset, target_user_key);
 
@@ -468,9 +526,20 @@ void DataBlockIter::SeekForPrevImpl(const Slice& target) {
   if (data_ == nullptr) {  // Not init yet
     return;
   }
+  if (expanded_entries_ != nullptr) {
+    const uint32_t num_entries = expanded_entries_->num_entries;
+    uint32_t index = ExpandedLowerBound(seek_key);
+    if (index == num_entries ||
+        icmp_->Compare(expanded_entries_->Key(index), seek_key) > 0) {
+      // The entry before, if any
+      index = index == 0 ? num_entries : index - 1;
+    }
+    SetExpandedEntry(index);
+    return;
+  }
   uint32_t index = 0;
   bool skip_linear_scan = false;
-  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
+  bool ok = DataBinarySeek(seek_key, &index, &skip_linear_scan);
 
   if (!ok) {
     return;
@@ -514,6 +583,10 @@ void DataBlockIter::SeekToFirstImpl() {
   if (data_ == nullptr) {  // Not init yet
     return;
   }
+  if (expanded_entries_ != nullptr) {
+    SetExpandedEntry(0);
+    return;
+  }
   SeekToRestartPoint(0);
   bool is_shared = false;
   ParseNextDataKey(&is_shared);
@@ -541,6 +614,10 @@ void DataBlockIter::SeekToLastImpl() {
   if (data_ == nullptr) {  // Not init yet
     return;
   }
+  if (expanded_entries_ != nullptr) {
+    SetExpandedEntry(expanded_entries_->num_entries - 1);
+    return;
+  }
   SeekToRestartPoint(num_restarts_ - 1);
   bool is_shared = false;
   while (ParseNextDataKey(&is_shared) && NextEntryOffset() < restarts_) {
@@ -751,7 +828,8 @@ void BlockIter<TValue>::FindKeyAfterBinarySeek(const Slice& target,
 template <class TValue>
 template <typename DecodeKeyFunc>
 bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
-                                   bool* skip_linear_scan) {
+                                   bool* skip_linear_scan, uint32_t begin,
+                                   uint32_t end) {
   if (restarts_ == 0) {
     // SST files dedicated to range tombstones are written with index blocks
     // that have no keys while also having `num_restarts_ == 1`. This would
@@ -769,7 +847,12 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
   //   keys.
   // - Any restart keys after index `right` are strictly greater than the target
   //   key.
-  int64_t left = -1, right = num_restarts_ - 1;
+  // Restart keys before `begin` being less than the target, the search can
+  // start with the last of them as `left`.
+  end = std::min(end, num_restarts_);
+  assert(begin <= end);
+  int64_t left = static_cast<int64_t>(begin) - 1;
+  int64_t right = static_cast<int64_t>(end) - 1;
   while (left != right) {
     // The `mid` is computed by rounding up so it lands in (`left`, `right`].
     int64_t mid = left + (right - left + 1) / 2;
@@ -999,7 +1082,9 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
           // The size is too small for NumRestarts() and therefore
           // restart_offset_ wrapped around.
           size_ = 0;
+          break;
         }
+        MaybeSetRestartKeyPrefixes();
         break;
       case BlockBasedTableOptions::kDataBlockBinaryAndHash:
         if (size_ < sizeof(uint32_t) /* block footer */ +
@@ -1024,6 +1109,7 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
           size_ = 0;
           break;
         }
+        MaybeSetRestartKeyPrefixes();
         break;
       default:
         size_ = 0;  // Error marker
@@ -1035,6 +1121,96 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
   }
 }
 
+bool Block::HasRestartKeyPrefixes() const {
+  assert(size_ >= 2 * sizeof(uint32_t));
+  if (size_ > kMaxBlockSizeSupportedByHashIndex) {
+    // The check is for the same reason as that in NumRestarts()
+    return false;
+  }
+  uint32_t block_footer = DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  uint32_t num_restarts = block_footer;
+  BlockBasedTableOptions::DataBlockIndexType index_type;
+  bool has_restart_key_prefixes = false;
+  UnPackIndexTypeAndNumRestarts(block_footer, &index_type, &num_restarts,
+                                &has_restart_key_prefixes);
+  return has_restart_key_prefixes;
+}
+
+void Block::MaybeSetRestartKeyPrefixes() {
+  if (size_ < 2 * sizeof(uint32_t) || !HasRestartKeyPrefixes()) {
+    return;
+  }
+  // The prefixes sit right before the footer (or the hash index), where
+  // restart_offset_ was computed to be as if they did not exist.
+  uint32_t prefixes_size =
+      num_restarts_ * static_cast<uint32_t>(kRestartKeyPrefixSize);
+  uint32_t restart_offset = restart_offset_ - prefixes_size;
+  if (restart_offset > restart_offset_) {
+    // The block is too small for the prefixes and therefore restart_offset
+    // wrapped around.
+    size_ = 0;
+    return;
+  }
+  restart_offset_ = restart_offset;
+  restart_key_prefixes_ =
+      data_ + restart_offset_ + num_restarts_ * sizeof(uint32_t);
+}
+
+size_t ExpandedDataBlockEntries::ApproximateMemoryUsage() const {
+  size_t usage = 0;
+#ifdef ROCKSDB_MALLOC_USABLE_SIZE
+  usage += malloc_usable_size((void*)this);
+  usage += malloc_usable_size(entries.get());
+  if (keys != nullptr) {
+    usage += malloc_usable_size(keys.get());
+  }
+#else
+  usage += sizeof(*this) + num_entries * sizeof(Entry) + keys_size;
+#endif  // ROCKSDB_MALLOC_USABLE_SIZE
+  return usage;
+}
+
+void Block::ExpandDataEntries() {
+  if (size_ < 2 * sizeof(uint32_t) || num_restarts_ == 0 ||
+      expanded_entries_ != nullptr) {
+    return;
+  }
+  DataBlockIter iter;
+  iter.Initialize(BytewiseComparator(), data_, restart_offset_, num_restarts_,
+                  kDisableGlobalSequenceNumber,
+                  /*read_amp_bitmap=*/nullptr,
+                  /*block_contents_pinned=*/false,
+                  /*data_block_hash_index=*/nullptr);
+  std::vector<ExpandedDataBlockEntries::Entry> entries;
+  std::string keys;
+  for (iter.SeekToFirstImpl(); iter.Valid(); iter.NextImpl()) {
+    Slice key = iter.raw_key_.GetInternalKey();
+    ExpandedDataBlockEntries::Entry entry;
+    entry.key_offset = static_cast<uint32_t>(keys.size());
+    entry.key_size = static_cast<uint32_t>(key.size());
+    entry.entry_offset = iter.current_;
+    entry.value_offset = iter.ValueOffset();
+    entry.value_size = static_cast<uint32_t>(iter.value_.size());
+    entries.push_back(entry);
+    keys.append(key.data(), key.size());
+  }
+  if (!iter.status().ok() || entries.empty()) {
+    // Left to the iterators to report
+    return;
+  }
+  std::unique_ptr<ExpandedDataBlockEntries> expanded(
+      new ExpandedDataBlockEntries());
+  expanded->num_entries = static_cast<uint32_t>(entries.size());
+  expanded->entries.reset(new ExpandedDataBlockEntries::Entry[entries.size()]);
+  std::copy(entries.begin(), entries.end(), expanded->entries.get());
+  expanded->keys_size = keys.size();
+  if (!keys.empty()) {
+    expanded->keys.reset(new char[keys.size()]);
+    memcpy(expanded->keys.get(), keys.data(), keys.size());
+  }
+  expanded_entries_ = std::move(expanded);
+}
+
 MetaBlockIter* Block::NewMetaIterator(bool block_contents_pinned) {
   MetaBlockIter* iter = new MetaBlockIter();
   if (size_ < 2 * sizeof(uint32_t)) {
@@ -1072,7 +1248,8 @@ DataBlockIter* Block::NewDataIterator(const Comparator* raw_ucmp,
     ret_iter->Initialize(
         raw_ucmp, data_, restart_offset_, num_restarts_, global_seqno,
         read_amp_bitmap_.get(), block_contents_pinned,
-        data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr);
+        data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr,
+        restart_key_prefixes_, expanded_entries_.get());
     if (read_amp_bitmap_) {
       if (read_amp_bitmap_->GetStatistics() != stats) {
         // DB changed the Statistics pointer, we need to notify read_amp_bitmap_
@@ -1125,6 +1302,9 @@ size_t Block::ApproximateMemoryUsage() const {
   if (read_amp_bitmap_) {
     usage += read_amp_bitmap_->ApproximateMemoryUsage();
   }
+  if (expanded_entries_) {
+    usage += expanded_entries_->ApproximateMemoryUsage();
+  }
   return usage;
 }
 
@@ -11,6 +11,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -137,6 +138,35 @@ class BlockReadAmpBitmap {
   uint32_t rnd_;
 };
 
+// The entries of a data block in a flat array, in block order, with their
+// keys fully materialized, so that DataBlockIter can seek and step through
+// the block without decoding entries. Values stay in the block. See
+// BlockBasedTableOptions::cache_expanded_data_blocks.
+struct ExpandedDataBlockEntries {
+  struct Entry {
+    // Location of the key in `keys`
+    uint32_t key_offset;
+    uint32_t key_size;
+    // Offsets in the block of the entry and of its value
+    uint32_t entry_offset;
+    uint32_t value_offset;
+    uint32_t value_size;
+  };
+
+  Slice Key(uint32_t index) const {
+    assert(index < num_entries);
+    return Slice(keys.get() + entries[index].key_offset,
+                 entries[index].key_size);
+  }
+
+  size_t ApproximateMemoryUsage() const;
+
+  std::unique_ptr<Entry[]> entries;
+  uint32_t num_entries = 0;
+  std::unique_ptr<char[]> keys;
+  size_t keys_size = 0;
+};
+
 // class Block is the uncompressed and "parsed" form for blocks containing
 // key-value pairs. (See BlockContents comments for more on terminology.)
 // This includes the in-memory representation of data blocks, index blocks
@@ -169,6 +199,14 @@ class Block {
   bool own_bytes() const { return contents_.own_bytes(); }
 
   BlockBasedTableOptions::DataBlockIndexType IndexType() const;
+  // Whether the data block has a restart key prefix array
+  bool HasRestartKeyPrefixes() const;
+
+  // Builds the expanded form of the entries of this data block, which
+  // NewDataIterator() then uses for iterators without a global seqno. No-op
+  // if the block is empty, corrupt or already expanded.
+  void ExpandDataEntries();
+  bool IsExpanded() const { return expanded_entries_ != nullptr; }
 
   // raw_ucmp is a raw (i.e., not wrapped by `UserComparatorWrapper`) user key
   // comparator.
@@ -240,6 +278,10 @@ class Block {
   const Slice& ContentSlice() const { return contents_.data; }
 
  private:
+  // Locates the restart key prefix array, if any, moving restart_offset_
+  // before it
+  void MaybeSetRestartKeyPrefixes();
+
   BlockContents contents_;
   const char* data_;         // contents_.data.data()
   size_t size_;              // contents_.data.size()
@@ -247,6 +289,10 @@ class Block {
   uint32_t num_restarts_;
   std::unique_ptr<BlockReadAmpBitmap> read_amp_bitmap_;
   DataBlockHashIndex data_block_hash_index_;
+  // Restart key prefix array of data blocks, see
+  // data_block_restart_key_prefixes.h. nullptr if the block has none.
+  const char* restart_key_prefixes_ = nullptr;
+  std::unique_ptr<ExpandedDataBlockEntries> expanded_entries_;
 };
 
 // A `BlockIter` iterates over the entries in a `Block`'s data buffer. The
@@ -481,9 +527,13 @@ class BlockIter : public InternalIteratorBase<TValue> {
   void CorruptionError();
 
  protected:
+  // Only searches restart points in [begin, end), with the caller
+  // guaranteeing that restart keys before `begin` are less than `target` and
+  // restart keys from `end` on are greater. `end` defaults to num_restarts_.
   template <typename DecodeKeyFunc>
   inline bool BinarySeek(const Slice& target, uint32_t* index,
-                         bool* is_index_key_result);
+                         bool* is_index_key_result, uint32_t begin = 0,
+                         uint32_t end = UINT32_MAX);
 
   void FindKeyAfterBinarySeek(const Slice& target, uint32_t index,
                               bool is_index_key_result);
@@ -496,23 +546,32 @@ class DataBlockIter final : public BlockIter<Slice> {
   DataBlockIter(const Comparator* raw_ucmp, const char* data, uint32_t restarts,
                 uint32_t num_restarts, SequenceNumber global_seqno,
                 BlockReadAmpBitmap* read_amp_bitmap, bool block_contents_pinned,
-                DataBlockHashIndex* data_block_hash_index)
+                DataBlockHashIndex* data_block_hash_index,
+                const char* restart_key_prefixes = nullptr)
       : DataBlockIter() {
     Initialize(raw_ucmp, data, restarts, num_restarts, global_seqno,
-               read_amp_bitmap, block_contents_pinned, data_block_hash_index);
+               read_amp_bitmap, block_contents_pinned, data_block_hash_index,
+               restart_key_prefixes);
   }
   void Initialize(const Comparator* raw_ucmp, const char* data,
                   uint32_t restarts, uint32_t num_restarts,
                   SequenceNumber global_seqno,
                   BlockReadAmpBitmap* read_amp_bitmap,
                   bool block_contents_pinned,
-                  DataBlockHashIndex* data_block_hash_index) {
+                  DataBlockHashIndex* data_block_hash_index,
+                  const char* restart_key_prefixes = nullptr,
+                  const ExpandedDataBlockEntries* expanded_entries = nullptr) {
     InitializeBase(raw_ucmp, data, restarts, num_restarts, global_seqno,
                    block_contents_pinned);
     raw_key_.SetIsUserKey(false);
     read_amp_bitmap_ = read_amp_bitmap;
     last_bitmap_offset_ = current_ + 1;
     data_block_hash_index_ = data_block_hash_index;
+    restart_key_prefixes_ = restart_key_prefixes;
+    // The expanded keys do not have the global seqno applied
+    expanded_entries_ = global_seqno == kDisableGlobalSequenceNumber
+                            ? expanded_entries
+                            : nullptr;
   }
 
   Slice value() const override {
@@ -527,7 +586,7 @@ class DataBlockIter final : public BlockIter<Slice> {
   }
 
   inline bool SeekForGet(const Slice& target) {
-    if (!data_block_hash_index_) {
+    if (!data_block_hash_index_ || expanded_entries_) {
       SeekImpl(target);
       UpdateKey();
       return true;
@@ -585,8 +644,24 @@ class DataBlockIter final : public BlockIter<Slice> {
   int32_t prev_entries_idx_ = -1;
 
   DataBlockHashIndex* data_block_hash_index_;
+  // Prefixes of the restart keys, or nullptr if the block has none
+  const char* restart_key_prefixes_ = nullptr;
+  // If not nullptr, positioning goes through the expanded entries instead
+  // of decoding the block, with expanded_index_ the current entry
+  const ExpandedDataBlockEntries* expanded_entries_ = nullptr;
+  uint32_t expanded_index_ = 0;
+
+  // Positions at the expanded entry, or makes the iterator invalid if
+  // `index` is the number of entries
+  void SetExpandedEntry(uint32_t index);
+  // The index of the first expanded entry not before `target`
+  uint32_t ExpandedLowerBound(const Slice& target) const;
 
   bool SeekForGetImpl(const Slice& target);
+  // Binary searches the restart points, narrowed down to the restart keys
+  // sharing the prefix of `target` when the block has restart key prefixes
+  bool DataBinarySeek(const Slice& target, uint32_t* index,
+                      bool* skip_linear_scan);
 };
 
 // Iterator over MetaBlocks.  MetaBlocks are similar to Data Blocks and
@@ -42,6 +42,7 @@
 #include "table/block_based/block_based_table_factory.h"
 #include "table/block_based/block_based_table_reader.h"
 #include "table/block_based/block_builder.h"
+#include "table/block_based/data_block_restart_key_prefixes.h"
 #include "table/block_based/filter_block.h"
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
@@ -207,9 +208,11 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
     : public IntTblPropCollector {
  public:
   explicit BlockBasedTablePropertiesCollector(
-      BlockBasedTableOptions::IndexType index_type, bool whole_key_filtering,
+      BlockBasedTableOptions::IndexType index_type,
+      const IndexBuilder* index_builder, bool whole_key_filtering,
       bool prefix_filtering)
       : index_type_(index_type),
+        index_builder_(index_builder),
         whole_key_filtering_(whole_key_filtering),
         prefix_filtering_(prefix_filtering) {}
 
@@ -230,7 +233,8 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
 
   Status Finish(UserCollectedProperties* properties) override {
     std::string val;
-    PutFixed32(&val, static_cast<uint32_t>(index_type_));
+    PutFixed32(&val, static_cast<uint32_t>(
+                         index_builder_->FinishedIndexType(index_type_)));
     properties->insert({BlockBasedTablePropertyNames::kIndexType, val});
     properties->insert({BlockBasedTablePropertyNames::kWholeKeyFiltering,
                         whole_key_filtering_ ? kPropTrue : kPropFalse});
@@ -251,6 +255,7 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
 
  private:
   BlockBasedTableOptions::IndexType index_type_;
+  const IndexBuilder* index_builder_;
   bool whole_key_filtering_;
   bool prefix_filtering_;
 };
@@ -421,7 +426,10 @@ struct BlockBasedTableBuilder::Rep {
                            ->CanKeysWithDifferentByteContentsBeEqual()
                        ? BlockBasedTableOptions::kDataBlockBinarySearch
                        : table_options.data_block_index_type,
-                   table_options.data_block_hash_table_util_ratio),
+                   table_options.data_block_hash_table_util_ratio,
+                   table_options.data_block_restart_key_prefixes &&
+                       SupportsRestartKeyPrefixes(
+                           tbo.internal_comparator.user_comparator())),
         range_del_block(1 /* block_restart_interval */),
         internal_prefix_transform(tbo.moptions.prefix_extractor.get()),
         compression_type(tbo.compression_type),
@@ -532,7 +540,8 @@ struct BlockBasedTableBuilder::Rep {
     }
     table_properties_collectors.emplace_back(
         new BlockBasedTablePropertiesCollector(
-            table_options.index_type, table_options.whole_key_filtering,
+            table_options.index_type, index_builder.get(),
+            table_options.whole_key_filtering,
             moptions.prefix_extractor != nullptr));
     const Comparator* ucmp = tbo.internal_comparator.user_comparator();
     assert(ucmp);
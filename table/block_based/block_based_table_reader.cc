@@ -22,9 +22,11 @@
 #include "block_cache.h"
 #include "cache/cache_entry_roles.h"
 #include "cache/cache_key.h"
+#include "db/block_cache_warmup.h"
 #include "db/compaction/compaction_picker.h"
 #include "db/dbformat.h"
 #include "db/pinned_iterators_manager.h"
+#include "file/async_read_batch.h"
 #include "file/file_prefetch_buffer.h"
 #include "file/file_util.h"
 #include "file/random_access_file_reader.h"
@@ -56,6 +58,7 @@
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/hash_index_reader.h"
+#include "table/block_based/learned_index_reader.h"
 #include "table/block_based/partitioned_filter_block.h"
 #include "table/block_based/partitioned_index_reader.h"
 #include "table/block_fetcher.h"
@@ -1648,6 +1651,23 @@ BlockBasedTable::MaybeReadBlockAndLoadToCache(
     }
   }
 
+  // Count the reads of data blocks by users, for the warm-up of the block
+  // cache on the next open
+  HotBlockCounter* hot_block_counter =
+      block_cache_tracer_ ? block_cache_tracer_->hot_block_counter() : nullptr;
+  if (hot_block_counter != nullptr &&
+      TBlocklike::kBlockType == BlockType::kData && block_cache && s.ok() &&
+      lookup_context != nullptr &&
+      (lookup_context->caller == TableReaderCaller::kUserGet ||
+       lookup_context->caller == TableReaderCaller::kUserMultiGet ||
+       lookup_context->caller == TableReaderCaller::kUserIterator) &&
+      hot_block_counter->ShouldSample()) {
+    const uint64_t file_number = rep_->sst_number_for_tracing();
+    if (file_number != UINT64_MAX) {
+      hot_block_counter->Record(file_number, handle.offset(), handle.size());
+    }
+  }
+
   // Fill lookup_context.
   if (block_cache_tracer_ && block_cache_tracer_->is_tracing_enabled() &&
       lookup_context) {
@@ -2270,6 +2290,117 @@ Status BlockBasedTable::MultiGetFilter(const ReadOptions& read_options,
   return Status::OK();
 }
 
+Status BlockBasedTable::MultiGetPrefetchBlocks(
+    const ReadOptions& read_options, const MultiGetRange* mget_range,
+    const SliceTransform* prefix_extractor, AsyncReadBatch* read_batch) {
+  // The blocks are handed over to MultiGet() through the block cache
+  if (rep_->table_options.block_cache == nullptr || !read_options.fill_cache ||
+      read_options.read_tier == kBlockCacheTier ||
+      rep_->ioptions.allow_mmap_reads || rep_->file->use_direct_io()) {
+    return Status::NotSupported();
+  }
+  if (mget_range->empty()) {
+    return Status::OK();
+  }
+
+  GetContext* get_context = mget_range->begin()->get_context;
+  BlockCacheLookupContext lookup_context{TableReaderCaller::kUserMultiGet};
+  IndexBlockIter iiter_on_stack;
+  bool need_upper_bound_check = false;
+  if (rep_->index_type == BlockBasedTableOptions::kHashSearch) {
+    need_upper_bound_check = PrefixExtractorChanged(prefix_extractor);
+  }
+  auto iiter = NewIndexIterator(read_options, need_upper_bound_check,
+                                &iiter_on_stack, get_context, &lookup_context);
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
+  if (iiter != &iiter_on_stack) {
+    iiter_unique_ptr.reset(iiter);
+  }
+
+  // Shared with the completion callbacks, which need the dictionary to
+  // uncompress blocks before caching them
+  auto uncompression_dict = std::make_shared<CachableEntry<UncompressionDict>>();
+  if (rep_->uncompression_dict_reader) {
+    Status s =
+        rep_->uncompression_dict_reader->GetOrReadUncompressionDictionary(
+            nullptr /* prefetch_buffer */, false /* no_io */,
+            read_options.verify_checksums, get_context, &lookup_context,
+            uncompression_dict.get());
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  IOOptions opts;
+  IOStatus io_s = rep_->file->PrepareIOOptions(read_options, opts);
+  if (!io_s.ok()) {
+    return io_s;
+  }
+
+  uint64_t prev_offset = std::numeric_limits<uint64_t>::max();
+  bool read_any = false;
+  for (auto miter = mget_range->begin(); miter != mget_range->end(); ++miter) {
+    iiter->Seek(miter->ikey);
+    if (!iiter->Valid()) {
+      // MultiGet() will deal with the error, if any
+      continue;
+    }
+    BlockHandle handle = iiter->value().handle;
+    if (handle.offset() == prev_offset || BlockInCache(handle)) {
+      prev_offset = handle.offset();
+      continue;
+    }
+    prev_offset = handle.offset();
+    read_any = true;
+    PERF_COUNTER_ADD(block_read_count, 1);
+    PERF_COUNTER_ADD(block_read_byte, BlockSizeWithTrailer(handle));
+    read_batch->Read(
+        rep_->file.get(), opts, handle.offset(), BlockSizeWithTrailer(handle),
+        [this, read_options, handle, uncompression_dict](
+            const Status& s, const Slice& result,
+            std::unique_ptr<char[]>&& buf) {
+          // On any failure, MultiGet() reads the block again and reports
+          // the error
+          if (!s.ok() || result.size() != BlockSizeWithTrailer(handle)) {
+            return;
+          }
+          if (result.data() != buf.get()) {
+            memcpy(buf.get(), result.data(), result.size());
+          }
+          if (read_options.verify_checksums) {
+            PERF_TIMER_GUARD(block_checksum_time);
+            Status checksum_s = VerifyBlockChecksum(
+                rep_->footer.checksum_type(), buf.get(), handle.size(),
+                rep_->file->file_name(), handle.offset());
+            if (!checksum_s.ok()) {
+              return;
+            }
+          }
+          BlockContents serialized_block(std::move(buf), handle.size());
+#ifndef NDEBUG
+          serialized_block.has_trailer = true;
+#endif
+          const UncompressionDict& dict =
+              uncompression_dict->GetValue()
+                  ? *uncompression_dict->GetValue()
+                  : UncompressionDict::GetEmptyDict();
+          CachableEntry<Block> block_entry;
+          BlockCacheLookupContext lookup_data_block_context(
+              TableReaderCaller::kUserMultiGet);
+          MaybeReadBlockAndLoadToCache(
+              nullptr, read_options, handle, dict, /*wait=*/true,
+              /*for_compaction=*/false, &block_entry.As<Block_kData>(),
+              /*get_context=*/nullptr, &lookup_data_block_context,
+              &serialized_block, /*async_read=*/false)
+              .PermitUncheckedError();
+        });
+  }
+  if (read_any && get_context) {
+    ++get_context->get_context_stats_.num_sst_read;
+  }
+  return Status::OK();
+}
+
 Status BlockBasedTable::Prefetch(const Slice* const begin,
                                  const Slice* const end) {
   auto& comparator = rep_->internal_comparator;
@@ -2331,6 +2462,104 @@ Status BlockBasedTable::Prefetch(const Slice* const begin,
   return Status::OK();
 }
 
+Status BlockBasedTable::WarmUpBlocks(const ReadOptions& read_options,
+                                     const std::vector<BlockHandle>& handles,
+                                     uint64_t* loaded_blocks,
+                                     uint64_t* loaded_bytes) {
+  assert(loaded_blocks != nullptr);
+  assert(loaded_bytes != nullptr);
+  *loaded_blocks = 0;
+  *loaded_bytes = 0;
+  if (rep_->table_options.block_cache == nullptr || !read_options.fill_cache ||
+      read_options.read_tier == kBlockCacheTier) {
+    return Status::NotSupported();
+  }
+
+  // Blocks closer than this to each other are read with a single IO, in
+  // runs of up to kMaxRunSize bytes
+  constexpr uint64_t kMaxGap = 16 << 10;
+  constexpr uint64_t kMaxRunSize = 256 << 10;
+
+  BlockCacheLookupContext lookup_context{TableReaderCaller::kPrefetch};
+  CachableEntry<UncompressionDict> uncompression_dict;
+  if (rep_->uncompression_dict_reader) {
+    Status s =
+        rep_->uncompression_dict_reader->GetOrReadUncompressionDictionary(
+            nullptr /* prefetch_buffer */, false /* no_io */,
+            read_options.verify_checksums, nullptr /* get_context */,
+            &lookup_context, &uncompression_dict);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  const UncompressionDict& dict = uncompression_dict.GetValue()
+                                      ? *uncompression_dict.GetValue()
+                                      : UncompressionDict::GetEmptyDict();
+
+  IOOptions opts;
+  Status s = rep_->file->PrepareIOOptions(read_options, opts);
+  if (!s.ok()) {
+    return s;
+  }
+
+  // The handles were recorded by an earlier instance of the DB, so do not
+  // trust them to be within the file
+  std::vector<BlockHandle> to_load;
+  for (const BlockHandle& handle : handles) {
+    if (handle.offset() + BlockSizeWithTrailer(handle) <= rep_->file_size &&
+        !BlockInCache(handle)) {
+      to_load.push_back(handle);
+    }
+  }
+
+  for (size_t run_begin = 0; run_begin < to_load.size();) {
+    const uint64_t run_offset = to_load[run_begin].offset();
+    uint64_t run_end_offset =
+        run_offset + BlockSizeWithTrailer(to_load[run_begin]);
+    size_t run_end = run_begin + 1;
+    while (run_end < to_load.size()) {
+      const BlockHandle& next = to_load[run_end];
+      const uint64_t next_end_offset =
+          next.offset() + BlockSizeWithTrailer(next);
+      if (next.offset() < run_end_offset ||
+          next.offset() - run_end_offset > kMaxGap ||
+          next_end_offset - run_offset > kMaxRunSize) {
+        break;
+      }
+      run_end_offset = next_end_offset;
+      ++run_end;
+    }
+
+    std::unique_ptr<FilePrefetchBuffer> prefetch_buffer;
+    rep_->CreateFilePrefetchBuffer(
+        0 /* readahead_size */, 0 /* max_readahead_size */, &prefetch_buffer,
+        false /* implicit_auto_readahead */, 0 /* num_file_reads */,
+        0 /* num_file_reads_for_auto_readahead */);
+    // On failure, the blocks are read one by one below
+    prefetch_buffer
+        ->Prefetch(opts, rep_->file.get(), run_offset,
+                   static_cast<size_t>(run_end_offset - run_offset),
+                   read_options.rate_limiter_priority)
+        .PermitUncheckedError();
+
+    for (size_t i = run_begin; i < run_end; ++i) {
+      CachableEntry<Block> block;
+      Status block_s = RetrieveBlock(
+          prefetch_buffer.get(), read_options, to_load[i], dict,
+          &block.As<Block_kData>(), nullptr /* get_context */,
+          &lookup_context, false /* for_compaction */, true /* use_cache */,
+          true /* wait_for_cache */, false /* async_read */);
+      // The caller counts the blocks failing to load as skipped
+      if (block_s.ok()) {
+        ++*loaded_blocks;
+        *loaded_bytes += to_load[i].size();
+      }
+    }
+    run_begin = run_end;
+  }
+  return Status::OK();
+}
+
 Status BlockBasedTable::VerifyChecksum(const ReadOptions& read_options,
                                        TableReaderCaller caller) {
   Status s;
@@ -2485,6 +2714,10 @@ Status BlockBasedTable::VerifyChecksumInMetaBlocks(
 }
 
 bool BlockBasedTable::TEST_BlockInCache(const BlockHandle& handle) const {
+  return BlockInCache(handle);
+}
+
+bool BlockBasedTable::BlockInCache(const BlockHandle& handle) const {
   assert(rep_ != nullptr);
 
   Cache* const cache = rep_->table_options.block_cache.get();
@@ -2539,6 +2772,11 @@ Status BlockBasedTable::CreateIndexReader(
                                              use_cache, prefetch, pin,
                                              lookup_context, index_reader);
     }
+    case BlockBasedTableOptions::kLearnedSearch: {
+      return LearnedIndexReader::Create(this, ro, prefetch_buffer, use_cache,
+                                        prefetch, pin, lookup_context,
+                                        index_reader);
+    }
     case BlockBasedTableOptions::kHashSearch: {
       if (!rep_->table_prefix_extractor) {
         ROCKS_LOG_WARN(rep_->ioptions.logger,
@@ -144,6 +144,11 @@ class BlockBasedTable : public TableReader {
                         const SliceTransform* prefix_extractor,
                         MultiGetRange* mget_range) override;
 
+  Status MultiGetPrefetchBlocks(const ReadOptions& read_options,
+                                const MultiGetRange* mget_range,
+                                const SliceTransform* prefix_extractor,
+                                AsyncReadBatch* read_batch) override;
+
   DECLARE_SYNC_AND_ASYNC_OVERRIDE(void, MultiGet,
                                   const ReadOptions& readOptions,
                                   const MultiGetContext::Range* mget_range,
@@ -194,6 +199,10 @@ class BlockBasedTable : public TableReader {
   Status VerifyChecksum(const ReadOptions& readOptions,
                         TableReaderCaller caller) override;
 
+  Status WarmUpBlocks(const ReadOptions& read_options,
+                      const std::vector<BlockHandle>& handles,
+                      uint64_t* loaded_blocks, uint64_t* loaded_bytes) override;
+
   ~BlockBasedTable();
 
   bool TEST_FilterBlockInCache() const;
@@ -311,6 +320,9 @@ class BlockBasedTable : public TableReader {
   friend class BlockBasedTableReaderTestVerifyChecksum_ChecksumMismatch_Test;
   BlockCacheTracer* const block_cache_tracer_;
 
+  // Whether the block is in the block cache, without updating statistics
+  bool BlockInCache(const BlockHandle& handle) const;
+
   void UpdateCacheHitMetrics(BlockType block_type, GetContext* get_context,
                              size_t usage) const;
   void UpdateCacheMissMetrics(BlockType block_type,
@@ -60,6 +60,11 @@ TBlockIter* BlockBasedTable::NewDataBlockIterator(
   }
 
   CachableEntry<Block> block;
+  // Uncompressed blocks read from a memory-mapped file are never inserted
+  // into the block cache, so there is no point looking them up
+  const bool use_cache =
+      !(ro.pin_mmap_values && block_type == BlockType::kData &&
+        rep_->ioptions.allow_mmap_reads && !rep_->blocks_maybe_compressed);
   if (rep_->uncompression_dict_reader && block_type == BlockType::kData) {
     CachableEntry<UncompressionDict> uncompression_dict;
     const bool no_io = (ro.read_tier == kBlockCacheTier);
@@ -79,13 +84,13 @@ TBlockIter* BlockBasedTable::NewDataBlockIterator(
                                         : UncompressionDict::GetEmptyDict();
     s = RetrieveBlock(
         prefetch_buffer, ro, handle, dict, &block.As<IterBlocklike>(),
-        get_context, lookup_context, for_compaction,
-        /* use_cache */ true, /* wait_for_cache */ true, async_read);
+        get_context, lookup_context, for_compaction, use_cache,
+        /* wait_for_cache */ true, async_read);
   } else {
     s = RetrieveBlock(
         prefetch_buffer, ro, handle, UncompressionDict::GetEmptyDict(),
         &block.As<IterBlocklike>(), get_context, lookup_context, for_compaction,
-        /* use_cache */ true, /* wait_for_cache */ true, async_read);
+        use_cache, /* wait_for_cache */ true, async_read);
   }
 
   if (s.IsTryAgain() && async_read) {
@@ -106,10 +111,15 @@ TBlockIter* BlockBasedTable::NewDataBlockIterator(
   // 1. block cache handle is set to be released in cleanup function, or
   // 2. it's pointing to immortal source. If own_bytes is true then we are
   //    not reading data from the original source, whether immortal or not.
-  //    Otherwise, the block is pinned iff the source is immortal.
+  //    Otherwise, the block is pinned iff the source is immortal, or
+  // 3. it's pointing to the memory-mapped file of a table reader, which the
+  //    iterator keeps in the table cache (see ReadOptions::pin_mmap_values)
   const bool block_contents_pinned =
       block.IsCached() ||
-      (!block.GetValue()->own_bytes() && rep_->immortal_table);
+      (!block.GetValue()->own_bytes() &&
+       (rep_->immortal_table ||
+        (ro.pin_mmap_values && get_context != nullptr &&
+         get_context->PinTableReader(iter))));
   iter = InitBlockIterator<TBlockIter>(rep_, block.GetValue(), block_type, iter,
                                        block_contents_pinned);
 
@@ -40,6 +40,7 @@
 #include "db/dbformat.h"
 #include "rocksdb/comparator.h"
 #include "table/block_based/data_block_footer.h"
+#include "table/block_based/data_block_restart_key_prefixes.h"
 #include "util/coding.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -48,10 +49,11 @@ BlockBuilder::BlockBuilder(
     int block_restart_interval, bool use_delta_encoding,
     bool use_value_delta_encoding,
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    double data_block_hash_table_util_ratio)
+    double data_block_hash_table_util_ratio, bool use_restart_key_prefixes)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
       use_value_delta_encoding_(use_value_delta_encoding),
+      use_restart_key_prefixes_(use_restart_key_prefixes),
       restarts_(1, 0),  // First restart point is at offset 0
       counter_(0),
       finished_(false) {
@@ -73,6 +75,7 @@ void BlockBuilder::Reset() {
   buffer_.clear();
   restarts_.resize(1);  // First restart point is at offset 0
   assert(restarts_[0] == 0);
+  restart_key_prefixes_.clear();
   estimate_ = sizeof(uint32_t) + sizeof(uint32_t);
   counter_ = 0;
   finished_ = false;
@@ -105,6 +108,9 @@ size_t BlockBuilder::EstimateSizeAfterKV(const Slice& key,
 
   if (counter_ >= block_restart_interval_) {
     estimate += sizeof(uint32_t);  // a new restart entry.
+    if (use_restart_key_prefixes_) {
+      estimate += kRestartKeyPrefixSize;
+    }
   }
 
   estimate += sizeof(int32_t);  // varint for shared prefix length.
@@ -125,16 +131,34 @@ Slice BlockBuilder::Finish() {
   }
 
   uint32_t num_restarts = static_cast<uint32_t>(restarts_.size());
+  // Like the hash index, restart key prefixes are only flagged in the footer
+  // of blocks within kMaxBlockSizeSupportedByHashIndex.
+  size_t block_size = estimate_;
+  bool has_restart_key_prefixes = false;
+  if (!restart_key_prefixes_.empty() &&
+      block_size + restart_key_prefixes_.size() * kRestartKeyPrefixSize <=
+          kMaxBlockSizeSupportedByHashIndex) {
+    assert(restart_key_prefixes_.size() == restarts_.size());
+    for (uint64_t prefix : restart_key_prefixes_) {
+      PutFixed64(&buffer_, prefix);
+    }
+    block_size += restart_key_prefixes_.size() * kRestartKeyPrefixSize;
+    has_restart_key_prefixes = true;
+  }
+
   BlockBasedTableOptions::DataBlockIndexType index_type =
       BlockBasedTableOptions::kDataBlockBinarySearch;
   if (data_block_hash_index_builder_.Valid() &&
-      CurrentSizeEstimate() <= kMaxBlockSizeSupportedByHashIndex) {
+      block_size + data_block_hash_index_builder_.EstimateSize() <=
+          kMaxBlockSizeSupportedByHashIndex) {
     data_block_hash_index_builder_.Finish(buffer_);
     index_type = BlockBasedTableOptions::kDataBlockBinaryAndHash;
   }
 
-  // footer is a packed format of data_block_index_type and num_restarts
-  uint32_t block_footer = PackIndexTypeAndNumRestarts(index_type, num_restarts);
+  // footer is a packed format of data_block_index_type, the restart key
+  // prefixes flag and num_restarts
+  uint32_t block_footer = PackIndexTypeAndNumRestarts(
+      index_type, num_restarts, has_restart_key_prefixes);
 
   PutFixed32(&buffer_, block_footer);
   finished_ = true;
@@ -197,6 +221,9 @@ inline void BlockBuilder::AddWithLastKeyImpl(const Slice& key,
     // See how much sharing to do with previous string
     shared = key.difference_offset(last_key);
   }
+  if (use_restart_key_prefixes_ && counter_ == 0) {
+    restart_key_prefixes_.push_back(GetRestartKeyPrefix(ExtractUserKey(key)));
+  }
 
   const size_t non_shared = key.size() - shared;
 
@@ -23,12 +23,15 @@ class BlockBuilder {
   BlockBuilder(const BlockBuilder&) = delete;
   void operator=(const BlockBuilder&) = delete;
 
+  // `use_restart_key_prefixes` requires internal keys ordered by the
+  // bytewise comparator, see data_block_restart_key_prefixes.h.
   explicit BlockBuilder(int block_restart_interval,
                         bool use_delta_encoding = true,
                         bool use_value_delta_encoding = false,
                         BlockBasedTableOptions::DataBlockIndexType index_type =
                             BlockBasedTableOptions::kDataBlockBinarySearch,
-                        double data_block_hash_table_util_ratio = 0.75);
+                        double data_block_hash_table_util_ratio = 0.75,
+                        bool use_restart_key_prefixes = false);
 
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
@@ -64,9 +67,10 @@ class BlockBuilder {
   // Returns an estimate of the current (uncompressed) size of the block
   // we are building.
   inline size_t CurrentSizeEstimate() const {
-    return estimate_ + (data_block_hash_index_builder_.Valid()
-                            ? data_block_hash_index_builder_.EstimateSize()
-                            : 0);
+    return estimate_ + restart_key_prefixes_.size() * sizeof(uint64_t) +
+           (data_block_hash_index_builder_.Valid()
+                ? data_block_hash_index_builder_.EstimateSize()
+                : 0);
   }
 
   // Returns an estimated block size after appending key and value.
@@ -86,9 +90,12 @@ class BlockBuilder {
   const bool use_delta_encoding_;
   // Refer to BlockIter::DecodeCurrentValue for format of delta encoded values
   const bool use_value_delta_encoding_;
+  const bool use_restart_key_prefixes_;
 
   std::string buffer_;              // Destination buffer
   std::vector<uint32_t> restarts_;  // Restart points
+  // Prefixes of the keys at restart points, if use_restart_key_prefixes_
+  std::vector<uint64_t> restart_key_prefixes_;
   size_t estimate_;
   int counter_;    // Number of entries emitted since restart
   bool finished_;  // Has Finish() been called?
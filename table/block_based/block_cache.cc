@@ -11,6 +11,10 @@ void BlockCreateContext::Create(std::unique_ptr<Block_kData>* parsed_out,
                                 BlockContents&& block) {
   parsed_out->reset(new Block_kData(
       std::move(block), table_options->read_amp_bytes_per_bit, statistics));
+  if (table_options->cache_expanded_data_blocks &&
+      table_options->block_cache != nullptr) {
+    (*parsed_out)->ExpandDataEntries();
+  }
 }
 void BlockCreateContext::Create(std::unique_ptr<Block_kIndex>* parsed_out,
                                 BlockContents&& block) {
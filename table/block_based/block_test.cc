@@ -18,12 +18,14 @@
 #include "db/dbformat.h"
 #include "db/memtable.h"
 #include "db/write_batch_internal.h"
+#include "rocksdb/cache.h"
 #include "rocksdb/db.h"
 #include "rocksdb/env.h"
 #include "rocksdb/iterator.h"
 #include "rocksdb/slice_transform.h"
 #include "rocksdb/table.h"
 #include "table/block_based/block_based_table_reader.h"
+#include "table/block_based/block_cache.h"
 #include "table/block_based/block_builder.h"
 #include "table/format.h"
 #include "test_util/testharness.h"
@@ -492,6 +494,296 @@ TEST_F(BlockTest, ReadAmpBitmapPow2) {
   ASSERT_EQ(BlockReadAmpBitmap(100, 35, stats.get()).GetBytesPerBit(), 32u);
 }
 
+class BlockRestartKeyPrefixesTest
+    : public testing::Test,
+      public testing::WithParamInterface<
+          std::tuple<int /* restart interval */, bool /* hash index */>> {};
+
+TEST_P(BlockRestartKeyPrefixesTest, SeekMatchesWithoutPrefixes) {
+  const int restart_interval = std::get<0>(GetParam());
+  const bool hash_index = std::get<1>(GetParam());
+  Random rnd(301);
+
+  // Short keys and keys sharing their first 8 bytes, from an alphabet
+  // including '\0' and '\xff' to cover zero padding and unsigned ordering.
+  const std::string alphabet("\0ab\xff", 4);
+  auto random_user_key = [&]() {
+    std::string key(rnd.OneIn(2) ? "prefix__" : "");
+    size_t len = rnd.Uniform(11);
+    for (size_t i = 0; i < len; ++i) {
+      key.push_back(alphabet[rnd.Uniform(static_cast<int>(alphabet.size()))]);
+    }
+    return key;
+  };
+  // The hash index supports fewer restart points
+  const size_t num_keys = hash_index ? 200 : 1000;
+  std::set<std::string> user_key_set;
+  while (user_key_set.size() < num_keys) {
+    user_key_set.insert(random_user_key());
+  }
+  std::vector<std::string> user_keys(user_key_set.begin(),
+                                     user_key_set.end());
+
+  BlockBuilder builder(restart_interval, true /* use_delta_encoding */,
+                       false /* use_value_delta_encoding */,
+                       hash_index
+                           ? BlockBasedTableOptions::kDataBlockBinaryAndHash
+                           : BlockBasedTableOptions::kDataBlockBinarySearch,
+                       0.75 /* data_block_hash_table_util_ratio */,
+                       true /* use_restart_key_prefixes */);
+  for (const std::string &user_key : user_keys) {
+    std::string key = user_key;
+    AppendInternalKeyFooter(&key, 100 /* seqno */, kTypeValue);
+    builder.Add(key, "v_" + user_key);
+  }
+  BlockContents contents;
+  contents.data = builder.Finish();
+  Block reader(std::move(contents));
+  ASSERT_TRUE(reader.HasRestartKeyPrefixes());
+  ASSERT_EQ(reader.IndexType(),
+            hash_index ? BlockBasedTableOptions::kDataBlockBinaryAndHash
+                       : BlockBasedTableOptions::kDataBlockBinarySearch);
+
+  std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+      BytewiseComparator(), kDisableGlobalSequenceNumber));
+  size_t count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ASSERT_LT(count, user_keys.size());
+    ASSERT_EQ(ExtractUserKey(iter->key()).ToString(), user_keys[count]);
+    ++count;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(count, user_keys.size());
+
+  for (int i = 0; i < 3000; ++i) {
+    std::string target_user_key =
+        rnd.OneIn(2) ? user_keys[rnd.Uniform(static_cast<int>(
+                           user_keys.size()))]
+                     : random_user_key();
+    InternalKey target(target_user_key, kMaxSequenceNumber, kValueTypeForSeek);
+    auto lower = std::lower_bound(user_keys.begin(), user_keys.end(),
+                                  target_user_key);
+    auto upper = std::upper_bound(user_keys.begin(), user_keys.end(),
+                                  target_user_key);
+
+    iter->Seek(target.Encode());
+    ASSERT_OK(iter->status());
+    if (lower == user_keys.end()) {
+      ASSERT_FALSE(iter->Valid());
+    } else {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(ExtractUserKey(iter->key()).ToString(), *lower);
+      ASSERT_EQ(iter->value().ToString(), "v_" + *lower);
+    }
+
+    // Seeks for the last entry at or before the user key
+    InternalKey prev_target(target_user_key, 0, kTypeDeletion);
+    iter->SeekForPrev(prev_target.Encode());
+    ASSERT_OK(iter->status());
+    if (upper == user_keys.begin()) {
+      ASSERT_FALSE(iter->Valid());
+    } else {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(ExtractUserKey(iter->key()).ToString(), *(upper - 1));
+    }
+
+    bool may_exist = iter->SeekForGet(target.Encode());
+    if (lower != user_keys.end() && *lower == target_user_key) {
+      ASSERT_TRUE(may_exist);
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(ExtractUserKey(iter->key()).ToString(), target_user_key);
+    } else if (may_exist && iter->Valid()) {
+      ASSERT_NE(ExtractUserKey(iter->key()).ToString(), target_user_key);
+    }
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(
+    BlockRestartKeyPrefixesTest, BlockRestartKeyPrefixesTest,
+    ::testing::Combine(::testing::Values(1, 4, 16), ::testing::Bool()));
+
+TEST_F(BlockTest, RestartKeyPrefixesSkippedForLargeBlock) {
+  BlockBuilder builder(16, true /* use_delta_encoding */,
+                       false /* use_value_delta_encoding */,
+                       BlockBasedTableOptions::kDataBlockBinarySearch,
+                       0.75 /* data_block_hash_table_util_ratio */,
+                       true /* use_restart_key_prefixes */);
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  GenerateRandomKVs(&keys, &values, 0, 1000);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    builder.Add(keys[i], values[i]);
+  }
+  BlockContents contents;
+  contents.data = builder.Finish();
+  ASSERT_GT(contents.data.size(), kMaxBlockSizeSupportedByHashIndex);
+  Block reader(std::move(contents));
+  ASSERT_FALSE(reader.HasRestartKeyPrefixes());
+
+  std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+      BytewiseComparator(), kDisableGlobalSequenceNumber));
+  for (size_t i = 0; i < keys.size(); i += 7) {
+    iter->Seek(keys[i]);
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(iter->key(), keys[i]);
+    ASSERT_EQ(iter->value(), values[i]);
+  }
+}
+
+class BlockExpandedEntriesTest
+    : public testing::Test,
+      public testing::WithParamInterface<
+          std::tuple<int /* restart interval */, bool /* hash index */>> {};
+
+TEST_P(BlockExpandedEntriesTest, MatchesDecodedBlock) {
+  const int restart_interval = std::get<0>(GetParam());
+  const bool hash_index = std::get<1>(GetParam());
+  Random rnd(301);
+
+  // Keys sharing prefixes, so that they are delta encoded. The hash index
+  // supports smaller blocks.
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  GenerateRandomKVs(&keys, &values, 0, hash_index ? 100 : 500, 1 /* step */,
+                    8 /* padding_size */, 3 /* keys_share_prefix */);
+  BlockBuilder builder(restart_interval, true /* use_delta_encoding */,
+                       false /* use_value_delta_encoding */,
+                       hash_index
+                           ? BlockBasedTableOptions::kDataBlockBinaryAndHash
+                           : BlockBasedTableOptions::kDataBlockBinarySearch);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    builder.Add(keys[i], values[i]);
+  }
+  const std::string raw_block = builder.Finish().ToString();
+
+  // On the heap, for ApproximateMemoryUsage()
+  BlockContents decoded_contents;
+  decoded_contents.data = raw_block;
+  std::unique_ptr<Block> decoded(new Block(std::move(decoded_contents)));
+  BlockContents expanded_contents;
+  expanded_contents.data = raw_block;
+  std::unique_ptr<Block> expanded(new Block(std::move(expanded_contents)));
+  const size_t usage_before = expanded->ApproximateMemoryUsage();
+  expanded->ExpandDataEntries();
+  ASSERT_TRUE(expanded->IsExpanded());
+  ASSERT_FALSE(decoded->IsExpanded());
+
+  // The expanded entries are accounted for
+  size_t keys_size = 0;
+  for (const std::string &key : keys) {
+    keys_size += key.size();
+  }
+  ASSERT_GE(expanded->ApproximateMemoryUsage(),
+            usage_before + keys_size +
+                keys.size() * sizeof(ExpandedDataBlockEntries::Entry));
+
+  std::unique_ptr<DataBlockIter> decoded_iter(decoded->NewDataIterator(
+      BytewiseComparator(), kDisableGlobalSequenceNumber));
+  std::unique_ptr<DataBlockIter> iter(expanded->NewDataIterator(
+      BytewiseComparator(), kDisableGlobalSequenceNumber));
+  size_t count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ASSERT_LT(count, keys.size());
+    ASSERT_EQ(iter->key(), keys[count]);
+    ASSERT_EQ(iter->value(), values[count]);
+    ++count;
+  }
+  ASSERT_EQ(count, keys.size());
+  for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+    ASSERT_GT(count, 0);
+    --count;
+    ASSERT_EQ(iter->key(), keys[count]);
+    ASSERT_EQ(iter->value(), values[count]);
+  }
+  ASSERT_EQ(count, 0);
+
+  auto assert_same_position = [&]() {
+    ASSERT_OK(iter->status());
+    ASSERT_OK(decoded_iter->status());
+    ASSERT_EQ(decoded_iter->Valid(), iter->Valid());
+    if (iter->Valid()) {
+      ASSERT_EQ(decoded_iter->key(), iter->key());
+      ASSERT_EQ(decoded_iter->value(), iter->value());
+    }
+  };
+  for (int i = 0; i < 2000; ++i) {
+    // Existing user keys, and ones before, between or after them
+    std::string user_key =
+        ExtractUserKey(keys[rnd.Uniform(static_cast<int>(keys.size()))])
+            .ToString();
+    if (rnd.OneIn(3)) {
+      user_key.resize(rnd.Uniform(static_cast<int>(user_key.size())));
+    } else if (rnd.OneIn(2)) {
+      user_key.push_back(static_cast<char>(rnd.Uniform(256)));
+    }
+    InternalKey target(user_key, rnd.OneIn(2) ? kMaxSequenceNumber : 0,
+                       kValueTypeForSeek);
+
+    iter->Seek(target.Encode());
+    decoded_iter->Seek(target.Encode());
+    assert_same_position();
+    for (int step = 0; step < 3 && iter->Valid(); ++step) {
+      if (rnd.OneIn(2)) {
+        iter->Next();
+        decoded_iter->Next();
+      } else {
+        iter->Prev();
+        decoded_iter->Prev();
+      }
+      assert_same_position();
+    }
+
+    iter->SeekForPrev(target.Encode());
+    decoded_iter->SeekForPrev(target.Encode());
+    assert_same_position();
+
+    // Without the hash index, which is bypassed for expanded blocks
+    ASSERT_TRUE(iter->SeekForGet(target.Encode()));
+    decoded_iter->Seek(target.Encode());
+    assert_same_position();
+  }
+
+  // With a global seqno, the iterators decode the block
+  std::unique_ptr<DataBlockIter> seqno_iter(
+      expanded->NewDataIterator(BytewiseComparator(), 100 /* global_seqno */));
+  count = 0;
+  for (seqno_iter->SeekToFirst(); seqno_iter->Valid(); seqno_iter->Next()) {
+    ASSERT_EQ(ExtractUserKey(seqno_iter->key()), ExtractUserKey(keys[count]));
+    ASSERT_EQ(GetInternalKeySeqno(seqno_iter->key()), 100);
+    ++count;
+  }
+  ASSERT_EQ(count, keys.size());
+}
+
+INSTANTIATE_TEST_CASE_P(
+    BlockExpandedEntriesTest, BlockExpandedEntriesTest,
+    ::testing::Combine(::testing::Values(1, 4, 16), ::testing::Bool()));
+
+TEST_F(BlockTest, CreateContextExpandsCachedDataBlocks) {
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  GenerateRandomKVs(&keys, &values, 0, 100);
+  BlockBuilder builder(16);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    builder.Add(keys[i], values[i]);
+  }
+  const std::string raw_block = builder.Finish().ToString();
+
+  BlockBasedTableOptions table_options;
+  table_options.cache_expanded_data_blocks = true;
+  for (bool with_cache : {false, true}) {
+    table_options.block_cache = with_cache ? NewLRUCache(1 << 20) : nullptr;
+    BlockCreateContext create_context(&table_options, nullptr /* statistics */,
+                                      false /* using_zstd */);
+    std::unique_ptr<Block_kData> block;
+    BlockContents contents;
+    contents.data = raw_block;
+    create_context.Create(&block, std::move(contents));
+    // Only where the block might be cached
+    ASSERT_EQ(with_cache, block->IsExpanded());
+  }
+}
+
 class IndexBlockTest
     : public testing::Test,
       public testing::WithParamInterface<std::tuple<bool, bool>> {
@@ -13,13 +13,17 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+// The footer of a data block is NUM_RESTARTS with the MSB flagging the
+// data block hash index and the second MSB flagging the restart key prefix
+// array (see BlockBasedTableOptions::data_block_restart_key_prefixes). Both
+// are only used in blocks smaller than kMaxBlockSizeSupportedByHashIndex.
 uint32_t PackIndexTypeAndNumRestarts(
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    uint32_t num_restarts);
+    uint32_t num_restarts, bool has_restart_key_prefixes = false);
 
 void UnPackIndexTypeAndNumRestarts(
     uint32_t block_footer,
     BlockBasedTableOptions::DataBlockIndexType* index_type,
-    uint32_t* num_restarts);
+    uint32_t* num_restarts, bool* has_restart_key_prefixes = nullptr);
 
 }  // namespace ROCKSDB_NAMESPACE
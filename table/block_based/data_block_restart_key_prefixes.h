@@ -0,0 +1,135 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "rocksdb/comparator.h"
+#include "rocksdb/slice.h"
+#include "util/coding.h"
+#include "util/math.h"
+
+#ifdef HAVE_AVX2
+#include <immintrin.h>
+#endif
+
+namespace ROCKSDB_NAMESPACE {
+// Restart key prefixes are an optional part of data blocks that speeds up
+// seeking within a block (see
+// BlockBasedTableOptions::data_block_restart_key_prefixes). The new data block
+// format is as follows:
+//
+// DATA_BLOCK: [RI RI RI ... RI RI_IDX PREFIXES [HASH_IDX] FOOTER]
+//
+// RI:       Restart Interval (the same as the default data-block format)
+// RI_IDX:   Restart Interval index (the same as the default data-block format)
+// PREFIXES: One fixed64 per restart point, holding the first 8 bytes of the
+//           user key at that restart point read as a big-endian number
+//           (zero-padded if the user key is shorter).
+// HASH_IDX: The optional data block hash index (see data_block_hash_index.h)
+// FOOTER:   NUM_RESTARTS with the second MSB flagging PREFIXES (see
+//           data_block_footer.h)
+//
+// For the bytewise comparator, the prefix is monotonic in the user key. So a
+// restart key whose prefix is less (greater) than the prefix of the seek
+// target is itself less (greater) than the target, and the binary search over
+// the restart keys only needs to decode and compare the restart keys sharing
+// the prefix of the target. The prefixes are searched with a few comparisons
+// of integers laid out contiguously in memory, instead of a cache miss and a
+// varint decode per probed restart key.
+
+// Size of the serialized prefix of one restart key
+const size_t kRestartKeyPrefixSize = sizeof(uint64_t);
+
+// Number of prefixes (two cache lines) at which searching switches from
+// binary search to a linear, SIMD-friendly count
+const uint32_t kRestartKeyPrefixScanLength = 16;
+
+// Whether the prefixes are ordered like the user keys of `ucmp`
+inline bool SupportsRestartKeyPrefixes(const Comparator* ucmp) {
+  return ucmp->timestamp_size() == 0 &&
+         strcmp(ucmp->Name(), BytewiseComparator()->Name()) == 0;
+}
+
+inline uint64_t GetRestartKeyPrefix(const Slice& user_key) {
+  if (user_key.size() >= kRestartKeyPrefixSize) {
+    return EndianSwapValue(DecodeFixed64(user_key.data()));
+  }
+  uint64_t prefix = 0;
+  for (size_t i = 0; i < user_key.size(); ++i) {
+    prefix |= static_cast<uint64_t>(static_cast<unsigned char>(user_key[i]))
+              << (56 - 8 * i);
+  }
+  return prefix;
+}
+
+// Returns the number of prefixes in the sorted `prefixes[0, num)` that are
+// less than `value` (or not greater than `value` if `kOrEqual`), assuming
+// that all of `prefixes[0, lo)` are.
+template <bool kOrEqual>
+inline uint32_t CountRestartKeyPrefixesBelow(const char* prefixes,
+                                             uint32_t lo, uint32_t num,
+                                             uint64_t value) {
+  uint32_t hi = num;
+  while (hi - lo > kRestartKeyPrefixScanLength) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    uint64_t prefix = DecodeFixed64(prefixes + mid * kRestartKeyPrefixSize);
+    if (prefix < value || (kOrEqual && prefix == value)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  // All prefixes before `lo` are below `value` and none from `hi` on, so
+  // counting the ones below in between gives the position without branching
+  // on each comparison.
+  uint32_t count = lo;
+  uint32_t i = lo;
+#ifdef HAVE_AVX2
+  // There is only a signed 64-bit comparison, so flip the sign bits to
+  // compare as unsigned.
+  const __m256i sign_bits = _mm256_set1_epi64x(INT64_MIN);
+  const __m256i values =
+      _mm256_xor_si256(_mm256_set1_epi64x(static_cast<int64_t>(value)),
+                       sign_bits);
+  for (; i + 4 <= hi; i += 4) {
+    const __m256i loaded = _mm256_xor_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+            prefixes + i * kRestartKeyPrefixSize)),
+        sign_bits);
+    if (kOrEqual) {
+      __m256i greater = _mm256_cmpgt_epi64(loaded, values);
+      count += 4 - static_cast<uint32_t>(__builtin_popcount(
+                       _mm256_movemask_pd(_mm256_castsi256_pd(greater))));
+    } else {
+      __m256i less = _mm256_cmpgt_epi64(values, loaded);
+      count += static_cast<uint32_t>(__builtin_popcount(
+          _mm256_movemask_pd(_mm256_castsi256_pd(less))));
+    }
+  }
+#endif  // HAVE_AVX2
+  for (; i < hi; ++i) {
+    uint64_t prefix = DecodeFixed64(prefixes + i * kRestartKeyPrefixSize);
+    count += (prefix < value || (kOrEqual && prefix == value)) ? 1 : 0;
+  }
+  return count;
+}
+
+// Sets [*begin, *end) to the range of restart points whose key prefix is
+// `value`. Restart keys before `*begin` are less than any key with prefix
+// `value`, and restart keys from `*end` on are greater.
+inline void FindRestartKeyPrefixRange(const char* prefixes,
+                                      uint32_t num_restarts, uint64_t value,
+                                      uint32_t* begin, uint32_t* end) {
+  *begin = CountRestartKeyPrefixesBelow<false>(prefixes, 0, num_restarts,
+                                               value);
+  *end = CountRestartKeyPrefixesBelow<true>(prefixes, *begin, num_restarts,
+                                            value);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
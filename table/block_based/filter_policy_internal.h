@@ -89,7 +89,10 @@ class FilterBitsReader {
   // Check if the entry match the bits in filter
   virtual bool MayMatch(const Slice& entry) = 0;
 
-  // Check if an array of entries match the bits in filter
+  // Check if an array of entries match the bits in filter. Built-in
+  // implementations work in two passes to overlap the cache misses of the
+  // keys: the first hashes all the keys and prefetches the memory they
+  // probe, the second probes.
   virtual void MayMatch(int num_keys, Slice** keys, bool* may_match) {
     for (int i = 0; i < num_keys; ++i) {
       may_match[i] = MayMatch(*keys[i]);
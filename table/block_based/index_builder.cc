@@ -61,6 +61,13 @@ IndexBuilder* IndexBuilder::CreateIndexBuilder(
           table_opt.index_shortening, /* include_first_key */ true);
       break;
     }
+    case BlockBasedTableOptions::kLearnedSearch: {
+      result = new LearnedIndexBuilder(
+          comparator, table_opt.index_block_restart_interval,
+          table_opt.format_version, use_value_delta_encoding,
+          table_opt.index_shortening);
+      break;
+    }
     default: {
       assert(!"Do not recognize the index type ");
       break;
@@ -19,6 +19,7 @@
 #include "rocksdb/comparator.h"
 #include "table/block_based/block_based_table_factory.h"
 #include "table/block_based/block_builder.h"
+#include "table/block_based/learned_index.h"
 #include "table/format.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -103,6 +104,14 @@ class IndexBuilder {
 
   virtual bool seperator_is_key_plus_seq() { return true; }
 
+  // The type of the index written by Finish(), which only differs from the
+  // configured `index_type` if the builder fell back to another index type.
+  // Must be called after ::Finish.
+  virtual BlockBasedTableOptions::IndexType FinishedIndexType(
+      BlockBasedTableOptions::IndexType index_type) const {
+    return index_type;
+  }
+
  protected:
   const InternalKeyComparator* comparator_;
   // Set after ::Finish is called
@@ -364,6 +373,80 @@ class HashIndexBuilder : public IndexBuilder {
   uint64_t current_restart_index_ = 0;
 };
 
+// LearnedIndexBuilder builds a learned index block (see learned_index.h). If
+// the table turns out not to qualify for a learned index, it falls back to a
+// binary search index, which it builds alongside until the learned index is
+// ruled out.
+class LearnedIndexBuilder : public IndexBuilder {
+ public:
+  explicit LearnedIndexBuilder(
+      const InternalKeyComparator* comparator,
+      int index_block_restart_interval, uint32_t format_version,
+      bool use_value_delta_encoding,
+      BlockBasedTableOptions::IndexShorteningMode shortening_mode)
+      : IndexBuilder(comparator),
+        fallback_index_builder_(comparator, index_block_restart_interval,
+                                format_version, use_value_delta_encoding,
+                                shortening_mode, /* include_first_key */ false),
+        index_block_builder_(1 /* block_restart_interval */),
+        learned_(SupportsLearnedIndex(comparator->user_comparator())) {}
+
+  virtual void AddIndexEntry(std::string* last_key_in_current_block,
+                             const Slice* first_key_in_next_block,
+                             const BlockHandle& block_handle) override {
+    if (learned_) {
+      // The separators are user keys, so a user key must not span blocks
+      const Slice last_user_key = ExtractUserKey(*last_key_in_current_block);
+      learned_ = (first_key_in_next_block == nullptr ||
+                  comparator_->user_comparator()->Compare(
+                      last_user_key,
+                      ExtractUserKey(*first_key_in_next_block)) != 0) &&
+                 learned_index_block_builder_.Add(last_user_key, block_handle);
+      if (!learned_) {
+        learned_index_block_builder_.Reset();
+      }
+    }
+    fallback_index_builder_.AddIndexEntry(last_key_in_current_block,
+                                          first_key_in_next_block,
+                                          block_handle);
+  }
+
+  using IndexBuilder::Finish;
+  virtual Status Finish(
+      IndexBlocks* index_blocks,
+      const BlockHandle& last_partition_block_handle) override {
+    if (!learned_) {
+      Status s = fallback_index_builder_.Finish(index_blocks,
+                                                last_partition_block_handle);
+      index_size_ = fallback_index_builder_.IndexSize();
+      return s;
+    }
+    index_block_builder_.Add(Slice(), learned_index_block_builder_.Finish());
+    index_blocks->index_block_contents = index_block_builder_.Finish();
+    index_size_ = index_blocks->index_block_contents.size();
+    return Status::OK();
+  }
+
+  virtual size_t IndexSize() const override { return index_size_; }
+
+  virtual bool seperator_is_key_plus_seq() override {
+    return learned_ ? false
+                    : fallback_index_builder_.seperator_is_key_plus_seq();
+  }
+
+  virtual BlockBasedTableOptions::IndexType FinishedIndexType(
+      BlockBasedTableOptions::IndexType /*index_type*/) const override {
+    return learned_ ? BlockBasedTableOptions::kLearnedSearch
+                    : BlockBasedTableOptions::kBinarySearch;
+  }
+
+ private:
+  ShortenedIndexBuilder fallback_index_builder_;
+  LearnedIndexBlockBuilder learned_index_block_builder_;
+  BlockBuilder index_block_builder_;
+  bool learned_;
+};
+
 /**
  * IndexBuilder for two-level indexing. Internally it creates a new index for
  * each partition and Finish then in order when Finish is called on it
@@ -0,0 +1,211 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/learned_index.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "table/block_based/block_based_table_reader.h"
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+bool LearnedIndexBlockBuilder::Add(const Slice& last_user_key,
+                                   const BlockHandle& handle) {
+  if (key_values_.empty()) {
+    if (last_user_key.empty() || last_user_key.size() > sizeof(uint64_t)) {
+      return false;
+    }
+    key_width_ = static_cast<uint32_t>(last_user_key.size());
+    first_offset_ = handle.offset();
+    next_offset_ = handle.offset();
+  } else if (last_user_key.size() != key_width_ ||
+             handle.offset() != next_offset_) {
+    return false;
+  }
+  const uint64_t key_value = GetLearnedIndexKeyValue(last_user_key, key_width_);
+  if (!key_values_.empty() && key_value <= key_values_.back()) {
+    return false;
+  }
+  const uint64_t end =
+      handle.offset() + handle.size() + BlockBasedTable::kBlockTrailerSize;
+  if (end - first_offset_ > std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+  key_values_.push_back(key_value);
+  PutFixed32(&ends_, static_cast<uint32_t>(end - first_offset_));
+  keys_.append(last_user_key.data(), last_user_key.size());
+  next_offset_ = end;
+  return true;
+}
+
+void LearnedIndexBlockBuilder::BuildSegments(
+    std::vector<Segment>* segments) const {
+  const size_t num_keys = key_values_.size();
+  size_t first = 0;
+  while (first < num_keys) {
+    // Slopes of lines through the first point of the segment that predict
+    // every point added so far within max_error_
+    double min_slope = 0;
+    double max_slope = std::numeric_limits<double>::infinity();
+    size_t i = first + 1;
+    for (; i < num_keys; ++i) {
+      const double dx =
+          static_cast<double>(key_values_[i] - key_values_[first]);
+      const double dy = static_cast<double>(i - first);
+      const double lo = std::max(min_slope, (dy - max_error_) / dx);
+      const double hi = std::min(max_slope, (dy + max_error_) / dx);
+      if (lo > hi) {
+        break;
+      }
+      min_slope = lo;
+      max_slope = hi;
+    }
+    Segment segment;
+    segment.first_key_value = key_values_[first];
+    segment.slope = i == first + 1 ? 0 : (min_slope + max_slope) / 2;
+    segment.first_block = static_cast<uint32_t>(first);
+    segments->push_back(segment);
+    first = i;
+  }
+}
+
+Slice LearnedIndexBlockBuilder::Finish() {
+  std::vector<Segment> segments;
+  BuildSegments(&segments);
+
+  buffer_.clear();
+  PutFixed32(&buffer_, static_cast<uint32_t>(key_values_.size()));
+  PutFixed32(&buffer_, key_width_);
+  PutFixed32(&buffer_, static_cast<uint32_t>(segments.size()));
+  PutFixed32(&buffer_, max_error_);
+  PutFixed64(&buffer_, first_offset_);
+  for (const Segment& segment : segments) {
+    uint64_t slope_bits;
+    static_assert(sizeof(slope_bits) == sizeof(segment.slope), "");
+    memcpy(&slope_bits, &segment.slope, sizeof(slope_bits));
+    PutFixed64(&buffer_, segment.first_key_value);
+    PutFixed64(&buffer_, slope_bits);
+    PutFixed32(&buffer_, segment.first_block);
+  }
+  buffer_.append(ends_);
+  buffer_.append(keys_);
+  return Slice(buffer_);
+}
+
+void LearnedIndexBlockBuilder::Reset() {
+  key_width_ = 0;
+  first_offset_ = 0;
+  next_offset_ = 0;
+  std::vector<uint64_t>().swap(key_values_);
+  std::string().swap(ends_);
+  std::string().swap(keys_);
+  std::string().swap(buffer_);
+}
+
+Status LearnedIndex::Init(const Slice& contents) {
+  if (contents.size() < kHeaderSize) {
+    return Status::Corruption("Learned index too short");
+  }
+  const char* p = contents.data();
+  num_blocks_ = DecodeFixed32(p);
+  key_width_ = DecodeFixed32(p + 4);
+  num_segments_ = DecodeFixed32(p + 8);
+  max_error_ = DecodeFixed32(p + 12);
+  first_offset_ = DecodeFixed64(p + 16);
+  if (num_blocks_ > 0 &&
+      (key_width_ == 0 || key_width_ > sizeof(uint64_t) ||
+       num_segments_ == 0 || num_segments_ > num_blocks_)) {
+    return Status::Corruption("Bad learned index header");
+  }
+  const uint64_t expected_size =
+      kHeaderSize + uint64_t{num_segments_} * kSegmentSize +
+      uint64_t{num_blocks_} * (sizeof(uint32_t) + key_width_);
+  if (contents.size() != expected_size) {
+    return Status::Corruption("Learned index size mismatch");
+  }
+  segments_ = p + kHeaderSize;
+  ends_ = segments_ + static_cast<size_t>(num_segments_) * kSegmentSize;
+  keys_ = ends_ + static_cast<size_t>(num_blocks_) * sizeof(uint32_t);
+  return Status::OK();
+}
+
+BlockHandle LearnedIndex::handle(uint32_t i) const {
+  assert(i < num_blocks_);
+  const uint64_t begin =
+      i == 0 ? 0 : DecodeFixed32(ends_ + (i - 1) * sizeof(uint32_t));
+  const uint64_t end = DecodeFixed32(ends_ + i * sizeof(uint32_t));
+  return BlockHandle(first_offset_ + begin,
+                     end - begin - BlockBasedTable::kBlockTrailerSize);
+}
+
+uint32_t LearnedIndex::PredictPosition(uint64_t key_value) const {
+  // Find the last segment starting at or before the key
+  uint32_t lo = 0;
+  uint32_t hi = num_segments_;
+  while (hi - lo > 1) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (DecodeFixed64(segments_ + mid * kSegmentSize) <= key_value) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  const char* segment = segments_ + lo * kSegmentSize;
+  const uint64_t first_key_value = DecodeFixed64(segment);
+  const uint64_t slope_bits = DecodeFixed64(segment + sizeof(uint64_t));
+  double slope;
+  memcpy(&slope, &slope_bits, sizeof(slope));
+  const uint32_t first_block = DecodeFixed32(segment + 2 * sizeof(uint64_t));
+  // Keys between two segments are in the first block of the next segment
+  const uint32_t limit =
+      lo + 1 < num_segments_
+          ? DecodeFixed32(segment + kSegmentSize + 2 * sizeof(uint64_t))
+          : num_blocks_ - 1;
+
+  double position = first_block;
+  if (key_value > first_key_value) {
+    position += slope * static_cast<double>(key_value - first_key_value);
+  }
+  // Also catches NaN
+  if (!(position < limit)) {
+    return limit;
+  }
+  return static_cast<uint32_t>(position);
+}
+
+uint32_t LearnedIndex::Seek(const Slice& user_key) const {
+  if (num_blocks_ == 0) {
+    return 0;
+  }
+  const uint32_t predicted =
+      std::min(PredictPosition(GetLearnedIndexKeyValue(user_key, key_width_)),
+               num_blocks_ - 1);
+  // The error is bounded for the keys of the model, so a key between two of
+  // them is at most one more block away.
+  uint32_t begin = predicted > max_error_ ? predicted - max_error_ : 0;
+  uint32_t end = static_cast<uint32_t>(
+      std::min(uint64_t{num_blocks_}, uint64_t{predicted} + max_error_ + 2));
+  // Make sure the window brackets the result even if the model is off, e.g.
+  // for a key longer than the key width.
+  if (begin > 0 && key(begin - 1).compare(user_key) >= 0) {
+    begin = 0;
+  }
+  if (end < num_blocks_ && key(end - 1).compare(user_key) < 0) {
+    end = num_blocks_;
+  }
+  while (begin < end) {
+    uint32_t mid = begin + (end - begin) / 2;
+    if (key(mid).compare(user_key) < 0) {
+      begin = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  return begin;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,145 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "rocksdb/comparator.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "table/format.h"
+
+namespace ROCKSDB_NAMESPACE {
+// A learned index (BlockBasedTableOptions::kLearnedSearch) locates the data
+// block for a user key with a piecewise-linear model of the position of a
+// data block as a function of its last user key, read as a big-endian number.
+// The model predicts the position within `max_error` blocks, so a lookup only
+// binary searches a small window of the (fixed-width) keys, which are laid out
+// contiguously. Block handles are not stored either: data blocks are
+// contiguous in the file, so one end offset per block is enough.
+//
+// The index block is a regular block with a single entry. Its key is empty and
+// its value is as follows:
+//
+// LEARNED_INDEX: [HEADER SEGMENT ... SEGMENT END ... END KEY ... KEY]
+//
+// HEADER:  fixed32 number of data blocks, fixed32 key width,
+//          fixed32 number of segments, fixed32 max_error and fixed64 offset of
+//          the first data block
+// SEGMENT: fixed64 value of the first key of the segment, fixed64 slope (bits
+//          of a double) and fixed32 position of its first data block
+// END:     fixed32 end offset of each data block including its trailer,
+//          relative to the offset of the first data block
+// KEY:     the last user key of each data block, `key width` bytes each
+//
+// Only tables whose user keys compare bytewise, without timestamps, can use a
+// learned index. Tables with data blocks whose last user keys differ in width
+// or are wider than 8 bytes, with user keys spanning data blocks or with gaps
+// between data blocks fall back to a binary search index.
+
+// Maximum distance between the predicted and the actual position of a data
+// block.
+const uint32_t kLearnedIndexMaxError = 8;
+
+// Whether keys of `ucmp` are ordered like their learned index key values
+inline bool SupportsLearnedIndex(const Comparator* ucmp) {
+  return ucmp->timestamp_size() == 0 &&
+         strcmp(ucmp->Name(), BytewiseComparator()->Name()) == 0;
+}
+
+// Returns the first `key_width` bytes of `user_key`, zero-padded, read as a
+// big-endian number.
+inline uint64_t GetLearnedIndexKeyValue(const Slice& user_key,
+                                        uint32_t key_width) {
+  uint64_t value = 0;
+  for (uint32_t i = 0; i < key_width; ++i) {
+    value <<= 8;
+    if (i < user_key.size()) {
+      value |= static_cast<unsigned char>(user_key[i]);
+    }
+  }
+  return value;
+}
+
+class LearnedIndexBlockBuilder {
+ public:
+  explicit LearnedIndexBlockBuilder(uint32_t max_error = kLearnedIndexMaxError)
+      : max_error_(max_error) {}
+
+  // Adds the data block at `handle` ending in `last_user_key`. Returns false,
+  // and adds nothing, if the block cannot be indexed, i.e. if its key is not
+  // of the width of the previous keys or not greater than them, or if the
+  // block does not directly follow the previous one.
+  bool Add(const Slice& last_user_key, const BlockHandle& handle);
+
+  // Returns the serialized index, which is valid until the builder is
+  // destroyed or Reset().
+  Slice Finish();
+
+  // Releases the memory of the builder.
+  void Reset();
+
+  size_t NumBlocks() const { return key_values_.size(); }
+
+ private:
+  struct Segment {
+    uint64_t first_key_value;
+    double slope;
+    uint32_t first_block;
+  };
+
+  // Greedily fits the longest segments predicting the position of each key
+  // within max_error_, by narrowing the range of feasible slopes.
+  void BuildSegments(std::vector<Segment>* segments) const;
+
+  const uint32_t max_error_;
+  uint32_t key_width_ = 0;
+  uint64_t first_offset_ = 0;
+  uint64_t next_offset_ = 0;
+  std::vector<uint64_t> key_values_;
+  std::string ends_;
+  std::string keys_;
+  std::string buffer_;
+};
+
+// A view of a learned index, referencing the serialized index.
+class LearnedIndex {
+ public:
+  Status Init(const Slice& contents);
+
+  uint32_t num_blocks() const { return num_blocks_; }
+
+  // The last user key of the `i`-th data block
+  Slice key(uint32_t i) const {
+    return Slice(keys_ + static_cast<size_t>(i) * key_width_, key_width_);
+  }
+
+  BlockHandle handle(uint32_t i) const;
+
+  // Returns the position of the first data block whose last user key is not
+  // less than `user_key`, or num_blocks() if there is none.
+  uint32_t Seek(const Slice& user_key) const;
+
+ private:
+  static const size_t kHeaderSize = 4 * sizeof(uint32_t) + sizeof(uint64_t);
+  static const size_t kSegmentSize = 2 * sizeof(uint64_t) + sizeof(uint32_t);
+
+  uint32_t PredictPosition(uint64_t key_value) const;
+
+  uint32_t num_blocks_ = 0;
+  uint32_t key_width_ = 0;
+  uint32_t num_segments_ = 0;
+  uint32_t max_error_ = 0;
+  uint64_t first_offset_ = 0;
+  const char* segments_ = nullptr;
+  const char* ends_ = nullptr;
+  const char* keys_ = nullptr;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,157 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#include "table/block_based/learned_index_reader.h"
+
+#include "table/block_based/learned_index.h"
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+// Iterates over the data blocks of a learned index. Keys are the last user
+// keys of the data blocks, without sequence numbers.
+class LearnedIndexIterator : public InternalIteratorBase<IndexValue> {
+ public:
+  explicit LearnedIndexIterator(const LearnedIndex& index)
+      : index_(index), current_(index.num_blocks()) {}
+
+  bool Valid() const override { return current_ < index_.num_blocks(); }
+
+  void SeekToFirst() override { current_ = 0; }
+
+  void SeekToLast() override {
+    current_ = index_.num_blocks() > 0 ? index_.num_blocks() - 1 : 0;
+  }
+
+  void Seek(const Slice& target) override {
+    current_ = index_.Seek(ExtractUserKey(target));
+  }
+
+  void SeekForPrev(const Slice&) override {
+    assert(false);
+    current_ = index_.num_blocks();
+    status_ = Status::InvalidArgument(
+        "RocksDB internal error: should never call SeekForPrev() on index "
+        "blocks");
+  }
+
+  void Next() override {
+    assert(Valid());
+    ++current_;
+  }
+
+  void Prev() override {
+    assert(Valid());
+    current_ = current_ > 0 ? current_ - 1 : index_.num_blocks();
+  }
+
+  Slice key() const override {
+    assert(Valid());
+    return index_.key(current_);
+  }
+
+  Slice user_key() const override { return key(); }
+
+  IndexValue value() const override {
+    assert(Valid());
+    return IndexValue(index_.handle(current_), Slice());
+  }
+
+  Status status() const override { return status_; }
+
+ private:
+  const LearnedIndex index_;
+  uint32_t current_;
+  Status status_;
+};
+
+// Parses the single entry of a learned index block
+Status GetLearnedIndexContents(const Block* block, Slice* contents) {
+  if (block->size() < 2 * sizeof(uint32_t)) {
+    return Status::Corruption("Bad learned index block");
+  }
+  const uint64_t restarts_size =
+      (uint64_t{block->NumRestarts()} + 1) * sizeof(uint32_t);
+  if (restarts_size > block->size()) {
+    return Status::Corruption("Bad learned index block");
+  }
+  const char* p = block->data();
+  const char* limit = p + (block->size() - restarts_size);
+  uint32_t shared = 0;
+  uint32_t non_shared = 0;
+  uint32_t value_length = 0;
+  if ((p = GetVarint32Ptr(p, limit, &shared)) == nullptr ||
+      (p = GetVarint32Ptr(p, limit, &non_shared)) == nullptr ||
+      (p = GetVarint32Ptr(p, limit, &value_length)) == nullptr ||
+      shared != 0 ||
+      static_cast<uint64_t>(limit - p) <
+          uint64_t{non_shared} + value_length) {
+    return Status::Corruption("Bad learned index block entry");
+  }
+  *contents = Slice(p + non_shared, value_length);
+  return Status::OK();
+}
+}  // namespace
+
+Status LearnedIndexReader::Create(const BlockBasedTable* table,
+                                  const ReadOptions& ro,
+                                  FilePrefetchBuffer* prefetch_buffer,
+                                  bool use_cache, bool prefetch, bool pin,
+                                  BlockCacheLookupContext* lookup_context,
+                                  std::unique_ptr<IndexReader>* index_reader) {
+  assert(table != nullptr);
+  assert(table->get_rep());
+  assert(!pin || prefetch);
+  assert(index_reader != nullptr);
+
+  CachableEntry<Block> index_block;
+  if (prefetch || !use_cache) {
+    const Status s =
+        ReadIndexBlock(table, prefetch_buffer, ro, use_cache,
+                       /*get_context=*/nullptr, lookup_context, &index_block);
+    if (!s.ok()) {
+      return s;
+    }
+
+    if (use_cache && !pin) {
+      index_block.Reset();
+    }
+  }
+
+  index_reader->reset(new LearnedIndexReader(table, std::move(index_block)));
+
+  return Status::OK();
+}
+
+InternalIteratorBase<IndexValue>* LearnedIndexReader::NewIterator(
+    const ReadOptions& read_options, bool /* disable_prefix_seek */,
+    IndexBlockIter* iter, GetContext* get_context,
+    BlockCacheLookupContext* lookup_context) {
+  const bool no_io = (read_options.read_tier == kBlockCacheTier);
+  CachableEntry<Block> index_block;
+  Status s = GetOrReadIndexBlock(no_io, read_options.rate_limiter_priority,
+                                 get_context, lookup_context, &index_block);
+  Slice contents;
+  LearnedIndex index;
+  if (s.ok()) {
+    s = GetLearnedIndexContents(index_block.GetValue(), &contents);
+  }
+  if (s.ok()) {
+    s = index.Init(contents);
+  }
+  if (!s.ok()) {
+    if (iter != nullptr) {
+      iter->Invalidate(s);
+      return iter;
+    }
+
+    return NewErrorInternalIterator<IndexValue>(s);
+  }
+
+  auto it = new LearnedIndexIterator(index);
+  index_block.TransferTo(it);
+
+  return it;
+}
+}  // namespace ROCKSDB_NAMESPACE
@@ -265,25 +265,36 @@ BlockHandle PartitionedFilterBlockReader::GetFilterPartitionHandle(
     const CachableEntry<Block_kFilterPartitionIndex>& filter_block,
     const Slice& entry) const {
   IndexBlockIter iter;
+  NewFilterPartitionIndexIterator(filter_block, &iter);
+  return SeekFilterPartition(&iter, entry);
+}
+
+void PartitionedFilterBlockReader::NewFilterPartitionIndexIterator(
+    const CachableEntry<Block_kFilterPartitionIndex>& filter_block,
+    IndexBlockIter* iter) const {
   const InternalKeyComparator* const comparator = internal_comparator();
   Statistics* kNullStats = nullptr;
   filter_block.GetValue()->NewIndexIterator(
       comparator->user_comparator(),
       table()->get_rep()->get_global_seqno(BlockType::kFilterPartitionIndex),
-      &iter, kNullStats, true /* total_order_seek */,
+      iter, kNullStats, true /* total_order_seek */,
       false /* have_first_key */, index_key_includes_seq(),
       index_value_is_full());
-  iter.Seek(entry);
-  if (UNLIKELY(!iter.Valid())) {
+}
+
+BlockHandle PartitionedFilterBlockReader::SeekFilterPartition(
+    IndexBlockIter* iter, const Slice& entry) {
+  iter->Seek(entry);
+  if (UNLIKELY(!iter->Valid())) {
     // entry is larger than all the keys. However its prefix might still be
     // present in the last partition. If this is called by PrefixMayMatch this
     // is necessary for correct behavior. Otherwise it is unnecessary but safe.
     // Assuming this is an unlikely case for full key search, the performance
     // overhead should be negligible.
-    iter.SeekToLast();
+    iter->SeekToLast();
   }
-  assert(iter.Valid());
-  BlockHandle fltr_blk_handle = iter.value().handle;
+  assert(iter->Valid());
+  BlockHandle fltr_blk_handle = iter->value().handle;
   return fltr_blk_handle;
 }
 
@@ -381,14 +392,26 @@ void PartitionedFilterBlockReader::MayMatch(
 
   auto start_iter_same_handle = range->begin();
   BlockHandle prev_filter_handle = BlockHandle::NullBlockHandle();
+  IndexBlockIter index_iter;
+  NewFilterPartitionIndexIterator(filter_block, &index_iter);
 
   // For all keys mapping to same partition (must be adjacent in sorted order)
   // share block cache lookup and use full filter multiget on the partition
   // filter.
   for (auto iter = start_iter_same_handle; iter != range->end(); ++iter) {
-    // TODO: re-use one top-level index iterator
-    BlockHandle this_filter_handle =
-        GetFilterPartitionHandle(filter_block, iter->ikey);
+    // Keys are sorted, so a key not past the last key of the partition of
+    // the previous key is in that partition too, without another search of
+    // the partition index
+    BlockHandle this_filter_handle;
+    if (!prev_filter_handle.IsNull() &&
+        (index_key_includes_seq()
+             ? internal_comparator()->Compare(index_iter.key(), iter->ikey)
+             : internal_comparator()->user_comparator()->Compare(
+                   index_iter.key(), ExtractUserKey(iter->ikey))) >= 0) {
+      this_filter_handle = prev_filter_handle;
+    } else {
+      this_filter_handle = SeekFilterPartition(&index_iter, iter->ikey);
+    }
     if (!prev_filter_handle.IsNull() &&
         this_filter_handle != prev_filter_handle) {
       MultiGetRange subrange(*range, start_iter_same_handle, iter);
@@ -137,6 +137,13 @@ class PartitionedFilterBlockReader
   BlockHandle GetFilterPartitionHandle(
       const CachableEntry<Block_kFilterPartitionIndex>& filter_block,
       const Slice& entry) const;
+  void NewFilterPartitionIndexIterator(
+      const CachableEntry<Block_kFilterPartitionIndex>& filter_block,
+      IndexBlockIter* iter) const;
+  // Positions `iter` at the filter partition for `entry` and returns its
+  // handle
+  static BlockHandle SeekFilterPartition(IndexBlockIter* iter,
+                                         const Slice& entry);
   Status GetFilterPartitionBlock(
       FilePrefetchBuffer* prefetch_buffer, const BlockHandle& handle,
       bool no_io, GetContext* get_context,
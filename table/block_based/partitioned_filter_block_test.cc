@@ -204,6 +204,33 @@ class PartitionedFilterBlockTest
                                          rate_limiter_priority));
       }
     }
+    // querying all keys at once, in sorted order like MultiGet
+    {
+      std::vector<Slice> batch(std::begin(keys), std::end(keys));
+      batch.insert(batch.end(), std::begin(missing_keys),
+                   std::end(missing_keys));
+      autovector<KeyContext, MultiGetContext::MAX_BATCH_SIZE> key_context;
+      autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE> sorted_keys;
+      for (const Slice& key : batch) {
+        key_context.emplace_back(nullptr, key, nullptr, nullptr, nullptr);
+      }
+      for (auto& key_ctx : key_context) {
+        sorted_keys.emplace_back(&key_ctx);
+      }
+      MultiGetContext ctx(&sorted_keys, 0, sorted_keys.size(), 0,
+                          ReadOptions(), nullptr, nullptr);
+      MultiGetContext::Range range = ctx.GetMultiGetRange();
+      reader->KeysMayMatch(&range, !no_io, /*lookup_context=*/nullptr,
+                           rate_limiter_priority);
+      std::vector<bool> may_match(batch.size());
+      for (auto iter = range.begin(); iter != range.end(); ++iter) {
+        may_match[iter.index()] = true;
+      }
+      const size_t num_keys = sizeof(keys) / sizeof(*keys);
+      for (size_t i = 0; i < batch.size(); ++i) {
+        ASSERT_EQ(i < num_keys || empty, may_match[i]) << batch[i].ToString();
+      }
+    }
   }
 
   int TestBlockPerKey() {
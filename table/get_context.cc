@@ -5,6 +5,7 @@
 
 #include "table/get_context.h"
 
+#include "cache/cache_helpers.h"
 #include "db/blob//blob_fetcher.h"
 #include "db/merge_helper.h"
 #include "db/pinned_iterators_manager.h"
@@ -571,6 +572,16 @@ bool GetContext::GetBlobValue(const Slice& blob_index,
   return true;
 }
 
+bool GetContext::PinTableReader(Cleanable* pinner) {
+  assert(pinner);
+  if (table_handle_ == nullptr || !table_cache_->Ref(table_handle_)) {
+    return false;
+  }
+  pinner->RegisterCleanup(&ReleaseCacheHandleCleanup, table_cache_,
+                          table_handle_);
+  return true;
+}
+
 void GetContext::push_operand(const Slice& value, Cleanable* value_pinner) {
   // TODO(yanqin) preserve timestamps information in merge_context
   if (pinned_iters_mgr() && pinned_iters_mgr()->PinningEnabled() &&
@@ -7,6 +7,7 @@
 #include <string>
 
 #include "db/read_callback.h"
+#include "rocksdb/cache.h"
 #include "rocksdb/types.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -161,6 +162,19 @@ class GetContext {
   // another GetContext with replayGetContextLog.
   void SetReplayLog(std::string* replay_log) { replay_log_ = replay_log; }
 
+  // Sets the table cache entry of the table being read, so that values
+  // pointing into memory owned by its table reader, e.g. a memory-mapped
+  // file, can be pinned with PinTableReader(). Pass nullptrs to unset.
+  void SetTableCacheHandle(Cache* table_cache, Cache::Handle* table_handle) {
+    table_cache_ = table_cache;
+    table_handle_ = table_handle;
+  }
+
+  // Makes `pinner` hold a reference to the table cache entry set with
+  // SetTableCacheHandle() until its cleanups run. Returns false if no entry
+  // is set.
+  bool PinTableReader(Cleanable* pinner);
+
   // Do we need to fetch the SequenceNumber for this key?
   bool NeedToReadSequence() const { return (seq_ != nullptr); }
 
@@ -219,6 +233,9 @@ class GetContext {
   // Get or a MultiGet.
   const uint64_t tracing_get_id_;
   BlobFetcher* blob_fetcher_;
+  // Table cache entry of the table being read, if values may be pinned to it
+  Cache* table_cache_ = nullptr;
+  Cache::Handle* table_handle_ = nullptr;
 };
 
 // Call this to replay a log and bring the get_context up to date. The replay
@@ -193,6 +193,15 @@ static int RegisterBuiltinMemTableRepFactory(ObjectLibrary& library,
         }
         return guard->get();
       });
+  library.AddFactory<MemTableRepFactory>(
+      ObjectLibrary::PatternEntry(AdaptiveRepFactory::kClassName(), true)
+          .AnotherName(AdaptiveRepFactory::kNickName()),
+      [](const std::string& /*uri*/,
+         std::unique_ptr<MemTableRepFactory>* guard,
+         std::string* /*errmsg*/) {
+        guard->reset(new AdaptiveRepFactory());
+        return guard->get();
+      });
   library.AddFactory<MemTableRepFactory>(
       AsPattern("HashLinkListRepFactory", "hash_linkedlist"),
       [](const std::string& uri, std::unique_ptr<MemTableRepFactory>* guard,
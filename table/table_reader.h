@@ -23,6 +23,8 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+class AsyncReadBatch;
+class BlockHandle;
 class Iterator;
 struct ParsedInternalKey;
 class Slice;
@@ -138,6 +140,19 @@ class TableReader {
     return Status::NotSupported();
   }
 
+  // Submits reads of the blocks that a MultiGet() of `mget_range` would read
+  // from the file to `read_batch`, so that the blocks are cached by the time
+  // read_batch->Wait() returns and the MultiGet() does no IO. Lets callers
+  // overlap the reads of several files without coroutines. Returns
+  // NotSupported() if the table cannot cache blocks this way.
+  virtual Status MultiGetPrefetchBlocks(
+      const ReadOptions& /*readOptions*/,
+      const MultiGetContext::Range* /*mget_range*/,
+      const SliceTransform* /*prefix_extractor*/,
+      AsyncReadBatch* /*read_batch*/) {
+    return Status::NotSupported();
+  }
+
   virtual void MultiGet(const ReadOptions& readOptions,
                         const MultiGetContext::Range* mget_range,
                         const SliceTransform* prefix_extractor,
@@ -179,6 +194,17 @@ class TableReader {
                                 TableReaderCaller /*caller*/) {
     return Status::NotSupported("VerifyChecksum() not supported");
   }
+
+  // Reads the data blocks at `handles`, sorted by offset, into the block
+  // cache, skipping those already cached. Sets `*loaded_blocks` and
+  // `*loaded_bytes` to the number and size of the blocks read. Returns
+  // NotSupported() if the table cannot cache blocks this way.
+  virtual Status WarmUpBlocks(const ReadOptions& /*read_options*/,
+                              const std::vector<BlockHandle>& /*handles*/,
+                              uint64_t* /*loaded_blocks*/,
+                              uint64_t* /*loaded_bytes*/) {
+    return Status::NotSupported("WarmUpBlocks() not supported");
+  }
 };
 
 }  // namespace ROCKSDB_NAMESPACE
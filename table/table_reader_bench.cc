@@ -276,6 +276,12 @@ DEFINE_bool(mmap_read, true, "Whether use mmap read");
 DEFINE_string(table_factory, "block_based",
               "Table factory to use: `block_based` (default), `plain_table` or "
               "`cuckoo_hash`.");
+DEFINE_int32(block_restart_interval, 16,
+             "Block restart interval of `block_based` tables");
+DEFINE_bool(restart_key_prefixes, false,
+            "Whether `block_based` tables store restart key prefixes in data "
+            "blocks, see BlockBasedTableOptions::"
+            "data_block_restart_key_prefixes");
 DEFINE_string(time_unit, "microsecond",
               "The time unit used for measuring performance. User can specify "
               "`microsecond` (default) or `nanosecond`");
@@ -325,7 +331,10 @@ int main(int argc, char** argv) {
     exit(1);
 #endif  // ROCKSDB_LITE
   } else if (FLAGS_table_factory == "block_based") {
-    tf.reset(new ROCKSDB_NAMESPACE::BlockBasedTableFactory());
+    ROCKSDB_NAMESPACE::BlockBasedTableOptions table_options;
+    table_options.block_restart_interval = FLAGS_block_restart_interval;
+    table_options.data_block_restart_key_prefixes = FLAGS_restart_key_prefixes;
+    tf.reset(new ROCKSDB_NAMESPACE::BlockBasedTableFactory(table_options));
   } else {
     fprintf(stderr, "Invalid table type %s\n", FLAGS_table_factory.c_str());
   }
@@ -2613,6 +2613,12 @@ TEST_P(BlockBasedTableTest, PartitionIndexTest) {
   }
 }
 
+TEST_P(BlockBasedTableTest, LearnedIndexTest) {
+  BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+  table_options.index_type = BlockBasedTableOptions::kLearnedSearch;
+  IndexTest(table_options);
+}
+
 TEST_P(BlockBasedTableTest, IndexSeekOptimizationIncomplete) {
   std::unique_ptr<InternalKeyComparator> comparator(
       new InternalKeyComparator(BytewiseComparator()));
@@ -2946,6 +2952,106 @@ TEST_P(BlockBasedTableTest, BinaryIndexWithFirstKeyGlobalSeqno) {
   c.ResetTableReader();
 }
 
+TEST_P(BlockBasedTableTest, LearnedIndex) {
+  // Big-endian integers with growing gaps, which take the model several
+  // segments. Keys wider than 8 bytes get a binary search index instead.
+  auto user_key = [](uint64_t value, size_t width) {
+    std::string key;
+    for (int shift = 56; shift >= 0; shift -= 8) {
+      key.push_back(static_cast<char>(value >> shift));
+    }
+    key.resize(width, 'x');
+    return key;
+  };
+  const uint64_t kNumKeys = 5000;
+
+  for (size_t width : {size_t{8}, size_t{9}}) {
+    uint64_t binary_search_index_size = 0;
+    for (auto index_type : {BlockBasedTableOptions::kBinarySearch,
+                            BlockBasedTableOptions::kLearnedSearch}) {
+      SCOPED_TRACE("width = " + std::to_string(width) +
+                   ", index_type = " + std::to_string(index_type));
+      BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+      table_options.index_type = index_type;
+      table_options.block_size = 256;
+      Options options;
+      options.compression = kNoCompression;
+      options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+      const ImmutableOptions ioptions(options);
+      const MutableCFOptions moptions(options);
+
+      TableConstructor c(BytewiseComparator(),
+                         true /* convert_to_internal_key_ */);
+      for (uint64_t i = 0; i < kNumKeys; ++i) {
+        c.Add(user_key(3 * i * i + 1, width), "value");
+      }
+      std::vector<std::string> keys;
+      stl_wrappers::KVMap kvmap;
+      c.Finish(options, ioptions, moptions, table_options,
+               GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+      auto reader = c.GetTableReader();
+      auto props = reader->GetTableProperties();
+      ASSERT_GT(props->num_data_blocks, 100u);
+      auto pos = props->user_collected_properties.find(
+          BlockBasedTablePropertyNames::kIndexType);
+      ASSERT_NE(pos, props->user_collected_properties.end());
+      const auto expected_index_type =
+          width <= 8 ? index_type : BlockBasedTableOptions::kBinarySearch;
+      ASSERT_EQ(static_cast<uint32_t>(expected_index_type),
+                DecodeFixed32(pos->second.data()));
+      if (index_type == BlockBasedTableOptions::kBinarySearch) {
+        binary_search_index_size = props->index_size;
+      } else if (width <= 8) {
+        ASSERT_LT(props->index_size, binary_search_index_size);
+      } else {
+        ASSERT_EQ(props->index_size, binary_search_index_size);
+      }
+
+      std::unique_ptr<InternalIterator> iter(c.NewIterator(nullptr));
+      for (uint64_t i = 0; i < kNumKeys; ++i) {
+        const std::string key = user_key(3 * i * i + 1, width);
+        iter->Seek(key);
+        ASSERT_OK(iter->status());
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(key, iter->key().ToString());
+
+        // Between the previous key and this one
+        iter->Seek(user_key(3 * i * i, 8));
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(key, iter->key().ToString());
+
+        // Just after this key
+        iter->Seek(key + '\0');
+        if (i + 1 < kNumKeys) {
+          ASSERT_TRUE(iter->Valid());
+          ASSERT_EQ(user_key(3 * (i + 1) * (i + 1) + 1, width),
+                    iter->key().ToString());
+        } else {
+          ASSERT_FALSE(iter->Valid());
+        }
+      }
+      iter->Seek(user_key(3 * kNumKeys * kNumKeys + 1, width));
+      ASSERT_OK(iter->status());
+      ASSERT_FALSE(iter->Valid());
+
+      uint64_t count = 0;
+      for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        ++count;
+      }
+      ASSERT_EQ(kNumKeys, count);
+      count = 0;
+      for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+        ++count;
+      }
+      ASSERT_OK(iter->status());
+      ASSERT_EQ(kNumKeys, count);
+
+      iter.reset();
+      c.ResetTableReader();
+    }
+  }
+}
+
 // It's very hard to figure out the index block size of a block accurately.
 // To make sure we get the index size, we just make sure as key number
 // grows, the filter block size also grows.
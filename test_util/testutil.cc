@@ -293,12 +293,14 @@ void RandomInitDBOptions(DBOptions* db_opt, Random* rnd) {
   db_opt->recycle_log_file_num = rnd->Uniform(2);
   db_opt->avoid_flush_during_recovery = rnd->Uniform(2);
   db_opt->avoid_flush_during_shutdown = rnd->Uniform(2);
+  db_opt->warm_block_cache_on_open = rnd->Uniform(2);
   db_opt->enforce_single_del_contracts = rnd->Uniform(2);
 
   // int options
   db_opt->max_background_compactions = rnd->Uniform(100);
   db_opt->max_background_flushes = rnd->Uniform(100);
   db_opt->max_file_opening_threads = rnd->Uniform(100);
+  db_opt->wal_recovery_threads = rnd->Uniform(100);
   db_opt->max_open_files = rnd->Uniform(100);
   db_opt->table_cache_numshardbits = rnd->Uniform(100);
 
@@ -307,6 +309,7 @@ void RandomInitDBOptions(DBOptions* db_opt, Random* rnd) {
   db_opt->keep_log_file_num = rnd->Uniform(10000);
   db_opt->log_file_time_to_roll = rnd->Uniform(10000);
   db_opt->manifest_preallocation_size = rnd->Uniform(10000);
+  db_opt->max_hot_blocks = rnd->Uniform(10000);
   db_opt->max_log_file_size = rnd->Uniform(10000);
 
   // std::string options
@@ -322,6 +325,7 @@ void RandomInitDBOptions(DBOptions* db_opt, Random* rnd) {
   db_opt->WAL_ttl_seconds = uint_max + rnd->Uniform(100000);
   db_opt->bytes_per_sync = uint_max + rnd->Uniform(100000);
   db_opt->delayed_write_rate = uint_max + rnd->Uniform(100000);
+  db_opt->block_cache_warmup_bytes_per_sec = uint_max + rnd->Uniform(100000);
   db_opt->delete_obsolete_files_period_micros = uint_max + rnd->Uniform(100000);
   db_opt->max_manifest_file_size = uint_max + rnd->Uniform(100000);
   db_opt->max_total_wal_size = uint_max + rnd->Uniform(100000);
@@ -580,6 +580,10 @@ DEFINE_double(cache_low_pri_pool_ratio, 0.0,
 
 DEFINE_string(cache_type, "lru_cache", "Type of block cache.");
 
+DEFINE_bool(cache_frequency_admission, false,
+            "Only admit an entry into a full lru_cache or hyper_clock_cache "
+            "if it was accessed more often than the entry it would evict.");
+
 DEFINE_bool(use_compressed_secondary_cache, false,
             "Use the CompressedSecondaryCache as the secondary cache.");
 
@@ -615,6 +619,16 @@ DEFINE_uint32(
     "compress_format_version == 2 -- decompressed size is included"
     " in the block header in varint32 format.");
 
+DEFINE_int32(compressed_secondary_cache_compression_level,
+             ROCKSDB_NAMESPACE::CompressedSecondaryCacheOptions()
+                 .compression_level,
+             "Compression level of CompressedSecondaryCache. Negative levels "
+             "select the fast modes of LZ4 and ZSTD.");
+
+DEFINE_uint32(compressed_secondary_cache_max_dict_bytes, 0,
+              "If positive, CompressedSecondaryCache compresses blocks with a "
+              "dictionary of up to this many bytes per block kind.");
+
 DEFINE_int64(simcache_size, -1,
              "Number of bytes to use as a simcache of "
              "uncompressed data. Nagative value disables simcache.");
@@ -635,6 +649,10 @@ DEFINE_bool(partition_index, false, "Partition index blocks");
 
 DEFINE_bool(index_with_first_key, false, "Include first key in the index");
 
+DEFINE_bool(learned_index, false,
+            "Use a learned index (kLearnedSearch). Tables only get one "
+            "with --key_size of at most 8.");
+
 DEFINE_bool(
     optimize_filters_for_memory,
     ROCKSDB_NAMESPACE::BlockBasedTableOptions().optimize_filters_for_memory,
@@ -709,6 +727,16 @@ DEFINE_double(data_block_hash_table_util_ratio, 0.75,
               "This is only valid if use_data_block_hash_index is "
               "set to true");
 
+DEFINE_bool(data_block_restart_key_prefixes, false,
+            "if true, data blocks store the prefixes of their restart keys "
+            "to speed up seeks within blocks. This is valid if only we use "
+            "BlockTable");
+
+DEFINE_bool(cache_expanded_data_blocks, false,
+            "if true, data blocks are expanded into arrays of whole keys "
+            "when read into the block cache, so that cache hits do not decode "
+            "them. This is valid if only we use BlockTable");
+
 DEFINE_int64(compressed_cache_size, -1,
              "Number of bytes to use as a cache of compressed data.");
 
@@ -716,6 +744,26 @@ DEFINE_int64(row_cache_size, 0,
              "Number of bytes to use as a cache of individual rows"
              " (0 = disabled).");
 
+DEFINE_int64(hot_key_cache_size, 0,
+             "Number of bytes to use as a cache of Get() results by key that"
+             " survives flushes and compactions (0 = disabled). Uses"
+             " --cache_frequency_admission.");
+
+DEFINE_uint64(hot_block_persist_period_sec,
+              ROCKSDB_NAMESPACE::Options().hot_block_persist_period_sec,
+              "If non-zero, write the most read data blocks to the HOT_BLOCKS"
+              " file of the DB this often, and when closing it");
+
+DEFINE_bool(warm_block_cache_on_open,
+            ROCKSDB_NAMESPACE::Options().warm_block_cache_on_open,
+            "Load the blocks listed in the HOT_BLOCKS file into the block"
+            " cache in the background after opening the DB");
+
+DEFINE_uint64(block_cache_warmup_bytes_per_sec,
+              ROCKSDB_NAMESPACE::Options().block_cache_warmup_bytes_per_sec,
+              "Rate limit of the reads of the block cache warm-up"
+              " (0 = unlimited)");
+
 DEFINE_int32(open_files, ROCKSDB_NAMESPACE::Options().max_open_files,
              "Maximum number of files to keep open at the same time"
              " (use default if == 0)");
@@ -729,6 +777,11 @@ DEFINE_int32(compaction_readahead_size, 0, "Compaction readahead size");
 
 DEFINE_int32(log_readahead_size, 0, "WAL and manifest readahead size");
 
+DEFINE_int32(wal_recovery_threads,
+             ROCKSDB_NAMESPACE::Options().wal_recovery_threads,
+             "Number of threads reading and decoding WAL files ahead of "
+             "memtable insertion during DB::Open()");
+
 DEFINE_int32(random_access_max_buffer_size, 1024 * 1024,
              "Maximum windows randomaccess buffer size");
 
@@ -983,6 +1036,7 @@ DEFINE_string(
     "\t--statistics\n"
     "\t--row_cache_size\n"
     "\t--row_cache_numshardbits\n"
+    "\t--hot_key_cache_size\n"
     "\t--enable_io_prio\n"
     "\t--dump_malloc_stats\n"
     "\t--num_multi_db\n");
@@ -1420,6 +1474,11 @@ DEFINE_bool(
     "Enable the unordered write feature, which provides higher throughput but "
     "relaxes the guarantees around atomic reads and immutable snapshots");
 
+DEFINE_uint64(write_queue_shards,
+              ROCKSDB_NAMESPACE::Options().write_queue_shards,
+              "Number of write queues forming write groups concurrently. "
+              "Values above 1 require --enable_pipelined_write=false");
+
 DEFINE_bool(allow_concurrent_memtable_write, true,
             "Allow multi-writers to update mem tables in parallel.");
 
@@ -1564,6 +1623,10 @@ DEFINE_uint64(max_total_wal_size, 0, "Set total max WAL size");
 DEFINE_bool(mmap_read, ROCKSDB_NAMESPACE::Options().allow_mmap_reads,
             "Allow reads to occur via mmap-ing files");
 
+DEFINE_bool(pin_mmap_values, false,
+            "With --mmap_read, Get() pins values in the memory-mapped files "
+            "instead of copying them (ReadOptions::pin_mmap_values)");
+
 DEFINE_bool(mmap_write, ROCKSDB_NAMESPACE::Options().allow_mmap_writes,
             "Allow writes to occur via mmap-ing files");
 
@@ -3051,17 +3114,23 @@ class Benchmark {
     if (FLAGS_cache_type == "clock_cache") {
       fprintf(stderr, "Old clock cache implementation has been removed.\n");
       exit(1);
-    } else if (FLAGS_cache_type == "hyper_clock_cache") {
-      return HyperClockCacheOptions(static_cast<size_t>(capacity),
-                                    FLAGS_block_size /*estimated_entry_charge*/,
-                                    FLAGS_cache_numshardbits)
-          .MakeSharedCache();
+    } else if (FLAGS_cache_type == "hyper_clock_cache" ||
+               FLAGS_cache_type == "auto_hyper_clock_cache") {
+      HyperClockCacheOptions opts(
+          static_cast<size_t>(capacity),
+          FLAGS_cache_type == "hyper_clock_cache"
+              ? FLAGS_block_size /*estimated_entry_charge*/
+              : 0 /*estimated_entry_charge*/,
+          FLAGS_cache_numshardbits);
+      opts.frequency_admission = FLAGS_cache_frequency_admission;
+      return opts.MakeSharedCache();
     } else if (FLAGS_cache_type == "lru_cache") {
       LRUCacheOptions opts(
           static_cast<size_t>(capacity), FLAGS_cache_numshardbits,
           false /*strict_capacity_limit*/, FLAGS_cache_high_pri_pool_ratio,
           GetCacheAllocator(), kDefaultToAdaptiveMutex,
           kDefaultCacheMetadataChargePolicy, FLAGS_cache_low_pri_pool_ratio);
+      opts.frequency_admission = FLAGS_cache_frequency_admission;
 
 #ifndef ROCKSDB_LITE
       if (!FLAGS_secondary_cache_uri.empty()) {
@@ -3091,6 +3160,10 @@ class Benchmark {
             FLAGS_compressed_secondary_cache_compression_type_e;
         secondary_cache_opts.compress_format_version =
             FLAGS_compressed_secondary_cache_compress_format_version;
+        secondary_cache_opts.compression_level =
+            FLAGS_compressed_secondary_cache_compression_level;
+        secondary_cache_opts.max_dict_bytes =
+            FLAGS_compressed_secondary_cache_max_dict_bytes;
         opts.secondary_cache =
             NewCompressedSecondaryCache(secondary_cache_opts);
       }
@@ -3374,6 +3447,7 @@ class Benchmark {
       read_options_.adaptive_readahead = FLAGS_adaptive_readahead;
       read_options_.async_io = FLAGS_async_io;
       read_options_.optimize_multiget_for_io = FLAGS_optimize_multiget_for_io;
+      read_options_.pin_mmap_values = FLAGS_pin_mmap_values;
 
       void (Benchmark::*method)(ThreadState*) = nullptr;
       void (Benchmark::*post_process_method)() = nullptr;
@@ -4200,6 +4274,11 @@ class Benchmark {
     options.max_file_opening_threads = FLAGS_file_opening_threads;
     options.compaction_readahead_size = FLAGS_compaction_readahead_size;
     options.log_readahead_size = FLAGS_log_readahead_size;
+    options.wal_recovery_threads = FLAGS_wal_recovery_threads;
+    options.hot_block_persist_period_sec = FLAGS_hot_block_persist_period_sec;
+    options.warm_block_cache_on_open = FLAGS_warm_block_cache_on_open;
+    options.block_cache_warmup_bytes_per_sec =
+        FLAGS_block_cache_warmup_bytes_per_sec;
     options.random_access_max_buffer_size = FLAGS_random_access_max_buffer_size;
     options.writable_file_max_buffer_size = FLAGS_writable_file_max_buffer_size;
     options.use_fsync = FLAGS_use_fsync;
@@ -4303,6 +4382,8 @@ class Benchmark {
       } else if (FLAGS_index_with_first_key) {
         block_based_options.index_type =
             BlockBasedTableOptions::kBinarySearchWithFirstKey;
+      } else if (FLAGS_learned_index) {
+        block_based_options.index_type = BlockBasedTableOptions::kLearnedSearch;
       }
       BlockBasedTableOptions::IndexShorteningMode index_shortening =
           block_based_options.index_shortening;
@@ -4412,6 +4493,10 @@ class Benchmark {
       }
       block_based_options.data_block_hash_table_util_ratio =
           FLAGS_data_block_hash_table_util_ratio;
+      block_based_options.data_block_restart_key_prefixes =
+          FLAGS_data_block_restart_key_prefixes;
+      block_based_options.cache_expanded_data_blocks =
+          FLAGS_cache_expanded_data_blocks;
       if (FLAGS_read_cache_path != "") {
 #ifndef ROCKSDB_LITE
         Status rc_status;
@@ -4556,6 +4641,7 @@ class Benchmark {
         FLAGS_enable_write_thread_adaptive_yield;
     options.enable_pipelined_write = FLAGS_enable_pipelined_write;
     options.unordered_write = FLAGS_unordered_write;
+    options.write_queue_shards = static_cast<size_t>(FLAGS_write_queue_shards);
     options.write_thread_max_yield_usec = FLAGS_write_thread_max_yield_usec;
     options.write_thread_slow_yield_usec = FLAGS_write_thread_slow_yield_usec;
     options.table_cache_numshardbits = FLAGS_table_cache_numshardbits;
@@ -4712,6 +4798,16 @@ class Benchmark {
       }
     }
 
+    if (options.hot_key_cache == nullptr && FLAGS_hot_key_cache_size > 0) {
+      LRUCacheOptions hot_key_cache_opts;
+      hot_key_cache_opts.capacity = FLAGS_hot_key_cache_size;
+      if (FLAGS_cache_numshardbits >= 1) {
+        hot_key_cache_opts.num_shard_bits = FLAGS_cache_numshardbits;
+      }
+      hot_key_cache_opts.frequency_admission = FLAGS_cache_frequency_admission;
+      options.hot_key_cache = NewLRUCache(hot_key_cache_opts);
+    }
+
     if (options.env == Env::Default()) {
       options.env = FLAGS_env;
     }
@@ -17,6 +17,7 @@
 
 namespace ROCKSDB_NAMESPACE {
 class Env;
+class HotBlockCounter;
 class SystemClock;
 
 extern const uint64_t kMicrosInSecond;
@@ -228,12 +229,22 @@ class BlockCacheTracer {
   // GetId cycles from 1 to std::numeric_limits<uint64_t>::max().
   uint64_t NextGetId();
 
+  // Table readers sharing this tracer also record the reads of data blocks
+  // by users in the counter, whether tracing or not. nullptr if none.
+  void SetHotBlockCounter(HotBlockCounter* counter) {
+    hot_block_counter_.store(counter, std::memory_order_relaxed);
+  }
+  HotBlockCounter* hot_block_counter() const {
+    return hot_block_counter_.load(std::memory_order_relaxed);
+  }
+
  private:
   BlockCacheTraceOptions trace_options_;
   // A mutex protects the writer_.
   InstrumentedMutex trace_writer_mutex_;
   std::atomic<BlockCacheTraceWriter*> writer_;
   std::atomic<uint64_t> get_id_counter_;
+  std::atomic<HotBlockCounter*> hot_block_counter_{nullptr};
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -26,6 +26,7 @@ int main() {
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/mock_block_based_table.h"
+#include "table/multiget_context.h"
 #include "table/plain/plain_table_bloom.h"
 #include "util/cast_util.h"
 #include "util/gflags_compat.h"
@@ -141,6 +142,7 @@ void _always_assert_fail(int line, const char *file, const char *expr) {
 #endif
 
 using ROCKSDB_NAMESPACE::Arena;
+using ROCKSDB_NAMESPACE::autovector;
 using ROCKSDB_NAMESPACE::BlockContents;
 using ROCKSDB_NAMESPACE::BloomFilterPolicy;
 using ROCKSDB_NAMESPACE::BloomHash;
@@ -159,11 +161,15 @@ using ROCKSDB_NAMESPACE::FilterPolicy;
 using ROCKSDB_NAMESPACE::FullFilterBlockReader;
 using ROCKSDB_NAMESPACE::GetSliceHash;
 using ROCKSDB_NAMESPACE::GetSliceHash64;
+using ROCKSDB_NAMESPACE::KeyContext;
+using ROCKSDB_NAMESPACE::kMaxSequenceNumber;
 using ROCKSDB_NAMESPACE::Lower32of64;
 using ROCKSDB_NAMESPACE::LRUCacheOptions;
+using ROCKSDB_NAMESPACE::MultiGetContext;
 using ROCKSDB_NAMESPACE::ParsedFullFilterBlock;
 using ROCKSDB_NAMESPACE::PlainTableBloomV1;
 using ROCKSDB_NAMESPACE::Random32;
+using ROCKSDB_NAMESPACE::ReadOptions;
 using ROCKSDB_NAMESPACE::Slice;
 using ROCKSDB_NAMESPACE::static_cast_with_check;
 using ROCKSDB_NAMESPACE::Status;
@@ -296,6 +302,32 @@ static uint32_t DryRunHash64(Slice &s) {
   return Lower32of64(GetSliceHash64(s));
 }
 
+// Queries a batch of keys like MultiGet does, including the cost of setting
+// up the MultiGetContext
+static void FullBlockReaderKeysMayMatch(FullFilterBlockReader *reader,
+                                        uint32_t num_keys, const Slice *keys,
+                                        bool *may_match) {
+  autovector<KeyContext, MultiGetContext::MAX_BATCH_SIZE> key_context;
+  autovector<KeyContext *, MultiGetContext::MAX_BATCH_SIZE> sorted_keys;
+  for (uint32_t i = 0; i < num_keys; ++i) {
+    key_context.emplace_back(nullptr, keys[i], nullptr, nullptr, nullptr);
+  }
+  for (auto &key_ctx : key_context) {
+    sorted_keys.emplace_back(&key_ctx);
+  }
+  MultiGetContext ctx(&sorted_keys, 0, num_keys, kMaxSequenceNumber,
+                      ReadOptions(), /*fs=*/nullptr, /*stats=*/nullptr);
+  MultiGetContext::Range range = ctx.GetMultiGetRange();
+  reader->KeysMayMatch(&range, /*no_io=*/false, /*lookup_context=*/nullptr,
+                       Env::IO_TOTAL);
+  for (uint32_t i = 0; i < num_keys; ++i) {
+    may_match[i] = false;
+  }
+  for (auto iter = range.begin(); iter != range.end(); ++iter) {
+    may_match[iter.index()] = true;
+  }
+}
+
 const std::shared_ptr<const FilterPolicy> &GetPolicy() {
   static std::shared_ptr<const FilterPolicy> policy;
   if (!policy) {
@@ -354,6 +386,14 @@ void FilterBench::Go() {
     throw std::runtime_error(
         "Can't combine -use_plain_table_bloom and -use_full_block_reader");
   }
+  if (FLAGS_use_full_block_reader &&
+      FLAGS_batch_size >
+          static_cast<uint32_t>(MultiGetContext::MAX_BATCH_SIZE)) {
+    throw std::runtime_error(
+        "-batch_size must be at most " +
+        std::to_string(MultiGetContext::MAX_BATCH_SIZE) +
+        " with -use_full_block_reader");
+  }
   if (FLAGS_use_plain_table_bloom) {
     if (FLAGS_impl > 1) {
       throw std::runtime_error(
@@ -647,6 +687,7 @@ double FilterBench::RandomQueryTest(uint32_t inside_threshold, bool dry_run,
   std::unique_ptr<Slice[]> batch_slices;
   std::unique_ptr<Slice *[]> batch_slice_ptrs;
   std::unique_ptr<bool[]> batch_results;
+  std::unique_ptr<uint32_t[]> batch_hashes;
   if (mode == kBatchPrepared || mode == kBatchUnprepared) {
     batch_size = static_cast<uint32_t>(kms_.size());
   }
@@ -654,6 +695,7 @@ double FilterBench::RandomQueryTest(uint32_t inside_threshold, bool dry_run,
   batch_slices.reset(new Slice[batch_size]);
   batch_slice_ptrs.reset(new Slice *[batch_size]);
   batch_results.reset(new bool[batch_size]);
+  batch_hashes.reset(new uint32_t[batch_size]);
   for (uint32_t i = 0; i < batch_size; ++i) {
     batch_results[i] = false;
     batch_slice_ptrs[i] = &batch_slices[i];
@@ -685,10 +727,7 @@ double FilterBench::RandomQueryTest(uint32_t inside_threshold, bool dry_run,
         info.outside_queries_++;
       }
     }
-    // TODO: implement batched interface to full block reader
-    // TODO: implement batched interface to plain table bloom
-    if (mode == kBatchPrepared && !FLAGS_use_full_block_reader &&
-        !FLAGS_use_plain_table_bloom) {
+    if (mode == kBatchPrepared) {
       for (uint32_t i = 0; i < batch_size; ++i) {
         batch_results[i] = false;
       }
@@ -697,6 +736,19 @@ double FilterBench::RandomQueryTest(uint32_t inside_threshold, bool dry_run,
           batch_results[i] = true;
           dry_run_hash += dry_run_hash_fn(batch_slices[i]);
         }
+      } else if (FLAGS_use_plain_table_bloom) {
+        // Hash and prefetch all, then probe
+        for (uint32_t i = 0; i < batch_size; ++i) {
+          batch_hashes[i] = GetSliceHash(batch_slices[i]);
+          info.plain_table_bloom_->Prefetch(batch_hashes[i]);
+        }
+        for (uint32_t i = 0; i < batch_size; ++i) {
+          batch_results[i] =
+              info.plain_table_bloom_->MayContainHash(batch_hashes[i]);
+        }
+      } else if (FLAGS_use_full_block_reader) {
+        FullBlockReaderKeysMayMatch(info.full_block_reader_.get(), batch_size,
+                                    batch_slices.get(), batch_results.get());
       } else {
         info.reader_->MayMatch(batch_size, batch_slice_ptrs.get(),
                                batch_results.get());
@@ -816,7 +868,8 @@ int main(int argc, char **argv) {
         << "  \"Single filter\" - essentially minimum cost, assuming filter"
         << "\n     fits easily in L1 CPU cache." << std::endl
         << "  \"Batched, prepared\" - several queries at once against a"
-        << "\n     randomly chosen filter, using multi-query interface."
+        << "\n     randomly chosen filter, using multi-query interface"
+        << "\n     (with -use_full_block_reader, the MultiGet interface)."
         << std::endl
         << "  \"Batched, unprepared\" - similar, but using serial calls"
         << "\n     to single query interface." << std::endl
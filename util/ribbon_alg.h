@@ -7,6 +7,11 @@
 
 #include <array>
 #include <memory>
+#include <type_traits>
+
+#ifdef HAVE_AVX2
+#include <immintrin.h>
+#endif
 
 #include "rocksdb/rocksdb_namespace.h"
 #include "util/math128.h"
@@ -962,6 +967,9 @@ bool SimpleFilterQuery(const typename FilterQueryHasher::Key &key,
 //   Index GetNumSegments() const;
 //   // Load an entry from the logical array of segments
 //   CoeffRow LoadSegment(Index segment_num) const;
+//   // Pointer to the little-endian representation of an entry in the
+//   // logical array of segments, which is contiguous
+//   const char *SegmentData(Index segment_num) const;
 //   // Store an entry to the logical array of segments
 //   void StoreSegment(Index segment_num, CoeffRow data);
 // };
@@ -1081,6 +1089,84 @@ void InterleavedBackSubst(InterleavedSolutionStorage *iss,
   assert(segment_num == 0);
 }
 
+#ifdef HAVE_AVX2
+namespace avx2 {
+
+// Maximum number of solution columns supported by SolutionRow, which
+// covers all Ribbon filters (at most 8 result bits)
+constexpr uint32_t kMaxColumns = 8;
+
+// Computes the solution row for a query on an InterleavedSolutionStorage
+// with 128-bit CoeffRow (see InterleavedPhsfQuery) with AVX2, two columns
+// per 256-bit vector. Unlike the generic code, it does not branch on the
+// (essentially random) solution bits.
+template <typename InterleavedSolutionStorage>
+inline uint32_t SolutionRow(
+    typename InterleavedSolutionStorage::Index segment_num,
+    typename InterleavedSolutionStorage::Index num_columns,
+    typename InterleavedSolutionStorage::Index start_bit, Unsigned128 cr,
+    const InterleavedSolutionStorage &iss) {
+  using Index = typename InterleavedSolutionStorage::Index;
+  constexpr Index kNumPairs = kMaxColumns / 2;
+  assert(num_columns <= kMaxColumns);
+
+  auto load = [&](Index first_segment, Index column) {
+    if (column < num_columns) {
+      return _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+          iss.SegmentData(first_segment + column)));
+    }
+    return _mm_setzero_si128();
+  };
+  auto broadcast = [](Unsigned128 v) {
+    return _mm256_set_epi64x(static_cast<int64_t>(Upper64of128(v)),
+                             static_cast<int64_t>(Lower64of128(v)),
+                             static_cast<int64_t>(Upper64of128(v)),
+                             static_cast<int64_t>(Lower64of128(v)));
+  };
+
+  const __m256i cr_left = broadcast(cr << static_cast<unsigned>(start_bit));
+  const __m256i cr_right =
+      start_bit == 0 ? _mm256_setzero_si256()
+                     : broadcast(cr >> static_cast<unsigned>(128 - start_bit));
+
+  // Bits of each column to sum, folded to the lower 64 bits of its lane
+  __m256i folded[kNumPairs];
+  for (Index p = 0; p < kNumPairs; ++p) {
+    __m256i v = _mm256_and_si256(
+        _mm256_set_m128i(load(segment_num, 2 * p + 1),
+                         load(segment_num, 2 * p)),
+        cr_left);
+    if (start_bit != 0) {
+      const Index right_segment_num = segment_num + num_columns;
+      v = _mm256_xor_si256(
+          v, _mm256_and_si256(
+                 _mm256_set_m128i(load(right_segment_num, 2 * p + 1),
+                                  load(right_segment_num, 2 * p)),
+                 cr_right));
+    }
+    folded[p] = _mm256_xor_si256(v, _mm256_bsrli_epi128(v, 8));
+  }
+  // Fold all columns to 32 bits in a single vector, in column order
+  // 0 4 2 6 1 5 3 7, then to one bit each
+  __m256i x = _mm256_unpacklo_epi64(folded[0], folded[1]);
+  __m256i y = _mm256_unpacklo_epi64(folded[2], folded[3]);
+  x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 32));
+  y = _mm256_xor_si256(y, _mm256_slli_epi64(y, 32));
+  x = _mm256_blend_epi32(x, y, 0xaa);
+  x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+  x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 8));
+  x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 4));
+  x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 2));
+  x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 1));
+  x = _mm256_permutevar8x32_epi32(x,
+                                  _mm256_setr_epi32(0, 4, 2, 6, 1, 5, 3, 7));
+  return static_cast<uint32_t>(
+      _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_slli_epi32(x, 31))));
+}
+
+}  // namespace avx2
+#endif  // HAVE_AVX2
+
 // Prefetch memory for a key in InterleavedSolutionStorage.
 template <typename InterleavedSolutionStorage, typename PhsfQueryHasher>
 inline void InterleavedPrepareQuery(
@@ -1145,6 +1231,15 @@ inline typename InterleavedSolutionStorage::ResultRow InterleavedPhsfQuery(
 
   const CoeffRow cr = hasher.GetCoeffRow(hash);
 
+#ifdef HAVE_AVX2
+  if constexpr (std::is_same<CoeffRow, Unsigned128>::value) {
+    if (num_columns <= avx2::kMaxColumns) {
+      return static_cast<ResultRow>(
+          avx2::SolutionRow(segment_num, num_columns, start_bit, cr, iss));
+    }
+  }
+#endif  // HAVE_AVX2
+
   ResultRow sr = 0;
   const CoeffRow cr_left = cr << static_cast<unsigned>(start_bit);
   for (Index i = 0; i < num_columns; ++i) {
@@ -1189,6 +1284,19 @@ inline bool InterleavedFilterQuery(
   const CoeffRow cr = hasher.GetCoeffRow(hash);
   const ResultRow expected = hasher.GetResultRowFromHash(hash);
 
+#ifdef HAVE_AVX2
+  if constexpr (std::is_same<CoeffRow, Unsigned128>::value) {
+    if (num_columns <= avx2::kMaxColumns) {
+      // Checking all columns at once, rather than returning at the first
+      // mismatch, avoids mispredicted branches
+      const uint32_t mask = (uint32_t{1} << num_columns) - 1;
+      const uint32_t sr =
+          avx2::SolutionRow(segment_num, num_columns, start_bit, cr, iss);
+      return ((sr ^ static_cast<uint32_t>(expected)) & mask) == 0;
+    }
+  }
+#endif  // HAVE_AVX2
+
   // TODO: consider optimizations such as
   // * get rid of start_bit == 0 condition with careful fetching & shifting
   if (start_bit == 0) {